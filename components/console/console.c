@@ -0,0 +1,523 @@
+#include "console.h"
+#include "gfx_text.h"
+#include "gfx_utf8.h"
+#include <assert.h>
+#include <string.h>
+
+#define CONSOLE_TAB_WIDTH (4U)
+#define CONSOLE_ESCAPE (0x1BU)
+#define CONSOLE_ESCAPE_PARAMETER_MAX (9999U)
+
+typedef enum {
+    CONSOLE_ESCAPE_STATE_NONE = 0,
+    CONSOLE_ESCAPE_STATE_START,
+    CONSOLE_ESCAPE_STATE_CSI,
+    // unsupported sequences are swallowed up to their final byte
+    CONSOLE_ESCAPE_STATE_IGNORE,
+    // intermediate bytes of an ESC sequence, e.g. the ( of a character set
+    // designation
+    CONSOLE_ESCAPE_STATE_INTERMEDIATE,
+} console_escape_state_t;
+
+static inline size_t console_cell_width(console_t const* console)
+{
+    return console->config.gfx->config.font.width + 1U;
+}
+
+static inline size_t console_physical_row(console_t const* console,
+                                          size_t row)
+{
+    row += console->scroll_row;
+
+    return row < console->rows ? row : row - console->rows;
+}
+
+static inline void console_set_cell(console_t* console,
+                                    size_t row,
+                                    size_t column,
+                                    uint16_t code_point,
+                                    uint8_t attributes)
+{
+    row = console_physical_row(console, row);
+    console_cell_t* cell = &console->cells[row][column];
+
+    if (cell->code_point != code_point || cell->attributes != attributes) {
+        cell->code_point = code_point;
+        cell->attributes = attributes;
+        console->damage[row] |= (uint32_t)1U << column;
+    }
+}
+
+static void console_clear_cells(console_t* console,
+                                size_t row,
+                                size_t begin,
+                                size_t end)
+{
+    for (size_t column = begin; column < end; ++column) {
+        console_set_cell(console, row, column, ' ', CONSOLE_ATTRIBUTE_NONE);
+    }
+}
+
+static void console_clear_row(console_t* console, size_t row, size_t column)
+{
+    console_clear_cells(console, row, column, console->columns);
+}
+
+static void console_scroll(console_t* console)
+{
+    if (console->config.hardware_scroll) {
+        // the old top row becomes the new bottom row in place
+        console->scroll_row = console_physical_row(console, 1U);
+        console->start_line_pending = true;
+        console_clear_row(console, console->rows - 1U, 0U);
+        return;
+    }
+
+    for (size_t row = 1U; row < console->rows; ++row) {
+        for (size_t column = 0U; column < console->columns; ++column) {
+            console_cell_t const* cell = &console->cells[row][column];
+            console_set_cell(console,
+                             row - 1U,
+                             column,
+                             cell->code_point,
+                             cell->attributes);
+        }
+    }
+
+    console_clear_row(console, console->rows - 1U, 0U);
+}
+
+static void console_new_line(console_t* console)
+{
+    console->cursor_column = 0U;
+
+    if (console->cursor_row + 1U < console->rows) {
+        ++console->cursor_row;
+    } else {
+        console_scroll(console);
+    }
+}
+
+static inline size_t console_escape_parameter(console_t const* console,
+                                              size_t index,
+                                              size_t fallback)
+{
+    return index < console->escape_parameter_count
+               ? console->escape_parameters[index]
+               : fallback;
+}
+
+static void console_escape_erase(console_t* console, bool whole_screen)
+{
+    size_t row = console->cursor_row;
+    size_t column = console->cursor_column < console->columns
+                        ? console->cursor_column
+                        : console->columns - 1U;
+
+    switch (console_escape_parameter(console, 0U, 0U)) {
+        case 0U: {
+            console_clear_row(console, row, column);
+            for (size_t below = row + 1U; whole_screen && below < console->rows;
+                 ++below) {
+                console_clear_row(console, below, 0U);
+            }
+            break;
+        }
+        case 1U: {
+            console_clear_cells(console, row, 0U, column + 1U);
+            for (size_t above = 0U; whole_screen && above < row; ++above) {
+                console_clear_row(console, above, 0U);
+            }
+            break;
+        }
+        case 2U: {
+            if (!whole_screen) {
+                console_clear_row(console, row, 0U);
+                break;
+            }
+            for (size_t index = 0U; index < console->rows; ++index) {
+                console_clear_row(console, index, 0U);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+static void console_escape_dispatch(console_t* console, uint8_t final)
+{
+    switch (final) {
+        case 'H':
+        case 'f': {
+            // one based, zero means the default just like a missing value
+            size_t row = console_escape_parameter(console, 0U, 1U);
+            size_t column = console_escape_parameter(console, 1U, 1U);
+            console_set_cursor(console,
+                               row > 0U ? row - 1U : 0U,
+                               column > 0U ? column - 1U : 0U);
+            break;
+        }
+        case 'K': {
+            console_escape_erase(console, false);
+            break;
+        }
+        case 'J': {
+            console_escape_erase(console, true);
+            break;
+        }
+        case 'm': {
+            if (console->escape_parameter_count == 0U) {
+                console->attributes = CONSOLE_ATTRIBUTE_NONE;
+            }
+            for (size_t index = 0U; index < console->escape_parameter_count;
+                 ++index) {
+                switch (console->escape_parameters[index]) {
+                    case 0U: {
+                        console->attributes = CONSOLE_ATTRIBUTE_NONE;
+                        break;
+                    }
+                    case 7U: {
+                        console->attributes |= CONSOLE_ATTRIBUTE_INVERSE;
+                        break;
+                    }
+                    case 27U: {
+                        console->attributes &=
+                            (uint8_t)~CONSOLE_ATTRIBUTE_INVERSE;
+                        break;
+                    }
+                    default: {
+                        break;
+                    }
+                }
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+// Returns false if the byte aborted the sequence and still has to be handled
+static bool console_escape_next(console_t* console, uint8_t byte)
+{
+    if (byte < 0x20U || byte >= 0x7FU) {
+        console->escape_state = CONSOLE_ESCAPE_STATE_NONE;
+        return false;
+    }
+
+    switch (console->escape_state) {
+        case CONSOLE_ESCAPE_STATE_START: {
+            if (byte == '[') {
+                console->escape_state = CONSOLE_ESCAPE_STATE_CSI;
+                console->escape_parameter_count = 0U;
+                memset(console->escape_parameters,
+                       0,
+                       sizeof(console->escape_parameters));
+            } else if (byte < 0x30U) {
+                console->escape_state = CONSOLE_ESCAPE_STATE_INTERMEDIATE;
+            } else {
+                console->escape_state = CONSOLE_ESCAPE_STATE_NONE;
+            }
+            return true;
+        }
+        case CONSOLE_ESCAPE_STATE_INTERMEDIATE: {
+            if (byte >= 0x30U) {
+                console->escape_state = CONSOLE_ESCAPE_STATE_NONE;
+            }
+            return true;
+        }
+        case CONSOLE_ESCAPE_STATE_CSI: {
+            if (byte >= '0' && byte <= '9') {
+                if (console->escape_parameter_count == 0U) {
+                    console->escape_parameter_count = 1U;
+                }
+                size_t index = console->escape_parameter_count - 1U;
+                uint16_t* parameter = &console->escape_parameters[index];
+                uint32_t value = *parameter * 10U + (byte - '0');
+                *parameter = (uint16_t)(value < CONSOLE_ESCAPE_PARAMETER_MAX
+                                            ? value
+                                            : CONSOLE_ESCAPE_PARAMETER_MAX);
+            } else if (byte == ';') {
+                if (console->escape_parameter_count == 0U) {
+                    console->escape_parameter_count = 1U;
+                }
+                if (console->escape_parameter_count <
+                    CONSOLE_ESCAPE_MAX_PARAMETERS) {
+                    ++console->escape_parameter_count;
+                } else {
+                    console->escape_state = CONSOLE_ESCAPE_STATE_IGNORE;
+                }
+            } else if (byte >= 0x40U) {
+                console->escape_state = CONSOLE_ESCAPE_STATE_NONE;
+                console_escape_dispatch(console, byte);
+            } else {
+                // private markers and intermediates are not supported
+                console->escape_state = CONSOLE_ESCAPE_STATE_IGNORE;
+            }
+            return true;
+        }
+        default: {
+            if (byte >= 0x40U) {
+                console->escape_state = CONSOLE_ESCAPE_STATE_NONE;
+            }
+            return true;
+        }
+    }
+}
+
+static void console_render_cell(console_t* console, size_t row, size_t column)
+{
+    console_cell_t const* cell = &console->cells[row][column];
+
+    gfx_draw_cell(console->config.gfx,
+                  (int16_t)(column * console_cell_width(console)),
+                  (int16_t)((console->config.first_row + row) *
+                            GFX_PAGE_HEIGHT),
+                  cell->code_point,
+                  (cell->attributes & CONSOLE_ATTRIBUTE_INVERSE)
+                      ? GFX_TEXT_ATTRIBUTE_INVERSE
+                      : GFX_TEXT_ATTRIBUTE_NONE);
+}
+
+void console_initialize(console_t* console, console_config_t const* config)
+{
+    assert(console && config && config->gfx);
+
+    memset(console, 0, sizeof(*console));
+    memcpy(&console->config, config, sizeof(*config));
+
+    gfx_t const* gfx = config->gfx;
+
+    console->columns = gfx->config.frame_width / console_cell_width(console);
+    if (console->columns > CONSOLE_MAX_COLUMNS) {
+        console->columns = CONSOLE_MAX_COLUMNS;
+    }
+
+    size_t pages = gfx->config.frame_height / GFX_PAGE_HEIGHT;
+    assert(config->first_row < pages);
+
+    console->rows = pages - config->first_row;
+    if (config->rows > 0U && config->rows < console->rows) {
+        console->rows = config->rows;
+    }
+    if (console->rows > CONSOLE_MAX_ROWS) {
+        console->rows = CONSOLE_MAX_ROWS;
+    }
+
+    // the start line wraps at the frame height, so must the rows
+    if (config->first_row != 0U ||
+        console->rows * GFX_PAGE_HEIGHT != gfx->config.frame_height ||
+        gfx->interface.set_start_line == NULL) {
+        console->config.hardware_scroll = false;
+    }
+
+    // the panel may still show an old start line, the first flush resets it
+    console->start_line_pending = console->config.hardware_scroll;
+
+    // panel contents are unknown, so every cell starts damaged
+    for (size_t row = 0U; row < console->rows; ++row) {
+        for (size_t column = 0U; column < console->columns; ++column) {
+            console->cells[row][column].code_point = ' ';
+        }
+        console->damage[row] = (uint32_t)((1ULL << console->columns) - 1U);
+    }
+}
+
+void console_deinitialize(console_t* console)
+{
+    assert(console);
+
+    memset(console, 0, sizeof(*console));
+}
+
+void console_set_cursor(console_t* console, size_t row, size_t column)
+{
+    assert(console);
+
+    console->cursor_row = row < console->rows ? row : console->rows - 1U;
+    console->cursor_column =
+        column < console->columns ? column : console->columns - 1U;
+}
+
+void console_set_attributes(console_t* console, uint8_t attributes)
+{
+    assert(console);
+
+    console->attributes = attributes;
+}
+
+void console_put_char(console_t* console, uint32_t code_point)
+{
+    assert(console);
+
+    switch (code_point) {
+        case '\n': {
+            console_new_line(console);
+            return;
+        }
+        case '\r': {
+            console->cursor_column = 0U;
+            return;
+        }
+        case '\b': {
+            if (console->cursor_column > 0U) {
+                --console->cursor_column;
+            }
+            return;
+        }
+        case '\t': {
+            do {
+                console_put_char(console, ' ');
+            } while (console->cursor_column % CONSOLE_TAB_WIDTH != 0U &&
+                     console->cursor_column < console->columns);
+            return;
+        }
+        default: {
+            break;
+        }
+    }
+
+    if (code_point < 0x20U) {
+        return;
+    }
+    if (code_point > UINT16_MAX) {
+        code_point = '?';
+    }
+
+    // wrap lazily, so that a full line does not scroll until more text comes
+    if (console->cursor_column >= console->columns) {
+        console_new_line(console);
+    }
+
+    console_set_cell(console,
+                     console->cursor_row,
+                     console->cursor_column,
+                     (uint16_t)code_point,
+                     console->attributes);
+    ++console->cursor_column;
+}
+
+void console_write(console_t* console, char const* data, size_t size)
+{
+    assert(console && (data || size == 0U));
+
+    for (size_t index = 0U; index < size; ++index) {
+        uint32_t byte = (uint8_t)data[index];
+
+        if (console->utf8_remaining > 0U) {
+            if ((byte & 0xC0U) == 0x80U) {
+                console->utf8_code_point =
+                    (console->utf8_code_point << 6U) | (byte & 0x3FU);
+                if (--console->utf8_remaining == 0U) {
+                    console_put_char(console, console->utf8_code_point);
+                }
+                continue;
+            }
+
+            console->utf8_remaining = 0U;
+            console_put_char(console, GFX_UTF8_REPLACEMENT);
+        }
+
+        if (console->escape_state != CONSOLE_ESCAPE_STATE_NONE &&
+            console_escape_next(console, (uint8_t)byte)) {
+            continue;
+        }
+
+        if (byte == CONSOLE_ESCAPE) {
+            console->escape_state = CONSOLE_ESCAPE_STATE_START;
+        } else if (byte < 0x80U) {
+            console_put_char(console, byte);
+        } else if ((byte & 0xE0U) == 0xC0U) {
+            console->utf8_code_point = byte & 0x1FU;
+            console->utf8_remaining = 1U;
+        } else if ((byte & 0xF0U) == 0xE0U) {
+            console->utf8_code_point = byte & 0x0FU;
+            console->utf8_remaining = 2U;
+        } else if ((byte & 0xF8U) == 0xF0U) {
+            console->utf8_code_point = byte & 0x07U;
+            console->utf8_remaining = 3U;
+        } else {
+            console_put_char(console, GFX_UTF8_REPLACEMENT);
+        }
+    }
+}
+
+void console_clear(console_t* console)
+{
+    assert(console);
+
+    for (size_t row = 0U; row < console->rows; ++row) {
+        console_clear_row(console, row, 0U);
+    }
+
+    console->cursor_row = 0U;
+    console->cursor_column = 0U;
+}
+
+void console_clear_to_end_of_line(console_t* console)
+{
+    assert(console);
+
+    console_clear_row(console, console->cursor_row, console->cursor_column);
+}
+
+void console_render(console_t* console)
+{
+    assert(console);
+
+    for (size_t row = 0U; row < console->rows; ++row) {
+        uint32_t damage = console->damage[row];
+
+        while (damage != 0U) {
+            size_t column = (size_t)__builtin_ctz(damage);
+            damage &= damage - 1U;
+
+            console_render_cell(console, row, column);
+        }
+
+        console->damage[row] = 0U;
+    }
+}
+
+gfx_err_t console_flush(console_t* console)
+{
+    assert(console);
+
+    for (size_t row = 0U; row < console->rows; ++row) {
+        while (console->damage[row] != 0U) {
+            uint32_t damage = console->damage[row];
+            size_t begin = (size_t)__builtin_ctz(damage);
+            size_t end = begin;
+
+            while (end < console->columns &&
+                   (damage & ((uint32_t)1U << end)) != 0U) {
+                console_render_cell(console, row, end);
+                ++end;
+            }
+
+            gfx_err_t err = gfx_flush(console->config.gfx);
+            if (err != GFX_ERR_OK) {
+                return err;
+            }
+
+            console->damage[row] &=
+                ~(uint32_t)(((1ULL << (end - begin)) - 1U) << begin);
+        }
+    }
+
+    if (console->start_line_pending) {
+        gfx_err_t err =
+            gfx_set_start_line(console->config.gfx,
+                               console->scroll_row * GFX_PAGE_HEIGHT);
+        if (err != GFX_ERR_OK) {
+            return err;
+        }
+
+        console->start_line_pending = false;
+    }
+
+    return GFX_ERR_OK;
+}
@@ -0,0 +1,83 @@
+#ifndef CONSOLE_CONSOLE_H
+#define CONSOLE_CONSOLE_H
+
+#include "gfx.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CONSOLE_MAX_COLUMNS (32U)
+#define CONSOLE_MAX_ROWS (GFX_MAX_PAGES)
+#define CONSOLE_ESCAPE_MAX_PARAMETERS (4U)
+
+typedef enum {
+    CONSOLE_ATTRIBUTE_NONE = 0,
+    CONSOLE_ATTRIBUTE_INVERSE = 1 << 0,
+} console_attribute_t;
+
+typedef struct {
+    uint16_t code_point;
+    uint8_t attributes;
+} console_cell_t;
+
+typedef struct {
+    gfx_t* gfx;
+    // frame buffer page of the top row and the row count, 0 for every page
+    // below it, so that the console can share the frame with other content
+    size_t first_row;
+    size_t rows;
+    // scroll by moving the panel start line instead of redrawing every row,
+    // requires the rows to cover the whole frame height from its top
+    bool hardware_scroll;
+} console_config_t;
+
+// Character grid on top of gfx, one row per display page. Cells are only
+// rasterized and flushed once their content changed. Cells and damage are
+// indexed by physical row, counted from first_row, logical row 0 lives at
+// scroll_row.
+typedef struct {
+    console_config_t config;
+
+    size_t columns;
+    size_t rows;
+    console_cell_t cells[CONSOLE_MAX_ROWS][CONSOLE_MAX_COLUMNS];
+    uint32_t damage[CONSOLE_MAX_ROWS];
+
+    size_t scroll_row;
+    bool start_line_pending;
+
+    size_t cursor_row;
+    size_t cursor_column;
+    uint8_t attributes;
+
+    uint32_t utf8_code_point;
+    uint8_t utf8_remaining;
+
+    uint8_t escape_state;
+    uint8_t escape_parameter_count;
+    uint16_t escape_parameters[CONSOLE_ESCAPE_MAX_PARAMETERS];
+} console_t;
+
+void console_initialize(console_t* console, console_config_t const* config);
+void console_deinitialize(console_t* console);
+
+void console_set_cursor(console_t* console, size_t row, size_t column);
+void console_set_attributes(console_t* console, uint8_t attributes);
+
+void console_put_char(console_t* console, uint32_t code_point);
+
+// Accepts UTF-8 byte streams with the VT100 escape sequences CUP, EL, ED and
+// SGR inverse, sequences may be split across calls
+void console_write(console_t* console, char const* data, size_t size);
+
+void console_clear(console_t* console);
+void console_clear_to_end_of_line(console_t* console);
+
+// Rasterizes damaged cells into the frame buffer
+void console_render(console_t* console);
+
+// Rasterizes and sends each run of damaged cells separately, then moves the
+// panel start line if the console scrolled in hardware
+gfx_err_t console_flush(console_t* console);
+
+#endif // CONSOLE_CONSOLE_H
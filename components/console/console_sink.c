@@ -0,0 +1,76 @@
+#include "console_sink.h"
+#include <assert.h>
+#include <string.h>
+
+void console_sink_initialize(console_sink_t* sink,
+                             console_sink_config_t const* config)
+{
+    assert(sink && config && config->console && config->buffer);
+
+    memset(sink, 0, sizeof(*sink));
+    memcpy(&sink->config, config, sizeof(*config));
+
+    ring_initialize(&sink->ring,
+                    &(ring_config_t){.buffer = config->buffer,
+                                     .size = config->buffer_size});
+}
+
+void console_sink_deinitialize(console_sink_t* sink)
+{
+    assert(sink);
+
+    ring_deinitialize(&sink->ring);
+    memset(&sink->config, 0, sizeof(sink->config));
+}
+
+size_t console_sink_write(console_sink_t* sink,
+                          char const* data,
+                          size_t size)
+{
+    assert(sink && data);
+
+    if (sink->detached) {
+        return 0U;
+    }
+
+    return ring_write_all(&sink->ring, data, size);
+}
+
+gfx_err_t console_sink_process(console_sink_t* sink)
+{
+    assert(sink);
+
+    // bounded by what was queued on entry, so a busy producer cannot starve
+    // the flush below
+    size_t pending = ring_get_used(&sink->ring);
+
+    while (pending > 0U) {
+        uint8_t const* data;
+        size_t size = ring_peek(&sink->ring, &data);
+        if (size > pending) {
+            size = pending;
+        }
+
+        if (!sink->detached) {
+            console_write(sink->config.console, (char const*)data, size);
+        }
+        ring_consume(&sink->ring, size);
+        pending -= size;
+    }
+
+    return sink->detached ? GFX_ERR_OK : console_flush(sink->config.console);
+}
+
+size_t console_sink_get_dropped(console_sink_t* sink)
+{
+    assert(sink);
+
+    return ring_get_dropped(&sink->ring);
+}
+
+void console_sink_detach(console_sink_t* sink)
+{
+    assert(sink);
+
+    sink->detached = true;
+}
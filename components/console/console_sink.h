@@ -0,0 +1,46 @@
+#ifndef CONSOLE_CONSOLE_SINK_H
+#define CONSOLE_CONSOLE_SINK_H
+
+#include "console.h"
+#include "ring.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    console_t* console;
+    uint8_t* buffer;
+    // must be a power of two
+    size_t buffer_size;
+} console_sink_config_t;
+
+// Decouples console writers from rendering, writes only queue bytes and a
+// later console_sink_process call renders and flushes them
+typedef struct {
+    console_sink_config_t config;
+    ring_t ring;
+    bool detached;
+} console_sink_t;
+
+void console_sink_initialize(console_sink_t* sink,
+                             console_sink_config_t const* config);
+void console_sink_deinitialize(console_sink_t* sink);
+
+// Safe from a single producer context. Writes that do not fit are dropped
+// whole, a cut one could end inside an escape or UTF-8 sequence and garble the
+// text queued after it.
+size_t console_sink_write(console_sink_t* sink,
+                          char const* data,
+                          size_t size);
+
+// Drains queued text into the console and flushes the damaged cells, once
+// detached it only discards the text
+gfx_err_t console_sink_process(console_sink_t* sink);
+
+size_t console_sink_get_dropped(console_sink_t* sink);
+
+// Drops what is queued and everything written later without counting it, the
+// console rows are left to whatever else draws over the frame
+void console_sink_detach(console_sink_t* sink);
+
+#endif // CONSOLE_CONSOLE_SINK_H
@@ -0,0 +1,374 @@
+#include "gfx.h"
+#include "gfx_private.h"
+#include <assert.h>
+#include <string.h>
+
+static inline bool gfx_is_inside(gfx_t const* gfx, int16_t x, int16_t y)
+{
+    return x >= 0 && y >= 0 && (size_t)x < gfx->config.frame_width &&
+           (size_t)y < gfx->config.frame_height;
+}
+
+static gfx_err_t gfx_flush_span(gfx_t const* gfx,
+                                size_t page,
+                                size_t column,
+                                uint8_t const* data,
+                                size_t size)
+{
+    return gfx->interface.flush_span
+               ? gfx->interface.flush_span(gfx->interface.panel_user,
+                                           page,
+                                           column,
+                                           data,
+                                           size)
+               : GFX_ERR_NULL;
+}
+
+void gfx_initialize(gfx_t* gfx,
+                    gfx_config_t const* config,
+                    gfx_interface_t const* interface)
+{
+    assert(gfx && config && interface && config->frame_buffer);
+    assert(config->frame_height <= GFX_MAX_PAGES * GFX_PAGE_HEIGHT);
+    assert(config->frame_width < UINT16_MAX);
+
+#ifndef NDEBUG
+    for (size_t index = 1U; index < config->font.extended_glyph_count;
+         ++index) {
+        assert(config->font.extended_code_points[index - 1U] <
+               config->font.extended_code_points[index]);
+    }
+#endif
+
+    memset(gfx, 0, sizeof(*gfx));
+    memcpy(&gfx->config, config, sizeof(*config));
+    memcpy(&gfx->interface, interface, sizeof(*interface));
+
+    // panel contents are unknown until the first full flush
+    gfx_clear_dirty(gfx);
+    gfx_mark_dirty(gfx,
+                   0,
+                   0,
+                   (int16_t)config->frame_width,
+                   (int16_t)config->frame_height);
+}
+
+void gfx_deinitialize(gfx_t* gfx)
+{
+    assert(gfx);
+
+    memset(gfx, 0, sizeof(*gfx));
+}
+
+void gfx_clear(gfx_t* gfx)
+{
+    assert(gfx);
+
+    memset(gfx->config.frame_buffer,
+           0,
+           gfx_get_pages(gfx) * gfx->config.frame_width);
+    gfx_mark_dirty(gfx,
+                   0,
+                   0,
+                   (int16_t)gfx->config.frame_width,
+                   (int16_t)gfx->config.frame_height);
+}
+
+size_t gfx_get_pages(gfx_t const* gfx)
+{
+    assert(gfx);
+
+    return (gfx->config.frame_height + GFX_PAGE_HEIGHT - 1U) / GFX_PAGE_HEIGHT;
+}
+
+void gfx_merge_area(gfx_t const* gfx,
+                    gfx_span_t* spans,
+                    int16_t x,
+                    int16_t y,
+                    int16_t width,
+                    int16_t height)
+{
+    int32_t begin = x < 0 ? 0 : x;
+    int32_t end = (int32_t)x + width;
+    if (end > (int32_t)gfx->config.frame_width) {
+        end = (int32_t)gfx->config.frame_width;
+    }
+
+    int32_t top = y < 0 ? 0 : y;
+    int32_t bottom = (int32_t)y + height;
+    if (bottom > (int32_t)gfx->config.frame_height) {
+        bottom = (int32_t)gfx->config.frame_height;
+    }
+
+    if (begin >= end || top >= bottom) {
+        return;
+    }
+
+    int32_t last_page = gfx_page_of(bottom - 1);
+    for (int32_t page = gfx_page_of(top); page <= last_page; ++page) {
+        gfx_span_merge(&spans[page], (uint16_t)begin, (uint16_t)end);
+    }
+}
+
+void gfx_mark_dirty(gfx_t* gfx,
+                    int16_t x,
+                    int16_t y,
+                    int16_t width,
+                    int16_t height)
+{
+    assert(gfx);
+
+    gfx_merge_area(gfx, gfx->dirty, x, y, width, height);
+}
+
+void gfx_clear_dirty(gfx_t* gfx)
+{
+    assert(gfx);
+
+    for (size_t page = 0U; page < GFX_MAX_PAGES; ++page) {
+        gfx_span_reset(&gfx->dirty[page]);
+    }
+}
+
+gfx_span_t gfx_get_dirty(gfx_t const* gfx, size_t page)
+{
+    assert(gfx && page < GFX_MAX_PAGES);
+
+    return gfx->dirty[page];
+}
+
+gfx_err_t gfx_flush(gfx_t* gfx)
+{
+    assert(gfx);
+
+    size_t pages = gfx_get_pages(gfx);
+
+    for (size_t page = 0U; page < pages; ++page) {
+        gfx_span_t* span = &gfx->dirty[page];
+        if (span->begin >= span->end) {
+            continue;
+        }
+
+        gfx_err_t err = gfx_flush_span(
+            gfx,
+            page,
+            span->begin,
+            &gfx->config.frame_buffer[page * gfx->config.frame_width +
+                                      span->begin],
+            (size_t)(span->end - span->begin));
+        if (err != GFX_ERR_OK) {
+            return err;
+        }
+
+        gfx_span_reset(span);
+    }
+
+    return GFX_ERR_OK;
+}
+
+gfx_err_t gfx_flush_image(gfx_t* gfx, uint8_t const* image)
+{
+    assert(gfx && image);
+
+    size_t pages = gfx_get_pages(gfx);
+    size_t frame_width = gfx->config.frame_width;
+
+    gfx_mark_dirty(gfx,
+                   0,
+                   0,
+                   (int16_t)frame_width,
+                   (int16_t)gfx->config.frame_height);
+
+    // the panel takes one page per transfer, its address has to be set
+    for (size_t page = 0U; page < pages; ++page) {
+        gfx_err_t err = gfx_flush_span(
+            gfx, page, 0U, &image[page * frame_width], frame_width);
+        if (err != GFX_ERR_OK) {
+            return err;
+        }
+    }
+
+    return GFX_ERR_OK;
+}
+
+gfx_err_t gfx_set_start_line(gfx_t* gfx, size_t line)
+{
+    assert(gfx && line < gfx->config.frame_height);
+
+    return gfx->interface.set_start_line
+               ? gfx->interface.set_start_line(gfx->interface.panel_user, line)
+               : GFX_ERR_NULL;
+}
+
+void gfx_set_pixel(gfx_t* gfx, int16_t x, int16_t y, bool state)
+{
+    assert(gfx);
+
+    if (!gfx_is_inside(gfx, x, y)) {
+        return;
+    }
+
+    size_t page = (size_t)y / GFX_PAGE_HEIGHT;
+    uint8_t* byte =
+        &gfx->config.frame_buffer[page * gfx->config.frame_width + (size_t)x];
+    uint8_t mask = (uint8_t)(1U << ((size_t)y % GFX_PAGE_HEIGHT));
+
+    if (state) {
+        *byte |= mask;
+    } else {
+        *byte &= (uint8_t)~mask;
+    }
+
+    gfx_span_merge(&gfx->dirty[page], (uint16_t)x, (uint16_t)(x + 1));
+}
+
+bool gfx_get_pixel(gfx_t const* gfx, int16_t x, int16_t y)
+{
+    assert(gfx);
+
+    if (!gfx_is_inside(gfx, x, y)) {
+        return false;
+    }
+
+    uint8_t byte = gfx->config.frame_buffer[((size_t)y / GFX_PAGE_HEIGHT) *
+                                                gfx->config.frame_width +
+                                            (size_t)x];
+
+    return ((uint32_t)byte >> ((size_t)y % GFX_PAGE_HEIGHT)) & 1U;
+}
+
+// Inlined twice, once with constant terms so that SET folds to plain ORs
+static inline void gfx_put_column_run(uint8_t* top,
+                                      uint8_t* bottom,
+                                      uint8_t const* columns,
+                                      size_t count,
+                                      uint32_t shift,
+                                      uint8_t top_mask,
+                                      uint8_t bottom_mask,
+                                      gfx_rop_terms_t top_terms,
+                                      gfx_rop_terms_t bottom_terms)
+{
+    for (size_t index = 0U; index < count; ++index) {
+        uint32_t column = columns[index];
+
+        if (top != NULL) {
+            uint8_t source = (uint8_t)((column << shift) & top_mask);
+            top[index] = gfx_rop_apply(top[index], source, top_terms);
+        }
+        if (bottom != NULL) {
+            uint8_t source =
+                (uint8_t)((column >> (GFX_PAGE_HEIGHT - shift)) & bottom_mask);
+            bottom[index] = gfx_rop_apply(bottom[index], source, bottom_terms);
+        }
+    }
+}
+
+// Rows of page inside the frame, the last page may reach past its height
+static inline uint8_t gfx_get_page_mask(gfx_t const* gfx, int32_t page)
+{
+    int32_t rows =
+        (int32_t)gfx->config.frame_height - page * (int32_t)GFX_PAGE_HEIGHT;
+
+    if (rows <= 0) {
+        return 0x00U;
+    }
+    if (rows >= (int32_t)GFX_PAGE_HEIGHT) {
+        return 0xFFU;
+    }
+
+    return (uint8_t)(0xFFU >> (GFX_PAGE_HEIGHT - (uint32_t)rows));
+}
+
+void gfx_put_columns(gfx_t* gfx,
+                     int16_t x,
+                     int16_t y,
+                     uint8_t const* columns,
+                     size_t count,
+                     gfx_rop_terms_t terms)
+{
+    int32_t frame_width = (int32_t)gfx->config.frame_width;
+    int32_t frame_pages = (int32_t)gfx_get_pages(gfx);
+
+    if (y <= -(int32_t)GFX_PAGE_HEIGHT ||
+        y >= (int32_t)gfx->config.frame_height || x >= frame_width) {
+        return;
+    }
+
+    // clamped while still a size_t, a cast could wrap it
+    int32_t begin = x < 0 ? -x : 0;
+    int32_t end = count < (size_t)(frame_width - x) ? (int32_t)count
+                                                    : frame_width - x;
+    if (begin >= end) {
+        return;
+    }
+
+    int32_t page = gfx_page_of(y);
+    uint32_t shift = (uint32_t)(y - page * (int32_t)GFX_PAGE_HEIGHT);
+
+    uint8_t* frame_buffer = gfx->config.frame_buffer;
+    int32_t top = page * frame_width + x + begin;
+    uint8_t* top_bytes = page >= 0 ? &frame_buffer[top] : NULL;
+    uint8_t* bottom_bytes = shift != 0U && page + 1 < frame_pages
+                                ? &frame_buffer[top + frame_width]
+                                : NULL;
+
+    // the source is cleared past the bottom of the frame as well
+    uint8_t top_mask =
+        (uint8_t)((0xFFU << shift) & gfx_get_page_mask(gfx, page));
+    uint8_t bottom_mask =
+        (uint8_t)((0xFFU >> (GFX_PAGE_HEIGHT - shift)) &
+                  gfx_get_page_mask(gfx, page + 1));
+
+    gfx_rop_terms_t set = gfx_rop_get_terms(GFX_ROP_SET);
+    bool inside = top_mask == (uint8_t)(0xFFU << shift) &&
+                  bottom_mask == (uint8_t)(0xFFU >> (GFX_PAGE_HEIGHT - shift));
+    if (inside && memcmp(&terms, &set, sizeof(terms)) == 0) {
+        // masking leaves the terms of SET unchanged and the shifts already
+        // clear the source outside of the pages
+        gfx_put_column_run(top_bytes,
+                           bottom_bytes,
+                           &columns[begin],
+                           (size_t)(end - begin),
+                           shift,
+                           0xFFU,
+                           0xFFU,
+                           set,
+                           set);
+        return;
+    }
+
+    gfx_put_column_run(top_bytes,
+                       bottom_bytes,
+                       &columns[begin],
+                       (size_t)(end - begin),
+                       shift,
+                       top_mask,
+                       bottom_mask,
+                       gfx_rop_mask_terms(terms, top_mask),
+                       gfx_rop_mask_terms(terms, bottom_mask));
+}
+
+void gfx_draw_columns(gfx_t* gfx,
+                      int16_t x,
+                      int16_t y,
+                      uint8_t const* columns,
+                      size_t count,
+                      gfx_rop_t rop)
+{
+    assert(gfx && columns);
+
+    gfx_put_columns(gfx, x, y, columns, count, gfx_rop_get_terms(rop));
+
+    // only the columns up to the right edge, so the width fits an int16_t
+    int32_t frame_width = (int32_t)gfx->config.frame_width;
+    if (x < frame_width) {
+        int32_t begin = x < 0 ? 0 : x;
+        int32_t end = count < (size_t)(frame_width - x) ? x + (int32_t)count
+                                                        : frame_width;
+        gfx_mark_dirty(gfx,
+                       (int16_t)begin,
+                       y,
+                       (int16_t)(end - begin),
+                       (int16_t)GFX_PAGE_HEIGHT);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef GFX_GFX_H
+#define GFX_GFX_H
+
+#include "gfx_config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Column range [begin, end) of a page, empty when begin >= end
+typedef struct {
+    uint16_t begin;
+    uint16_t end;
+} gfx_span_t;
+
+// Frame buffer uses the SH1107 page layout: byte (page * frame_width + x)
+// holds rows [page * 8, page * 8 + 8) of column x, LSB being the top row.
+typedef struct {
+    gfx_config_t config;
+    gfx_interface_t interface;
+    gfx_span_t dirty[GFX_MAX_PAGES];
+} gfx_t;
+
+void gfx_initialize(gfx_t* gfx,
+                    gfx_config_t const* config,
+                    gfx_interface_t const* interface);
+void gfx_deinitialize(gfx_t* gfx);
+
+void gfx_clear(gfx_t* gfx);
+
+size_t gfx_get_pages(gfx_t const* gfx);
+
+void gfx_mark_dirty(gfx_t* gfx,
+                    int16_t x,
+                    int16_t y,
+                    int16_t width,
+                    int16_t height);
+void gfx_clear_dirty(gfx_t* gfx);
+gfx_span_t gfx_get_dirty(gfx_t const* gfx, size_t page);
+
+// Sends only the dirty span of each page, spans are cleared once sent
+gfx_err_t gfx_flush(gfx_t* gfx);
+
+// Sends a frame sized page layout image, for example one rendered at compile
+// time into flash, straight to the panel. The frame buffer stays as it is
+// and is marked dirty, the next flush puts it back.
+gfx_err_t gfx_flush_image(gfx_t* gfx, uint8_t const* image);
+
+gfx_err_t gfx_set_start_line(gfx_t* gfx, size_t line);
+
+void gfx_set_pixel(gfx_t* gfx, int16_t x, int16_t y, bool state);
+bool gfx_get_pixel(gfx_t const* gfx, int16_t x, int16_t y);
+
+// Combines 8 pixel tall columns (LSB on top) with the frame at (x, y)
+void gfx_draw_columns(gfx_t* gfx,
+                      int16_t x,
+                      int16_t y,
+                      uint8_t const* columns,
+                      size_t count,
+                      gfx_rop_t rop);
+
+#endif // GFX_GFX_H
@@ -0,0 +1,219 @@
+#include "gfx_blit.h"
+#include "gfx_private.h"
+#include <assert.h>
+#include <string.h>
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t source_x;
+    int32_t source_y;
+    int32_t width;
+    int32_t height;
+} gfx_blit_area_t;
+
+// Shrinks both sides of the area together, false once nothing is left
+static bool gfx_blit_clip(gfx_blit_area_t* area,
+                          size_t buffer_width,
+                          size_t buffer_height,
+                          gfx_bitmap_t const* source)
+{
+    int32_t skip_x = 0;
+    if (area->x < 0) {
+        skip_x = -area->x;
+    }
+    if (area->source_x < -skip_x) {
+        skip_x = -area->source_x;
+    }
+
+    int32_t skip_y = 0;
+    if (area->y < 0) {
+        skip_y = -area->y;
+    }
+    if (area->source_y < -skip_y) {
+        skip_y = -area->source_y;
+    }
+
+    area->x += skip_x;
+    area->source_x += skip_x;
+    area->width -= skip_x;
+    area->y += skip_y;
+    area->source_y += skip_y;
+    area->height -= skip_y;
+
+    int32_t limit_x = (int32_t)buffer_width - area->x;
+    if ((int32_t)source->width - area->source_x < limit_x) {
+        limit_x = (int32_t)source->width - area->source_x;
+    }
+    int32_t limit_y = (int32_t)buffer_height - area->y;
+    if ((int32_t)source->height - area->source_y < limit_y) {
+        limit_y = (int32_t)source->height - area->source_y;
+    }
+
+    area->width = area->width < limit_x ? area->width : limit_x;
+    area->height = area->height < limit_y ? area->height : limit_y;
+
+    return area->width > 0 && area->height > 0;
+}
+
+static inline uint8_t gfx_blit_gather(uint8_t const* upper,
+                                      uint8_t const* lower,
+                                      uint32_t shift,
+                                      int32_t index)
+{
+    uint32_t source = upper != NULL ? (uint32_t)upper[index] >> shift : 0U;
+    if (lower != NULL) {
+        source |= (uint32_t)lower[index] << (GFX_PAGE_HEIGHT - shift);
+    }
+
+    return (uint8_t)source;
+}
+
+// One page of the destination. The source rows line up with it shifted by
+// shift bits, so every byte is gathered from two source pages.
+static void gfx_blit_page(uint8_t* destination,
+                          uint8_t const* upper,
+                          uint8_t const* lower,
+                          uint32_t shift,
+                          int32_t count,
+                          bool backwards,
+                          uint8_t mask,
+                          gfx_rop_terms_t terms)
+{
+    if (backwards) {
+        for (int32_t index = count - 1; index >= 0; --index) {
+            uint8_t source = gfx_blit_gather(upper, lower, shift, index);
+            destination[index] = gfx_rop_apply(
+                destination[index], (uint8_t)(source & mask), terms);
+        }
+        return;
+    }
+
+    for (int32_t index = 0; index < count; ++index) {
+        uint8_t source = gfx_blit_gather(upper, lower, shift, index);
+        destination[index] = gfx_rop_apply(
+            destination[index], (uint8_t)(source & mask), terms);
+    }
+}
+
+static void gfx_blit_area(uint8_t* buffer,
+                          size_t buffer_width,
+                          gfx_blit_area_t const* area,
+                          gfx_bitmap_t const* source,
+                          gfx_rop_t rop)
+{
+    gfx_rop_terms_t terms = gfx_rop_get_terms(rop);
+    int32_t source_pages =
+        (int32_t)((source->height + GFX_PAGE_HEIGHT - 1U) / GFX_PAGE_HEIGHT);
+    int32_t first_page = area->y / (int32_t)GFX_PAGE_HEIGHT;
+    int32_t last_page =
+        (area->y + area->height - 1) / (int32_t)GFX_PAGE_HEIGHT;
+
+    // like memmove, pages and columns are walked away from the side the
+    // source lies on, so a buffer blitted onto itself reads nothing it
+    // has already written
+    bool upwards = area->source_y < area->y;
+    bool backwards = area->source_x < area->x;
+    int32_t offset = area->source_y - area->y;
+
+    for (int32_t index = 0; index <= last_page - first_page; ++index) {
+        int32_t page = upwards ? last_page - index : first_page + index;
+        int32_t row = page * (int32_t)GFX_PAGE_HEIGHT;
+
+        int32_t top = area->y > row ? area->y - row : 0;
+        int32_t bottom = area->y + area->height - row;
+        uint32_t rows = bottom < (int32_t)GFX_PAGE_HEIGHT ? (uint32_t)bottom
+                                                          : GFX_PAGE_HEIGHT;
+        uint8_t mask =
+            (uint8_t)((0xFFU << top) & (0xFFU >> (GFX_PAGE_HEIGHT - rows)));
+
+        int32_t source_page = gfx_page_of(row + offset);
+        uint32_t shift = (uint32_t)(row + offset -
+                                    source_page * (int32_t)GFX_PAGE_HEIGHT);
+
+        uint8_t* destination =
+            &buffer[(size_t)page * buffer_width + (size_t)area->x];
+        uint8_t const* upper =
+            source_page >= 0 && source_page < source_pages
+                ? &source->data[(size_t)source_page * source->width +
+                                (size_t)area->source_x]
+                : NULL;
+        uint8_t const* lower =
+            shift != 0U && source_page + 1 < source_pages
+                ? &source->data[(size_t)(source_page + 1) * source->width +
+                                (size_t)area->source_x]
+                : NULL;
+
+        if (rop == GFX_ROP_COPY && mask == 0xFFU && shift == 0U) {
+            memmove(destination, upper, (size_t)area->width);
+            continue;
+        }
+
+        gfx_blit_page(destination,
+                      upper,
+                      lower,
+                      shift,
+                      area->width,
+                      backwards,
+                      mask,
+                      gfx_rop_mask_terms(terms, mask));
+    }
+}
+
+gfx_bitmap_t gfx_get_frame(gfx_t const* gfx)
+{
+    assert(gfx);
+
+    return (gfx_bitmap_t){.data = gfx->config.frame_buffer,
+                          .width = gfx->config.frame_width,
+                          .height = gfx->config.frame_height};
+}
+
+void gfx_blit_buffer(uint8_t* buffer,
+                     size_t buffer_width,
+                     size_t buffer_height,
+                     int16_t x,
+                     int16_t y,
+                     gfx_bitmap_t const* source,
+                     int16_t source_x,
+                     int16_t source_y,
+                     int16_t width,
+                     int16_t height,
+                     gfx_rop_t rop)
+{
+    assert(buffer && source && source->data);
+
+    gfx_blit_area_t area = {x, y, source_x, source_y, width, height};
+    if (gfx_blit_clip(&area, buffer_width, buffer_height, source)) {
+        gfx_blit_area(buffer, buffer_width, &area, source, rop);
+    }
+}
+
+void gfx_blit(gfx_t* gfx,
+              int16_t x,
+              int16_t y,
+              gfx_bitmap_t const* source,
+              int16_t source_x,
+              int16_t source_y,
+              int16_t width,
+              int16_t height,
+              gfx_rop_t rop)
+{
+    assert(gfx && source && source->data);
+
+    gfx_blit_area_t area = {x, y, source_x, source_y, width, height};
+    if (!gfx_blit_clip(&area,
+                       gfx->config.frame_width,
+                       gfx->config.frame_height,
+                       source)) {
+        return;
+    }
+
+    gfx_blit_area(
+        gfx->config.frame_buffer, gfx->config.frame_width, &area, source, rop);
+    gfx_mark_dirty(gfx,
+                   (int16_t)area.x,
+                   (int16_t)area.y,
+                   (int16_t)area.width,
+                   (int16_t)area.height);
+}
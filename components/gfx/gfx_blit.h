@@ -0,0 +1,46 @@
+#ifndef GFX_GFX_BLIT_H
+#define GFX_GFX_BLIT_H
+
+#include "gfx.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// 1bpp image in the frame buffer page layout, byte (page * width + x)
+// holds rows [page * 8, page * 8 + 8) of column x
+typedef struct {
+    uint8_t const* data;
+    size_t width;
+    size_t height;
+} gfx_bitmap_t;
+
+// The frame buffer as a blit source, for scrolling and save-under
+gfx_bitmap_t gfx_get_frame(gfx_t const* gfx);
+
+// Combines the width x height area of source at (source_x, source_y) with
+// a page layout buffer at (x, y). Both areas are clipped and the copy is
+// done in the order that keeps overlapping areas of one buffer intact.
+// COPY of whole pages moves bytes with memmove.
+void gfx_blit_buffer(uint8_t* buffer,
+                     size_t buffer_width,
+                     size_t buffer_height,
+                     int16_t x,
+                     int16_t y,
+                     gfx_bitmap_t const* source,
+                     int16_t source_x,
+                     int16_t source_y,
+                     int16_t width,
+                     int16_t height,
+                     gfx_rop_t rop);
+
+// Same with the frame buffer as destination, the area is marked dirty
+void gfx_blit(gfx_t* gfx,
+              int16_t x,
+              int16_t y,
+              gfx_bitmap_t const* source,
+              int16_t source_x,
+              int16_t source_y,
+              int16_t width,
+              int16_t height,
+              gfx_rop_t rop);
+
+#endif // GFX_GFX_BLIT_H
@@ -0,0 +1,58 @@
+#ifndef GFX_GFX_CONFIG_H
+#define GFX_GFX_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GFX_PAGE_HEIGHT (8U)
+#define GFX_MAX_PAGES (16U)
+#define GFX_GLYPH_NOT_FOUND (SIZE_MAX)
+
+typedef enum {
+    GFX_ERR_OK = 0,
+    GFX_ERR_FAIL = 1 << 0,
+    GFX_ERR_NULL = 1 << 1,
+} gfx_err_t;
+
+// Raster operations, applied where the source has pixels. Shapes have them
+// all set, so for them AND leaves the frame as is, INVERT acts as XOR and
+// COPY as SET. With glyphs and bitmaps INVERT flips the whole 8 pixel tall
+// cells and COPY overwrites them, background included.
+typedef enum {
+    GFX_ROP_SET = 0,
+    GFX_ROP_CLEAR = 1,
+    GFX_ROP_XOR = 2,
+    GFX_ROP_AND = 3,
+    GFX_ROP_INVERT = 4,
+    GFX_ROP_COPY = 5,
+} gfx_rop_t;
+
+typedef struct {
+    uint8_t const* glyphs;
+    size_t glyph_count;
+    size_t code_offset;
+    size_t width;
+    size_t height;
+
+    // sorted ascending, parallel to extended_glyphs
+    uint16_t const* extended_code_points;
+    uint8_t const* extended_glyphs;
+    size_t extended_glyph_count;
+} gfx_font_t;
+
+typedef struct {
+    uint8_t* frame_buffer;
+    size_t frame_width;
+    size_t frame_height;
+    gfx_font_t font;
+} gfx_config_t;
+
+typedef struct {
+    void* panel_user;
+    // sends size bytes of page data starting at column
+    gfx_err_t (*flush_span)(void*, size_t, size_t, uint8_t const*, size_t);
+    // moves the panel row shown on top, optional
+    gfx_err_t (*set_start_line)(void*, size_t);
+} gfx_interface_t;
+
+#endif // GFX_GFX_CONFIG_H
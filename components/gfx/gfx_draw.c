@@ -0,0 +1,710 @@
+#include "gfx_draw.h"
+#include "gfx_private.h"
+#include <assert.h>
+#include <string.h>
+
+// Applies the operation to the row mask of count consecutive bytes of a
+// page, a word at a time once aligned. The memcpy calls compile to single
+// loads and stores.
+static void gfx_mask_bytes(uint8_t* bytes,
+                           size_t count,
+                           uint8_t mask,
+                           gfx_rop_terms_t terms)
+{
+    // a shape is its own source, all of its pixels are set
+    gfx_rop_terms_t masked = gfx_rop_mask_terms(terms, mask);
+    uint8_t and_mask =
+        (uint8_t)((mask & masked.and_source) ^ masked.and_constant);
+    uint8_t xor_mask =
+        (uint8_t)((mask & masked.xor_source) ^ masked.xor_constant);
+
+    while (count > 0U && ((uintptr_t)bytes & 3U) != 0U) {
+        *bytes = (uint8_t)((*bytes & and_mask) ^ xor_mask);
+        ++bytes;
+        --count;
+    }
+
+    uint32_t word_and = and_mask * 0x01010101U;
+    uint32_t word_xor = xor_mask * 0x01010101U;
+
+    for (; count >= 4U; count -= 4U, bytes += 4U) {
+        uint32_t word;
+        memcpy(&word, bytes, sizeof(word));
+        word = (word & word_and) ^ word_xor;
+        memcpy(bytes, &word, sizeof(word));
+    }
+
+    while (count > 0U) {
+        *bytes = (uint8_t)((*bytes & and_mask) ^ xor_mask);
+        ++bytes;
+        --count;
+    }
+}
+
+void gfx_fill_area(gfx_t* gfx,
+                   int32_t x,
+                   int32_t y,
+                   int32_t width,
+                   int32_t height,
+                   gfx_rop_terms_t terms)
+{
+    int32_t frame_width = (int32_t)gfx->config.frame_width;
+    int32_t frame_height = (int32_t)gfx->config.frame_height;
+
+    int32_t left = x < 0 ? 0 : x;
+    int32_t top = y < 0 ? 0 : y;
+    int32_t right = x + width > frame_width ? frame_width : x + width;
+    int32_t bottom = y + height > frame_height ? frame_height : y + height;
+
+    if (left >= right || top >= bottom) {
+        return;
+    }
+
+    int32_t first_page = top / (int32_t)GFX_PAGE_HEIGHT;
+    int32_t last_page = (bottom - 1) / (int32_t)GFX_PAGE_HEIGHT;
+
+    for (int32_t page = first_page; page <= last_page; ++page) {
+        uint32_t first = page == first_page ? (uint32_t)top % GFX_PAGE_HEIGHT
+                                            : 0U;
+        uint32_t last = page == last_page
+                            ? (uint32_t)(bottom - 1) % GFX_PAGE_HEIGHT
+                            : GFX_PAGE_HEIGHT - 1U;
+        uint8_t mask = (uint8_t)((0xFFU << first) &
+                                 (0xFFU >> (GFX_PAGE_HEIGHT - 1U - last)));
+
+        gfx_mask_bytes(
+            &gfx->config.frame_buffer[page * frame_width + left],
+            (size_t)(right - left),
+            mask,
+            terms);
+    }
+}
+
+static inline void gfx_plot(gfx_t* gfx,
+                            int32_t x,
+                            int32_t y,
+                            gfx_rop_terms_t terms)
+{
+    if (x < 0 || y < 0 || x >= (int32_t)gfx->config.frame_width ||
+        y >= (int32_t)gfx->config.frame_height) {
+        return;
+    }
+
+    size_t page = (size_t)y / GFX_PAGE_HEIGHT;
+    uint8_t* byte =
+        &gfx->config.frame_buffer[page * gfx->config.frame_width + (size_t)x];
+    uint8_t mask = (uint8_t)(1U << ((size_t)y % GFX_PAGE_HEIGHT));
+
+    *byte = gfx_rop_apply(*byte, mask, gfx_rop_mask_terms(terms, mask));
+
+    // per pixel, a diagonal line covers a small part of its bounding box
+    gfx_span_merge(&gfx->dirty[page], (uint16_t)x, (uint16_t)(x + 1));
+}
+
+// Merges an area given by int32_t bounds, clipped first so it fits int16_t
+static void gfx_mark_bounds(gfx_t* gfx,
+                            int32_t left,
+                            int32_t top,
+                            int32_t right,
+                            int32_t bottom)
+{
+    int32_t frame_width = (int32_t)gfx->config.frame_width;
+    int32_t frame_height = (int32_t)gfx->config.frame_height;
+
+    left = left < 0 ? 0 : left;
+    top = top < 0 ? 0 : top;
+    right = right > frame_width ? frame_width : right;
+    bottom = bottom > frame_height ? frame_height : bottom;
+
+    if (left < right && top < bottom) {
+        gfx_mark_dirty(gfx,
+                       (int16_t)left,
+                       (int16_t)top,
+                       (int16_t)(right - left),
+                       (int16_t)(bottom - top));
+    }
+}
+
+static void gfx_fill_marked(gfx_t* gfx,
+                            int32_t x,
+                            int32_t y,
+                            int32_t width,
+                            int32_t height,
+                            gfx_rop_terms_t terms)
+{
+    gfx_fill_area(gfx, x, y, width, height, terms);
+    gfx_mark_bounds(gfx, x, y, x + width, y + height);
+}
+
+// sin of whole degrees 0 to 90, scaled by 1 << 14
+static int16_t const gfx_sine_table[91] = {
+    0,     286,   572,   857,   1143,  1428,  1713,  1997,  2280,  2563,
+    2845,  3126,  3406,  3686,  3964,  4240,  4516,  4790,  5063,  5334,
+    5604,  5872,  6138,  6402,  6664,  6924,  7182,  7438,  7692,  7943,
+    8192,  8438,  8682,  8923,  9162,  9397,  9630,  9860,  10087, 10311,
+    10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+    12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+    14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+    15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+    16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+    16384,
+};
+
+// Angles between two rays, counterclockwise with y pointing up
+typedef struct {
+    int32_t start_x;
+    int32_t start_y;
+    int32_t end_x;
+    int32_t end_y;
+    int32_t sweep;
+} gfx_sector_t;
+
+static int32_t gfx_sine(int32_t degrees)
+{
+    degrees %= 360;
+    if (degrees < 0) {
+        degrees += 360;
+    }
+
+    if (degrees <= 90) {
+        return gfx_sine_table[degrees];
+    }
+    if (degrees <= 180) {
+        return gfx_sine_table[180 - degrees];
+    }
+    if (degrees <= 270) {
+        return -gfx_sine_table[degrees - 180];
+    }
+    return -gfx_sine_table[360 - degrees];
+}
+
+static gfx_sector_t gfx_sector_make(int16_t start, int16_t end)
+{
+    int32_t sweep = ((int32_t)end - start) % 360;
+    if (sweep <= 0) {
+        sweep += 360;
+    }
+
+    return (gfx_sector_t){.start_x = gfx_sine(start + 90),
+                          .start_y = gfx_sine(start),
+                          .end_x = gfx_sine(end + 90),
+                          .end_y = gfx_sine(end),
+                          .sweep = sweep};
+}
+
+static bool gfx_sector_contains(gfx_sector_t const* sector,
+                                int32_t x,
+                                int32_t y)
+{
+    if (sector == NULL || sector->sweep == 360) {
+        return true;
+    }
+
+    // screen rows grow downwards
+    y = -y;
+
+    int32_t after_start = sector->start_x * y - sector->start_y * x;
+    int32_t before_end = x * sector->end_y - y * sector->end_x;
+
+    if (sector->sweep <= 180) {
+        return after_start >= 0 && before_end >= 0;
+    }
+
+    int32_t after_end = sector->end_x * y - sector->end_y * x;
+    int32_t before_start = x * sector->start_y - y * sector->start_x;
+
+    return !(after_end > 0 && before_start > 0);
+}
+
+// Plots the up to four mirror images of an offset, each pixel only once
+static void gfx_plot_mirrored(gfx_t* gfx,
+                              int32_t center_x,
+                              int32_t center_y,
+                              int32_t x,
+                              int32_t y,
+                              gfx_sector_t const* sector,
+                              gfx_rop_terms_t terms)
+{
+    int32_t const signs[4][2] = {{1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+
+    for (size_t index = 0U; index < 4U; ++index) {
+        if ((x == 0 && signs[index][0] < 0) ||
+            (y == 0 && signs[index][1] < 0)) {
+            continue;
+        }
+
+        int32_t offset_x = x * signs[index][0];
+        int32_t offset_y = y * signs[index][1];
+        if (gfx_sector_contains(sector, offset_x, offset_y)) {
+            gfx_plot(gfx, center_x + offset_x, center_y + offset_y, terms);
+        }
+    }
+}
+
+static int32_t gfx_floor_div(int32_t numerator, int32_t denominator)
+{
+    int32_t quotient = numerator / denominator;
+
+    return (numerator % denominator != 0 && numerator < 0) ? quotient - 1
+                                                           : quotient;
+}
+
+// Narrows the rows to those where slope * y + offset >= 0, or > 0 if strict.
+// The cross products are linear in y, so a column needs no per pixel test.
+static void gfx_clip_rows(int32_t slope,
+                          int32_t offset,
+                          bool strict,
+                          int32_t* top,
+                          int32_t* bottom)
+{
+    if (slope == 0) {
+        if (offset < 0 || (strict && offset == 0)) {
+            *bottom = *top - 1;
+        }
+    } else if (slope > 0) {
+        int32_t limit = strict ? gfx_floor_div(-offset, slope) + 1
+                               : -gfx_floor_div(offset, slope);
+        if (*top < limit) {
+            *top = limit;
+        }
+    } else {
+        int32_t limit = strict ? -gfx_floor_div(-offset, -slope) - 1
+                               : gfx_floor_div(offset, -slope);
+        if (*bottom > limit) {
+            *bottom = limit;
+        }
+    }
+}
+
+static void gfx_fill_rows(gfx_t* gfx,
+                          int32_t x,
+                          int32_t center_y,
+                          int32_t top,
+                          int32_t bottom,
+                          gfx_rop_terms_t terms)
+{
+    if (top <= bottom) {
+        gfx_fill_marked(gfx, x, center_y + top, 1, bottom - top + 1, terms);
+    }
+}
+
+// Fills a column of a round shape, limited to the rows inside the sector
+static void gfx_fill_column(gfx_t* gfx,
+                            int32_t center_x,
+                            int32_t center_y,
+                            int32_t x,
+                            int32_t half_height,
+                            gfx_sector_t const* sector,
+                            gfx_rop_terms_t terms)
+{
+    int32_t top = -half_height;
+    int32_t bottom = half_height;
+
+    if (sector == NULL || sector->sweep == 360) {
+        gfx_fill_rows(gfx, center_x + x, center_y, top, bottom, terms);
+        return;
+    }
+
+    // same tests as gfx_sector_contains with y flipped
+    if (sector->sweep <= 180) {
+        gfx_clip_rows(
+            -sector->start_x, -sector->start_y * x, false, &top, &bottom);
+        gfx_clip_rows(sector->end_x, sector->end_y * x, false, &top, &bottom);
+        gfx_fill_rows(gfx, center_x + x, center_y, top, bottom, terms);
+        return;
+    }
+
+    int32_t outside_top = top;
+    int32_t outside_bottom = bottom;
+    gfx_clip_rows(-sector->end_x,
+                  -sector->end_y * x,
+                  true,
+                  &outside_top,
+                  &outside_bottom);
+    gfx_clip_rows(sector->start_x,
+                  sector->start_y * x,
+                  true,
+                  &outside_top,
+                  &outside_bottom);
+
+    if (outside_top > outside_bottom) {
+        gfx_fill_rows(gfx, center_x + x, center_y, top, bottom, terms);
+    } else {
+        gfx_fill_rows(
+            gfx, center_x + x, center_y, top, outside_top - 1, terms);
+        gfx_fill_rows(
+            gfx, center_x + x, center_y, outside_bottom + 1, bottom, terms);
+    }
+}
+
+// Octant walk of the midpoint circle, each outline pixel is plotted once
+static void gfx_circle_outline(gfx_t* gfx,
+                               int32_t center_x,
+                               int32_t center_y,
+                               int32_t radius,
+                               gfx_sector_t const* sector,
+                               gfx_rop_terms_t terms)
+{
+    int32_t x = radius;
+    int32_t y = 0;
+    int32_t error = 1 - radius;
+
+    while (x >= y) {
+        gfx_plot_mirrored(gfx, center_x, center_y, x, y, sector, terms);
+        if (x != y) {
+            gfx_plot_mirrored(gfx, center_x, center_y, y, x, sector, terms);
+        }
+
+        ++y;
+        if (error < 0) {
+            error += 2 * y + 1;
+        } else {
+            --x;
+            error += 2 * (y - x) + 1;
+        }
+    }
+}
+
+// Same walk, every column is filled once with its full height
+static void gfx_circle_fill(gfx_t* gfx,
+                            int32_t center_x,
+                            int32_t center_y,
+                            int32_t radius,
+                            gfx_sector_t const* sector,
+                            gfx_rop_terms_t terms)
+{
+    int32_t x = radius;
+    int32_t y = 0;
+    int32_t error = 1 - radius;
+
+    while (x >= y) {
+        // the columns at +-y reach +-x, the first visit is the tallest
+        gfx_fill_column(gfx, center_x, center_y, y, x, sector, terms);
+        if (y != 0) {
+            gfx_fill_column(gfx, center_x, center_y, -y, x, sector, terms);
+        }
+
+        ++y;
+        if (error < 0) {
+            error += 2 * y + 1;
+        } else {
+            // the columns at +-x are left for good, y - 1 was their height
+            if (x >= y) {
+                gfx_fill_column(
+                    gfx, center_x, center_y, x, y - 1, sector, terms);
+                gfx_fill_column(
+                    gfx, center_x, center_y, -x, y - 1, sector, terms);
+            }
+            --x;
+            error += 2 * (y - x) + 1;
+        }
+    }
+}
+
+// Two region midpoint ellipse, the decision values are scaled by four to
+// stay integral. Every step moves to a new point of the first quadrant.
+static void gfx_ellipse_walk(gfx_t* gfx,
+                             int32_t center_x,
+                             int32_t center_y,
+                             int32_t radius_x,
+                             int32_t radius_y,
+                             bool fill,
+                             gfx_rop_terms_t terms)
+{
+    int64_t radius_x2 = (int64_t)radius_x * radius_x;
+    int64_t radius_y2 = (int64_t)radius_y * radius_y;
+    int32_t x = 0;
+    int32_t y = radius_y;
+    int64_t step_x = 0;
+    int64_t step_y = 2 * radius_x2 * y;
+    int64_t error = 4 * radius_y2 - 4 * radius_x2 * radius_y + radius_x2;
+
+    while (step_x < step_y) {
+        if (fill) {
+            gfx_fill_column(gfx, center_x, center_y, x, y, NULL, terms);
+            if (x != 0) {
+                gfx_fill_column(gfx, center_x, center_y, -x, y, NULL, terms);
+            }
+        } else {
+            gfx_plot_mirrored(gfx, center_x, center_y, x, y, NULL, terms);
+        }
+
+        ++x;
+        step_x += 2 * radius_y2;
+        if (error < 0) {
+            error += 4 * (radius_y2 + step_x);
+        } else {
+            --y;
+            step_y -= 2 * radius_x2;
+            error += 4 * (radius_y2 + step_x - step_y);
+        }
+    }
+
+    error = radius_y2 * (2 * x + 1) * (2 * x + 1) +
+            4 * radius_x2 * (y - 1) * (y - 1) - 4 * radius_x2 * radius_y2;
+    bool new_column = true;
+
+    while (y >= 0) {
+        if (!fill) {
+            gfx_plot_mirrored(gfx, center_x, center_y, x, y, NULL, terms);
+        } else if (new_column) {
+            gfx_fill_column(gfx, center_x, center_y, x, y, NULL, terms);
+            if (x != 0) {
+                gfx_fill_column(gfx, center_x, center_y, -x, y, NULL, terms);
+            }
+        }
+
+        --y;
+        step_y -= 2 * radius_x2;
+        new_column = error <= 0;
+        if (error > 0) {
+            error += 4 * (radius_x2 - step_y);
+        } else {
+            ++x;
+            step_x += 2 * radius_y2;
+            error += 4 * (radius_x2 - step_y + step_x);
+        }
+    }
+}
+
+void gfx_draw_pixel(gfx_t* gfx, int16_t x, int16_t y, gfx_rop_t rop)
+{
+    assert(gfx);
+
+    gfx_plot(gfx, x, y, gfx_rop_get_terms(rop));
+}
+
+void gfx_draw_line(gfx_t* gfx,
+                   int16_t x0,
+                   int16_t y0,
+                   int16_t x1,
+                   int16_t y1,
+                   gfx_rop_t rop)
+{
+    assert(gfx);
+
+    gfx_rop_terms_t terms = gfx_rop_get_terms(rop);
+
+    int32_t left = x0 < x1 ? x0 : x1;
+    int32_t top = y0 < y1 ? y0 : y1;
+    int32_t right = (x0 < x1 ? x1 : x0) + 1;
+    int32_t bottom = (y0 < y1 ? y1 : y0) + 1;
+
+    if (y0 == y1 || x0 == x1) {
+        gfx_fill_marked(gfx, left, top, right - left, bottom - top, terms);
+        return;
+    }
+
+    int32_t dx = right - left - 1;
+    int32_t dy = -(bottom - top - 1);
+    int32_t step_x = x0 < x1 ? 1 : -1;
+    int32_t step_y = y0 < y1 ? 1 : -1;
+    int32_t error = dx + dy;
+    int32_t x = x0;
+    int32_t y = y0;
+
+    while (true) {
+        gfx_plot(gfx, x, y, terms);
+        if (x == x1 && y == y1) {
+            break;
+        }
+
+        int32_t doubled = 2 * error;
+        if (doubled >= dy) {
+            error += dy;
+            x += step_x;
+        }
+        if (doubled <= dx) {
+            error += dx;
+            y += step_y;
+        }
+    }
+}
+
+void gfx_draw_hline(gfx_t* gfx,
+                    int16_t x,
+                    int16_t y,
+                    int16_t width,
+                    gfx_rop_t rop)
+{
+    gfx_fill_rect(gfx, x, y, width, 1, rop);
+}
+
+void gfx_draw_vline(gfx_t* gfx,
+                    int16_t x,
+                    int16_t y,
+                    int16_t height,
+                    gfx_rop_t rop)
+{
+    gfx_fill_rect(gfx, x, y, 1, height, rop);
+}
+
+void gfx_draw_rect(gfx_t* gfx,
+                   int16_t x,
+                   int16_t y,
+                   int16_t width,
+                   int16_t height,
+                   gfx_rop_t rop)
+{
+    assert(gfx);
+
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    gfx_rop_terms_t terms = gfx_rop_get_terms(rop);
+
+    int32_t right = (int32_t)x + width;
+    int32_t bottom = (int32_t)y + height;
+
+    // edges are marked separately, the inside may span pages untouched.
+    // They do not overlap, XOR would clear the corners otherwise.
+    gfx_fill_marked(gfx, x, y, width, 1, terms);
+    if (height > 1) {
+        gfx_fill_marked(gfx, x, bottom - 1, width, 1, terms);
+    }
+    if (height > 2) {
+        gfx_fill_marked(gfx, x, y + 1, 1, height - 2, terms);
+        if (width > 1) {
+            gfx_fill_marked(gfx, right - 1, y + 1, 1, height - 2, terms);
+        }
+    }
+}
+
+void gfx_fill_rect(gfx_t* gfx,
+                   int16_t x,
+                   int16_t y,
+                   int16_t width,
+                   int16_t height,
+                   gfx_rop_t rop)
+{
+    assert(gfx);
+
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    gfx_fill_marked(gfx, x, y, width, height, gfx_rop_get_terms(rop));
+}
+
+void gfx_draw_circle(gfx_t* gfx,
+                     int16_t x,
+                     int16_t y,
+                     int16_t radius,
+                     gfx_rop_t rop)
+{
+    assert(gfx);
+
+    if (radius < 0) {
+        return;
+    }
+
+    gfx_circle_outline(gfx, x, y, radius, NULL, gfx_rop_get_terms(rop));
+}
+
+void gfx_fill_circle(gfx_t* gfx,
+                     int16_t x,
+                     int16_t y,
+                     int16_t radius,
+                     gfx_rop_t rop)
+{
+    assert(gfx);
+
+    if (radius < 0) {
+        return;
+    }
+
+    gfx_circle_fill(gfx, x, y, radius, NULL, gfx_rop_get_terms(rop));
+}
+
+void gfx_draw_ellipse(gfx_t* gfx,
+                      int16_t x,
+                      int16_t y,
+                      int16_t radius_x,
+                      int16_t radius_y,
+                      gfx_rop_t rop)
+{
+    assert(gfx);
+
+    if (radius_x < 0 || radius_y < 0) {
+        return;
+    }
+
+    gfx_rop_terms_t terms = gfx_rop_get_terms(rop);
+
+    if (radius_x == 0 || radius_y == 0) {
+        gfx_fill_marked(gfx,
+                        x - radius_x,
+                        y - radius_y,
+                        2 * radius_x + 1,
+                        2 * radius_y + 1,
+                        terms);
+        return;
+    }
+
+    gfx_ellipse_walk(gfx, x, y, radius_x, radius_y, false, terms);
+}
+
+void gfx_fill_ellipse(gfx_t* gfx,
+                      int16_t x,
+                      int16_t y,
+                      int16_t radius_x,
+                      int16_t radius_y,
+                      gfx_rop_t rop)
+{
+    assert(gfx);
+
+    if (radius_x < 0 || radius_y < 0) {
+        return;
+    }
+
+    gfx_rop_terms_t terms = gfx_rop_get_terms(rop);
+
+    if (radius_x == 0 || radius_y == 0) {
+        gfx_fill_marked(gfx,
+                        x - radius_x,
+                        y - radius_y,
+                        2 * radius_x + 1,
+                        2 * radius_y + 1,
+                        terms);
+        return;
+    }
+
+    gfx_ellipse_walk(gfx, x, y, radius_x, radius_y, true, terms);
+}
+
+void gfx_draw_arc(gfx_t* gfx,
+                  int16_t x,
+                  int16_t y,
+                  int16_t radius,
+                  int16_t start,
+                  int16_t end,
+                  gfx_rop_t rop)
+{
+    assert(gfx);
+
+    if (radius < 0) {
+        return;
+    }
+
+    gfx_sector_t sector = gfx_sector_make(start, end);
+    gfx_circle_outline(gfx, x, y, radius, &sector, gfx_rop_get_terms(rop));
+}
+
+void gfx_fill_arc(gfx_t* gfx,
+                  int16_t x,
+                  int16_t y,
+                  int16_t radius,
+                  int16_t start,
+                  int16_t end,
+                  gfx_rop_t rop)
+{
+    assert(gfx);
+
+    if (radius < 0) {
+        return;
+    }
+
+    gfx_sector_t sector = gfx_sector_make(start, end);
+    gfx_circle_fill(gfx, x, y, radius, &sector, gfx_rop_get_terms(rop));
+}
@@ -0,0 +1,94 @@
+#ifndef GFX_GFX_DRAW_H
+#define GFX_GFX_DRAW_H
+
+#include "gfx.h"
+#include <stdint.h>
+
+// Every primitive sets each of its pixels exactly once, so XOR and INVERT
+// can be undone by drawing the same shape again
+void gfx_draw_pixel(gfx_t* gfx, int16_t x, int16_t y, gfx_rop_t rop);
+
+// Lines are Bresenham, horizontal and vertical ones take the span paths
+void gfx_draw_line(gfx_t* gfx,
+                   int16_t x0,
+                   int16_t y0,
+                   int16_t x1,
+                   int16_t y1,
+                   gfx_rop_t rop);
+
+// Masks the row bit into each page byte, four bytes per store
+void gfx_draw_hline(gfx_t* gfx,
+                    int16_t x,
+                    int16_t y,
+                    int16_t width,
+                    gfx_rop_t rop);
+
+// Writes one byte per page, whole bytes for the pages in between
+void gfx_draw_vline(gfx_t* gfx,
+                    int16_t x,
+                    int16_t y,
+                    int16_t height,
+                    gfx_rop_t rop);
+
+void gfx_draw_rect(gfx_t* gfx,
+                   int16_t x,
+                   int16_t y,
+                   int16_t width,
+                   int16_t height,
+                   gfx_rop_t rop);
+
+void gfx_fill_rect(gfx_t* gfx,
+                   int16_t x,
+                   int16_t y,
+                   int16_t width,
+                   int16_t height,
+                   gfx_rop_t rop);
+
+// Midpoint circle walked over one octant, every outline pixel is set once
+void gfx_draw_circle(gfx_t* gfx,
+                     int16_t x,
+                     int16_t y,
+                     int16_t radius,
+                     gfx_rop_t rop);
+
+// Fills each column once, a byte per page instead of pixel by pixel
+void gfx_fill_circle(gfx_t* gfx,
+                     int16_t x,
+                     int16_t y,
+                     int16_t radius,
+                     gfx_rop_t rop);
+
+void gfx_draw_ellipse(gfx_t* gfx,
+                      int16_t x,
+                      int16_t y,
+                      int16_t radius_x,
+                      int16_t radius_y,
+                      gfx_rop_t rop);
+
+void gfx_fill_ellipse(gfx_t* gfx,
+                      int16_t x,
+                      int16_t y,
+                      int16_t radius_x,
+                      int16_t radius_y,
+                      gfx_rop_t rop);
+
+// Angles are in degrees, counterclockwise from three o'clock. The arc runs
+// from start to end, equal angles give the whole circle.
+void gfx_draw_arc(gfx_t* gfx,
+                  int16_t x,
+                  int16_t y,
+                  int16_t radius,
+                  int16_t start,
+                  int16_t end,
+                  gfx_rop_t rop);
+
+// Fills the pie slice between the two angles
+void gfx_fill_arc(gfx_t* gfx,
+                  int16_t x,
+                  int16_t y,
+                  int16_t radius,
+                  int16_t start,
+                  int16_t end,
+                  gfx_rop_t rop);
+
+#endif // GFX_GFX_DRAW_H
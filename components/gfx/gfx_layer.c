@@ -0,0 +1,283 @@
+#include "gfx_layer.h"
+#include "gfx_private.h"
+#include <assert.h>
+#include <string.h>
+
+// Finds the bytes a layer has in page, row[column - *left] is the one of
+// column for columns [*left, *right). False if the layer misses the page.
+static bool gfx_layer_get_row(gfx_compositor_t const* compositor,
+                              gfx_layer_t const* layer,
+                              size_t page,
+                              uint8_t const** row,
+                              size_t* left,
+                              size_t* right)
+{
+    size_t frame_width = compositor->config.frame_width;
+
+    if (!layer->gfx) {
+        *row = &layer->data[page * frame_width];
+        *left = 0U;
+        *right = frame_width;
+        return true;
+    }
+
+    gfx_t const* gfx = layer->gfx;
+    if (page < layer->page || page - layer->page >= gfx_get_pages(gfx)) {
+        return false;
+    }
+
+    *row = &gfx->config.frame_buffer[(page - layer->page) *
+                                     gfx->config.frame_width];
+    *left = layer->x;
+    *right = layer->x + gfx->config.frame_width;
+    return true;
+}
+
+// Dirty span of a drawn layer in page, NULL for static layers and pages
+// outside of a window
+static gfx_span_t* gfx_layer_get_dirty(gfx_layer_t const* layer, size_t page)
+{
+    gfx_t* gfx = layer->gfx;
+
+    if (!gfx || page < layer->page ||
+        page - layer->page >= gfx_get_pages(gfx)) {
+        return NULL;
+    }
+
+    return &gfx->dirty[page - layer->page];
+}
+
+static size_t gfx_compositor_get_pages(gfx_compositor_t const* compositor)
+{
+    return (compositor->config.frame_height + GFX_PAGE_HEIGHT - 1U) /
+           GFX_PAGE_HEIGHT;
+}
+
+static void gfx_compositor_mark_all(gfx_compositor_t* compositor)
+{
+    size_t pages = gfx_compositor_get_pages(compositor);
+
+    for (size_t page = 0U; page < pages; ++page) {
+        compositor->dirty[page].begin = 0U;
+        compositor->dirty[page].end = (uint16_t)compositor->config.frame_width;
+    }
+}
+
+// Recomposes what the layer covers on the next flush
+static void gfx_compositor_mark_layer(gfx_compositor_t* compositor,
+                                      gfx_layer_t const* layer)
+{
+    if (!layer->gfx) {
+        gfx_compositor_mark_all(compositor);
+        return;
+    }
+
+    size_t pages = gfx_get_pages(layer->gfx);
+    for (size_t page = 0U; page < pages; ++page) {
+        gfx_span_merge(
+            &compositor->dirty[layer->page + page],
+            (uint16_t)layer->x,
+            (uint16_t)(layer->x + layer->gfx->config.frame_width));
+    }
+}
+
+// Combines count layer bytes into the staging bytes, a word at a time. The
+// memcpy calls compile to single loads and stores.
+static void gfx_compose_bytes(uint8_t* bytes,
+                              uint8_t const* source,
+                              size_t count,
+                              gfx_rop_terms_t terms)
+{
+    uint32_t and_source = terms.and_source * 0x01010101U;
+    uint32_t and_constant = terms.and_constant * 0x01010101U;
+    uint32_t xor_source = terms.xor_source * 0x01010101U;
+    uint32_t xor_constant = terms.xor_constant * 0x01010101U;
+
+    for (; count >= 4U; count -= 4U, bytes += 4U, source += 4U) {
+        uint32_t word;
+        uint32_t source_word;
+        memcpy(&word, bytes, sizeof(word));
+        memcpy(&source_word, source, sizeof(source_word));
+        word = (word & ((source_word & and_source) ^ and_constant)) ^
+               ((source_word & xor_source) ^ xor_constant);
+        memcpy(bytes, &word, sizeof(word));
+    }
+
+    while (count > 0U) {
+        *bytes = gfx_rop_apply(*bytes, *source, terms);
+        ++bytes;
+        ++source;
+        --count;
+    }
+}
+
+// Composes the columns [begin, end) of page into the staging buffer
+static void gfx_compose(gfx_compositor_t const* compositor,
+                        size_t page,
+                        size_t begin,
+                        size_t end)
+{
+    uint8_t* staging = compositor->config.staging;
+    bool blank = true;
+
+    for (size_t index = 0U; index < compositor->config.layer_count; ++index) {
+        gfx_layer_t const* layer = &compositor->config.layers[index];
+        uint8_t const* row;
+        size_t left;
+        size_t right;
+        if (!layer->visible ||
+            !gfx_layer_get_row(compositor, layer, page, &row, &left, &right)) {
+            continue;
+        }
+
+        size_t first = begin > left ? begin : left;
+        size_t last = end < right ? end : right;
+        if (first >= last) {
+            continue;
+        }
+
+        uint8_t const* source = &row[first - left];
+        size_t count = last - first;
+
+        // over a blank span these copy the layer
+        if (blank && first == begin && last == end &&
+            (layer->rop == GFX_ROP_SET || layer->rop == GFX_ROP_XOR ||
+             layer->rop == GFX_ROP_COPY)) {
+            memcpy(staging, source, count);
+        } else {
+            if (blank) {
+                memset(staging, 0, end - begin);
+            }
+            gfx_compose_bytes(&staging[first - begin],
+                              source,
+                              count,
+                              gfx_rop_get_terms(layer->rop));
+        }
+
+        blank = false;
+    }
+
+    if (blank) {
+        memset(staging, 0, end - begin);
+    }
+}
+
+void gfx_compositor_initialize(gfx_compositor_t* compositor,
+                               gfx_compositor_config_t const* config,
+                               gfx_interface_t const* interface)
+{
+    assert(compositor && config && interface && config->staging);
+    assert(config->layers || config->layer_count == 0U);
+    assert(config->frame_height <= GFX_MAX_PAGES * GFX_PAGE_HEIGHT);
+    assert(config->frame_width < UINT16_MAX);
+
+#ifndef NDEBUG
+    for (size_t index = 0U; index < config->layer_count; ++index) {
+        gfx_layer_t const* layer = &config->layers[index];
+        assert(layer->gfx ? layer->x + layer->gfx->config.frame_width <=
+                                    config->frame_width &&
+                                layer->page * GFX_PAGE_HEIGHT +
+                                        layer->gfx->config.frame_height <=
+                                    config->frame_height
+                          : layer->data != NULL);
+    }
+#endif
+
+    memset(compositor, 0, sizeof(*compositor));
+    memcpy(&compositor->config, config, sizeof(*config));
+    memcpy(&compositor->interface, interface, sizeof(*interface));
+
+    // panel contents are unknown until the first full flush
+    for (size_t page = 0U; page < GFX_MAX_PAGES; ++page) {
+        gfx_span_reset(&compositor->dirty[page]);
+    }
+    gfx_compositor_mark_all(compositor);
+}
+
+void gfx_compositor_deinitialize(gfx_compositor_t* compositor)
+{
+    assert(compositor);
+
+    memset(compositor, 0, sizeof(*compositor));
+}
+
+void gfx_compositor_set_visible(gfx_compositor_t* compositor,
+                                size_t layer,
+                                bool visible)
+{
+    assert(compositor && layer < compositor->config.layer_count);
+
+    gfx_layer_t* entry = &compositor->config.layers[layer];
+    if (entry->visible != visible) {
+        entry->visible = visible;
+        gfx_compositor_mark_layer(compositor, entry);
+    }
+}
+
+void gfx_compositor_set_rop(gfx_compositor_t* compositor,
+                            size_t layer,
+                            gfx_rop_t rop)
+{
+    assert(compositor && layer < compositor->config.layer_count);
+
+    gfx_layer_t* entry = &compositor->config.layers[layer];
+    if (entry->rop != rop) {
+        entry->rop = rop;
+        gfx_compositor_mark_layer(compositor, entry);
+    }
+}
+
+gfx_err_t gfx_compositor_flush(gfx_compositor_t* compositor)
+{
+    assert(compositor);
+
+    if (!compositor->interface.flush_span) {
+        return GFX_ERR_NULL;
+    }
+
+    size_t pages = gfx_compositor_get_pages(compositor);
+    gfx_layer_t* layers = compositor->config.layers;
+    size_t layer_count = compositor->config.layer_count;
+
+    for (size_t page = 0U; page < pages; ++page) {
+        gfx_span_t span = compositor->dirty[page];
+
+        // changes to hidden layers do not show, they are dropped below
+        for (size_t index = 0U; index < layer_count; ++index) {
+            gfx_span_t* layer_span = gfx_layer_get_dirty(&layers[index], page);
+            if (layer_span && layer_span->begin < layer_span->end &&
+                layers[index].visible) {
+                gfx_span_merge(
+                    &span,
+                    (uint16_t)(layer_span->begin + layers[index].x),
+                    (uint16_t)(layer_span->end + layers[index].x));
+            }
+        }
+
+        if (span.begin < span.end) {
+            size_t count = (size_t)(span.end - span.begin);
+
+            gfx_compose(compositor, page, span.begin, span.end);
+
+            gfx_err_t err = compositor->interface.flush_span(
+                compositor->interface.panel_user,
+                page,
+                span.begin,
+                compositor->config.staging,
+                count);
+            if (err != GFX_ERR_OK) {
+                return err;
+            }
+        }
+
+        gfx_span_reset(&compositor->dirty[page]);
+        for (size_t index = 0U; index < layer_count; ++index) {
+            gfx_span_t* layer_span = gfx_layer_get_dirty(&layers[index], page);
+            if (layer_span) {
+                gfx_span_reset(layer_span);
+            }
+        }
+    }
+
+    return GFX_ERR_OK;
+}
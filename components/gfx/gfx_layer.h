@@ -0,0 +1,66 @@
+#ifndef GFX_GFX_LAYER_H
+#define GFX_GFX_LAYER_H
+
+#include "gfx.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// One 1bpp layer in the page layout. A layer drawn at run time has its own
+// gfx, whose flush_span stays NULL as the compositor sends for it. Static
+// layers only have frame sized data, which can point into flash.
+typedef struct {
+    gfx_t* gfx;
+    // a gfx smaller than the frame is a window with its top left corner at
+    // column x of page, nothing is combined outside of it
+    size_t x;
+    size_t page;
+    // ignored when gfx is set
+    uint8_t const* data;
+    // combines the layer with the ones below it, the bottom one goes over
+    // a blank frame
+    gfx_rop_t rop;
+    bool visible;
+} gfx_layer_t;
+
+typedef struct {
+    // bottom first
+    gfx_layer_t* layers;
+    size_t layer_count;
+    size_t frame_width;
+    size_t frame_height;
+    // frame_width bytes, a page span is composed here and sent from here
+    uint8_t* staging;
+} gfx_compositor_config_t;
+
+// Combines the layers only when flushing and only where a layer changed,
+// so the panel image never exists in RAM as a whole. A flash background
+// with a few small windows on top takes the RAM of the windows and one
+// page of staging.
+typedef struct {
+    gfx_compositor_config_t config;
+    gfx_interface_t interface;
+    // changes not tracked by the layers, visibility and operations
+    gfx_span_t dirty[GFX_MAX_PAGES];
+} gfx_compositor_t;
+
+void gfx_compositor_initialize(gfx_compositor_t* compositor,
+                               gfx_compositor_config_t const* config,
+                               gfx_interface_t const* interface);
+void gfx_compositor_deinitialize(gfx_compositor_t* compositor);
+
+// Both recompose what the layer covers on the next flush, the whole frame
+// for frame sized layers. A blinking cursor is cheaper drawn and cleared on
+// its own layer, which recomposes only the bytes it changed.
+void gfx_compositor_set_visible(gfx_compositor_t* compositor,
+                                size_t layer,
+                                bool visible);
+void gfx_compositor_set_rop(gfx_compositor_t* compositor,
+                            size_t layer,
+                            gfx_rop_t rop);
+
+// Sends the union of the dirty spans of every page composed from the
+// visible layers, the spans are cleared once sent
+gfx_err_t gfx_compositor_flush(gfx_compositor_t* compositor);
+
+#endif // GFX_GFX_LAYER_H
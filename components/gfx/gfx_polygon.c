@@ -0,0 +1,191 @@
+#include "gfx_polygon.h"
+#include "gfx_private.h"
+#include <assert.h>
+
+static int64_t gfx_floor_div(int64_t numerator, int64_t denominator)
+{
+    int64_t quotient = numerator / denominator;
+
+    return (numerator % denominator != 0 && numerator < 0) ? quotient - 1
+                                                           : quotient;
+}
+
+// First column right of the crossing, pixel centres sit at x + 0.5
+static inline int32_t gfx_edge_column(gfx_edge_t const* edge)
+{
+    return edge->x + (2 * edge->remainder > edge->denominator ? 1 : 0);
+}
+
+static inline void gfx_edge_advance(gfx_edge_t* edge)
+{
+    edge->x += edge->step;
+    edge->remainder += edge->remainder_step;
+    if (edge->remainder >= edge->denominator) {
+        edge->remainder -= edge->denominator;
+        ++edge->x;
+    }
+}
+
+// Sets up the edge at the first row it covers on screen, false if it
+// covers none
+static bool gfx_edge_make(gfx_edge_t* edge,
+                          gfx_point_t from,
+                          gfx_point_t to,
+                          int32_t frame_height)
+{
+    if (from.y == to.y) {
+        return false;
+    }
+
+    int8_t winding = 1;
+    if (from.y > to.y) {
+        gfx_point_t swap = from;
+        from = to;
+        to = swap;
+        winding = -1;
+    }
+
+    int32_t top = from.y < 0 ? 0 : from.y;
+    int32_t bottom = to.y > frame_height ? frame_height : to.y;
+    if (top >= bottom) {
+        return false;
+    }
+
+    // the crossing at the centre of row y is from.x + (2 * (y - from.y) + 1)
+    // * dx / (2 * dy), it moves by 2 * dx over the same denominator per row
+    int32_t dx = (int32_t)to.x - from.x;
+    int32_t denominator = 2 * ((int32_t)to.y - from.y);
+    int64_t numerator = (int64_t)(2 * (top - from.y) + 1) * dx;
+    int64_t whole = gfx_floor_div(numerator, denominator);
+    int32_t step = (int32_t)gfx_floor_div(2 * dx, denominator);
+
+    *edge = (gfx_edge_t){
+        .x = from.x + (int32_t)whole,
+        .remainder = (int32_t)(numerator - whole * denominator),
+        .step = step,
+        .remainder_step = 2 * dx - step * denominator,
+        .denominator = denominator,
+        .top = (int16_t)top,
+        .bottom = (int16_t)bottom,
+        .winding = winding,
+    };
+
+    return true;
+}
+
+static void gfx_fill_row(gfx_t* gfx,
+                         int32_t y,
+                         int32_t left,
+                         int32_t right,
+                         gfx_rop_terms_t terms)
+{
+    int32_t frame_width = (int32_t)gfx->config.frame_width;
+
+    left = left < 0 ? 0 : left;
+    right = right > frame_width ? frame_width : right;
+    if (left >= right) {
+        return;
+    }
+
+    gfx_fill_area(gfx, left, y, right - left, 1, terms);
+    gfx_span_merge(&gfx->dirty[(size_t)y / GFX_PAGE_HEIGHT],
+                   (uint16_t)left,
+                   (uint16_t)right);
+}
+
+gfx_err_t gfx_fill_polygon(gfx_t* gfx,
+                           gfx_point_t const* points,
+                           size_t count,
+                           gfx_fill_rule_t rule,
+                           gfx_edge_t* edges,
+                           size_t edge_capacity,
+                           gfx_rop_t rop)
+{
+    assert(gfx && (points || count == 0U) && (edges || edge_capacity == 0U));
+
+    int32_t frame_height = (int32_t)gfx->config.frame_height;
+    gfx_rop_terms_t terms = gfx_rop_get_terms(rop);
+    size_t edge_count = 0U;
+
+    // the edge table is kept sorted by top row
+    for (size_t index = 0U; index < count; ++index) {
+        gfx_edge_t edge;
+        if (!gfx_edge_make(&edge,
+                           points[index],
+                           points[(index + 1U) % count],
+                           frame_height)) {
+            continue;
+        }
+        if (edge_count == edge_capacity) {
+            return GFX_ERR_FAIL;
+        }
+
+        size_t position = edge_count++;
+        for (; position > 0U && edges[position - 1U].top > edge.top;
+             --position) {
+            edges[position] = edges[position - 1U];
+        }
+        edges[position] = edge;
+    }
+
+    // edges [first, last) are active, finished ones are swapped below first
+    size_t first = 0U;
+    size_t last = 0U;
+
+    for (int32_t y = edge_count > 0U ? edges[0].top : frame_height;
+         y < frame_height && first < edge_count;
+         ++y) {
+        while (last < edge_count && edges[last].top <= y) {
+            ++last;
+        }
+        for (size_t index = first; index < last; ++index) {
+            if (edges[index].bottom <= y) {
+                gfx_edge_t swap = edges[first];
+                edges[first++] = edges[index];
+                edges[index] = swap;
+            }
+        }
+        if (first == last) {
+            // the next edges start further down
+            if (last < edge_count) {
+                y = edges[last].top - 1;
+            }
+            continue;
+        }
+
+        // crossings barely move between rows, insertion sort is near linear
+        for (size_t index = first + 1U; index < last; ++index) {
+            gfx_edge_t edge = edges[index];
+            int32_t column = gfx_edge_column(&edge);
+            size_t position = index;
+            for (; position > first &&
+                   gfx_edge_column(&edges[position - 1U]) > column;
+                 --position) {
+                edges[position] = edges[position - 1U];
+            }
+            edges[position] = edge;
+        }
+
+        int32_t winding = 0;
+        int32_t left = 0;
+        for (size_t index = first; index < last; ++index) {
+            bool was_inside = winding != 0;
+            if (rule == GFX_FILL_RULE_EVEN_ODD) {
+                winding ^= 1;
+            } else {
+                winding += edges[index].winding;
+            }
+
+            if (!was_inside && winding != 0) {
+                left = gfx_edge_column(&edges[index]);
+            } else if (was_inside && winding == 0) {
+                gfx_fill_row(
+                    gfx, y, left, gfx_edge_column(&edges[index]), terms);
+            }
+
+            gfx_edge_advance(&edges[index]);
+        }
+    }
+
+    return GFX_ERR_OK;
+}
@@ -0,0 +1,45 @@
+#ifndef GFX_GFX_POLYGON_H
+#define GFX_GFX_POLYGON_H
+
+#include "gfx.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+} gfx_point_t;
+
+typedef enum {
+    GFX_FILL_RULE_EVEN_ODD = 0,
+    GFX_FILL_RULE_NONZERO = 1,
+} gfx_fill_rule_t;
+
+// Edge table entry, the caller only provides storage for them. The
+// crossing of a row is x + remainder / denominator, kept exact.
+typedef struct {
+    int32_t x;
+    int32_t remainder;
+    int32_t step;
+    int32_t remainder_step;
+    int32_t denominator;
+    int16_t top;
+    int16_t bottom;
+    int8_t winding;
+} gfx_edge_t;
+
+// Fills the polygon closed from the last point back to the first. Pixels
+// are inside when their centre is, so a square of corners (0, 0) and
+// (8, 8) fills the same 8x8 pixels as gfx_fill_rect. The edge table lives
+// in edges, one entry per visible non horizontal edge, count entries are
+// always enough. Nothing is drawn and GFX_ERR_FAIL is returned when the
+// table does not fit.
+gfx_err_t gfx_fill_polygon(gfx_t* gfx,
+                           gfx_point_t const* points,
+                           size_t count,
+                           gfx_fill_rule_t rule,
+                           gfx_edge_t* edges,
+                           size_t edge_capacity,
+                           gfx_rop_t rop);
+
+#endif // GFX_GFX_POLYGON_H
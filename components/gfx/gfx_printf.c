@@ -0,0 +1,306 @@
+#include "gfx_printf.h"
+#include "gfx_private.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// enough for 32 bit values in any supported conversion, sign excluded
+#define GFX_PRINTF_DIGITS (24U)
+#define GFX_PRINTF_MAX_FRACTION (9U)
+
+typedef struct {
+    gfx_t* gfx;
+    int16_t y;
+    int32_t cursor;
+    gfx_rop_terms_t terms;
+} gfx_printf_stream_t;
+
+typedef struct {
+    bool left;
+    bool zero;
+    size_t width;
+    size_t precision;
+    bool has_precision;
+    bool is_long;
+} gfx_printf_spec_t;
+
+static void gfx_printf_emit(gfx_printf_stream_t* stream,
+                            char const* string,
+                            size_t length)
+{
+    if (length > 0U) {
+        stream->cursor = gfx_render_text(stream->gfx,
+                                         stream->cursor,
+                                         stream->y,
+                                         string,
+                                         length,
+                                         stream->terms);
+    }
+}
+
+static void gfx_printf_pad(gfx_printf_stream_t* stream,
+                           char character,
+                           size_t count)
+{
+    char const* run = character == '0' ? "00000000" : "        ";
+
+    while (count > 0U) {
+        size_t chunk = count < 8U ? count : 8U;
+        gfx_printf_emit(stream, run, chunk);
+        count -= chunk;
+    }
+}
+
+static void gfx_printf_field(gfx_printf_stream_t* stream,
+                             gfx_printf_spec_t const* spec,
+                             char sign,
+                             char const* body,
+                             size_t length)
+{
+    size_t used = length + (sign != '\0' ? 1U : 0U);
+    size_t padding = spec->width > used ? spec->width - used : 0U;
+
+    if (!spec->left && !spec->zero) {
+        gfx_printf_pad(stream, ' ', padding);
+    }
+    if (sign != '\0') {
+        gfx_printf_emit(stream, &sign, 1U);
+    }
+    if (!spec->left && spec->zero) {
+        gfx_printf_pad(stream, '0', padding);
+    }
+
+    gfx_printf_emit(stream, body, length);
+
+    if (spec->left) {
+        gfx_printf_pad(stream, ' ', padding);
+    }
+}
+
+// Writes digits backwards ending at end, returns the first digit. Zero has
+// no digits of its own, it shows as the minimum count of zeros.
+static char* gfx_printf_digits(uint32_t value,
+                               uint32_t base,
+                               bool upper,
+                               size_t minimum,
+                               char* end)
+{
+    char const* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char* begin = end;
+
+    while (value > 0U) {
+        *--begin = digits[value % base];
+        value /= base;
+    }
+
+    while ((size_t)(end - begin) < minimum) {
+        *--begin = '0';
+    }
+
+    return begin;
+}
+
+static char* gfx_printf_fixed(uint32_t magnitude, size_t places, char* end)
+{
+    uint32_t scale = 1U;
+    for (size_t place = 0U; place < places; ++place) {
+        scale *= 10U;
+    }
+
+    char* begin = end;
+    if (places > 0U) {
+        begin = gfx_printf_digits(magnitude % scale, 10U, false, places, end);
+        *--begin = '.';
+    }
+
+    return gfx_printf_digits(magnitude / scale, 10U, false, 1U, begin);
+}
+
+static int32_t gfx_printf_signed(gfx_printf_spec_t const* spec,
+                                 va_list* arguments)
+{
+    return spec->is_long ? (int32_t)va_arg(*arguments, long)
+                         : (int32_t)va_arg(*arguments, int);
+}
+
+static uint32_t gfx_printf_unsigned(gfx_printf_spec_t const* spec,
+                                    va_list* arguments)
+{
+    return spec->is_long ? (uint32_t)va_arg(*arguments, unsigned long)
+                         : (uint32_t)va_arg(*arguments, unsigned int);
+}
+
+// Precision is the minimum digit count of integer conversions and turns
+// the 0 flag off, as in C
+static size_t gfx_printf_minimum(gfx_printf_spec_t* spec)
+{
+    if (!spec->has_precision) {
+        return 1U;
+    }
+
+    spec->zero = false;
+    return spec->precision < GFX_PRINTF_DIGITS ? spec->precision
+                                               : GFX_PRINTF_DIGITS;
+}
+
+static uint32_t gfx_printf_magnitude(int32_t value, char* sign)
+{
+    if (value < 0) {
+        *sign = '-';
+        return 0U - (uint32_t)value;
+    }
+
+    return (uint32_t)value;
+}
+
+int32_t gfx_draw_vprintf(gfx_t* gfx,
+                         int16_t x,
+                         int16_t y,
+                         gfx_rop_t rop,
+                         char const* format,
+                         va_list arguments)
+{
+    assert(gfx && format);
+
+    gfx_printf_stream_t stream = {
+        .gfx = gfx, .y = y, .cursor = x, .terms = gfx_rop_get_terms(rop)};
+    va_list values;
+    va_copy(values, arguments);
+    char buffer[GFX_PRINTF_DIGITS];
+    char* end = buffer + sizeof(buffer);
+
+    while (*format != '\0') {
+        char const* run = format;
+        while (*format != '\0' && *format != '%') {
+            ++format;
+        }
+        gfx_printf_emit(&stream, run, (size_t)(format - run));
+
+        if (*format == '\0') {
+            break;
+        }
+        char const* conversion = format;
+        ++format;
+
+        gfx_printf_spec_t spec = {0};
+        for (;; ++format) {
+            if (*format == '-') {
+                spec.left = true;
+            } else if (*format == '0') {
+                spec.zero = true;
+            } else {
+                break;
+            }
+        }
+        while (*format >= '0' && *format <= '9') {
+            spec.width = spec.width * 10U + (size_t)(*format++ - '0');
+        }
+        if (*format == '.') {
+            spec.has_precision = true;
+            ++format;
+            while (*format >= '0' && *format <= '9') {
+                spec.precision =
+                    spec.precision * 10U + (size_t)(*format++ - '0');
+            }
+        }
+        while (*format == 'l') {
+            spec.is_long = true;
+            ++format;
+        }
+
+        char sign = '\0';
+        char const* body = end;
+
+        switch (*format) {
+            case 'd':
+            case 'i': {
+                int32_t value = gfx_printf_signed(&spec, &values);
+                uint32_t magnitude = gfx_printf_magnitude(value, &sign);
+                body = gfx_printf_digits(
+                    magnitude, 10U, false, gfx_printf_minimum(&spec), end);
+                break;
+            }
+            case 'u': {
+                uint32_t value = gfx_printf_unsigned(&spec, &values);
+                body = gfx_printf_digits(
+                    value, 10U, false, gfx_printf_minimum(&spec), end);
+                break;
+            }
+            case 'x':
+            case 'X': {
+                uint32_t value = gfx_printf_unsigned(&spec, &values);
+                body = gfx_printf_digits(value,
+                                         16U,
+                                         *format == 'X',
+                                         gfx_printf_minimum(&spec),
+                                         end);
+                break;
+            }
+            case 'k': {
+                size_t places = spec.has_precision ? spec.precision : 2U;
+                if (places > GFX_PRINTF_MAX_FRACTION) {
+                    places = GFX_PRINTF_MAX_FRACTION;
+                }
+                int32_t value = gfx_printf_signed(&spec, &values);
+                uint32_t magnitude = gfx_printf_magnitude(value, &sign);
+                body = gfx_printf_fixed(magnitude, places, end);
+                break;
+            }
+            case 'c': {
+                buffer[0] = (char)va_arg(values, int);
+                gfx_printf_field(&stream, &spec, '\0', buffer, 1U);
+                ++format;
+                continue;
+            }
+            case 's': {
+                char const* string = va_arg(values, char const*);
+                if (!string) {
+                    string = "(null)";
+                }
+                size_t length = 0U;
+                while (string[length] != '\0' &&
+                       (!spec.has_precision || length < spec.precision)) {
+                    ++length;
+                }
+                gfx_printf_field(&stream, &spec, '\0', string, length);
+                ++format;
+                continue;
+            }
+            case '%': {
+                gfx_printf_emit(&stream, "%", 1U);
+                ++format;
+                continue;
+            }
+            default: {
+                // unknown conversion, drawn verbatim from its '%'
+                format += *format ? 1 : 0;
+                gfx_printf_emit(
+                    &stream, conversion, (size_t)(format - conversion));
+                continue;
+            }
+        }
+
+        gfx_printf_field(&stream, &spec, sign, body, (size_t)(end - body));
+        ++format;
+    }
+
+    va_end(values);
+    gfx_merge_text(gfx, gfx->dirty, x, y, stream.cursor);
+
+    return stream.cursor;
+}
+
+int32_t gfx_draw_printf(gfx_t* gfx,
+                        int16_t x,
+                        int16_t y,
+                        gfx_rop_t rop,
+                        char const* format,
+                        ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+    int32_t cursor = gfx_draw_vprintf(gfx, x, y, rop, format, arguments);
+    va_end(arguments);
+
+    return cursor;
+}
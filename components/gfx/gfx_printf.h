@@ -0,0 +1,38 @@
+#ifndef GFX_GFX_PRINTF_H
+#define GFX_GFX_PRINTF_H
+
+#include "gfx.h"
+#include <stdarg.h>
+#include <stdint.h>
+
+// Streams formatted text straight into the frame buffer, no heap and no
+// intermediate string. Conversions: %[-0][width][.precision][l] followed by
+//   d i   signed decimal
+//   u     unsigned decimal
+//   x X   hexadecimal
+//   k     int32_t fixed point with precision decimal places (default 2),
+//         e.g. ("%.1k", 235) draws "23.5"
+//   c     character
+//   s     UTF-8 string, precision limits the byte count, NULL is "(null)"
+//   %     literal percent sign
+// Precision is the minimum digit count of d, i, u, x and X, up to 24.
+// Unknown conversions are drawn as written.
+// Returns the column following the last drawn glyph. No printf format
+// attribute, as the compiler would reject the %k conversion.
+// Costs about 2 KB of code, which does not save any flash while something
+// else still links the C library printf, the gain is speed and no heap.
+int32_t gfx_draw_printf(gfx_t* gfx,
+                        int16_t x,
+                        int16_t y,
+                        gfx_rop_t rop,
+                        char const* format,
+                        ...);
+
+int32_t gfx_draw_vprintf(gfx_t* gfx,
+                         int16_t x,
+                         int16_t y,
+                         gfx_rop_t rop,
+                         char const* format,
+                         va_list arguments);
+
+#endif // GFX_GFX_PRINTF_H
@@ -0,0 +1,145 @@
+#ifndef GFX_GFX_PRIVATE_H
+#define GFX_GFX_PRIVATE_H
+
+#include "gfx.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static inline void gfx_span_reset(gfx_span_t* span)
+{
+    span->begin = UINT16_MAX;
+    span->end = 0U;
+}
+
+static inline void gfx_span_merge(gfx_span_t* span,
+                                  uint16_t begin,
+                                  uint16_t end)
+{
+    if (begin < span->begin) {
+        span->begin = begin;
+    }
+    if (end > span->end) {
+        span->end = end;
+    }
+}
+
+// Floor division of y into a page index, valid for negative y as well
+static inline int32_t gfx_page_of(int32_t y)
+{
+    int32_t page_height = (int32_t)GFX_PAGE_HEIGHT;
+
+    return (y < 0 ? y - (page_height - 1) : y) / page_height;
+}
+
+// A raster operation as byte = (byte & and) ^ xor, both derived from the
+// source byte. One expression serves every operation, so the loops have no
+// per pixel switch and every operation costs the same.
+typedef struct {
+    uint8_t and_source;
+    uint8_t and_constant;
+    uint8_t xor_source;
+    uint8_t xor_constant;
+} gfx_rop_terms_t;
+
+static inline gfx_rop_terms_t gfx_rop_get_terms(gfx_rop_t rop)
+{
+    switch (rop) {
+        case GFX_ROP_SET: {
+            return (gfx_rop_terms_t){0xFFU, 0xFFU, 0xFFU, 0x00U};
+        }
+        case GFX_ROP_CLEAR: {
+            return (gfx_rop_terms_t){0xFFU, 0xFFU, 0x00U, 0x00U};
+        }
+        case GFX_ROP_XOR: {
+            return (gfx_rop_terms_t){0x00U, 0xFFU, 0xFFU, 0x00U};
+        }
+        case GFX_ROP_AND: {
+            return (gfx_rop_terms_t){0xFFU, 0x00U, 0x00U, 0x00U};
+        }
+        case GFX_ROP_INVERT: {
+            return (gfx_rop_terms_t){0x00U, 0xFFU, 0x00U, 0xFFU};
+        }
+        case GFX_ROP_COPY: {
+            return (gfx_rop_terms_t){0x00U, 0x00U, 0xFFU, 0x00U};
+        }
+        default: {
+            return (gfx_rop_terms_t){0x00U, 0xFFU, 0x00U, 0x00U};
+        }
+    }
+}
+
+// Writes the complement of the source, used by inverse text
+static inline gfx_rop_terms_t gfx_rop_get_inverse_terms(void)
+{
+    return (gfx_rop_terms_t){0x00U, 0x00U, 0xFFU, 0xFFU};
+}
+
+// Folds mask into the constants, bits outside of it are left as they are.
+// The source has to be clear outside of mask from then on.
+static inline gfx_rop_terms_t gfx_rop_mask_terms(gfx_rop_terms_t terms,
+                                                 uint8_t mask)
+{
+    return (gfx_rop_terms_t){
+        .and_source = terms.and_source,
+        .and_constant = (uint8_t)(terms.and_constant | ~mask),
+        .xor_source = terms.xor_source,
+        .xor_constant = (uint8_t)(terms.xor_constant & mask),
+    };
+}
+
+// Applies masked terms to byte
+static inline uint8_t gfx_rop_apply(uint8_t byte,
+                                    uint8_t source,
+                                    gfx_rop_terms_t terms)
+{
+    uint8_t and_mask = (uint8_t)((source & terms.and_source) ^
+                                 terms.and_constant);
+    uint8_t xor_mask = (uint8_t)((source & terms.xor_source) ^
+                                 terms.xor_constant);
+
+    return (uint8_t)((byte & and_mask) ^ xor_mask);
+}
+
+// Merges an area into per page spans without touching the frame buffer
+void gfx_merge_area(gfx_t const* gfx,
+                    gfx_span_t* spans,
+                    int16_t x,
+                    int16_t y,
+                    int16_t width,
+                    int16_t height);
+
+// Fills without dirty bookkeeping, one masked byte run per page
+void gfx_fill_area(gfx_t* gfx,
+                   int32_t x,
+                   int32_t y,
+                   int32_t width,
+                   int32_t height,
+                   gfx_rop_terms_t terms);
+
+// Writes columns without dirty bookkeeping, the operation covers the whole
+// 8 pixel tall cell of every column
+void gfx_put_columns(gfx_t* gfx,
+                     int16_t x,
+                     int16_t y,
+                     uint8_t const* columns,
+                     size_t count,
+                     gfx_rop_terms_t terms);
+
+// Renders text starting at column x without dirty bookkeeping, returns the
+// column following the last rendered glyph
+int32_t gfx_render_text(gfx_t* gfx,
+                        int32_t x,
+                        int16_t y,
+                        char const* string,
+                        size_t length,
+                        gfx_rop_terms_t terms);
+
+// Merges the line of text spanning columns [x, end) into per page spans
+void gfx_merge_text(gfx_t const* gfx,
+                    gfx_span_t* spans,
+                    int32_t x,
+                    int16_t y,
+                    int32_t end);
+
+#endif // GFX_GFX_PRIVATE_H
@@ -0,0 +1,289 @@
+#ifndef GFX_GFX_STATIC_HPP
+#define GFX_GFX_STATIC_HPP
+
+#include "gfx_config.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// Renders a screen that never changes at compile time, into the frame
+// buffer page layout. A constexpr image lands in flash and is sent as is,
+// see gfx_flush_image. Drawing follows the runtime renderer pixel for
+// pixel, operations included.
+template <std::size_t Width, std::size_t Height>
+class gfx_static_screen {
+public:
+    static constexpr std::size_t pages =
+        (Height + GFX_PAGE_HEIGHT - 1U) / GFX_PAGE_HEIGHT;
+
+    using image_t = std::array<std::uint8_t, Width * pages>;
+
+    constexpr explicit gfx_static_screen(gfx_font_t const& font) :
+        font_(font)
+    {
+    }
+
+    constexpr image_t const& get_image() const
+    {
+        return image_;
+    }
+
+    constexpr void draw_pixel(int x, int y, gfx_rop_t rop)
+    {
+        apply(x, y, true, rop);
+    }
+
+    constexpr void draw_line(int x0, int y0, int x1, int y1, gfx_rop_t rop)
+    {
+        int dx = x0 < x1 ? x1 - x0 : x0 - x1;
+        int dy = -(y0 < y1 ? y1 - y0 : y0 - y1);
+        int step_x = x0 < x1 ? 1 : -1;
+        int step_y = y0 < y1 ? 1 : -1;
+        int error = dx + dy;
+
+        while (true) {
+            apply(x0, y0, true, rop);
+            if (x0 == x1 && y0 == y1) {
+                break;
+            }
+
+            int doubled = 2 * error;
+            if (doubled >= dy) {
+                error += dy;
+                x0 += step_x;
+            }
+            if (doubled <= dx) {
+                error += dx;
+                y0 += step_y;
+            }
+        }
+    }
+
+    constexpr void draw_hline(int x, int y, int width, gfx_rop_t rop)
+    {
+        fill_rect(x, y, width, 1, rop);
+    }
+
+    constexpr void draw_vline(int x, int y, int height, gfx_rop_t rop)
+    {
+        fill_rect(x, y, 1, height, rop);
+    }
+
+    // Edges do not overlap, as in gfx_draw_rect
+    constexpr void draw_rect(int x, int y, int width, int height, gfx_rop_t rop)
+    {
+        if (width <= 0 || height <= 0) {
+            return;
+        }
+
+        fill_rect(x, y, width, 1, rop);
+        if (height > 1) {
+            fill_rect(x, y + height - 1, width, 1, rop);
+        }
+        if (height > 2) {
+            fill_rect(x, y + 1, 1, height - 2, rop);
+            if (width > 1) {
+                fill_rect(x + width - 1, y + 1, 1, height - 2, rop);
+            }
+        }
+    }
+
+    constexpr void fill_rect(int x, int y, int width, int height, gfx_rop_t rop)
+    {
+        for (int row = y; row < y + height; ++row) {
+            for (int column = x; column < x + width; ++column) {
+                apply(column, row, true, rop);
+            }
+        }
+    }
+
+    // 8 pixel tall columns, LSB on top, the operation covers whole cells
+    constexpr void draw_columns(int x,
+                                int y,
+                                std::span<std::uint8_t const> columns,
+                                gfx_rop_t rop)
+    {
+        for (std::size_t index = 0U; index < columns.size(); ++index) {
+            put_column(x + static_cast<int>(index), y, columns[index], rop);
+        }
+    }
+
+    // UTF-8, unknown code points and malformed bytes show as '?'
+    constexpr void draw_string(int x,
+                               int y,
+                               std::string_view string,
+                               gfx_rop_t rop)
+    {
+        int advance = static_cast<int>(font_.width) + 1;
+        bool has_spacer =
+            rop == GFX_ROP_INVERT || rop == GFX_ROP_AND || rop == GFX_ROP_COPY;
+
+        while (!string.empty() && string.front() != '\0' &&
+               x < static_cast<int>(Width)) {
+            std::uint32_t code_point = 0U;
+            string.remove_prefix(decode(string, code_point));
+            std::uint8_t const* glyph = get_glyph(code_point);
+
+            for (std::size_t column = 0U; column < font_.width; ++column) {
+                put_column(x + static_cast<int>(column), y, glyph[column], rop);
+            }
+            if (has_spacer) {
+                put_column(x + advance - 1, y, 0x00U, rop);
+            }
+
+            x += advance;
+        }
+    }
+
+    // Page layout image of width x height, as gfx_bitmap_t data
+    constexpr void blit(int x,
+                        int y,
+                        std::span<std::uint8_t const> data,
+                        std::size_t width,
+                        std::size_t height,
+                        gfx_rop_t rop)
+    {
+        for (std::size_t row = 0U; row < height; ++row) {
+            for (std::size_t column = 0U; column < width; ++column) {
+                std::uint8_t byte =
+                    data[(row / GFX_PAGE_HEIGHT) * width + column];
+                apply(x + static_cast<int>(column),
+                      y + static_cast<int>(row),
+                      ((byte >> (row % GFX_PAGE_HEIGHT)) & 1) != 0,
+                      rop);
+            }
+        }
+    }
+
+private:
+    // The terms of gfx_rop_get_terms, one bit at a time
+    static constexpr bool combine(bool pixel, bool source, gfx_rop_t rop)
+    {
+        switch (rop) {
+            case GFX_ROP_SET: {
+                return pixel || source;
+            }
+            case GFX_ROP_CLEAR: {
+                return pixel && !source;
+            }
+            case GFX_ROP_XOR: {
+                return pixel != source;
+            }
+            case GFX_ROP_AND: {
+                return pixel && source;
+            }
+            case GFX_ROP_INVERT: {
+                return !pixel;
+            }
+            case GFX_ROP_COPY: {
+                return source;
+            }
+            default: {
+                return pixel;
+            }
+        }
+    }
+
+    constexpr void apply(int x, int y, bool source, gfx_rop_t rop)
+    {
+        if (x < 0 || y < 0 || x >= static_cast<int>(Width) ||
+            y >= static_cast<int>(Height)) {
+            return;
+        }
+
+        std::uint8_t& byte =
+            image_[static_cast<std::size_t>(y) / GFX_PAGE_HEIGHT * Width +
+                   static_cast<std::size_t>(x)];
+        auto bit = static_cast<std::uint8_t>(
+            1U << (static_cast<unsigned>(y) % GFX_PAGE_HEIGHT));
+
+        if (combine((byte & bit) != 0U, source, rop)) {
+            byte = static_cast<std::uint8_t>(byte | bit);
+        } else {
+            byte = static_cast<std::uint8_t>(byte & ~bit);
+        }
+    }
+
+    constexpr void put_column(int x, int y, std::uint8_t column, gfx_rop_t rop)
+    {
+        for (int row = 0; row < static_cast<int>(GFX_PAGE_HEIGHT); ++row) {
+            apply(x, y + row, ((column >> row) & 1) != 0, rop);
+        }
+    }
+
+    constexpr std::uint8_t const*
+    get_ascii_glyph(std::uint32_t code_point) const
+    {
+        std::size_t index = code_point - font_.code_offset;
+
+        if (index >= font_.glyph_count) {
+            index = static_cast<std::size_t>('?') - font_.code_offset;
+        }
+
+        return &font_.glyphs[index * font_.width];
+    }
+
+    constexpr std::uint8_t const* get_glyph(std::uint32_t code_point) const
+    {
+        if (code_point < 0x80U) {
+            return get_ascii_glyph(code_point);
+        }
+
+        for (std::size_t index = 0U; index < font_.extended_glyph_count;
+             ++index) {
+            if (font_.extended_code_points[index] == code_point) {
+                return &font_.extended_glyphs[index * font_.width];
+            }
+        }
+
+        return get_ascii_glyph('?');
+    }
+
+    // gfx_utf8_decode, malformed sequences consume a single byte and decode
+    // to a code point without a glyph
+    static constexpr std::size_t decode(std::string_view string,
+                                        std::uint32_t& code_point)
+    {
+        auto lead = static_cast<std::uint8_t>(string[0]);
+
+        code_point = 0xFFFDU;
+        if (lead < 0x80U) {
+            code_point = lead;
+            return 1U;
+        }
+
+        std::size_t length = (lead & 0xE0U) == 0xC0U   ? 2U
+                             : (lead & 0xF0U) == 0xE0U ? 3U
+                             : (lead & 0xF8U) == 0xF0U ? 4U
+                                                       : 0U;
+        if (length == 0U || length > string.size()) {
+            return 1U;
+        }
+
+        std::uint32_t value = lead & (0x7FU >> length);
+        for (std::size_t index = 1U; index < length; ++index) {
+            auto byte = static_cast<std::uint8_t>(string[index]);
+            if ((byte & 0xC0U) != 0x80U) {
+                return 1U;
+            }
+            value = (value << 6U) | (byte & 0x3FU);
+        }
+
+        constexpr std::array<std::uint32_t, 5> minimum = {
+            0U, 0U, 0x80U, 0x800U, 0x10000U};
+        if (value < minimum[length] || value > 0x10FFFFU ||
+            (value >= 0xD800U && value <= 0xDFFFU)) {
+            return 1U;
+        }
+
+        code_point = value;
+        return length;
+    }
+
+    gfx_font_t font_;
+    image_t image_{};
+};
+
+#endif // GFX_GFX_STATIC_HPP
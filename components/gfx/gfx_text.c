@@ -0,0 +1,197 @@
+#include "gfx_text.h"
+#include "gfx_private.h"
+#include "gfx_utf8.h"
+#include <assert.h>
+#include <stdbool.h>
+
+static inline uint8_t const* gfx_font_get_ascii_glyph(gfx_font_t const* font,
+                                                      uint32_t code_point)
+{
+    size_t index = (size_t)code_point - font->code_offset;
+
+    if (index >= font->glyph_count) {
+        index = (size_t)'?' - font->code_offset;
+    }
+
+    return &font->glyphs[index * font->width];
+}
+
+size_t gfx_font_find_extended(gfx_font_t const* font, uint32_t code_point)
+{
+    assert(font);
+
+    uint16_t const* code_points = font->extended_code_points;
+    size_t size = font->extended_glyph_count;
+    size_t base = 0U;
+
+    if (size == 0U) {
+        return GFX_GLYPH_NOT_FOUND;
+    }
+
+    // fixed trip count lower bound, the select compiles to a conditional move
+    while (size > 1U) {
+        size_t half = size / 2U;
+        base = (code_points[base + half] <= code_point) ? base + half : base;
+        size -= half;
+    }
+
+    return code_points[base] == code_point ? base : GFX_GLYPH_NOT_FOUND;
+}
+
+uint8_t const* gfx_font_get_glyph(gfx_font_t const* font, uint32_t code_point)
+{
+    assert(font);
+
+    if (code_point < 0x80U) {
+        return gfx_font_get_ascii_glyph(font, code_point);
+    }
+
+    size_t index = gfx_font_find_extended(font, code_point);
+    if (index == GFX_GLYPH_NOT_FOUND) {
+        return gfx_font_get_ascii_glyph(font, '?');
+    }
+
+    return &font->extended_glyphs[index * font->width];
+}
+
+int32_t gfx_render_text(gfx_t* gfx,
+                        int32_t x,
+                        int16_t y,
+                        char const* string,
+                        size_t length,
+                        gfx_rop_terms_t terms)
+{
+    static uint8_t const spacer = 0x00U;
+
+    // the blank spacer column only matters to operations that change the
+    // frame where the source is clear
+    bool has_spacer = terms.and_constant != 0xFFU || terms.xor_constant != 0U;
+
+    gfx_font_t const* font = &gfx->config.font;
+    int32_t advance = (int32_t)font->width + 1;
+    int32_t frame_width = (int32_t)gfx->config.frame_width;
+    int32_t cursor = x;
+
+    while (length > 0U && *string != '\0' && cursor < frame_width) {
+        uint8_t const* glyph;
+        size_t consumed = 1U;
+
+        if ((uint8_t)*string < 0x80U) {
+            glyph = gfx_font_get_ascii_glyph(font, (uint8_t)*string);
+        } else {
+            uint32_t code_point;
+            consumed = gfx_utf8_decode(string, length, &code_point);
+            glyph = gfx_font_get_glyph(font, code_point);
+        }
+
+        string += consumed;
+        length -= consumed;
+
+        if (cursor + advance > 0) {
+            gfx_put_columns(
+                gfx, (int16_t)cursor, y, glyph, font->width, terms);
+            if (has_spacer) {
+                gfx_put_columns(gfx,
+                                (int16_t)(cursor + advance - 1),
+                                y,
+                                &spacer,
+                                1U,
+                                terms);
+            }
+        }
+
+        cursor += advance;
+    }
+
+    return cursor;
+}
+
+void gfx_merge_text(gfx_t const* gfx,
+                    gfx_span_t* spans,
+                    int32_t x,
+                    int16_t y,
+                    int32_t end)
+{
+    int32_t begin = x < 0 ? 0 : x;
+
+    if (end > begin) {
+        gfx_merge_area(gfx,
+                       spans,
+                       (int16_t)begin,
+                       y,
+                       (int16_t)(end - begin),
+                       (int16_t)GFX_PAGE_HEIGHT);
+    }
+}
+
+void gfx_draw_string(gfx_t* gfx,
+                     int16_t x,
+                     int16_t y,
+                     char const* string,
+                     gfx_rop_t rop)
+{
+    assert(gfx && string);
+
+    int32_t end = gfx_render_text(
+        gfx, x, y, string, SIZE_MAX, gfx_rop_get_terms(rop));
+    gfx_merge_text(gfx, gfx->dirty, x, y, end);
+}
+
+void gfx_draw_text(gfx_t* gfx,
+                   int16_t x,
+                   int16_t y,
+                   char const* string,
+                   size_t length,
+                   gfx_rop_t rop)
+{
+    assert(gfx && string);
+
+    int32_t end =
+        gfx_render_text(gfx, x, y, string, length, gfx_rop_get_terms(rop));
+    gfx_merge_text(gfx, gfx->dirty, x, y, end);
+}
+
+void gfx_draw_cell(gfx_t* gfx,
+                   int16_t x,
+                   int16_t y,
+                   uint32_t code_point,
+                   uint8_t attributes)
+{
+    static uint8_t const blank = 0x00U;
+    static uint8_t const solid = 0xFFU;
+
+    assert(gfx);
+
+    gfx_font_t const* font = &gfx->config.font;
+    uint8_t const* glyph = gfx_font_get_glyph(font, code_point);
+    int32_t advance = (int32_t)font->width + 1;
+
+    gfx_rop_terms_t inverse = gfx_rop_get_inverse_terms();
+
+    if ((attributes & GFX_TEXT_ATTRIBUTE_INVERSE) != 0U) {
+        gfx_put_columns(gfx, x, y, glyph, font->width, inverse);
+        gfx_put_columns(
+            gfx, (int16_t)(x + advance - 1), y, &blank, 1U, inverse);
+    } else {
+        // solid columns written inverted clear the cell background
+        for (int32_t column = 0; column < advance; ++column) {
+            gfx_put_columns(
+                gfx, (int16_t)(x + column), y, &solid, 1U, inverse);
+        }
+        gfx_put_columns(
+            gfx, x, y, glyph, font->width, gfx_rop_get_terms(GFX_ROP_SET));
+    }
+
+    gfx_mark_dirty(gfx, x, y, (int16_t)advance, (int16_t)GFX_PAGE_HEIGHT);
+}
+
+void gfx_draw_prepared_string(gfx_t* gfx,
+                              int16_t x,
+                              int16_t y,
+                              gfx_prepared_string_t const* string,
+                              gfx_rop_t rop)
+{
+    assert(gfx && string);
+
+    gfx_draw_columns(gfx, x, y, string->columns, string->width, rop);
+}
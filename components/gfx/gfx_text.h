@@ -0,0 +1,56 @@
+#ifndef GFX_GFX_TEXT_H
+#define GFX_GFX_TEXT_H
+
+#include "gfx.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Glyph columns of a whole string, shaped ahead of time by
+// scripts/prepare_strings.py. Every glyph is followed by its spacer column,
+// so the columns draw as gfx_draw_string draws the text.
+typedef struct {
+    uint8_t const* columns;
+    size_t width;
+} gfx_prepared_string_t;
+
+typedef enum {
+    GFX_TEXT_ATTRIBUTE_NONE = 0,
+    GFX_TEXT_ATTRIBUTE_INVERSE = 1 << 0,
+} gfx_text_attribute_t;
+
+// Returns the glyph index in font->extended_glyphs or GFX_GLYPH_NOT_FOUND
+size_t gfx_font_find_extended(gfx_font_t const* font, uint32_t code_point);
+
+// Returns the glyph columns for code_point, falling back to '?'
+uint8_t const* gfx_font_get_glyph(gfx_font_t const* font, uint32_t code_point);
+
+// Draws an UTF-8 string, ASCII bytes skip decoding and the extended lookup
+void gfx_draw_string(gfx_t* gfx,
+                     int16_t x,
+                     int16_t y,
+                     char const* string,
+                     gfx_rop_t rop);
+
+// Draws at most length bytes of an UTF-8 string, stopping early at a NUL
+void gfx_draw_text(gfx_t* gfx,
+                   int16_t x,
+                   int16_t y,
+                   char const* string,
+                   size_t length,
+                   gfx_rop_t rop);
+
+// Overwrites a whole character cell, background included, with a glyph
+// drawn using gfx_text_attribute_t attributes
+void gfx_draw_cell(gfx_t* gfx,
+                   int16_t x,
+                   int16_t y,
+                   uint32_t code_point,
+                   uint8_t attributes);
+
+void gfx_draw_prepared_string(gfx_t* gfx,
+                              int16_t x,
+                              int16_t y,
+                              gfx_prepared_string_t const* string,
+                              gfx_rop_t rop);
+
+#endif // GFX_GFX_TEXT_H
@@ -0,0 +1,81 @@
+#include "gfx_text_field.h"
+#include "gfx_text.h"
+#include "gfx_utf8.h"
+#include <assert.h>
+#include <string.h>
+
+typedef struct {
+    char const* string;
+    size_t length;
+} gfx_text_field_cursor_t;
+
+static inline uint32_t gfx_text_field_next(gfx_text_field_cursor_t* cursor)
+{
+    if (cursor->length == 0U) {
+        return UINT32_MAX;
+    }
+
+    uint32_t code_point;
+    size_t consumed =
+        gfx_utf8_decode(cursor->string, cursor->length, &code_point);
+
+    cursor->string += consumed;
+    cursor->length -= consumed;
+
+    return code_point;
+}
+
+void gfx_text_field_initialize(gfx_text_field_t* field, int16_t x, int16_t y)
+{
+    assert(field);
+
+    memset(field, 0, sizeof(*field));
+    field->x = x;
+    field->y = y;
+}
+
+void gfx_text_field_update(gfx_t* gfx,
+                           gfx_text_field_t* field,
+                           char const* string,
+                           size_t length)
+{
+    assert(gfx && field && string);
+
+    if (length > GFX_TEXT_FIELD_CAPACITY) {
+        length = GFX_TEXT_FIELD_CAPACITY;
+        // never split a multi-byte sequence
+        while (length > 0U && ((uint8_t)string[length] & 0xC0U) == 0x80U) {
+            --length;
+        }
+    }
+
+    gfx_text_field_cursor_t previous = {.string = field->text,
+                                        .length = field->length};
+    gfx_text_field_cursor_t next = {.string = string, .length = length};
+
+    int32_t advance = (int32_t)gfx->config.font.width + 1;
+    int32_t x = field->x;
+
+    while (previous.length > 0U || next.length > 0U) {
+        uint32_t old_code_point = gfx_text_field_next(&previous);
+        uint32_t new_code_point = gfx_text_field_next(&next);
+
+        if (old_code_point != new_code_point) {
+            gfx_draw_cell(gfx,
+                          (int16_t)x,
+                          field->y,
+                          new_code_point != UINT32_MAX ? new_code_point : ' ',
+                          GFX_TEXT_ATTRIBUTE_NONE);
+        }
+
+        x += advance;
+    }
+
+    memcpy(field->text, string, length);
+    field->length = length;
+}
+
+void gfx_text_field_clear(gfx_t* gfx, gfx_text_field_t* field)
+{
+    gfx_text_field_update(gfx, field, "", 0U);
+}
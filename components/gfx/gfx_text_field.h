@@ -0,0 +1,31 @@
+#ifndef GFX_GFX_TEXT_FIELD_H
+#define GFX_GFX_TEXT_FIELD_H
+
+#include "gfx.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define GFX_TEXT_FIELD_CAPACITY (32U)
+
+// Single line of text that remembers what it last rendered, so updates only
+// touch and dirty the character cells that actually changed
+typedef struct {
+    int16_t x;
+    int16_t y;
+    size_t length;
+    char text[GFX_TEXT_FIELD_CAPACITY];
+} gfx_text_field_t;
+
+void gfx_text_field_initialize(gfx_text_field_t* field, int16_t x, int16_t y);
+
+// Renders the difference between the current and the new UTF-8 text, text
+// longer than GFX_TEXT_FIELD_CAPACITY bytes is truncated
+void gfx_text_field_update(gfx_t* gfx,
+                           gfx_text_field_t* field,
+                           char const* string,
+                           size_t length);
+
+// Clears every cell of the field and forgets its text
+void gfx_text_field_clear(gfx_t* gfx, gfx_text_field_t* field);
+
+#endif // GFX_GFX_TEXT_FIELD_H
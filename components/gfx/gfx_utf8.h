@@ -0,0 +1,68 @@
+#ifndef GFX_GFX_UTF8_H
+#define GFX_GFX_UTF8_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GFX_UTF8_REPLACEMENT (0xFFFDUL)
+
+// Decodes one code point from at most size bytes and returns the number of
+// bytes consumed. Malformed sequences decode to GFX_UTF8_REPLACEMENT and
+// consume a single byte. Never reads past a NUL byte.
+static inline size_t gfx_utf8_decode(char const* string,
+                                     size_t size,
+                                     uint32_t* code_point)
+{
+    uint8_t const* bytes = (uint8_t const*)string;
+    uint32_t lead = bytes[0];
+
+    if (lead < 0x80U) {
+        *code_point = lead;
+        return 1U;
+    }
+
+    size_t length;
+    uint32_t value;
+    uint32_t minimum;
+
+    if ((lead & 0xE0U) == 0xC0U) {
+        length = 2U;
+        value = lead & 0x1FU;
+        minimum = 0x80U;
+    } else if ((lead & 0xF0U) == 0xE0U) {
+        length = 3U;
+        value = lead & 0x0FU;
+        minimum = 0x800U;
+    } else if ((lead & 0xF8U) == 0xF0U) {
+        length = 4U;
+        value = lead & 0x07U;
+        minimum = 0x10000U;
+    } else {
+        *code_point = GFX_UTF8_REPLACEMENT;
+        return 1U;
+    }
+
+    if (length > size) {
+        *code_point = GFX_UTF8_REPLACEMENT;
+        return 1U;
+    }
+
+    for (size_t index = 1U; index < length; ++index) {
+        if ((bytes[index] & 0xC0U) != 0x80U) {
+            *code_point = GFX_UTF8_REPLACEMENT;
+            return 1U;
+        }
+        value = (value << 6U) | (bytes[index] & 0x3FU);
+    }
+
+    if (value < minimum || value > 0x10FFFFUL ||
+        (value >= 0xD800U && value <= 0xDFFFU)) {
+        *code_point = GFX_UTF8_REPLACEMENT;
+        return 1U;
+    }
+
+    *code_point = value;
+    return length;
+}
+
+#endif // GFX_GFX_UTF8_H
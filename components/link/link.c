@@ -0,0 +1,346 @@
+#include "link.h"
+#include <assert.h>
+#include <string.h>
+
+// CRC-16/CCITT-FALSE, polynomial 0x1021
+static uint16_t const link_crc_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+static inline uint16_t link_crc_update(uint16_t crc, uint8_t byte)
+{
+    return (uint16_t)((crc << 8U) ^ link_crc_table[(crc >> 8U) ^ byte]);
+}
+
+typedef struct {
+    uint8_t* buffer;
+    size_t size;
+    size_t code_index;
+    uint8_t code;
+} link_cobs_t;
+
+static inline void link_cobs_begin(link_cobs_t* cobs, uint8_t* buffer)
+{
+    cobs->buffer = buffer;
+    cobs->size = 1U;
+    cobs->code_index = 0U;
+    cobs->code = 1U;
+}
+
+static inline void link_cobs_put(link_cobs_t* cobs, uint8_t byte)
+{
+    if (byte != LINK_FRAME_DELIMITER) {
+        cobs->buffer[cobs->size++] = byte;
+        if (++cobs->code != 0xFFU) {
+            return;
+        }
+    }
+
+    cobs->buffer[cobs->code_index] = cobs->code;
+    cobs->code_index = cobs->size++;
+    cobs->code = 1U;
+}
+
+static inline size_t link_cobs_end(link_cobs_t* cobs)
+{
+    cobs->buffer[cobs->code_index] = cobs->code;
+    cobs->buffer[cobs->size++] = LINK_FRAME_DELIMITER;
+
+    return cobs->size;
+}
+
+// Decodes in place, the output never overtakes the input
+static bool link_cobs_decode(uint8_t* data, size_t size, size_t* decoded)
+{
+    size_t read = 0U;
+    size_t write = 0U;
+
+    while (read < size) {
+        size_t code = data[read++];
+        if (code == 0U || read + code - 1U > size) {
+            return false;
+        }
+
+        for (size_t index = 1U; index < code; ++index) {
+            data[write++] = data[read++];
+        }
+        if (code != 0xFFU && read < size) {
+            data[write++] = 0U;
+        }
+    }
+
+    *decoded = write;
+    return true;
+}
+
+static inline size_t link_cobs_max_size(size_t size)
+{
+    // one code byte per started block of 254 plus the delimiter
+    return size + size / 254U + 2U;
+}
+
+static link_err_t link_send_control(link_t* link,
+                                    uint8_t control,
+                                    uint32_t value)
+{
+    uint8_t payload[5] = {control,
+                          (uint8_t)value,
+                          (uint8_t)(value >> 8U),
+                          (uint8_t)(value >> 16U),
+                          (uint8_t)(value >> 24U)};
+
+    return link_send(link, LINK_CHANNEL_CONTROL, payload, sizeof(payload));
+}
+
+static link_err_t link_set_baud(link_t* link, uint32_t baud)
+{
+    if (link->interface.transport_set_baud == NULL) {
+        return LINK_ERR_NULL;
+    }
+
+    link_err_t err =
+        link->interface.transport_set_baud(link->interface.transport_user,
+                                           baud);
+    if (err == LINK_ERR_OK) {
+        link->config.baud = baud;
+    }
+
+    return err;
+}
+
+static void link_handle_control(link_t* link,
+                                uint8_t const* payload,
+                                size_t size,
+                                uint32_t now)
+{
+    if (size == 0U) {
+        return;
+    }
+
+    switch (payload[0]) {
+        case LINK_CONTROL_PING: {
+            link->confirm_pending = false;
+            link_send_control(link, LINK_CONTROL_PONG, link->config.baud);
+            break;
+        }
+        case LINK_CONTROL_SET_BAUD: {
+            if (size < 5U) {
+                break;
+            }
+
+            uint32_t baud = (uint32_t)payload[1] |
+                            ((uint32_t)payload[2] << 8U) |
+                            ((uint32_t)payload[3] << 16U) |
+                            ((uint32_t)payload[4] << 24U);
+
+            if (baud < LINK_MIN_BAUD || baud > link->config.max_baud ||
+                link->interface.transport_set_baud == NULL) {
+                link_send_control(link, LINK_CONTROL_BAUD_NAK, baud);
+                break;
+            }
+
+            // acknowledged at the old rate, which must be fully sent first
+            link_send_control(link, LINK_CONTROL_BAUD_ACK, baud);
+            if (link->interface.transport_drain) {
+                link->interface.transport_drain(link->interface.transport_user);
+            }
+
+            uint32_t previous_baud = link->config.baud;
+            if (link_set_baud(link, baud) == LINK_ERR_OK) {
+                link->previous_baud = previous_baud;
+                link->confirm_deadline = now + LINK_BAUD_CONFIRM_TIMEOUT;
+                link->confirm_pending = true;
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+static void link_handle_frame(link_t* link, uint32_t now)
+{
+    size_t size;
+    if (!link_cobs_decode(link->config.rx_buffer, link->rx_size, &size) ||
+        size < 1U + LINK_CRC_SIZE) {
+        ++link->rx_dropped;
+        return;
+    }
+
+    uint8_t const* frame = link->config.rx_buffer;
+    uint16_t crc = 0xFFFFU;
+    for (size_t index = 0U; index < size - LINK_CRC_SIZE; ++index) {
+        crc = link_crc_update(crc, frame[index]);
+    }
+
+    uint16_t expected = (uint16_t)(frame[size - 2U] | (frame[size - 1U] << 8U));
+    if (crc != expected) {
+        ++link->rx_dropped;
+        return;
+    }
+
+    uint8_t channel = frame[0];
+    uint8_t const* payload = &frame[1];
+    size_t payload_size = size - 1U - LINK_CRC_SIZE;
+
+    if (channel == LINK_CHANNEL_CONTROL) {
+        link_handle_control(link, payload, payload_size, now);
+    } else if (link->interface.receive) {
+        link->interface.receive(link->interface.receive_user,
+                                channel,
+                                payload,
+                                payload_size);
+    }
+}
+
+void link_initialize(link_t* link,
+                     link_config_t const* config,
+                     link_interface_t const* interface)
+{
+    assert(link && config && interface);
+    assert(config->tx_buffer && config->rx_buffer);
+    assert(config->tx_buffer_size > link_cobs_max_size(1U + LINK_CRC_SIZE));
+
+    memset(link, 0, sizeof(*link));
+    memcpy(&link->config, config, sizeof(*config));
+    memcpy(&link->interface, interface, sizeof(*interface));
+}
+
+void link_deinitialize(link_t* link)
+{
+    assert(link);
+
+    memset(link, 0, sizeof(*link));
+}
+
+size_t link_get_max_payload(link_t const* link)
+{
+    assert(link);
+
+    size_t size = link->config.tx_buffer_size;
+    size_t frame = size - size / 255U - 2U;
+
+    return frame - 1U - LINK_CRC_SIZE;
+}
+
+link_err_t link_send(link_t* link,
+                     uint8_t channel,
+                     uint8_t const* payload,
+                     size_t size)
+{
+    assert(link && (payload || size == 0U));
+
+    if (size > link_get_max_payload(link)) {
+        return LINK_ERR_FAIL;
+    }
+    if (link->interface.transport_write == NULL) {
+        return LINK_ERR_NULL;
+    }
+
+    link_cobs_t cobs;
+    link_cobs_begin(&cobs, link->config.tx_buffer);
+
+    uint16_t crc = link_crc_update(0xFFFFU, channel);
+    link_cobs_put(&cobs, channel);
+
+    for (size_t index = 0U; index < size; ++index) {
+        crc = link_crc_update(crc, payload[index]);
+        link_cobs_put(&cobs, payload[index]);
+    }
+
+    link_cobs_put(&cobs, (uint8_t)crc);
+    link_cobs_put(&cobs, (uint8_t)(crc >> 8U));
+
+    size_t encoded = link_cobs_end(&cobs);
+
+    return link->interface.transport_write(link->interface.transport_user,
+                                           link->config.tx_buffer,
+                                           encoded) == encoded
+               ? LINK_ERR_OK
+               : LINK_ERR_FAIL;
+}
+
+void link_process(link_t* link, uint32_t now)
+{
+    assert(link);
+
+    if (link->interface.transport_read) {
+        uint8_t chunk[64];
+        size_t size;
+
+        while ((size = link->interface.transport_read(
+                    link->interface.transport_user,
+                    chunk,
+                    sizeof(chunk))) > 0U) {
+            for (size_t index = 0U; index < size; ++index) {
+                uint8_t byte = chunk[index];
+
+                if (byte == LINK_FRAME_DELIMITER) {
+                    if (link->rx_overflow) {
+                        ++link->rx_dropped;
+                    } else if (link->rx_size > 0U) {
+                        link_handle_frame(link, now);
+                    }
+                    link->rx_size = 0U;
+                    link->rx_overflow = false;
+                } else if (link->rx_size < link->config.rx_buffer_size) {
+                    link->config.rx_buffer[link->rx_size++] = byte;
+                } else {
+                    link->rx_overflow = true;
+                }
+            }
+        }
+    }
+
+    if (link->confirm_pending &&
+        (int32_t)(now - link->confirm_deadline) >= 0) {
+        link->confirm_pending = false;
+        link_set_baud(link, link->previous_baud);
+    }
+}
+
+uint32_t link_get_baud(link_t const* link)
+{
+    assert(link);
+
+    return link->config.baud;
+}
+
+size_t link_get_rx_dropped(link_t const* link)
+{
+    assert(link);
+
+    return link->rx_dropped;
+}
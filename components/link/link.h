@@ -0,0 +1,47 @@
+#ifndef LINK_LINK_H
+#define LINK_LINK_H
+
+#include "link_config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Framed transport, every frame is the channel, the payload and a CRC-16 over
+// both, COBS encoded and terminated by a zero byte. The control channel lets
+// the host raise the baud rate, the new rate has to be confirmed by a ping
+// within LINK_BAUD_CONFIRM_TIMEOUT or the link falls back.
+typedef struct {
+    link_config_t config;
+    link_interface_t interface;
+
+    size_t rx_size;
+    bool rx_overflow;
+    size_t rx_dropped;
+
+    uint32_t previous_baud;
+    uint32_t confirm_deadline;
+    bool confirm_pending;
+} link_t;
+
+void link_initialize(link_t* link,
+                     link_config_t const* config,
+                     link_interface_t const* interface);
+void link_deinitialize(link_t* link);
+
+// Largest payload a single frame can carry with the configured buffers
+size_t link_get_max_payload(link_t const* link);
+
+// Encodes and writes one frame, not reentrant
+link_err_t link_send(link_t* link,
+                     uint8_t channel,
+                     uint8_t const* payload,
+                     size_t size);
+
+// Reads whatever arrived, dispatches complete frames and runs the baud rate
+// fallback, now is a millisecond tick
+void link_process(link_t* link, uint32_t now);
+
+uint32_t link_get_baud(link_t const* link);
+size_t link_get_rx_dropped(link_t const* link);
+
+#endif // LINK_LINK_H
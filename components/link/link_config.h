@@ -0,0 +1,66 @@
+#ifndef LINK_LINK_CONFIG_H
+#define LINK_LINK_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LINK_FRAME_DELIMITER (0x00U)
+#define LINK_CRC_SIZE (2U)
+#define LINK_MIN_BAUD (1200UL)
+#define LINK_BAUD_CONFIRM_TIMEOUT (500UL)
+
+typedef enum {
+    LINK_ERR_OK = 0,
+    LINK_ERR_FAIL = 1 << 0,
+    LINK_ERR_NULL = 1 << 1,
+} link_err_t;
+
+typedef enum {
+    LINK_CHANNEL_CONTROL = 0,
+    LINK_CHANNEL_TEXT = 1,
+    LINK_CHANNEL_TRACE = 2,
+    // frame buffer changes, see components/mirror
+    LINK_CHANNEL_MIRROR = 3,
+    // draw commands and their replies, see components/remote
+    LINK_CHANNEL_DRAW = 4,
+    // streamed animation frames, see components/video
+    LINK_CHANNEL_VIDEO = 5,
+    // first channel free for protocols built on top of the link
+    LINK_CHANNEL_USER = 16,
+} link_channel_t;
+
+typedef enum {
+    LINK_CONTROL_PING = 0,
+    LINK_CONTROL_PONG = 1,
+    // followed by the requested baud rate, little endian
+    LINK_CONTROL_SET_BAUD = 2,
+    LINK_CONTROL_BAUD_ACK = 3,
+    LINK_CONTROL_BAUD_NAK = 4,
+} link_control_t;
+
+typedef struct {
+    // hold one COBS encoded frame each, including the delimiter
+    uint8_t* tx_buffer;
+    size_t tx_buffer_size;
+    uint8_t* rx_buffer;
+    size_t rx_buffer_size;
+
+    uint32_t baud;
+    uint32_t max_baud;
+} link_config_t;
+
+typedef struct {
+    void* transport_user;
+    size_t (*transport_write)(void*, uint8_t const*, size_t);
+    // must not block, returns the number of bytes read
+    size_t (*transport_read)(void*, uint8_t*, size_t);
+    // waits until every written byte left the wire
+    void (*transport_drain)(void*);
+    link_err_t (*transport_set_baud)(void*, uint32_t);
+
+    void* receive_user;
+    // called for every intact frame outside the control channel
+    void (*receive)(void*, uint8_t, uint8_t const*, size_t);
+} link_interface_t;
+
+#endif // LINK_LINK_CONFIG_H
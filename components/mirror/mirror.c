@@ -0,0 +1,163 @@
+#include "mirror.h"
+#include <assert.h>
+#include <string.h>
+
+static inline size_t mirror_worst_size(size_t size)
+{
+    // nothing but literals, one control byte per MIRROR_LITERAL_MAX bytes
+    return size + (size + MIRROR_LITERAL_MAX - 1U) / MIRROR_LITERAL_MAX;
+}
+
+static inline void mirror_put_u16(uint8_t* buffer, size_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8U);
+}
+
+static void mirror_send(mirror_t* mirror)
+{
+    if (mirror->size > 0U && mirror->interface.sink_write) {
+        mirror->interface.sink_write(mirror->interface.sink_user,
+                                     mirror->config.buffer,
+                                     mirror->size);
+    }
+
+    mirror->size = 0U;
+}
+
+static uint8_t* mirror_reserve(mirror_t* mirror, size_t size)
+{
+    if (mirror->size + size > mirror->config.buffer_size) {
+        mirror_send(mirror);
+    }
+
+    uint8_t* record = &mirror->config.buffer[mirror->size];
+    mirror->size += size;
+    mirror->changed = true;
+
+    return record;
+}
+
+// A control byte below 0x80 is followed by that many plus one literal bytes,
+// otherwise the next byte repeats the control minus 0x7E times
+static size_t mirror_encode(uint8_t* output, uint8_t const* data, size_t size)
+{
+    size_t encoded = 0U;
+    size_t literal = 0U;
+    size_t literal_count = 0U;
+
+    for (size_t index = 0U; index < size;) {
+        size_t run = 1U;
+        while (index + run < size && run < MIRROR_RUN_MAX &&
+               data[index + run] == data[index]) {
+            ++run;
+        }
+
+        // shorter runs cost as much as literals and would split them
+        if (run < 3U) {
+            if (literal_count == 0U) {
+                literal = encoded++;
+            }
+            output[encoded++] = data[index++];
+            if (++literal_count == MIRROR_LITERAL_MAX) {
+                output[literal] = (uint8_t)(literal_count - 1U);
+                literal_count = 0U;
+            }
+            continue;
+        }
+
+        if (literal_count > 0U) {
+            output[literal] = (uint8_t)(literal_count - 1U);
+            literal_count = 0U;
+        }
+
+        output[encoded++] = (uint8_t)(0x80U + run - 2U);
+        output[encoded++] = data[index];
+        index += run;
+    }
+
+    if (literal_count > 0U) {
+        output[literal] = (uint8_t)(literal_count - 1U);
+    }
+
+    return encoded;
+}
+
+void mirror_initialize(mirror_t* mirror,
+                       mirror_config_t const* config,
+                       mirror_interface_t const* interface)
+{
+    assert(mirror && config && interface && config->buffer);
+    assert(config->buffer_size > MIRROR_SPAN_HEADER_SIZE + 1U);
+
+    memset(mirror, 0, sizeof(*mirror));
+    memcpy(&mirror->config, config, sizeof(*config));
+    memcpy(&mirror->interface, interface, sizeof(*interface));
+}
+
+void mirror_deinitialize(mirror_t* mirror)
+{
+    assert(mirror);
+
+    memset(mirror, 0, sizeof(*mirror));
+}
+
+void mirror_span(mirror_t* mirror,
+                 size_t page,
+                 size_t column,
+                 uint8_t const* data,
+                 size_t size)
+{
+    assert(mirror && data);
+
+    // largest span whose worst case encoding fits an empty buffer
+    size_t capacity = mirror->config.buffer_size - MIRROR_SPAN_HEADER_SIZE;
+    size_t max_size = capacity - (capacity + MIRROR_LITERAL_MAX) /
+                                     (MIRROR_LITERAL_MAX + 1U);
+
+    while (size > 0U) {
+        size_t chunk = size < max_size ? size : max_size;
+
+        uint8_t* record = mirror_reserve(
+            mirror,
+            MIRROR_SPAN_HEADER_SIZE + mirror_worst_size(chunk));
+        record[0] = MIRROR_RECORD_SPAN;
+        record[1] = (uint8_t)page;
+        mirror_put_u16(&record[2], column);
+        mirror_put_u16(&record[4], chunk);
+
+        size_t encoded =
+            mirror_encode(&record[MIRROR_SPAN_HEADER_SIZE], data, chunk);
+        mirror->size -= mirror_worst_size(chunk) - encoded;
+
+        column += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void mirror_start_line(mirror_t* mirror, size_t line)
+{
+    assert(mirror);
+
+    uint8_t* record = mirror_reserve(mirror, 3U);
+    record[0] = MIRROR_RECORD_START_LINE;
+    mirror_put_u16(&record[1], line);
+}
+
+void mirror_frame(mirror_t* mirror)
+{
+    assert(mirror);
+
+    if (!mirror->changed) {
+        return;
+    }
+
+    uint8_t* record = mirror_reserve(mirror, 5U);
+    record[0] = MIRROR_RECORD_FRAME;
+    mirror_put_u16(&record[1], mirror->config.frame_width);
+    mirror_put_u16(&record[3], mirror->config.frame_height);
+
+    mirror_send(mirror);
+    mirror->changed = false;
+}
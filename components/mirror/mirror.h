@@ -0,0 +1,37 @@
+#ifndef MIRROR_MIRROR_H
+#define MIRROR_MIRROR_H
+
+#include "mirror_config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Replays what reaches the panel to a host, see scripts/mirror_viewer.py.
+// Only the spans actually flushed are sent, so the bandwidth follows the
+// amount of change instead of the frame size.
+typedef struct {
+    mirror_config_t config;
+    mirror_interface_t interface;
+
+    size_t size;
+    bool changed;
+} mirror_t;
+
+void mirror_initialize(mirror_t* mirror,
+                       mirror_config_t const* config,
+                       mirror_interface_t const* interface);
+void mirror_deinitialize(mirror_t* mirror);
+
+// Records size bytes of page data flushed starting at column
+void mirror_span(mirror_t* mirror,
+                 size_t page,
+                 size_t column,
+                 uint8_t const* data,
+                 size_t size);
+
+void mirror_start_line(mirror_t* mirror, size_t line);
+
+// Ends the frame if anything changed since the last one and sends the records
+void mirror_frame(mirror_t* mirror);
+
+#endif // MIRROR_MIRROR_H
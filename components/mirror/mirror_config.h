@@ -0,0 +1,36 @@
+#ifndef MIRROR_MIRROR_CONFIG_H
+#define MIRROR_MIRROR_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// record type, page, column and byte count, the numbers little endian
+#define MIRROR_SPAN_HEADER_SIZE (6U)
+#define MIRROR_RUN_MAX (129U)
+#define MIRROR_LITERAL_MAX (128U)
+
+typedef enum {
+    // page data starting at a column, PackBits encoded
+    MIRROR_RECORD_SPAN = 1,
+    // panel row shown on top, 16 bit
+    MIRROR_RECORD_START_LINE = 2,
+    // end of a frame, followed by the 16 bit frame width and height
+    MIRROR_RECORD_FRAME = 3,
+} mirror_record_t;
+
+typedef struct {
+    // records are collected here and sent once it is full or a frame ends
+    uint8_t* buffer;
+    size_t buffer_size;
+
+    size_t frame_width;
+    size_t frame_height;
+} mirror_config_t;
+
+typedef struct {
+    void* sink_user;
+    // called with whole records only
+    void (*sink_write)(void*, uint8_t const*, size_t);
+} mirror_interface_t;
+
+#endif // MIRROR_MIRROR_CONFIG_H
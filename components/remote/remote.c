@@ -0,0 +1,173 @@
+#include "remote.h"
+#include "gfx_draw.h"
+#include "gfx_text.h"
+#include <assert.h>
+#include <string.h>
+
+static inline uint16_t remote_get_u16(uint8_t const* data)
+{
+    return (uint16_t)(data[0] | (data[1] << 8U));
+}
+
+static inline int16_t remote_get_i16(uint8_t const* data)
+{
+    return (int16_t)remote_get_u16(data);
+}
+
+static void remote_flush(remote_t* remote, uint8_t sequence)
+{
+    gfx_flush(remote->config.gfx);
+
+    if (remote->interface.reply) {
+        uint8_t reply[6] = {REMOTE_COMMAND_FLUSH,
+                            sequence,
+                            (uint8_t)remote->executed,
+                            (uint8_t)(remote->executed >> 8U),
+                            (uint8_t)(remote->executed >> 16U),
+                            (uint8_t)(remote->executed >> 24U)};
+        remote->interface.reply(remote->interface.reply_user,
+                                reply,
+                                sizeof(reply));
+    }
+}
+
+// Returns the size of the command at data or 0 if it is malformed or
+// truncated, so nothing is executed past the end
+static size_t remote_get_size(uint8_t const* data, size_t size)
+{
+    switch (data[0]) {
+        case REMOTE_COMMAND_CLEAR: {
+            return 1U;
+        }
+        case REMOTE_COMMAND_PIXEL: {
+            return size >= 6U ? 6U : 0U;
+        }
+        case REMOTE_COMMAND_FILL: {
+            return size >= 10U ? 10U : 0U;
+        }
+        case REMOTE_COMMAND_TEXT: {
+            size_t length = size >= 6U ? 6U + data[5] : 0U;
+            return length <= size ? length : 0U;
+        }
+        case REMOTE_COMMAND_BITMAP: {
+            size_t length =
+                size >= 8U ? 8U + (size_t)remote_get_u16(&data[5]) * data[7]
+                           : 0U;
+            return length <= size ? length : 0U;
+        }
+        case REMOTE_COMMAND_FLUSH: {
+            return size >= 2U ? 2U : 0U;
+        }
+        default: {
+            return 0U;
+        }
+    }
+}
+
+void remote_initialize(remote_t* remote,
+                       remote_config_t const* config,
+                       remote_interface_t const* interface)
+{
+    assert(remote && config && interface && config->gfx);
+
+    memset(remote, 0, sizeof(*remote));
+    memcpy(&remote->config, config, sizeof(*config));
+    memcpy(&remote->interface, interface, sizeof(*interface));
+}
+
+void remote_deinitialize(remote_t* remote)
+{
+    assert(remote);
+
+    memset(remote, 0, sizeof(*remote));
+}
+
+remote_err_t remote_execute(remote_t* remote,
+                            uint8_t const* data,
+                            size_t size)
+{
+    assert(remote && (data || size == 0U));
+
+    gfx_t* gfx = remote->config.gfx;
+
+    while (size > 0U) {
+        size_t command_size = remote_get_size(data, size);
+        if (command_size == 0U) {
+            ++remote->errors;
+            return REMOTE_ERR_FAIL;
+        }
+
+        // every command but clear and flush starts with x and y
+        int16_t x = command_size >= 5U ? remote_get_i16(&data[1]) : 0;
+        int16_t y = command_size >= 5U ? remote_get_i16(&data[3]) : 0;
+
+        switch (data[0]) {
+            case REMOTE_COMMAND_CLEAR: {
+                gfx_clear(gfx);
+                break;
+            }
+            case REMOTE_COMMAND_PIXEL: {
+                gfx_set_pixel(gfx, x, y, data[5] != 0U);
+                break;
+            }
+            case REMOTE_COMMAND_FILL: {
+                gfx_fill_rect(gfx,
+                              x,
+                              y,
+                              remote_get_i16(&data[5]),
+                              remote_get_i16(&data[7]),
+                              data[9] != 0U ? GFX_ROP_SET : GFX_ROP_CLEAR);
+                break;
+            }
+            case REMOTE_COMMAND_TEXT: {
+                gfx_draw_text(gfx,
+                              x,
+                              y,
+                              (char const*)&data[6],
+                              data[5],
+                              GFX_ROP_SET);
+                break;
+            }
+            case REMOTE_COMMAND_BITMAP: {
+                size_t width = remote_get_u16(&data[5]);
+                for (size_t page = 0U; page < data[7]; ++page) {
+                    gfx_draw_columns(
+                        gfx,
+                        x,
+                        (int16_t)(y + (int32_t)(page * GFX_PAGE_HEIGHT)),
+                        &data[8U + page * width],
+                        width,
+                        GFX_ROP_SET);
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+
+        ++remote->executed;
+        if (data[0] == REMOTE_COMMAND_FLUSH) {
+            remote_flush(remote, data[1]);
+        }
+
+        data += command_size;
+        size -= command_size;
+    }
+
+    return REMOTE_ERR_OK;
+}
+
+uint32_t remote_get_executed(remote_t const* remote)
+{
+    assert(remote);
+
+    return remote->executed;
+}
+
+size_t remote_get_errors(remote_t const* remote)
+{
+    assert(remote);
+
+    return remote->errors;
+}
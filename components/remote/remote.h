@@ -0,0 +1,33 @@
+#ifndef REMOTE_REMOTE_H
+#define REMOTE_REMOTE_H
+
+#include "remote_config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Draw commands sent by host tools, see scripts/remote_draw.py. Commands only
+// touch the frame buffer, the panel is updated once per flush command so a
+// whole batch shares one transfer of the merged dirty spans.
+typedef struct {
+    remote_config_t config;
+    remote_interface_t interface;
+
+    uint32_t executed;
+    size_t errors;
+} remote_t;
+
+void remote_initialize(remote_t* remote,
+                       remote_config_t const* config,
+                       remote_interface_t const* interface);
+void remote_deinitialize(remote_t* remote);
+
+// Executes the commands in data where they lie, stops at the first malformed
+// or truncated one
+remote_err_t remote_execute(remote_t* remote,
+                            uint8_t const* data,
+                            size_t size);
+
+uint32_t remote_get_executed(remote_t const* remote);
+size_t remote_get_errors(remote_t const* remote);
+
+#endif // REMOTE_REMOTE_H
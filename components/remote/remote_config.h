@@ -0,0 +1,40 @@
+#ifndef REMOTE_REMOTE_CONFIG_H
+#define REMOTE_REMOTE_CONFIG_H
+
+#include "gfx.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    REMOTE_ERR_OK = 0,
+    REMOTE_ERR_FAIL = 1 << 0,
+    REMOTE_ERR_NULL = 1 << 1,
+} remote_err_t;
+
+// Every command is the opcode followed by its fields, coordinates are signed
+// 16 bit and all numbers little endian
+typedef enum {
+    REMOTE_COMMAND_CLEAR = 1,
+    // x, y, state
+    REMOTE_COMMAND_PIXEL = 2,
+    // x, y, width, height, state
+    REMOTE_COMMAND_FILL = 3,
+    // x, y, length, then length bytes of UTF-8
+    REMOTE_COMMAND_TEXT = 4,
+    // x, y, width, pages, then pages rows of width columns, ORed in
+    REMOTE_COMMAND_BITMAP = 5,
+    // sequence, answered with the sequence and the 32 bit count of commands
+    // executed so far once the frame was sent
+    REMOTE_COMMAND_FLUSH = 6,
+} remote_command_t;
+
+typedef struct {
+    gfx_t* gfx;
+} remote_config_t;
+
+typedef struct {
+    void* reply_user;
+    void (*reply)(void*, uint8_t const*, size_t);
+} remote_interface_t;
+
+#endif // REMOTE_REMOTE_CONFIG_H
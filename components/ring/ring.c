@@ -0,0 +1,190 @@
+#include "ring.h"
+#include <assert.h>
+#include <string.h>
+
+static inline size_t ring_min(size_t left, size_t right)
+{
+    return left < right ? left : right;
+}
+
+void ring_initialize(ring_t* ring, ring_config_t const* config)
+{
+    assert(ring && config && config->buffer);
+    assert(config->size > 0U && (config->size & (config->size - 1U)) == 0U);
+
+    memcpy(&ring->config, config, sizeof(*config));
+    atomic_init(&ring->head, 0U);
+    atomic_init(&ring->tail, 0U);
+    atomic_init(&ring->dropped, 0U);
+}
+
+void ring_deinitialize(ring_t* ring)
+{
+    assert(ring);
+
+    memset(&ring->config, 0, sizeof(ring->config));
+    atomic_store(&ring->head, 0U);
+    atomic_store(&ring->tail, 0U);
+    atomic_store(&ring->dropped, 0U);
+}
+
+size_t ring_write(ring_t* ring, void const* data, size_t size)
+{
+    assert(ring && data);
+
+    size_t mask = ring->config.size - 1U;
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    size_t written = ring_min(size, ring->config.size - (head - tail));
+    size_t offset = head & mask;
+    size_t first = ring_min(written, ring->config.size - offset);
+
+    memcpy(&ring->config.buffer[offset], data, first);
+    memcpy(ring->config.buffer, (uint8_t const*)data + first, written - first);
+
+    atomic_store_explicit(&ring->head, head + written, memory_order_release);
+
+    if (written < size) {
+        atomic_fetch_add_explicit(&ring->dropped,
+                                  size - written,
+                                  memory_order_relaxed);
+    }
+
+    return written;
+}
+
+size_t ring_write_all(ring_t* ring, void const* data, size_t size)
+{
+    assert(ring && data);
+
+    // only the consumer runs concurrently and it can only free more space
+    if (size > ring_get_free(ring)) {
+        atomic_fetch_add_explicit(&ring->dropped, size, memory_order_relaxed);
+        return 0U;
+    }
+
+    return ring_write(ring, data, size);
+}
+
+void ring_commit(ring_t* ring, size_t size)
+{
+    assert(ring && size <= ring_get_free(ring));
+
+    atomic_fetch_add_explicit(&ring->head, size, memory_order_release);
+}
+
+static size_t ring_advance_tail(ring_t* ring, size_t size)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    size_t advanced;
+
+    do {
+        advanced = ring_min(size, head - tail);
+    } while (!atomic_compare_exchange_weak_explicit(&ring->tail,
+                                                    &tail,
+                                                    tail + advanced,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire));
+
+    return advanced;
+}
+
+size_t ring_discard(ring_t* ring, size_t size)
+{
+    assert(ring);
+
+    size_t discarded = ring_advance_tail(ring, size);
+    atomic_fetch_add_explicit(&ring->dropped, discarded, memory_order_relaxed);
+
+    return discarded;
+}
+
+size_t ring_realign(ring_t* ring)
+{
+    assert(ring);
+
+    size_t discarded = ring_discard(ring, SIZE_MAX);
+
+    size_t mask = ring->config.size - 1U;
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head,
+                          (head + mask) & ~mask,
+                          memory_order_release);
+
+    // the skipped bytes were never data, so they are not counted
+    ring_advance_tail(ring, SIZE_MAX);
+
+    return discarded;
+}
+
+size_t ring_read(ring_t* ring, void* data, size_t size)
+{
+    assert(ring && data);
+
+    size_t mask = ring->config.size - 1U;
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    size_t read;
+
+    // a concurrent discard moves the tail, the copy is then stale and redone
+    do {
+        size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        read = ring_min(size, head - tail);
+        size_t offset = tail & mask;
+        size_t first = ring_min(read, ring->config.size - offset);
+
+        memcpy(data, &ring->config.buffer[offset], first);
+        memcpy((uint8_t*)data + first, ring->config.buffer, read - first);
+    } while (!atomic_compare_exchange_weak_explicit(&ring->tail,
+                                                    &tail,
+                                                    tail + read,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire));
+
+    return read;
+}
+
+size_t ring_peek(ring_t* ring, uint8_t const** data)
+{
+    assert(ring && data);
+
+    size_t mask = ring->config.size - 1U;
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t offset = tail & mask;
+
+    *data = &ring->config.buffer[offset];
+
+    return ring_min(head - tail, ring->config.size - offset);
+}
+
+void ring_consume(ring_t* ring, size_t size)
+{
+    assert(ring && size <= ring_get_used(ring));
+
+    atomic_fetch_add_explicit(&ring->tail, size, memory_order_release);
+}
+
+size_t ring_get_used(ring_t* ring)
+{
+    assert(ring);
+
+    return atomic_load_explicit(&ring->head, memory_order_acquire) -
+           atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
+
+size_t ring_get_free(ring_t* ring)
+{
+    assert(ring);
+
+    return ring->config.size - ring_get_used(ring);
+}
+
+size_t ring_get_dropped(ring_t* ring)
+{
+    assert(ring);
+
+    return atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+}
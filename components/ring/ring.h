@@ -0,0 +1,60 @@
+#ifndef RING_RING_H
+#define RING_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint8_t* buffer;
+    // must be a power of two
+    size_t size;
+} ring_config_t;
+
+// Single producer, single consumer byte queue. Head and tail run freely, the
+// head is only advanced by the producer, the tail by the consumer and by
+// ring_discard, so no locks are needed.
+typedef struct {
+    ring_config_t config;
+
+    atomic_size_t head;
+    atomic_size_t tail;
+    atomic_size_t dropped;
+} ring_t;
+
+void ring_initialize(ring_t* ring, ring_config_t const* config);
+void ring_deinitialize(ring_t* ring);
+
+// Producer side, never blocks, bytes that do not fit are dropped and counted
+size_t ring_write(ring_t* ring, void const* data, size_t size);
+
+// Producer side, never blocks, writes all size bytes or, if they do not fit,
+// drops and counts all of them, so that records are never cut
+size_t ring_write_all(ring_t* ring, void const* data, size_t size);
+
+// Producer side, publishes size bytes already placed into the buffer in front
+// of the head, e.g. by DMA
+void ring_commit(ring_t* ring, size_t size);
+
+// Producer side, drops up to size of the oldest unread bytes and counts them
+size_t ring_discard(ring_t* ring, size_t size);
+
+// Producer side, drops every unread byte and moves the head to the start of
+// the buffer, for producers that restart there. Must not be interrupted by the
+// consumer.
+size_t ring_realign(ring_t* ring);
+
+// Consumer side, copies out up to size bytes, safe against ring_discard
+size_t ring_read(ring_t* ring, void* data, size_t size);
+
+// Consumer side, exposes the longest contiguous readable run without copying,
+// must not be mixed with ring_discard
+size_t ring_peek(ring_t* ring, uint8_t const** data);
+void ring_consume(ring_t* ring, size_t size);
+
+size_t ring_get_used(ring_t* ring);
+size_t ring_get_free(ring_t* ring);
+size_t ring_get_dropped(ring_t* ring);
+
+#endif // RING_RING_H
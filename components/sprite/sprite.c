@@ -0,0 +1,323 @@
+#include "sprite.h"
+#include <assert.h>
+#include <string.h>
+
+static size_t sprite_get_save_size(gfx_bitmap_t const* image)
+{
+    // an image that does not start on a page boundary reaches one page further
+    return image->width * ((image->height + 2U * GFX_PAGE_HEIGHT - 2U) /
+                           GFX_PAGE_HEIGHT);
+}
+
+static sprite_slot_t* sprite_get_slot(sprite_t* sprite, size_t id)
+{
+    if (id >= sprite->count || !sprite->config.slots[id].used) {
+        return NULL;
+    }
+
+    return &sprite->config.slots[id];
+}
+
+// Empty for hidden sprites and those outside the frame buffer
+static sprite_area_t sprite_get_area(sprite_t const* sprite,
+                                     sprite_slot_t const* slot)
+{
+    gfx_t const* gfx = sprite->config.gfx;
+    sprite_area_t area = {0};
+
+    if (!slot->used || !slot->visible) {
+        return area;
+    }
+
+    int32_t left = slot->x > 0 ? slot->x : 0;
+    int32_t right = slot->x + (int32_t)slot->image->width;
+    if (right > (int32_t)gfx->config.frame_width) {
+        right = (int32_t)gfx->config.frame_width;
+    }
+    int32_t top = slot->y > 0 ? slot->y : 0;
+    int32_t bottom = slot->y + (int32_t)slot->image->height;
+    if (bottom > (int32_t)gfx->config.frame_height) {
+        bottom = (int32_t)gfx->config.frame_height;
+    }
+
+    if (left < right && top < bottom) {
+        area.x = (int16_t)left;
+        area.width = (int16_t)(right - left);
+        area.page = (int16_t)(top / (int32_t)GFX_PAGE_HEIGHT);
+        area.pages =
+            (int16_t)((bottom - 1) / (int32_t)GFX_PAGE_HEIGHT - area.page + 1);
+    }
+
+    return area;
+}
+
+static bool sprite_overlaps(sprite_area_t const* a, sprite_area_t const* b)
+{
+    return a->width > 0 && b->width > 0 && a->x < b->x + b->width &&
+           b->x < a->x + a->width && a->page < b->page + b->pages &&
+           b->page < a->page + a->pages;
+}
+
+static void sprite_take_off(sprite_t* sprite, sprite_slot_t* slot)
+{
+    sprite_area_t const* area = &slot->saved;
+
+    if (area->width > 0) {
+        gfx_bitmap_t saved = {
+            .data = slot->save,
+            .width = (size_t)area->width,
+            .height = (size_t)area->pages * GFX_PAGE_HEIGHT,
+        };
+        gfx_blit(sprite->config.gfx,
+                 area->x,
+                 (int16_t)(area->page * (int16_t)GFX_PAGE_HEIGHT),
+                 &saved,
+                 0,
+                 0,
+                 (int16_t)saved.width,
+                 (int16_t)saved.height,
+                 GFX_ROP_COPY);
+    }
+
+    slot->drawn = false;
+}
+
+static void sprite_draw(sprite_t* sprite, sprite_slot_t* slot)
+{
+    gfx_t* gfx = sprite->config.gfx;
+    sprite_area_t area = sprite_get_area(sprite, slot);
+
+    if (area.width > 0) {
+        gfx_bitmap_t frame = gfx_get_frame(gfx);
+        int16_t height = (int16_t)(area.pages * (int16_t)GFX_PAGE_HEIGHT);
+
+        gfx_blit_buffer(slot->save,
+                        (size_t)area.width,
+                        (size_t)height,
+                        0,
+                        0,
+                        &frame,
+                        area.x,
+                        (int16_t)(area.page * (int16_t)GFX_PAGE_HEIGHT),
+                        area.width,
+                        height,
+                        GFX_ROP_COPY);
+
+        int16_t width = (int16_t)slot->image->width;
+        height = (int16_t)slot->image->height;
+        if (slot->mask) {
+            gfx_blit(gfx,
+                     slot->x,
+                     slot->y,
+                     slot->mask,
+                     0,
+                     0,
+                     width,
+                     height,
+                     GFX_ROP_CLEAR);
+        }
+        gfx_blit(
+            gfx, slot->x, slot->y, slot->image, 0, 0, width, height, slot->rop);
+    }
+
+    slot->saved = area;
+    slot->drawn = true;
+}
+
+void sprite_initialize(sprite_t* sprite, sprite_config_t const* config)
+{
+    assert(sprite && config && config->gfx && config->slots);
+    assert(config->save_buffer || config->save_buffer_size == 0U);
+
+    memset(sprite, 0, sizeof(*sprite));
+    memcpy(&sprite->config, config, sizeof(*config));
+    memset(config->slots, 0, config->capacity * sizeof(*config->slots));
+}
+
+void sprite_deinitialize(sprite_t* sprite)
+{
+    assert(sprite);
+
+    memset(sprite, 0, sizeof(*sprite));
+}
+
+sprite_err_t sprite_add(sprite_t* sprite,
+                        gfx_bitmap_t const* image,
+                        gfx_bitmap_t const* mask,
+                        gfx_rop_t rop,
+                        size_t* id)
+{
+    assert(sprite && image && id);
+    assert(!mask ||
+           (mask->width == image->width && mask->height == image->height));
+
+    sprite_slot_t* slots = sprite->config.slots;
+    size_t save_size = sprite_get_save_size(image);
+    sprite_slot_t* slot = NULL;
+
+    // a removed sprite gives its slot back once the update took it off
+    for (size_t index = 0U; index < sprite->count; ++index) {
+        if (!slots[index].used && !slots[index].drawn &&
+            slots[index].save_size >= save_size) {
+            slot = &slots[index];
+            *id = index;
+            break;
+        }
+    }
+
+    if (!slot) {
+        if (sprite->count == sprite->config.capacity ||
+            save_size > sprite->config.save_buffer_size - sprite->save_used) {
+            return SPRITE_ERR_FAIL;
+        }
+
+        slot = &slots[sprite->count];
+        slot->save = &sprite->config.save_buffer[sprite->save_used];
+        slot->save_size = save_size;
+        sprite->save_used += save_size;
+        *id = sprite->count++;
+    }
+
+    slot->image = image;
+    slot->mask = mask;
+    slot->rop = rop;
+    slot->x = 0;
+    slot->y = 0;
+    slot->visible = false;
+    slot->changed = false;
+    slot->used = true;
+
+    return SPRITE_ERR_OK;
+}
+
+sprite_err_t sprite_remove(sprite_t* sprite, size_t id)
+{
+    assert(sprite);
+
+    sprite_slot_t* slot = sprite_get_slot(sprite, id);
+    if (!slot) {
+        return SPRITE_ERR_FAIL;
+    }
+
+    slot->used = false;
+    slot->visible = false;
+    slot->changed = true;
+
+    return SPRITE_ERR_OK;
+}
+
+sprite_err_t sprite_move(sprite_t* sprite, size_t id, int16_t x, int16_t y)
+{
+    assert(sprite);
+
+    sprite_slot_t* slot = sprite_get_slot(sprite, id);
+    if (!slot) {
+        return SPRITE_ERR_FAIL;
+    }
+
+    if (slot->x != x || slot->y != y) {
+        slot->x = x;
+        slot->y = y;
+        slot->changed = true;
+    }
+
+    return SPRITE_ERR_OK;
+}
+
+sprite_err_t sprite_set_visible(sprite_t* sprite, size_t id, bool visible)
+{
+    assert(sprite);
+
+    sprite_slot_t* slot = sprite_get_slot(sprite, id);
+    if (!slot) {
+        return SPRITE_ERR_FAIL;
+    }
+
+    if (slot->visible != visible) {
+        slot->visible = visible;
+        slot->changed = true;
+    }
+
+    return SPRITE_ERR_OK;
+}
+
+sprite_err_t sprite_set_image(sprite_t* sprite,
+                              size_t id,
+                              gfx_bitmap_t const* image,
+                              gfx_bitmap_t const* mask)
+{
+    assert(sprite && image);
+    assert(!mask ||
+           (mask->width == image->width && mask->height == image->height));
+
+    sprite_slot_t* slot = sprite_get_slot(sprite, id);
+    if (!slot || sprite_get_save_size(image) > slot->save_size) {
+        return SPRITE_ERR_FAIL;
+    }
+
+    slot->image = image;
+    slot->mask = mask;
+    slot->changed = true;
+
+    return SPRITE_ERR_OK;
+}
+
+void sprite_update(sprite_t* sprite)
+{
+    assert(sprite);
+
+    sprite_slot_t* slots = sprite->config.slots;
+
+    // what a sprite covered or will cover may lie under sprites above it,
+    // those have to come off first and go back on after it. Marks only
+    // spread upwards, so one pass in drawing order finds them all.
+    for (size_t index = 0U; index < sprite->count; ++index) {
+        if (!slots[index].changed) {
+            continue;
+        }
+
+        sprite_area_t old_area =
+            slots[index].drawn ? slots[index].saved : (sprite_area_t){0};
+        sprite_area_t new_area = sprite_get_area(sprite, &slots[index]);
+
+        for (size_t above = index + 1U; above < sprite->count; ++above) {
+            sprite_slot_t* slot = &slots[above];
+            if (slot->drawn && !slot->changed &&
+                (sprite_overlaps(&slot->saved, &old_area) ||
+                 sprite_overlaps(&slot->saved, &new_area))) {
+                slot->changed = true;
+            }
+        }
+    }
+
+    for (size_t index = sprite->count; index-- > 0U;) {
+        if (slots[index].changed && slots[index].drawn) {
+            sprite_take_off(sprite, &slots[index]);
+        }
+    }
+
+    for (size_t index = 0U; index < sprite->count; ++index) {
+        if (!slots[index].changed) {
+            continue;
+        }
+
+        slots[index].changed = false;
+        if (slots[index].used && slots[index].visible) {
+            sprite_draw(sprite, &slots[index]);
+        }
+    }
+}
+
+void sprite_restore(sprite_t* sprite)
+{
+    assert(sprite);
+
+    sprite_slot_t* slots = sprite->config.slots;
+
+    for (size_t index = sprite->count; index-- > 0U;) {
+        if (slots[index].drawn) {
+            sprite_take_off(sprite, &slots[index]);
+            slots[index].changed = true;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef SPRITE_SPRITE_H
+#define SPRITE_SPRITE_H
+
+#include "sprite_config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Sprites over a background that stays in the frame buffer. Every drawn
+// sprite keeps the bytes it covers and puts them back when it moves, so
+// only its old and new pages are touched and marked dirty. Changes are
+// collected and applied by sprite_update, the caller flushes after that.
+typedef struct {
+    sprite_config_t config;
+
+    // slots handed out so far, each keeps its part of the save buffer
+    size_t count;
+    size_t save_used;
+} sprite_t;
+
+void sprite_initialize(sprite_t* sprite, sprite_config_t const* config);
+void sprite_deinitialize(sprite_t* sprite);
+
+// Takes a slot for a hidden sprite, the image and mask must stay valid and
+// be of the same size. Fails once the slots or the save buffer run out.
+sprite_err_t sprite_add(sprite_t* sprite,
+                        gfx_bitmap_t const* image,
+                        gfx_bitmap_t const* mask,
+                        gfx_rop_t rop,
+                        size_t* id);
+sprite_err_t sprite_remove(sprite_t* sprite, size_t id);
+
+sprite_err_t sprite_move(sprite_t* sprite, size_t id, int16_t x, int16_t y);
+sprite_err_t sprite_set_visible(sprite_t* sprite, size_t id, bool visible);
+// Fails if the new image needs more save bytes than the slot got
+sprite_err_t sprite_set_image(sprite_t* sprite,
+                              size_t id,
+                              gfx_bitmap_t const* image,
+                              gfx_bitmap_t const* mask);
+
+// Takes changed sprites off and draws them where they are now. Sprites on
+// top of one that changed come off first and are drawn again after it.
+void sprite_update(sprite_t* sprite);
+
+// Takes every sprite off so the background can be drawn, the next update
+// draws them again over it
+void sprite_restore(sprite_t* sprite);
+
+#endif // SPRITE_SPRITE_H
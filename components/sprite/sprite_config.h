@@ -0,0 +1,57 @@
+#ifndef SPRITE_SPRITE_CONFIG_H
+#define SPRITE_SPRITE_CONFIG_H
+
+#include "gfx.h"
+#include "gfx_blit.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    SPRITE_ERR_OK = 0,
+    SPRITE_ERR_FAIL = 1 << 0,
+    SPRITE_ERR_NULL = 1 << 1,
+} sprite_err_t;
+
+// Frame buffer bytes a sprite covers, whole pages of the columns it spans
+typedef struct {
+    int16_t x;
+    int16_t page;
+    int16_t width;
+    int16_t pages;
+} sprite_area_t;
+
+typedef struct {
+    gfx_bitmap_t const* image;
+    // optional, its set pixels are cleared before the image is drawn, which
+    // makes the sprite opaque there and transparent elsewhere
+    gfx_bitmap_t const* mask;
+    gfx_rop_t rop;
+    int16_t x;
+    int16_t y;
+    bool visible;
+
+    bool used;
+    // waits for the next update to be taken off and drawn again
+    bool changed;
+    // the sprite is in the frame buffer and save holds what it covers
+    bool drawn;
+    sprite_area_t saved;
+    uint8_t* save;
+    size_t save_size;
+} sprite_slot_t;
+
+typedef struct {
+    gfx_t* gfx;
+
+    // later slots are drawn on top of earlier ones
+    sprite_slot_t* slots;
+    size_t capacity;
+
+    // shared by the slots, each takes the width times the pages the image
+    // can span, which is (height + 14) / 8
+    uint8_t* save_buffer;
+    size_t save_buffer_size;
+} sprite_config_t;
+
+#endif // SPRITE_SPRITE_CONFIG_H
@@ -0,0 +1,59 @@
+#include "trace.h"
+#include <assert.h>
+#include <string.h>
+
+// marker plus identifier and arguments of at most five LEB128 bytes each
+#define TRACE_RECORD_SIZE (1U + 5U * (1U + TRACE_MAX_ARGUMENTS))
+
+static inline size_t trace_encode(uint8_t* buffer, uint32_t value)
+{
+    size_t size = 0U;
+
+    while (value >= 0x80U) {
+        buffer[size++] = (uint8_t)(value | 0x80U);
+        value >>= 7U;
+    }
+    buffer[size++] = (uint8_t)value;
+
+    return size;
+}
+
+void trace_initialize(trace_t* trace, trace_interface_t const* interface)
+{
+    assert(trace && interface);
+
+    memset(trace, 0, sizeof(*trace));
+    memcpy(&trace->interface, interface, sizeof(*interface));
+}
+
+void trace_deinitialize(trace_t* trace)
+{
+    assert(trace);
+
+    memset(trace, 0, sizeof(*trace));
+}
+
+void trace_write(trace_t* trace,
+                 char const* format,
+                 uint32_t const* arguments,
+                 size_t count)
+{
+    assert(trace && format && (arguments || count == 0U));
+    assert(count <= TRACE_MAX_ARGUMENTS);
+
+    if (trace->interface.sink_write == NULL) {
+        return;
+    }
+
+    uint8_t record[TRACE_RECORD_SIZE];
+    size_t size = 0U;
+
+    record[size++] = (uint8_t)(TRACE_RECORD_MARKER + count);
+    size += trace_encode(&record[size], (uint32_t)(uintptr_t)format);
+
+    for (size_t index = 0U; index < count; ++index) {
+        size += trace_encode(&record[size], arguments[index]);
+    }
+
+    trace->interface.sink_write(trace->interface.sink_user, record, size);
+}
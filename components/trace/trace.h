@@ -0,0 +1,91 @@
+#ifndef TRACE_TRACE_H
+#define TRACE_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRACE_MAX_ARGUMENTS (6U)
+
+// Never part of UTF-8, so records can share a stream with plain text, the
+// marker of a record is this plus its argument count, up to 0xFE
+#define TRACE_RECORD_MARKER (0xF8U)
+
+typedef struct {
+    void* sink_user;
+    // must not block, called with one complete record at a time, which has
+    // to be queued whole or dropped whole for the decoder to stay in step
+    void (*sink_write)(void*, uint8_t const*, size_t);
+} trace_interface_t;
+
+// Binary log, a record is the marker, the format string identifier and the
+// arguments, all but the marker as LEB128. The marker carries the argument
+// count, so the decoder stays in step and can tell when it does not match
+// the conversions of the format. The format strings themselves are
+// kept in the non-loaded .trace_strings section, the identifier is their
+// address there and scripts/decode_trace.py formats them on the host.
+typedef struct {
+    trace_interface_t interface;
+} trace_t;
+
+void trace_initialize(trace_t* trace, trace_interface_t const* interface);
+void trace_deinitialize(trace_t* trace);
+
+void trace_write(trace_t* trace,
+                 char const* format,
+                 uint32_t const* arguments,
+                 size_t count);
+
+#define TRACE_SELECT(_1, _2, _3, _4, _5, _6, _7, name, ...) name
+
+// The macros below never leave a variadic parameter empty, which ISO C does
+// not allow before C23 and __VA_OPT__ would otherwise paper over
+#define TRACE_FORMAT(format, ...) format
+
+#define TRACE_COUNT(...) TRACE_SELECT(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0, )
+
+#define TRACE_CAST_1(argument) ((uint32_t)(argument))
+#define TRACE_CAST_2(argument, ...) \
+    TRACE_CAST_1(argument), TRACE_CAST_1(__VA_ARGS__)
+#define TRACE_CAST_3(argument, ...) \
+    TRACE_CAST_1(argument), TRACE_CAST_2(__VA_ARGS__)
+#define TRACE_CAST_4(argument, ...) \
+    TRACE_CAST_1(argument), TRACE_CAST_3(__VA_ARGS__)
+#define TRACE_CAST_5(argument, ...) \
+    TRACE_CAST_1(argument), TRACE_CAST_4(__VA_ARGS__)
+#define TRACE_CAST_6(argument, ...) \
+    TRACE_CAST_1(argument), TRACE_CAST_5(__VA_ARGS__)
+
+// The leading zero only keeps the argument array from being empty
+#define TRACE_ARGUMENTS_0(format) 0U
+#define TRACE_ARGUMENTS_1(format, ...) 0U, TRACE_CAST_1(__VA_ARGS__)
+#define TRACE_ARGUMENTS_2(format, ...) 0U, TRACE_CAST_2(__VA_ARGS__)
+#define TRACE_ARGUMENTS_3(format, ...) 0U, TRACE_CAST_3(__VA_ARGS__)
+#define TRACE_ARGUMENTS_4(format, ...) 0U, TRACE_CAST_4(__VA_ARGS__)
+#define TRACE_ARGUMENTS_5(format, ...) 0U, TRACE_CAST_5(__VA_ARGS__)
+#define TRACE_ARGUMENTS_6(format, ...) 0U, TRACE_CAST_6(__VA_ARGS__)
+
+#define TRACE_ARGUMENTS(...)        \
+    TRACE_SELECT(__VA_ARGS__,       \
+                 TRACE_ARGUMENTS_6, \
+                 TRACE_ARGUMENTS_5, \
+                 TRACE_ARGUMENTS_4, \
+                 TRACE_ARGUMENTS_3, \
+                 TRACE_ARGUMENTS_2, \
+                 TRACE_ARGUMENTS_1, \
+                 TRACE_ARGUMENTS_0, )(__VA_ARGS__)
+
+// Logs a format followed by up to TRACE_MAX_ARGUMENTS integer arguments, each
+// truncated to 32 bits, the format supports the d, i, u, x, X, c and p
+// conversions
+#define TRACE(trace, ...)                                                 \
+    do {                                                                  \
+        static char const trace_format[]                                  \
+            __attribute__((section(".trace_strings"), used)) =            \
+                TRACE_FORMAT(__VA_ARGS__, );                              \
+        trace_write((trace),                                              \
+                    trace_format,                                         \
+                    (uint32_t const[]){TRACE_ARGUMENTS(__VA_ARGS__)} + 1, \
+                    TRACE_COUNT(__VA_ARGS__));                            \
+    } while (0)
+
+#endif // TRACE_TRACE_H
@@ -0,0 +1,281 @@
+#include "uart.h"
+#include <assert.h>
+#include <string.h>
+
+static inline void uart_lock(uart_t const* uart)
+{
+    if (uart->interface.lock) {
+        uart->interface.lock(uart->interface.bus_user);
+    }
+}
+
+static inline void uart_unlock(uart_t const* uart)
+{
+    if (uart->interface.unlock) {
+        uart->interface.unlock(uart->interface.bus_user);
+    }
+}
+
+// Whoever wins tx_busy owns the staging chunk until the transfer completes
+static void uart_transmit_next(uart_t* uart)
+{
+    bool idle = false;
+
+    while (ring_get_used(&uart->tx_ring) > 0U &&
+           atomic_compare_exchange_strong(&uart->tx_busy, &idle, true)) {
+        size_t size =
+            ring_read(&uart->tx_ring, uart->tx_chunk, sizeof(uart->tx_chunk));
+
+        if (size > 0U && uart->interface.bus_transmit &&
+            uart->interface.bus_transmit(uart->interface.bus_user,
+                                         uart->tx_chunk,
+                                         size) == UART_ERR_OK) {
+            return;
+        }
+
+        atomic_store(&uart->tx_busy, false);
+        idle = false;
+
+        // a failing bus would spin forever, the chunk is lost instead and the
+        // rest waits for the next write or drain
+        if (size > 0U) {
+            atomic_fetch_add_explicit(&uart->tx_ring.dropped,
+                                      size,
+                                      memory_order_relaxed);
+            atomic_store(&uart->tx_failed, true);
+            return;
+        }
+    }
+}
+
+static size_t uart_queue(uart_t* uart, uint8_t const* data, size_t size)
+{
+    ring_t* ring = &uart->tx_ring;
+
+    switch (uart->config.overflow) {
+        case UART_OVERFLOW_BLOCK: {
+            size_t free = ring_get_free(ring);
+            return ring_write(ring, data, size < free ? size : free);
+        }
+        case UART_OVERFLOW_OVERWRITE: {
+            // only the newest bytes can survive a write larger than the ring
+            if (size > ring->config.size) {
+                atomic_fetch_add_explicit(&ring->dropped,
+                                          size - ring->config.size,
+                                          memory_order_relaxed);
+                data += size - ring->config.size;
+                size = ring->config.size;
+            }
+
+            size_t free = ring_get_free(ring);
+            if (size > free) {
+                ring_discard(ring, size - free);
+            }
+            return ring_write(ring, data, size);
+        }
+        default: {
+            return ring_write(ring, data, size);
+        }
+    }
+}
+
+void uart_initialize(uart_t* uart,
+                     uart_config_t const* config,
+                     uart_interface_t const* interface)
+{
+    assert(uart && config && interface && config->tx_buffer);
+    assert((interface->lock == NULL) == (interface->unlock == NULL));
+
+    memset(uart, 0, sizeof(*uart));
+    memcpy(&uart->config, config, sizeof(*config));
+    memcpy(&uart->interface, interface, sizeof(*interface));
+
+    ring_initialize(&uart->tx_ring,
+                    &(ring_config_t){.buffer = config->tx_buffer,
+                                     .size = config->tx_buffer_size});
+    atomic_init(&uart->tx_busy, false);
+    atomic_init(&uart->tx_failed, false);
+
+    if (config->rx_buffer) {
+        ring_initialize(&uart->rx_ring,
+                        &(ring_config_t){.buffer = config->rx_buffer,
+                                         .size = config->rx_buffer_size});
+    }
+}
+
+void uart_deinitialize(uart_t* uart)
+{
+    assert(uart);
+
+    ring_deinitialize(&uart->tx_ring);
+    ring_deinitialize(&uart->rx_ring);
+    memset(&uart->config, 0, sizeof(uart->config));
+    memset(&uart->interface, 0, sizeof(uart->interface));
+}
+
+size_t uart_write(uart_t* uart, void const* data, size_t size)
+{
+    assert(uart && data);
+
+    uint8_t const* bytes = (uint8_t const*)data;
+    size_t queued = 0U;
+
+    do {
+        uart_lock(uart);
+        size_t written = uart_queue(uart, bytes + queued, size - queued);
+        uart_unlock(uart);
+
+        queued += written;
+        uart_transmit_next(uart);
+    } while (uart->config.overflow == UART_OVERFLOW_BLOCK && queued < size);
+
+    return queued;
+}
+
+size_t uart_write_all(uart_t* uart, void const* data, size_t size)
+{
+    assert(uart && data);
+
+    if (uart->config.overflow == UART_OVERFLOW_BLOCK) {
+        return uart_write(uart, data, size);
+    }
+
+    // overwriting keeps only the newest bytes of a write larger than the ring
+    uart_lock(uart);
+    size_t queued = uart->config.overflow == UART_OVERFLOW_DROP ||
+                            size > uart->tx_ring.config.size
+                        ? ring_write_all(&uart->tx_ring, data, size)
+                        : uart_queue(uart, data, size);
+    uart_unlock(uart);
+
+    uart_transmit_next(uart);
+
+    return queued;
+}
+
+void uart_transmit_complete(uart_t* uart)
+{
+    assert(uart);
+
+    atomic_store(&uart->tx_busy, false);
+    uart_transmit_next(uart);
+}
+
+uart_err_t uart_receive_start(uart_t* uart)
+{
+    assert(uart && uart->config.rx_buffer);
+
+    if (uart->interface.bus_receive == NULL) {
+        return UART_ERR_NULL;
+    }
+
+    // the bus restarts at the beginning of the buffer
+    ring_t* ring = &uart->rx_ring;
+    ring_realign(ring);
+    uart->rx_offset = 0U;
+
+    return uart->interface.bus_receive(uart->interface.bus_user,
+                                       ring->config.buffer,
+                                       ring->config.size);
+}
+
+void uart_receive_event(uart_t* uart, size_t position)
+{
+    assert(uart && uart->config.rx_buffer);
+
+    ring_t* ring = &uart->rx_ring;
+    size_t mask = ring->config.size - 1U;
+    size_t offset = position & mask;
+    size_t received = (offset - uart->rx_offset) & mask;
+
+    size_t free = ring_get_free(ring);
+    if (received > free) {
+        ring_discard(ring, received - free);
+    }
+
+    ring_commit(ring, received);
+    uart->rx_offset = offset;
+}
+
+size_t uart_read(uart_t* uart, void* data, size_t size)
+{
+    assert(uart && data && uart->config.rx_buffer);
+
+    return ring_read(&uart->rx_ring, data, size);
+}
+
+bool uart_read_line(uart_t* uart, char const** line, size_t* length)
+{
+    assert(uart && line && length && uart->config.rx_buffer);
+    assert(uart->config.rx_line_buffer &&
+           uart->config.rx_line_buffer_size > 1U);
+
+    char* buffer = uart->config.rx_line_buffer;
+
+    if (uart->rx_line_complete) {
+        uart->rx_line_complete = false;
+        uart->rx_line_length = 0U;
+    }
+
+    uint8_t byte;
+    while (ring_read(&uart->rx_ring, &byte, 1U) > 0U) {
+        bool carriage_return = uart->rx_line_carriage_return;
+        uart->rx_line_carriage_return = byte == '\r';
+
+        if (byte == '\n' && carriage_return) {
+            continue;
+        }
+
+        if (byte == '\r' || byte == '\n') {
+            uart->rx_line_complete = true;
+        } else {
+            buffer[uart->rx_line_length++] = (char)byte;
+            uart->rx_line_complete =
+                uart->rx_line_length + 1U >= uart->config.rx_line_buffer_size;
+        }
+
+        if (uart->rx_line_complete) {
+            buffer[uart->rx_line_length] = '\0';
+            *line = buffer;
+            *length = uart->rx_line_length;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t uart_get_receive_dropped(uart_t* uart)
+{
+    assert(uart);
+
+    return ring_get_dropped(&uart->rx_ring);
+}
+
+uart_err_t uart_drain(uart_t* uart)
+{
+    assert(uart);
+
+    uint32_t (*get_tick)(void*) = uart->interface.get_tick;
+    uint32_t start = get_tick ? get_tick(uart->interface.bus_user) : 0U;
+
+    while (ring_get_used(&uart->tx_ring) > 0U ||
+           atomic_load(&uart->tx_busy)) {
+        uart_transmit_next(uart);
+
+        if (get_tick && get_tick(uart->interface.bus_user) - start >=
+                            uart->config.drain_timeout) {
+            return UART_ERR_FAIL;
+        }
+    }
+
+    return atomic_exchange(&uart->tx_failed, false) ? UART_ERR_FAIL
+                                                    : UART_ERR_OK;
+}
+
+size_t uart_get_dropped(uart_t* uart)
+{
+    assert(uart);
+
+    return ring_get_dropped(&uart->tx_ring);
+}
@@ -0,0 +1,74 @@
+#ifndef UART_UART_H
+#define UART_UART_H
+
+#include "ring.h"
+#include "uart_config.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Queued transmitter, writes return as soon as the bytes are in the ring and
+// the transfers are chained from the completion interrupt
+typedef struct {
+    uart_config_t config;
+    uart_interface_t interface;
+
+    ring_t tx_ring;
+    atomic_bool tx_busy;
+    // set when the bus refused a transfer, uart_drain reports it
+    atomic_bool tx_failed;
+    // transfers are staged, so overwriting never races the running transfer
+    uint8_t tx_chunk[UART_TX_CHUNK_SIZE];
+
+    // the receive buffer doubles as ring storage, the bus is its producer
+    ring_t rx_ring;
+    size_t rx_offset;
+    size_t rx_line_length;
+    bool rx_line_complete;
+    bool rx_line_carriage_return;
+} uart_t;
+
+void uart_initialize(uart_t* uart,
+                     uart_config_t const* config,
+                     uart_interface_t const* interface);
+void uart_deinitialize(uart_t* uart);
+
+// Queues size bytes and returns how many were queued, never waits unless the
+// overflow policy is UART_OVERFLOW_BLOCK, which must not be used from
+// interrupts
+size_t uart_write(uart_t* uart, void const* data, size_t size);
+
+// Queues all size bytes or none of them and returns how many were queued, for
+// framed producers whose records must not be cut. Waits like uart_write under
+// UART_OVERFLOW_BLOCK.
+size_t uart_write_all(uart_t* uart, void const* data, size_t size);
+
+// Reports the end of the running transfer, meant for the completion interrupt
+void uart_transmit_complete(uart_t* uart);
+
+// (Re)arms reception, anything not yet read is lost
+uart_err_t uart_receive_start(uart_t* uart);
+
+// Reports that the bus filled the receive buffer up to position, meant for
+// the receive event interrupt. Bytes overrun before being read are dropped.
+void uart_receive_event(uart_t* uart, size_t position);
+
+// Copies out up to size received bytes, never waits
+size_t uart_read(uart_t* uart, void* data, size_t size);
+
+// Assembles received bytes into the line buffer and returns true once a line
+// ended with CR, LF or CRLF, or filled the buffer. The NUL terminated line,
+// without its terminator, stays valid until the next call.
+bool uart_read_line(uart_t* uart, char const** line, size_t* length);
+
+size_t uart_get_receive_dropped(uart_t* uart);
+
+// Waits until every queued byte has been sent, restarting the transmitter if
+// a refused transfer left it idle. Fails once drain_timeout passed or if the
+// bus refused a transfer since the last drain, its bytes are lost.
+uart_err_t uart_drain(uart_t* uart);
+
+size_t uart_get_dropped(uart_t* uart);
+
+#endif // UART_UART_H
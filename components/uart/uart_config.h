@@ -0,0 +1,60 @@
+#ifndef UART_UART_CONFIG_H
+#define UART_UART_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define UART_TX_CHUNK_SIZE (64U)
+
+typedef enum {
+    UART_ERR_OK = 0,
+    UART_ERR_FAIL = 1 << 0,
+    UART_ERR_NULL = 1 << 1,
+} uart_err_t;
+
+typedef enum {
+    // bytes that do not fit are lost
+    UART_OVERFLOW_DROP,
+    // the writer spins until the transmitter made room
+    UART_OVERFLOW_BLOCK,
+    // the oldest queued bytes are lost in favour of the new ones
+    UART_OVERFLOW_OVERWRITE,
+} uart_overflow_t;
+
+typedef struct {
+    uint8_t* tx_buffer;
+    // must be a power of two
+    size_t tx_buffer_size;
+    uart_overflow_t overflow;
+
+    // optional, filled circularly by the bus, must be a power of two
+    uint8_t* rx_buffer;
+    size_t rx_buffer_size;
+
+    // optional, assembles received bytes for uart_read_line
+    char* rx_line_buffer;
+    size_t rx_line_buffer_size;
+
+    // milliseconds uart_drain waits at most, measured with get_tick
+    uint32_t drain_timeout;
+} uart_config_t;
+
+typedef struct {
+    void* bus_user;
+    // starts an asynchronous transfer, its completion must be reported with
+    // uart_transmit_complete
+    uart_err_t (*bus_transmit)(void*, uint8_t const*, size_t);
+    // arms endless circular reception into the buffer, progress must be
+    // reported with uart_receive_event
+    uart_err_t (*bus_receive)(void*, uint8_t*, size_t);
+
+    // optional, make uart_write safe to call from several contexts at once
+    void (*lock)(void*);
+    void (*unlock)(void*);
+
+    // optional, millisecond tick bounding uart_drain, without it only a
+    // transfer that never completes keeps uart_drain waiting
+    uint32_t (*get_tick)(void*);
+} uart_interface_t;
+
+#endif // UART_UART_CONFIG_H
@@ -0,0 +1,137 @@
+#include "video.h"
+#include <assert.h>
+#include <string.h>
+
+static void video_mark_dirty(video_t* video, size_t offset, size_t size)
+{
+    gfx_t* gfx = video->config.gfx;
+    size_t width = gfx->config.frame_width;
+
+    while (size > 0U) {
+        size_t column = offset % width;
+        size_t count = width - column < size ? width - column : size;
+
+        gfx_mark_dirty(gfx,
+                       (int16_t)column,
+                       (int16_t)((offset / width) * GFX_PAGE_HEIGHT),
+                       (int16_t)count,
+                       (int16_t)GFX_PAGE_HEIGHT);
+
+        offset += count;
+        size -= count;
+    }
+}
+
+static video_err_t video_lose_sync(video_t* video)
+{
+    video->synchronized = false;
+    ++video->errors;
+
+    return VIDEO_ERR_FAIL;
+}
+
+void video_initialize(video_t* video, video_config_t const* config)
+{
+    assert(video && config && config->gfx);
+
+    memset(video, 0, sizeof(*video));
+    memcpy(&video->config, config, sizeof(*config));
+}
+
+void video_deinitialize(video_t* video)
+{
+    assert(video);
+
+    memset(video, 0, sizeof(*video));
+}
+
+video_err_t video_decode(video_t* video, uint8_t const* data, size_t size)
+{
+    assert(video && (data || size == 0U));
+
+    if (size < VIDEO_CHUNK_HEADER_SIZE) {
+        return video_lose_sync(video);
+    }
+
+    uint8_t flags = data[0];
+    bool in_order = data[1] == video->sequence;
+    video->sequence = (uint8_t)(data[1] + 1U);
+
+    gfx_t* gfx = video->config.gfx;
+    uint8_t* frame_buffer = gfx->config.frame_buffer;
+    size_t frame_size = gfx_get_pages(gfx) * gfx->config.frame_width;
+
+    if ((flags & VIDEO_CHUNK_BEGIN) && (flags & VIDEO_CHUNK_KEY)) {
+        gfx_clear(gfx);
+        video->synchronized = true;
+    } else if (!video->synchronized) {
+        return VIDEO_ERR_FAIL;
+    } else if (!in_order) {
+        return video_lose_sync(video);
+    }
+
+    if (flags & VIDEO_CHUNK_BEGIN) {
+        video->cursor = 0U;
+    }
+
+    size_t cursor = video->cursor;
+
+    for (size_t index = VIDEO_CHUNK_HEADER_SIZE; index < size;) {
+        uint8_t token = data[index++];
+
+        if (token < VIDEO_TOKEN_LITERAL) {
+            size_t count = token + 1U;
+            if (count > frame_size - cursor) {
+                return video_lose_sync(video);
+            }
+            cursor += count;
+        } else if (token < VIDEO_TOKEN_REPEAT) {
+            size_t count = token - (VIDEO_TOKEN_LITERAL - 1U);
+            if (count > frame_size - cursor || count > size - index) {
+                return video_lose_sync(video);
+            }
+            for (size_t offset = 0U; offset < count; ++offset) {
+                frame_buffer[cursor + offset] ^= data[index + offset];
+            }
+            video_mark_dirty(video, cursor, count);
+            cursor += count;
+            index += count;
+        } else {
+            size_t count = token - (VIDEO_TOKEN_REPEAT - 2U);
+            if (count > frame_size - cursor || index == size) {
+                return video_lose_sync(video);
+            }
+            uint8_t value = data[index++];
+            for (size_t offset = 0U; offset < count; ++offset) {
+                frame_buffer[cursor + offset] ^= value;
+            }
+            video_mark_dirty(video, cursor, count);
+            cursor += count;
+        }
+    }
+
+    video->cursor = cursor;
+
+    if (flags & VIDEO_CHUNK_END) {
+        ++video->frames;
+        if (gfx_flush(gfx) != GFX_ERR_OK) {
+            return VIDEO_ERR_FAIL;
+        }
+    }
+
+    return VIDEO_ERR_OK;
+}
+
+size_t video_get_frames(video_t const* video)
+{
+    assert(video);
+
+    return video->frames;
+}
+
+size_t video_get_errors(video_t const* video)
+{
+    assert(video);
+
+    return video->errors;
+}
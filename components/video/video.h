@@ -0,0 +1,35 @@
+#ifndef VIDEO_VIDEO_H
+#define VIDEO_VIDEO_H
+
+#include "video_config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streamed animation, every frame is the XOR delta against the one before,
+// run-length coded and split into chunks, see scripts/video_stream.py. The
+// delta is applied straight to the frame buffer, there is no second frame.
+typedef struct {
+    video_config_t config;
+
+    size_t cursor;
+    uint8_t sequence;
+    // cleared by broken or missing chunks until the next key frame
+    bool synchronized;
+
+    size_t frames;
+    size_t errors;
+} video_t;
+
+void video_initialize(video_t* video, video_config_t const* config);
+void video_deinitialize(video_t* video);
+
+// Applies one chunk and flushes the changed spans once it ends a frame.
+// After a broken or missing chunk everything up to the next key frame is
+// dropped, as the deltas no longer apply.
+video_err_t video_decode(video_t* video, uint8_t const* data, size_t size);
+
+size_t video_get_frames(video_t const* video);
+size_t video_get_errors(video_t const* video);
+
+#endif // VIDEO_VIDEO_H
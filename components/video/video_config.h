@@ -0,0 +1,45 @@
+#ifndef VIDEO_VIDEO_CONFIG_H
+#define VIDEO_VIDEO_CONFIG_H
+
+#include "gfx.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Largest run a single token covers
+#define VIDEO_SKIP_MAX (128U)
+#define VIDEO_LITERAL_MAX (64U)
+#define VIDEO_REPEAT_MAX (65U)
+
+typedef enum {
+    VIDEO_ERR_OK = 0,
+    VIDEO_ERR_FAIL = 1 << 0,
+    VIDEO_ERR_NULL = 1 << 1,
+} video_err_t;
+
+// Every chunk starts with these flags and a sequence number that counts
+// chunks, the rest are tokens that never span chunks
+#define VIDEO_CHUNK_HEADER_SIZE (2U)
+
+typedef enum {
+    // the tokens start at the first frame buffer byte
+    VIDEO_CHUNK_BEGIN = 1 << 0,
+    // the frame is complete and gets flushed
+    VIDEO_CHUNK_END = 1 << 1,
+    // the delta is against a blank frame, decoding resumes here after a loss
+    VIDEO_CHUNK_KEY = 1 << 2,
+} video_chunk_t;
+
+// A token below 0x80 skips that many plus one unchanged bytes, one below 0xC0
+// is followed by the token minus 0x7F bytes to XOR in, the others XOR the
+// next byte into the token minus 0xBE bytes
+typedef enum {
+    VIDEO_TOKEN_SKIP = 0x00,
+    VIDEO_TOKEN_LITERAL = 0x80,
+    VIDEO_TOKEN_REPEAT = 0xC0,
+} video_token_t;
+
+typedef struct {
+    gfx_t* gfx;
+} video_config_t;
+
+#endif // VIDEO_VIDEO_CONFIG_H
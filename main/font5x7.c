@@ -97,4 +97,40 @@ uint8_t font5x7[96][5] = {
     {0x00, 0x41, 0x36, 0x08, 0x00}, // }
     {0x08, 0x08, 0x2A, 0x1C, 0x08}, // ->
     {0x08, 0x1C, 0x2A, 0x08, 0x08}  // <-
-};
\ No newline at end of file
+};
+
+uint16_t const font5x7_ext_code_points[FONT5X7_EXT_CHARS] = {
+    0x00B0, 0x00B1, 0x00B5, 0x00D3, 0x00F3, 0x0104, 0x0105,
+    0x0106, 0x0107, 0x0118, 0x0119, 0x0141, 0x0142, 0x0143,
+    0x0144, 0x015A, 0x015B, 0x0179, 0x017A, 0x017B, 0x017C,
+    0x20AC, 0x2190, 0x2191, 0x2192, 0x2193,
+};
+
+uint8_t const font5x7_ext[FONT5X7_EXT_CHARS][5] = {
+    {0x00, 0x06, 0x09, 0x09, 0x06}, // °
+    {0x44, 0x44, 0x5F, 0x44, 0x44}, // ±
+    {0x7C, 0x20, 0x20, 0x10, 0x3C}, // µ
+    {0x3C, 0x42, 0x43, 0x42, 0x3C}, // Ó
+    {0x38, 0x44, 0x46, 0x45, 0x38}, // ó
+    {0x3E, 0x09, 0x09, 0x49, 0x3E}, // Ą
+    {0x18, 0x24, 0x24, 0x64, 0x3C}, // ą
+    {0x3C, 0x42, 0x42, 0x43, 0x24}, // Ć
+    {0x38, 0x44, 0x46, 0x45, 0x20}, // ć
+    {0x3F, 0x25, 0x25, 0x65, 0x21}, // Ę
+    {0x18, 0x2C, 0x2C, 0x6C, 0x08}, // ę
+    {0x10, 0x7F, 0x44, 0x40, 0x40}, // Ł
+    {0x00, 0x51, 0x7F, 0x44, 0x00}, // ł
+    {0x7E, 0x04, 0x09, 0x10, 0x7E}, // Ń
+    {0x7C, 0x08, 0x06, 0x05, 0x78}, // ń
+    {0x44, 0x4A, 0x4B, 0x4A, 0x32}, // Ś
+    {0x48, 0x54, 0x56, 0x55, 0x20}, // ś
+    {0x62, 0x52, 0x4A, 0x47, 0x42}, // Ź
+    {0x44, 0x64, 0x56, 0x4D, 0x44}, // ź
+    {0x62, 0x52, 0x4B, 0x46, 0x42}, // Ż
+    {0x44, 0x64, 0x55, 0x4C, 0x44}, // ż
+    {0x14, 0x3E, 0x55, 0x55, 0x41}, // €
+    {0x08, 0x1C, 0x2A, 0x08, 0x08}, // ←
+    {0x04, 0x02, 0x7F, 0x02, 0x04}, // ↑
+    {0x08, 0x08, 0x2A, 0x1C, 0x08}, // →
+    {0x10, 0x20, 0x7F, 0x20, 0x10}, // ↓
+};
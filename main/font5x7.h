@@ -5,11 +5,17 @@
 
 #define FONT5X7_CHAR_CODE_OFFSET (32UL)
 #define FONT5X7_WIDTH (5UL)
+// Glyph columns use bits 0-6 only, bit 7 is the blank row between lines.
+// Letters with an ogonek are a row shorter to keep it above that row.
 #define FONT5X7_HEIGHT (7UL)
 #define FONT5X7_LINE_HEIGHT (FONT5X7_HEIGHT + 1UL)
 #define FONT5X7_CHAR_WIDTH (FONT5X7_WIDTH + 1UL)
 #define FONT5X7_CHARS (96UL)
+#define FONT5X7_EXT_CHARS (26UL)
 
 extern uint8_t font5x7[FONT5X7_CHARS][5];
 
+extern uint16_t const font5x7_ext_code_points[FONT5X7_EXT_CHARS];
+extern uint8_t const font5x7_ext[FONT5X7_EXT_CHARS][5];
+
 #endif // MAIN_FONT5x7_H
\ No newline at end of file
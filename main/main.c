@@ -1,11 +1,26 @@
 #include "main.h"
+#include "console.h"
+#include "console_sink.h"
+#include "dma.h"
 #include "font5x7.h"
+#include "gfx.h"
+#include "gfx_printf.h"
+#include "gfx_text.h"
 #include "gpio.h"
+#include "labels.h"
+#include "link.h"
+#include "mirror.h"
+#include "remote.h"
+#include "screens.h"
 #include "sh1107.h"
 #include "spi.h"
 #include "stm32l476xx.h"
 #include "stm32l4xx_hal.h"
+#include "syscalls.h"
+#include "trace.h"
+#include "uart.h"
 #include "usart.h"
+#include "video.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -107,6 +122,243 @@ static sh1107_err_t sh1107_initialize_chip(sh1107_t* sh1107)
     return SH1107_ERR_OK;
 }
 
+static gfx_err_t sh1107_transmit(sh1107_t* sh1107,
+                                 bool is_data,
+                                 uint8_t const* data,
+                                 size_t data_size)
+{
+    sh1107_gpio_write(sh1107->interface.gpio_user,
+                      sh1107->config.control_pin,
+                      is_data);
+
+    return sh1107_bus_transmit_data(sh1107->interface.bus_user,
+                                    data,
+                                    data_size) == SH1107_ERR_OK
+               ? GFX_ERR_OK
+               : GFX_ERR_FAIL;
+}
+
+static mirror_t mirror;
+static bool link_mode;
+
+static gfx_err_t gfx_panel_flush_span(void* user,
+                                      size_t page,
+                                      size_t column,
+                                      uint8_t const* data,
+                                      size_t size)
+{
+    sh1107_t* sh1107 = (sh1107_t*)user;
+
+    uint8_t cmd[3] = {(uint8_t)(0xB0 | page),           // Page Address
+                      (uint8_t)(0x00 | (column & 0x0F)), // Lower Column
+                      (uint8_t)(0x10 | (column >> 4))};  // Higher Column
+
+    gfx_err_t err = sh1107_transmit(sh1107, false, cmd, sizeof(cmd));
+    if (err != GFX_ERR_OK) {
+        return err;
+    }
+
+    if (link_mode) {
+        mirror_span(&mirror, page, column, data, size);
+    }
+
+    return sh1107_transmit(sh1107, true, data, size);
+}
+
+static gfx_err_t gfx_panel_set_start_line(void* user, size_t line)
+{
+    sh1107_t* sh1107 = (sh1107_t*)user;
+
+    uint8_t cmd[2] = {0xDC, (uint8_t)line}; // Display Start Line
+
+    if (link_mode) {
+        mirror_start_line(&mirror, line);
+    }
+
+    return sh1107_transmit(sh1107, false, cmd, sizeof(cmd));
+}
+
+typedef struct {
+    UART_HandleTypeDef* huart;
+    uint32_t primask;
+} uart_user_t;
+
+static uart_t uart;
+
+static uart_err_t uart_bus_transmit(void* user,
+                                    uint8_t const* data,
+                                    size_t size)
+{
+    uart_user_t* uart_user = (uart_user_t*)user;
+
+    return HAL_UART_Transmit_DMA(uart_user->huart, data, (uint16_t)size) ==
+                   HAL_OK
+               ? UART_ERR_OK
+               : UART_ERR_FAIL;
+}
+
+static void uart_bus_lock(void* user)
+{
+    uart_user_t* uart_user = (uart_user_t*)user;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uart_user->primask = primask;
+}
+
+static void uart_bus_unlock(void* user)
+{
+    uart_user_t* uart_user = (uart_user_t*)user;
+
+    __set_PRIMASK(uart_user->primask);
+}
+
+static uint32_t uart_bus_get_tick(void* user)
+{
+    (void)user;
+
+    return HAL_GetTick();
+}
+
+static uart_err_t uart_bus_receive(void* user, uint8_t* data, size_t size)
+{
+    uart_user_t* uart_user = (uart_user_t*)user;
+
+    return HAL_UARTEx_ReceiveToIdle_DMA(uart_user->huart,
+                                        data,
+                                        (uint16_t)size) == HAL_OK
+               ? UART_ERR_OK
+               : UART_ERR_FAIL;
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
+{
+    if (huart == &huart2) {
+        uart_transmit_complete(&uart);
+    }
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t size)
+{
+    if (huart == &huart2) {
+        uart_receive_event(&uart, size);
+    }
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart)
+{
+    // errors such as overruns abort the reception, so rearm it
+    if (huart == &huart2) {
+        uart_receive_start(&uart);
+    }
+}
+
+static size_t link_transport_write(void* user,
+                                   uint8_t const* data,
+                                   size_t size)
+{
+    // a cut frame would be lost along with the one after it
+    return uart_write_all((uart_t*)user, data, size);
+}
+
+static size_t link_transport_read(void* user, uint8_t* data, size_t size)
+{
+    return uart_read((uart_t*)user, data, size);
+}
+
+static void link_transport_drain(void* user)
+{
+    uart_drain((uart_t*)user);
+}
+
+static link_err_t link_transport_set_baud(void* user, uint32_t baud)
+{
+    uart_t* link_uart = (uart_t*)user;
+
+    // reception restarts from scratch, the host waits for the acknowledge
+    HAL_UART_AbortReceive(&huart2);
+    huart2.Init.BaudRate = baud;
+    if (HAL_UART_Init(&huart2) != HAL_OK) {
+        return LINK_ERR_FAIL;
+    }
+
+    return uart_receive_start(link_uart) == UART_ERR_OK ? LINK_ERR_OK
+                                                        : LINK_ERR_FAIL;
+}
+
+static remote_t remote;
+static video_t video;
+
+static void link_receive(void* user,
+                         uint8_t channel,
+                         uint8_t const* data,
+                         size_t size)
+{
+    (void)user;
+
+    if (channel == LINK_CHANNEL_TEXT) {
+        printf("> %.*s\n", (int)size, (char const*)data);
+    } else if (channel == LINK_CHANNEL_DRAW) {
+        // decoded right where the link received the frame
+        remote_execute(&remote, data, size);
+    } else if (channel == LINK_CHANNEL_VIDEO) {
+        video_decode(&video, data, size);
+    }
+}
+
+static link_t link;
+
+// Splits data into frames of the given channel once the link is up
+static void link_write_channel(uint8_t channel,
+                               uint8_t const* data,
+                               size_t size)
+{
+    size_t max_payload = link_get_max_payload(&link);
+
+    while (size > 0U) {
+        size_t chunk = size < max_payload ? size : max_payload;
+        link_send(&link, channel, data, chunk);
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+static void uart_write_stdout(void* user, char const* data, size_t size)
+{
+    if (link_mode) {
+        link_write_channel(LINK_CHANNEL_TEXT, (uint8_t const*)data, size);
+    } else {
+        uart_write((uart_t*)user, data, size);
+    }
+}
+
+static void trace_sink_write(void* user, uint8_t const* data, size_t size)
+{
+    if (link_mode) {
+        link_write_channel(LINK_CHANNEL_TRACE, data, size);
+    } else {
+        // a cut record would desynchronize the decoder
+        uart_write_all((uart_t*)user, data, size);
+    }
+}
+
+static void mirror_sink_write(void* user, uint8_t const* data, size_t size)
+{
+    link_send((link_t*)user, LINK_CHANNEL_MIRROR, data, size);
+}
+
+static void remote_reply(void* user, uint8_t const* data, size_t size)
+{
+    link_send((link_t*)user, LINK_CHANNEL_DRAW, data, size);
+}
+
+static void console_sink_write_stdout(void* user,
+                                     char const* data,
+                                     size_t size)
+{
+    console_sink_write((console_sink_t*)user, data, size);
+}
+
 void SystemClock_Config(void);
 
 int main(void)
@@ -115,11 +367,68 @@ int main(void)
     SystemClock_Config();
 
     MX_GPIO_Init();
+    MX_DMA_Init();
     MX_USART2_UART_Init();
     MX_SPI3_Init();
 
     HAL_Delay(500);
 
+    static uint8_t uart_tx_buffer[1024];
+    static uint8_t uart_rx_buffer[256];
+    static char uart_line_buffer[64];
+    static uart_user_t uart_user = {.huart = &huart2};
+    uart_initialize(
+        &uart,
+        &(uart_config_t){.tx_buffer = uart_tx_buffer,
+                         .tx_buffer_size = sizeof(uart_tx_buffer),
+                         .overflow = UART_OVERFLOW_DROP,
+                         .rx_buffer = uart_rx_buffer,
+                         .rx_buffer_size = sizeof(uart_rx_buffer),
+                         .rx_line_buffer = uart_line_buffer,
+                         .rx_line_buffer_size = sizeof(uart_line_buffer),
+                         .drain_timeout = 1000U},
+        &(uart_interface_t){.bus_user = &uart_user,
+                            .bus_transmit = uart_bus_transmit,
+                            .bus_receive = uart_bus_receive,
+                            .lock = uart_bus_lock,
+                            .unlock = uart_bus_unlock,
+                            .get_tick = uart_bus_get_tick});
+    uart_receive_start(&uart);
+    syscalls_add_write_sink(uart_write_stdout, &uart);
+
+    static uint8_t link_tx_buffer[512];
+    static uint8_t link_rx_buffer[512];
+    link_initialize(
+        &link,
+        &(link_config_t){.tx_buffer = link_tx_buffer,
+                         .tx_buffer_size = sizeof(link_tx_buffer),
+                         .rx_buffer = link_rx_buffer,
+                         .rx_buffer_size = sizeof(link_rx_buffer),
+                         .baud = huart2.Init.BaudRate,
+                         .max_baud = HAL_RCC_GetPCLK1Freq() / 16U},
+        &(link_interface_t){.transport_user = &uart,
+                            .transport_write = link_transport_write,
+                            .transport_read = link_transport_read,
+                            .transport_drain = link_transport_drain,
+                            .transport_set_baud = link_transport_set_baud,
+                            .receive = link_receive});
+
+    static uint8_t mirror_buffer[sizeof(link_tx_buffer)];
+    mirror_initialize(
+        &mirror,
+        &(mirror_config_t){.buffer = mirror_buffer,
+                           .buffer_size = link_get_max_payload(&link),
+                           .frame_width = SH1107_SCREEN_WIDTH,
+                           .frame_height = SH1107_SCREEN_HEIGHT},
+        &(mirror_interface_t){.sink_user = &link,
+                              .sink_write = mirror_sink_write});
+
+    static trace_t trace;
+    trace_initialize(&trace,
+                     &(trace_interface_t){.sink_user = &uart,
+                                          .sink_write = trace_sink_write});
+    TRACE(&trace, "boot after %u ms\n", HAL_GetTick());
+
     static uint8_t frame_buffer[SH1107_FRAME_BUFFER_SIZE];
 
     sh1107_user_t sh1107_user = {.sh1107_spi_bus = &hspi3,
@@ -151,10 +460,96 @@ int main(void)
                               .gpio_deinitialize = sh1107_gpio_deinitialize,
                               .gpio_write = sh1107_gpio_write});
     sh1107_initialize_chip(&sh1107);
-    sh1107_draw_string(&sh1107, 0, 0, "DUPA ZBITA");
-    sh1107_draw_string(&sh1107, 30, 30, "DUPA CIPA");
-    sh1107_display_frame_buffer(&sh1107);
+
+    gfx_t gfx;
+    gfx_initialize(
+        &gfx,
+        &(gfx_config_t){
+            .frame_buffer = frame_buffer,
+            .frame_width = SH1107_SCREEN_WIDTH,
+            .frame_height = SH1107_SCREEN_HEIGHT,
+            .font = {.glyphs = (uint8_t const*)font5x7,
+                     .glyph_count = FONT5X7_CHARS,
+                     .code_offset = FONT5X7_CHAR_CODE_OFFSET,
+                     .width = FONT5X7_WIDTH,
+                     .height = FONT5X7_HEIGHT,
+                     .extended_code_points = font5x7_ext_code_points,
+                     .extended_glyphs = (uint8_t const*)font5x7_ext,
+                     .extended_glyph_count = FONT5X7_EXT_CHARS}},
+        &(gfx_interface_t){.panel_user = &sh1107,
+                           .flush_span = gfx_panel_flush_span,
+                           .set_start_line = gfx_panel_set_start_line});
+
+    // rendered at compile time, sent straight from flash while booting
+    gfx_flush_image(&gfx, screens_splash);
+    HAL_Delay(1000);
+
+    gfx_draw_string(&gfx, 0, 0, "DUPA ZBITA", GFX_ROP_SET);
+    gfx_draw_string(&gfx, 30, 30, "DUPA CIPA", GFX_ROP_SET);
+    gfx_draw_string(&gfx, 0, 60, "Zażółć gęślą jaźń", GFX_ROP_SET);
+    gfx_draw_prepared_string(&gfx, 0, 80, &labels_temperature, GFX_ROP_SET);
+    gfx_draw_printf(&gfx, 78, 80, GFX_ROP_SET, "%.1k°C", 235);
+    gfx_flush(&gfx);
+
+    remote_initialize(&remote,
+                      &(remote_config_t){.gfx = &gfx},
+                      &(remote_interface_t){.reply_user = &link,
+                                            .reply = remote_reply});
+
+    video_initialize(&video, &(video_config_t){.gfx = &gfx});
+
+    // the pages below the demo text, the panel start line stays put for the
+    // remote and video output drawn over the whole frame in link mode
+    static console_t console;
+    console_initialize(&console,
+                       &(console_config_t){.gfx = &gfx, .first_row = 11U});
+
+    static uint8_t console_buffer[512];
+    static console_sink_t console_sink;
+    console_sink_initialize(
+        &console_sink,
+        &(console_sink_config_t){.console = &console,
+                                 .buffer = console_buffer,
+                                 .buffer_size = sizeof(console_buffer)});
+    syscalls_add_write_sink(console_sink_write_stdout, &console_sink);
+
+    printf("console ready\n");
 
     while (1) {
+        char const* line;
+        size_t length;
+        if (link_mode) {
+            link_process(&link, HAL_GetTick());
+        } else if (uart_read_line(&uart, &line, &length)) {
+            TRACE(&trace, "received %u byte line\n", length);
+            if (strcmp(line, "link") == 0) {
+                // from here on everything is framed, see scripts/link.py
+                printf("link mode\n");
+                uart_drain(&uart);
+
+                // remote and video own the frame from here on, text goes out
+                // on the link only
+                console_sink_process(&console_sink);
+                console_sink_detach(&console_sink);
+                link_mode = true;
+
+                // the mirror starts from a full frame shown from line 0
+                gfx_set_start_line(&gfx, 0U);
+                gfx_mark_dirty(&gfx,
+                               0,
+                               0,
+                               SH1107_SCREEN_WIDTH,
+                               SH1107_SCREEN_HEIGHT);
+                gfx_flush(&gfx);
+            } else {
+                printf("> %.*s\n", (int)length, line);
+            }
+        }
+
+        console_sink_process(&console_sink);
+
+        if (link_mode) {
+            mirror_frame(&mirror);
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+extern "C" {
+#include "screens.h"
+#include "sh1107.h"
+}
+
+#include "font5x7_static.hpp"
+#include "gfx_static.hpp"
+#include <array>
+#include <cstdint>
+
+namespace {
+
+    using screen_t =
+        gfx_static_screen<SH1107_SCREEN_WIDTH, SH1107_SCREEN_HEIGHT>;
+
+    // 8x8, LSB on top
+    constexpr std::array<std::uint8_t, 8> thermometer = {
+        0x00, 0x60, 0x9E, 0x81, 0x9E, 0x60, 0x00, 0x00};
+
+    constexpr screen_t::image_t render_splash()
+    {
+        screen_t screen(font5x7_static);
+
+        screen.draw_rect(
+            0, 0, SH1107_SCREEN_WIDTH, SH1107_SCREEN_HEIGHT, GFX_ROP_SET);
+        screen.fill_rect(2, 2, SH1107_SCREEN_WIDTH - 4, 12, GFX_ROP_SET);
+        screen.draw_string(4, 4, "SH1107", GFX_ROP_CLEAR);
+        screen.draw_hline(2, 16, SH1107_SCREEN_WIDTH - 4, GFX_ROP_SET);
+
+        screen.draw_string(4, 24, "Zażółć gęślą jaźń", GFX_ROP_SET);
+        screen.draw_columns(4, 40, thermometer, GFX_ROP_SET);
+        screen.draw_string(16, 40, "Temperatura:", GFX_ROP_SET);
+        screen.draw_string(16, 52, "Wilgotność:", GFX_ROP_SET);
+        screen.draw_string(16, 64, "Ciśnienie:", GFX_ROP_SET);
+
+        screen.draw_line(4, 120, 60, 84, GFX_ROP_SET);
+        screen.draw_line(60, 84, 123, 120, GFX_ROP_SET);
+
+        return screen.get_image();
+    }
+
+    // A glyph drawn on a page boundary is the font columns as they are
+    constexpr bool is_glyph_at_origin(char const* string,
+                                      std::uint8_t const* glyph)
+    {
+        gfx_static_screen<8, 8> screen(font5x7_static);
+        screen.draw_string(0, 0, string, GFX_ROP_SET);
+
+        for (std::size_t column = 0U; column < 5U; ++column) {
+            if (screen.get_image()[column] != glyph[column]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static_assert(is_glyph_at_origin("A",
+                                     &font5x7_static_glyphs[('A' - 32) * 5]));
+    // a stray continuation byte falls back to '?'
+    static_assert(is_glyph_at_origin("\x80",
+                                     &font5x7_static_glyphs[('?' - 32) * 5]));
+
+    constexpr screen_t::image_t splash = render_splash();
+
+    // the border's top left corner covers a whole column of the first page
+    static_assert(splash[0] == 0xFFU);
+
+} // namespace
+
+extern "C" std::uint8_t const* const screens_splash = splash.data();
@@ -0,0 +1,10 @@
+#ifndef MAIN_SCREENS_H
+#define MAIN_SCREENS_H
+
+#include <stdint.h>
+
+// Frame sized page layout images rendered at compile time by screens.cpp,
+// they stay in flash and are sent with gfx_flush_image
+extern uint8_t const* const screens_splash;
+
+#endif // MAIN_SCREENS_H
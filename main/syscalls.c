@@ -1,3 +1,4 @@
+#include "syscalls.h"
 #include "usart.h"
 #include <errno.h>
 #include <signal.h>
@@ -12,6 +13,34 @@
 char* __env[1] = {0};
 char** environ = __env;
 
+static struct {
+    syscalls_write_sink_t sink;
+    void* user;
+} write_sinks[SYSCALLS_MAX_WRITE_SINKS];
+static size_t write_sink_count = 0U;
+
+static syscalls_read_source_t read_source = NULL;
+static void* read_source_user = NULL;
+
+bool syscalls_add_write_sink(syscalls_write_sink_t sink, void* user)
+{
+    if (sink == NULL || write_sink_count >= SYSCALLS_MAX_WRITE_SINKS) {
+        return false;
+    }
+
+    write_sinks[write_sink_count].sink = sink;
+    write_sinks[write_sink_count].user = user;
+    ++write_sink_count;
+
+    return true;
+}
+
+void syscalls_set_read_source(syscalls_read_source_t source, void* user)
+{
+    read_source = source;
+    read_source_user = user;
+}
+
 int _getpid(void)
 {
     return 1;
@@ -35,14 +64,34 @@ void _exit(int status)
 int _read(int file, char* ptr, int len)
 {
     (void)file;
-    HAL_UART_Receive(&huart2, (uint8_t*)ptr, len, len);
-    return len;
+
+    if (read_source == NULL) {
+        HAL_UART_Receive(&huart2, (uint8_t*)ptr, len, len);
+        return len;
+    }
+
+    size_t size = read_source(read_source_user, ptr, (size_t)len);
+    if (size == 0U) {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    return (int)size;
 }
 
 int _write(int file, char* ptr, int len)
 {
     (void)file;
-    HAL_UART_Transmit(&huart2, (uint8_t*)ptr, len, len);
+
+    if (write_sink_count == 0U) {
+        HAL_UART_Transmit(&huart2, (uint8_t*)ptr, len, len);
+        return len;
+    }
+
+    for (size_t index = 0U; index < write_sink_count; ++index) {
+        write_sinks[index].sink(write_sinks[index].user, ptr, (size_t)len);
+    }
+
     return len;
 }
 
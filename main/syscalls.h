@@ -0,0 +1,23 @@
+#ifndef MAIN_SYSCALLS_H
+#define MAIN_SYSCALLS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SYSCALLS_MAX_WRITE_SINKS (2U)
+
+typedef void (*syscalls_write_sink_t)(void* user,
+                                      char const* data,
+                                      size_t size);
+
+typedef size_t (*syscalls_read_source_t)(void* user, char* data, size_t size);
+
+// Hands everything written to stdout and stderr to sink, which must not
+// block. Until a sink is added _write transmits over USART2 synchronously.
+bool syscalls_add_write_sink(syscalls_write_sink_t sink, void* user);
+
+// Serves stdin from source, which must not block, an empty read then fails
+// with EAGAIN. Until a source is set _read receives over USART2 synchronously.
+void syscalls_set_read_source(syscalls_read_source_t source, void* user);
+
+#endif // MAIN_SYSCALLS_H
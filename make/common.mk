@@ -8,6 +8,7 @@ BUILD_DIR := $(PROJECT_DIR)/build
 CUBEMX_DIR := $(PROJECT_DIR)/cubemx
 SCRIPTS_DIR := $(PROJECT_DIR)/scripts
 COMPONENTS_DIR := $(PROJECT_DIR)/components
+TESTS_DIR := $(PROJECT_DIR)/tests
 SUBMODULES_DIR := $(PROJECT_DIR)/submodules
 REQUIREMENTS_DIR := $(PROJECT_DIR)/requirements
 
@@ -1,6 +1,6 @@
 include make/common.mk
 
-LINTERS_DIRS := $(MAIN_DIR) $(COMPONENTS_DIR) 
+LINTERS_DIRS := $(MAIN_DIR) $(COMPONENTS_DIR) $(TESTS_DIR)
 LINTERS_SCRIPT := $(SCRIPTS_DIR)/linters.sh
 
 .PHONY: clang_tidy
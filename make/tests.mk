@@ -0,0 +1,16 @@
+include make/common.mk
+
+TESTS_BUILD_DIR := $(BUILD_DIR)/tests
+BENCHMARKS_BUILD_DIR := $(BUILD_DIR)/benchmarks
+
+.PHONY: test
+test:
+	cmake -S "$(TESTS_DIR)" -B "$(TESTS_BUILD_DIR)" -DCMAKE_BUILD_TYPE=Debug
+	$(MAKE) -C "$(TESTS_BUILD_DIR)"
+	ctest --test-dir "$(TESTS_BUILD_DIR)" --output-on-failure
+
+.PHONY: benchmark
+benchmark:
+	cmake -S "$(TESTS_DIR)" -B "$(BENCHMARKS_BUILD_DIR)" -DCMAKE_BUILD_TYPE=Release
+	$(MAKE) -C "$(BENCHMARKS_BUILD_DIR)"
+	ctest --test-dir "$(BENCHMARKS_BUILD_DIR)" --label-regex benchmark --verbose
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+
+import argparse
+import pathlib
+import re
+import struct
+import sys
+
+RECORD_MARKER = 0xF8
+MAX_ARGUMENTS = 6
+SECTION = ".trace_strings"
+CONVERSION = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(?:hh|h|l|z|t)?([diuxXcp%])")
+
+
+def parse_strings(path):
+    image = pathlib.Path(path).read_bytes()
+    if image[:4] != b"\x7fELF":
+        sys.exit(f"{path}: not an ELF file")
+
+    is_64 = image[4] == 2
+    endian = "<" if image[5] == 1 else ">"
+
+    if is_64:
+        shoff, = struct.unpack_from(endian + "Q", image, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", image, 0x3A)
+        header = endian + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(endian + "I", image, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", image, 0x2E)
+        header = endian + "IIIIIIIIII"
+
+    sections = [
+        struct.unpack_from(header, image, shoff + index * shentsize)
+        for index in range(shnum)
+    ]
+    names = sections[shstrndx]
+
+    for name, _, _, address, offset, size, *_ in sections:
+        end = image.index(b"\0", names[4] + name)
+        if image[names[4] + name : end].decode() == SECTION:
+            return address, image[offset : offset + size]
+
+    sys.exit(f"{path}: no {SECTION} section, is the firmware using TRACE?")
+
+
+def format_record(format, arguments):
+    arguments = iter(arguments)
+
+    def convert(match):
+        flags, width, precision, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+
+        value = next(arguments, 0)
+        if conversion in "di":
+            value -= (value & 0x80000000) << 1
+        elif conversion == "c":
+            value = chr(value & 0xFF)
+        elif conversion == "p":
+            flags, conversion = flags + "#", "x"
+
+        precision = f".{precision}" if precision else ""
+        return f"%{flags}{width}{precision}{conversion}" % value
+
+    return CONVERSION.sub(convert, format)
+
+
+def decode(stream, output, address, strings):
+    def read_varint():
+        value = 0
+        for shift in range(0, 35, 7):
+            byte = stream.read(1)
+            if not byte:
+                raise EOFError
+            value |= (byte[0] & 0x7F) << shift
+            if byte[0] < 0x80:
+                return value & 0xFFFFFFFF
+        return value & 0xFFFFFFFF
+
+    while True:
+        byte = stream.read(1)
+        if not byte:
+            return
+
+        if not RECORD_MARKER <= byte[0] <= RECORD_MARKER + MAX_ARGUMENTS:
+            output.buffer.write(byte)
+            if byte == b"\n":
+                output.flush()
+            continue
+
+        try:
+            offset = read_varint() - address
+            arguments = [read_varint() for _ in range(byte[0] - RECORD_MARKER)]
+        except EOFError:
+            return
+
+        if not 0 <= offset < len(strings):
+            output.write(f"<unknown trace record 0x{offset + address:X}>\n")
+            output.flush()
+            continue
+
+        end = strings.index(b"\0", offset)
+        format = strings[offset:end].decode("utf-8", "replace")
+        count = sum(1 for match in CONVERSION.finditer(format) if match.group(4) != "%")
+        if count != len(arguments):
+            output.write(
+                f"<trace record 0x{offset + address:X} has {len(arguments)} "
+                f"arguments, its format wants {count}>\n"
+            )
+            output.flush()
+            continue
+
+        output.write(format_record(format, arguments))
+        output.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Turns binary trace records back into text, passing plain text through"
+    )
+    parser.add_argument("--elf", required=True)
+    parser.add_argument("--input", default="-", help="capture file or serial device")
+    arguments = parser.parse_args()
+
+    address, strings = parse_strings(arguments.elf)
+
+    if arguments.input == "-":
+        decode(sys.stdin.buffer, sys.stdout, address, strings)
+    else:
+        with open(arguments.input, "rb", buffering=0) as stream:
+            decode(stream, sys.stdout, address, strings)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+
+import argparse
+import io
+import os
+import random
+import select
+import socket
+import sys
+import termios
+import time
+import tty
+
+DELIMITER = 0x00
+MIN_BAUD = 1200
+
+CHANNEL_CONTROL = 0
+CHANNEL_TEXT = 1
+CHANNEL_TRACE = 2
+CHANNEL_MIRROR = 3
+CHANNEL_DRAW = 4
+CHANNEL_VIDEO = 5
+CHANNEL_USER = 16
+
+CONTROL_PING = 0
+CONTROL_PONG = 1
+CONTROL_SET_BAUD = 2
+CONTROL_BAUD_ACK = 3
+CONTROL_BAUD_NAK = 4
+
+
+def crc16(data, crc=0xFFFF):
+    # CRC-16/CCITT-FALSE, matches components/link
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+        crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    output = bytearray(b"\x01")
+    code_index = 0
+
+    for byte in data:
+        if byte != DELIMITER:
+            output.append(byte)
+            output[code_index] += 1
+            if output[code_index] != 0xFF:
+                continue
+        code_index = len(output)
+        output.append(1)
+
+    output.append(DELIMITER)
+    return bytes(output)
+
+
+def cobs_decode(data):
+    output = bytearray()
+    index = 0
+
+    while index < len(data):
+        code = data[index]
+        if code == 0 or index + code > len(data):
+            return None
+        output += data[index + 1 : index + code]
+        index += code
+        if code != 0xFF and index < len(data):
+            output.append(0)
+
+    return bytes(output)
+
+
+def encode_frame(channel, payload):
+    frame = bytes([channel]) + bytes(payload)
+    return cobs_encode(frame + crc16(frame).to_bytes(2, "little"))
+
+
+class FrameDecoder:
+    def __init__(self, max_size=4096):
+        self.buffer = bytearray()
+        self.max_size = max_size
+        self.overflow = False
+        self.dropped = 0
+
+    def feed(self, data):
+        frames = []
+
+        for byte in data:
+            if byte != DELIMITER:
+                if len(self.buffer) < self.max_size:
+                    self.buffer.append(byte)
+                else:
+                    self.overflow = True
+                continue
+
+            if self.overflow:
+                self.dropped += 1
+            elif self.buffer:
+                frame = cobs_decode(self.buffer)
+                if (
+                    frame is None
+                    or len(frame) < 3
+                    or crc16(frame[:-2]) != int.from_bytes(frame[-2:], "little")
+                ):
+                    self.dropped += 1
+                else:
+                    frames.append((frame[0], frame[1:-2]))
+
+            self.buffer.clear()
+            self.overflow = False
+
+        return frames
+
+
+def baud_constant(baud):
+    constant = getattr(termios, f"B{baud}", None)
+    if constant is None:
+        sys.exit(f"baud rate {baud} is not supported by termios")
+    return constant
+
+
+class Link:
+    def __init__(self, fd, is_tty=True):
+        self.fd = fd
+        self.is_tty = is_tty
+        self.decoder = FrameDecoder()
+        self.pending = []
+
+    def set_baud(self, baud):
+        if not self.is_tty:
+            return
+        attributes = termios.tcgetattr(self.fd)
+        attributes[4] = attributes[5] = baud_constant(baud)
+        termios.tcsetattr(self.fd, termios.TCSADRAIN, attributes)
+
+    def write(self, data):
+        view = memoryview(data)
+
+        # keeps reading while blocked, a peer that answers while we write
+        # would otherwise stall both sides
+        while view:
+            readable, writable, _ = select.select([self.fd], [self.fd], [])
+            if readable:
+                self.pending += self.decoder.feed(os.read(self.fd, 4096))
+            if writable:
+                view = view[os.write(self.fd, view) :]
+
+    def send(self, channel, payload=b""):
+        self.write(encode_frame(channel, payload))
+
+    def receive(self, timeout):
+        deadline = time.monotonic() + timeout
+
+        while not self.pending:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0 or not select.select([self.fd], [], [], remaining)[0]:
+                return None
+            data = os.read(self.fd, 4096)
+            if not data:
+                return None
+            self.pending += self.decoder.feed(data)
+
+        return self.pending.pop(0)
+
+    def control(self, control, value, expected, timeout=0.5):
+        self.send(CHANNEL_CONTROL, bytes([control]) + value.to_bytes(4, "little"))
+        deadline = time.monotonic() + timeout
+
+        while (remaining := deadline - time.monotonic()) > 0:
+            frame = self.receive(remaining)
+            if frame is None:
+                break
+            channel, payload = frame
+            if channel == CHANNEL_CONTROL and payload and payload[0] in expected:
+                return payload[0]
+            self.pending.append(frame)
+
+        return None
+
+    def negotiate(self, current, baud):
+        reply = self.control(
+            CONTROL_SET_BAUD, baud, (CONTROL_BAUD_ACK, CONTROL_BAUD_NAK)
+        )
+        if reply != CONTROL_BAUD_ACK:
+            return False
+
+        # the device falls back on its own unless the ping arrives in time
+        self.set_baud(baud)
+        reply = self.control(CONTROL_PING, 0, (CONTROL_PONG,), timeout=0.2)
+        if reply == CONTROL_PONG:
+            return True
+
+        self.set_baud(current)
+        return False
+
+
+def open_serial(device, baud):
+    fd = os.open(device, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    link = Link(fd)
+    link.set_baud(baud)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return link
+
+
+def loopback(count, size):
+    host, device = socket.socketpair()
+    host_link = Link(host.fileno(), is_tty=False)
+    device_link = Link(device.fileno(), is_tty=False)
+    generator = random.Random(0)
+
+    # shapes that stress COBS: all zeros, no zeros, block boundaries
+    payloads = [b"", b"\0" * size, b"\xAB" * size, b"\x01" * 254, b"\x01" * 255]
+    for _ in range(count):
+        length = generator.randrange(size + 1)
+        payloads.append(
+            bytes(generator.choice((0, generator.randrange(256))) for _ in range(length))
+        )
+
+    for payload in payloads:
+        host_link.send(CHANNEL_USER, payload)
+        if device_link.receive(1.0) != (CHANNEL_USER, payload):
+            sys.exit(f"loopback: {len(payload)} byte frame did not survive")
+
+    corrupted = bytearray(encode_frame(CHANNEL_USER, b"corrupted payload"))
+    corrupted[3] ^= 0x40
+    host.sendall(bytes(corrupted))
+    host_link.send(CHANNEL_TEXT, b"after")
+    received = device_link.receive(1.0)
+    if received != (CHANNEL_TEXT, b"after") or device_link.decoder.dropped != 1:
+        sys.exit("loopback: corrupted frame was not rejected")
+
+    payload = bytes(generator.randrange(256) for _ in range(size))
+    frame = encode_frame(CHANNEL_USER, payload)
+    frames = max(1, (1 << 20) // len(frame))
+    begin = time.monotonic()
+    for _ in range(frames):
+        host.sendall(frame)
+        while device_link.receive(1.0) is None:
+            pass
+    elapsed = time.monotonic() - begin
+
+    throughput = frames * len(payload) / elapsed
+    efficiency = len(payload) / len(frame)
+    print(f"loopback: {len(payloads)} frames intact, corrupted frame rejected")
+    print(f"loopback: {throughput / 1e6:.1f} MB/s decoded")
+    print(f"loopback: {efficiency:.1%} of the wire is payload")
+    for baud in (115200, 921600, 2000000, 4000000):
+        print(f"loopback: at {baud} baud that is {baud / 10 * efficiency / 1e3:.1f} kB/s")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Talks to the framed link mode or tests the framing locally"
+    )
+    parser.add_argument("--device", help="serial device")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--negotiate", type=int, help="baud rate to switch to")
+    parser.add_argument("--enter", action="store_true", help="send the link command")
+    parser.add_argument("--elf", help="image to decode trace frames with")
+    parser.add_argument("--loopback", action="store_true")
+    parser.add_argument("--frames", type=int, default=1000)
+    parser.add_argument("--size", type=int, default=251)
+    arguments = parser.parse_args()
+
+    if arguments.loopback:
+        loopback(arguments.frames, arguments.size)
+        return
+
+    if not arguments.device:
+        parser.error("--device is required unless --loopback is given")
+
+    trace = None
+    if arguments.elf:
+        sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+        import decode_trace
+
+        trace = (decode_trace, *decode_trace.parse_strings(arguments.elf))
+
+    link = open_serial(arguments.device, arguments.baud)
+    if arguments.enter:
+        link.write(b"link\n")
+        time.sleep(0.1)
+        termios.tcflush(link.fd, termios.TCIFLUSH)
+
+    if arguments.negotiate:
+        if arguments.negotiate < MIN_BAUD:
+            sys.exit(f"baud rate must be at least {MIN_BAUD}")
+        if not link.negotiate(arguments.baud, arguments.negotiate):
+            sys.exit(f"device did not switch to {arguments.negotiate} baud")
+        print(f"link: running at {arguments.negotiate} baud", file=sys.stderr)
+
+    while True:
+        frame = link.receive(1.0)
+        if frame is None:
+            continue
+
+        channel, payload = frame
+        if channel == CHANNEL_TEXT:
+            sys.stdout.buffer.write(payload)
+            sys.stdout.flush()
+        elif channel == CHANNEL_TRACE and trace:
+            module, address, strings = trace
+            module.decode(io.BytesIO(payload), sys.stdout, address, strings)
+        elif channel != CHANNEL_CONTROL:
+            print(f"<channel {channel}: {payload.hex()}>")
+
+
+if __name__ == "__main__":
+    main()
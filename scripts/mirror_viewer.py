@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+
+import argparse
+import os
+import pathlib
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import link
+
+PAGE_HEIGHT = 8
+
+RECORD_SPAN = 1
+RECORD_START_LINE = 2
+RECORD_FRAME = 3
+
+
+def decode_runs(data, index, size):
+    output = bytearray()
+
+    while len(output) < size:
+        control = data[index]
+        if control < 0x80:
+            output += data[index + 1 : index + control + 2]
+            index += control + 2
+        else:
+            output += bytes([data[index + 1]]) * (control - 0x7E)
+            index += 2
+
+    if len(output) != size:
+        raise ValueError("span overruns its byte count")
+    return bytes(output), index
+
+
+class Mirror:
+    def __init__(self, width, height):
+        self.resize(width, height)
+        self.frames = 0
+        self.frame_bytes = 0
+
+    def resize(self, width, height):
+        self.width = width
+        self.height = height
+        self.start_line = 0
+        self.pages = bytearray(width * ((height + PAGE_HEIGHT - 1) // PAGE_HEIGHT))
+
+    def feed(self, payload):
+        # returns the bytes received for each frame that ended in this payload
+        ended = []
+        self.frame_bytes += len(payload)
+        index = 0
+
+        while index < len(payload):
+            record = payload[index]
+            if record == RECORD_SPAN:
+                page = payload[index + 1]
+                column = int.from_bytes(payload[index + 2 : index + 4], "little")
+                size = int.from_bytes(payload[index + 4 : index + 6], "little")
+                data, index = decode_runs(payload, index + 6, size)
+                offset = page * self.width + column
+                self.pages[offset : offset + size] = data
+            elif record == RECORD_START_LINE:
+                line = int.from_bytes(payload[index + 1 : index + 3], "little")
+                self.start_line = line
+                index += 3
+            elif record == RECORD_FRAME:
+                width = int.from_bytes(payload[index + 1 : index + 3], "little")
+                height = int.from_bytes(payload[index + 3 : index + 5], "little")
+                if (width, height) != (self.width, self.height):
+                    self.resize(width, height)
+                index += 5
+                self.frames += 1
+                ended.append(self.frame_bytes)
+                self.frame_bytes = 0
+            else:
+                raise ValueError(f"unknown record {record}")
+
+        return ended
+
+    def pixel(self, x, y):
+        # the panel shows the frame buffer row at the start line on top
+        row = (y + self.start_line) % self.height
+        byte = self.pages[(row // PAGE_HEIGHT) * self.width + x]
+        return (byte >> (row % PAGE_HEIGHT)) & 1
+
+    def pbm(self):
+        rows = bytearray()
+        for y in range(self.height):
+            row = 0
+            for x in range(self.width):
+                row = (row << 1) | self.pixel(x, y)
+            padding = -self.width % 8
+            rows += (row << padding).to_bytes((self.width + padding) // 8, "big")
+
+        return f"P4\n{self.width} {self.height}\n".encode() + bytes(rows)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Rebuilds the panel contents from the mirror channel"
+    )
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--device", help="serial device in link mode")
+    source.add_argument("--input", help="recorded link stream")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--record", help="also save the raw link stream here")
+    parser.add_argument("--output", default="frame_%05d.pbm", help="PBM name pattern")
+    parser.add_argument("--width", type=int, default=128)
+    parser.add_argument("--height", type=int, default=128)
+    arguments = parser.parse_args()
+
+    if arguments.device:
+        serial = link.open_serial(arguments.device, arguments.baud)
+        stream = open(serial.fd, "rb", buffering=0, closefd=False)
+    else:
+        stream = open(arguments.input, "rb", buffering=0)
+
+    record = open(arguments.record, "wb") if arguments.record else None
+    decoder = link.FrameDecoder()
+    mirror = Mirror(arguments.width, arguments.height)
+
+    while data := stream.read(4096):
+        if record:
+            record.write(data)
+            record.flush()
+
+        for channel, payload in decoder.feed(data):
+            if channel != link.CHANNEL_MIRROR:
+                continue
+
+            for size in mirror.feed(payload):
+                path = pathlib.Path(arguments.output % mirror.frames)
+                path.write_bytes(mirror.pbm())
+                print(f"{path}: {size} bytes", file=sys.stderr)
+
+    if decoder.dropped:
+        print(f"{decoder.dropped} damaged frames dropped", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+
+import argparse
+import os
+import pathlib
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+from prepare_strings import parse_font
+
+
+def array(kind, name, values, per_row):
+    lines = [f"inline constexpr std::array<{kind}, {len(values)}> {name} = {{"]
+    for begin in range(0, len(values), per_row):
+        row = ", ".join(values[begin : begin + per_row])
+        lines.append(f"    {row},")
+    lines.append("};")
+    lines.append("")
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Turns the C font into constexpr data for gfx_static.hpp"
+    )
+    parser.add_argument("--font", required=True)
+    parser.add_argument("--output", required=True)
+    parser.add_argument("--code-offset", type=int, default=32)
+    parser.add_argument("--height", type=int, default=7)
+    arguments = parser.parse_args()
+
+    glyphs = parse_font(arguments.font, arguments.code_offset)
+    ascii_points = sorted(point for point in glyphs if point < 0x80)
+    extended_points = sorted(point for point in glyphs if point >= 0x80)
+    width = len(glyphs[ascii_points[0]])
+
+    output = pathlib.Path(arguments.output)
+    name = output.name
+    guard = f"MAIN_{name.upper()}_HPP"
+
+    def columns(points):
+        return [f"0x{byte:02X}" for point in points for byte in glyphs[point]]
+
+    lines = [
+        f"#ifndef {guard}",
+        f"#define {guard}",
+        "",
+        '#include "gfx_config.h"',
+        "#include <array>",
+        "#include <cstdint>",
+        "",
+        "// Generated from the C font by scripts/prepare_font.py",
+        "",
+    ]
+    lines += array("std::uint8_t", f"{name}_glyphs", columns(ascii_points), 10)
+    lines += array(
+        "std::uint16_t",
+        f"{name}_extended_code_points",
+        [f"0x{point:04X}" for point in extended_points],
+        8,
+    )
+    lines += array(
+        "std::uint8_t", f"{name}_extended_glyphs", columns(extended_points), 10
+    )
+    lines += [
+        f"inline constexpr gfx_font_t {name} = {{",
+        f"    .glyphs = {name}_glyphs.data(),",
+        f"    .glyph_count = {len(ascii_points)},",
+        f"    .code_offset = {ascii_points[0]},",
+        f"    .width = {width},",
+        f"    .height = {arguments.height},",
+        f"    .extended_code_points = {name}_extended_code_points.data(),",
+        f"    .extended_glyphs = {name}_extended_glyphs.data(),",
+        f"    .extended_glyph_count = {len(extended_points)},",
+        "};",
+        "",
+        f"#endif // {guard}",
+        "",
+    ]
+
+    output.parent.mkdir(parents=True, exist_ok=True)
+    output.with_suffix(".hpp").write_text("\n".join(lines), encoding="utf-8")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,242 @@
+#!/usr/bin/env python3
+
+import argparse
+import pathlib
+import re
+import sys
+
+GLYPH_ROW = re.compile(r"\{\s*(0x[0-9A-Fa-f]{2}(?:\s*,\s*0x[0-9A-Fa-f]{2})*)\s*\}")
+ENTRY = re.compile(r'^\s*([A-Za-z_][A-Za-z0-9_]*)\s*=\s*"((?:[^"\\]|\\.)*)"\s*$')
+REPLACEMENT = 0xFFFD
+
+
+def parse_array(source, name):
+    match = re.search(r"\b" + re.escape(name) + r"\b[^=;]*=\s*\{", source)
+    if not match:
+        sys.exit(f"array {name} not found in font source")
+
+    depth = 1
+    index = match.end()
+    while depth:
+        depth += {"{": 1, "}": -1}.get(source[index], 0)
+        index += 1
+
+    return re.sub(r"//[^\n]*", "", source[match.end() : index - 1])
+
+
+def parse_font(path, code_offset):
+    source = pathlib.Path(path).read_text(encoding="utf-8")
+    glyphs = {}
+
+    rows = GLYPH_ROW.findall(parse_array(source, "font5x7"))
+    for index, row in enumerate(rows):
+        glyphs[code_offset + index] = [int(byte, 16) for byte in row.split(",")]
+
+    code_points = re.findall(
+        r"0x[0-9A-Fa-f]+", parse_array(source, "font5x7_ext_code_points")
+    )
+    rows = GLYPH_ROW.findall(parse_array(source, "font5x7_ext"))
+    for code_point, row in zip(code_points, rows):
+        glyphs[int(code_point, 16)] = [int(byte, 16) for byte in row.split(",")]
+
+    return glyphs
+
+
+SIMPLE_ESCAPES = {
+    "a": 0x07,
+    "b": 0x08,
+    "f": 0x0C,
+    "n": 0x0A,
+    "r": 0x0D,
+    "t": 0x09,
+    "v": 0x0B,
+    "\\": 0x5C,
+    "'": 0x27,
+    '"': 0x22,
+    "?": 0x3F,
+}
+
+
+def parse_c_string(text):
+    """Bytes of a C string literal body, UTF-8 characters stay UTF-8."""
+    data = bytearray()
+    index = 0
+
+    while index < len(text):
+        character = text[index]
+        index += 1
+        if character != "\\":
+            data += character.encode("utf-8")
+            continue
+
+        escape = text[index]
+        index += 1
+        if escape in SIMPLE_ESCAPES:
+            data.append(SIMPLE_ESCAPES[escape])
+        elif escape == "x":
+            digits = re.match(r"[0-9A-Fa-f]+", text[index:])
+            if not digits:
+                raise ValueError("\\x without hex digits")
+            digits = digits.group(0)
+            if int(digits, 16) > 0xFF:
+                raise ValueError(f"\\x{digits} is out of range")
+            data.append(int(digits, 16))
+            index += len(digits)
+        elif escape in "01234567":
+            digits = re.match(r"[0-7]{1,3}", text[index - 1 :]).group(0)
+            if int(digits, 8) > 0xFF:
+                raise ValueError(f"\\{digits} is out of range")
+            data.append(int(digits, 8))
+            index += len(digits) - 1
+        elif escape in "uU":
+            size = 4 if escape == "u" else 8
+            digits = text[index : index + size]
+            if not re.fullmatch(r"[0-9A-Fa-f]{%d}" % size, digits):
+                raise ValueError(f"\\{escape} needs {size} hex digits")
+            code_point = int(digits, 16)
+            if code_point > 0x10FFFF or 0xD800 <= code_point <= 0xDFFF:
+                raise ValueError(f"\\{escape}{digits} is not a character")
+            data += chr(code_point).encode("utf-8")
+            index += size
+        else:
+            raise ValueError(f"unknown escape \\{escape}")
+
+    return bytes(data)
+
+
+def c_string(data):
+    """C string literal of bytes, octal escapes do not run into digits."""
+    body = ""
+    for byte in data:
+        if byte in (0x22, 0x5C):
+            body += "\\" + chr(byte)
+        elif 0x20 <= byte < 0x7F:
+            body += chr(byte)
+        else:
+            body += f"\\{byte:03o}"
+
+    return f'"{body}"'
+
+
+def parse_strings(path):
+    strings = []
+
+    for number, line in enumerate(
+        pathlib.Path(path).read_text(encoding="utf-8").splitlines(), 1
+    ):
+        if not line.strip() or line.lstrip().startswith("#"):
+            continue
+
+        match = ENTRY.match(line)
+        if not match:
+            sys.exit(f"{path}:{number}: expected: name = \"text\"")
+
+        try:
+            strings.append((match.group(1), parse_c_string(match.group(2))))
+        except ValueError as error:
+            sys.exit(f"{path}:{number}: {error}")
+
+    return strings
+
+
+def decode_utf8(data, index):
+    """Code point at index and its length, as gfx_utf8_decode does it."""
+    lead = data[index]
+    if lead < 0x80:
+        return lead, 1
+
+    if lead & 0xE0 == 0xC0:
+        length, value, minimum = 2, lead & 0x1F, 0x80
+    elif lead & 0xF0 == 0xE0:
+        length, value, minimum = 3, lead & 0x0F, 0x800
+    elif lead & 0xF8 == 0xF0:
+        length, value, minimum = 4, lead & 0x07, 0x10000
+    else:
+        return REPLACEMENT, 1
+
+    if index + length > len(data):
+        return REPLACEMENT, 1
+
+    for byte in data[index + 1 : index + length]:
+        if byte & 0xC0 != 0x80:
+            return REPLACEMENT, 1
+        value = (value << 6) | (byte & 0x3F)
+
+    if value < minimum or value > 0x10FFFF or 0xD800 <= value <= 0xDFFF:
+        return REPLACEMENT, 1
+
+    return value, length
+
+
+def shape(data, glyphs):
+    """Columns gfx_draw_string puts down for data, spacers included."""
+    columns = []
+    index = 0
+
+    while index < len(data) and data[index] != 0:
+        code_point, length = decode_utf8(data, index)
+        index += length
+        columns.extend(glyphs.get(code_point, glyphs[ord("?")]))
+        columns.append(0)
+
+    return columns
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Pre-shapes a string table into glyph column arrays"
+    )
+    parser.add_argument("--font", required=True)
+    parser.add_argument("--strings", required=True)
+    parser.add_argument("--output", required=True)
+    parser.add_argument("--code-offset", type=int, default=32)
+    arguments = parser.parse_args()
+
+    glyphs = parse_font(arguments.font, arguments.code_offset)
+    strings = parse_strings(arguments.strings)
+
+    output = pathlib.Path(arguments.output)
+    name = output.name
+    guard = f"MAIN_{name.upper()}_H"
+
+    header = [
+        f"#ifndef {guard}",
+        f"#define {guard}",
+        "",
+        '#include "gfx_text.h"',
+        "",
+    ]
+    header += [f"extern gfx_prepared_string_t const {name}_{key};" for key, _ in strings]
+    header += ["", "// The source texts, the same columns come out of gfx_draw_string"]
+    header += [
+        f"#define {name.upper()}_{key.upper()}_TEXT {c_string(text)}"
+        for key, text in strings
+    ]
+    header += ["", f"#endif // {guard}", ""]
+
+    source = [f'#include "{name}.h"', ""]
+    for key, text in strings:
+        columns = shape(text, glyphs)
+        width = len(columns)
+        # C has no empty arrays, the column past width is never drawn
+        columns = columns or [0]
+        source.append(f"// {c_string(text)}")
+        source.append(f"static uint8_t const {name}_{key}_columns[] = {{")
+        for begin in range(0, len(columns), 10):
+            row = ", ".join(f"0x{byte:02X}" for byte in columns[begin : begin + 10])
+            source.append(f"    {row},")
+        source.append("};")
+        source.append("")
+        source.append(f"gfx_prepared_string_t const {name}_{key} = {{")
+        source.append(f"    .columns = {name}_{key}_columns,")
+        source.append(f"    .width = {width}U,")
+        source.append("};")
+        source.append("")
+
+    output.parent.mkdir(parents=True, exist_ok=True)
+    output.with_suffix(".h").write_text("\n".join(header), encoding="utf-8")
+    output.with_suffix(".c").write_text("\n".join(source), encoding="utf-8")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+
+import argparse
+import os
+import random
+import socket
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import link
+
+CLEAR = 1
+PIXEL = 2
+FILL = 3
+TEXT = 4
+BITMAP = 5
+FLUSH = 6
+
+# a command never spans frames, the device executes each frame on its own
+MAX_PAYLOAD = 480
+
+
+class Commands:
+    def __init__(self, max_payload=MAX_PAYLOAD):
+        self.max_payload = max_payload
+        self.payloads = [bytearray()]
+        self.count = 0
+
+    def add(self, command):
+        if len(command) > self.max_payload:
+            raise ValueError(f"{len(command)} byte command does not fit a frame")
+        if len(self.payloads[-1]) + len(command) > self.max_payload:
+            self.payloads.append(bytearray())
+        self.payloads[-1] += command
+        self.count += 1
+        return self
+
+    def clear(self):
+        return self.add(bytes([CLEAR]))
+
+    def pixel(self, x, y, state=True):
+        return self.add(pack(PIXEL, x, y) + bytes([state]))
+
+    def fill(self, x, y, width, height, state=True):
+        return self.add(pack(FILL, x, y, width, height) + bytes([state]))
+
+    def text(self, x, y, string):
+        data = string.encode("utf-8")
+        return self.add(pack(TEXT, x, y) + bytes([len(data)]) + data)
+
+    def bitmap(self, x, y, width, columns):
+        # columns holds whole pages, 8 pixel tall columns with the LSB on top
+        pages = len(columns) // width
+        header = pack(BITMAP, x, y) + width.to_bytes(2, "little") + bytes([pages])
+        return self.add(header + bytes(columns[: pages * width]))
+
+    def flush(self, sequence=0):
+        return self.add(bytes([FLUSH, sequence & 0xFF]))
+
+    def take(self):
+        payloads = [bytes(payload) for payload in self.payloads if payload]
+        self.payloads = [bytearray()]
+        return payloads
+
+
+def pack(opcode, *coordinates):
+    return bytes([opcode]) + b"".join(
+        value.to_bytes(2, "little", signed=True) for value in coordinates
+    )
+
+
+def parse(payload):
+    # reference decoder, mirrors remote_execute
+    commands = []
+    index = 0
+
+    while index < len(payload):
+        opcode = payload[index]
+        if opcode == CLEAR:
+            size = 1
+        elif opcode == PIXEL:
+            size = 6
+        elif opcode == FILL:
+            size = 10
+        elif opcode == TEXT:
+            size = 6 + payload[index + 5]
+        elif opcode == BITMAP:
+            width = int.from_bytes(payload[index + 5 : index + 7], "little")
+            size = 8 + width * payload[index + 7]
+        elif opcode == FLUSH:
+            size = 2
+        else:
+            raise ValueError(f"unknown opcode {opcode}")
+
+        if index + size > len(payload):
+            raise ValueError("truncated command")
+        commands.append(payload[index : index + size])
+        index += size
+
+    return commands
+
+
+def send(device, commands):
+    for payload in commands.take():
+        device.send(link.CHANNEL_DRAW, payload)
+
+
+def wait_flush(device, sequence, timeout=2.0):
+    deadline = time.monotonic() + timeout
+
+    while (remaining := deadline - time.monotonic()) > 0:
+        frame = device.receive(remaining)
+        if frame is None:
+            break
+        channel, payload = frame
+        if channel == link.CHANNEL_DRAW and payload[:2] == bytes([FLUSH, sequence]):
+            return int.from_bytes(payload[2:6], "little")
+
+    return None
+
+
+def benchmark(device, count, batch):
+    generator = random.Random(0)
+    commands = Commands()
+    executed = 0
+    begin = time.monotonic()
+
+    for sequence in range(count // batch):
+        for _ in range(batch):
+            commands.pixel(generator.randrange(128), generator.randrange(128))
+        commands.flush(sequence)
+        send(device, commands)
+        if wait_flush(device, sequence & 0xFF) is None:
+            sys.exit(f"benchmark: flush {sequence} was not answered")
+        executed += batch + 1
+
+    elapsed = time.monotonic() - begin
+    print(f"benchmark: {executed} commands in {elapsed:.2f} s")
+    print(f"benchmark: {executed / elapsed:.0f} commands/s, {batch} per flush")
+
+
+def random_commands(generator, count):
+    commands = Commands()
+
+    for _ in range(count):
+        kind = generator.randrange(6)
+        x = generator.randrange(-20, 148)
+        y = generator.randrange(-20, 148)
+        if kind == 0:
+            commands.clear()
+        elif kind == 1:
+            commands.pixel(x, y, generator.randrange(2))
+        elif kind == 2:
+            commands.fill(x, y, generator.randrange(64), generator.randrange(64))
+        elif kind == 3:
+            commands.text(x, y, "Zażółć"[: generator.randrange(7)])
+        elif kind == 4:
+            width = generator.randrange(1, 64)
+            pages = generator.randrange(1, 4)
+            columns = bytes(generator.randrange(256) for _ in range(width * pages))
+            commands.bitmap(x, y, width, columns)
+        else:
+            commands.flush(generator.randrange(256))
+
+    return commands
+
+
+def loopback(count):
+    host, device = socket.socketpair()
+    host_link = link.Link(host.fileno(), is_tty=False)
+    device_link = link.Link(device.fileno(), is_tty=False)
+    received = []
+
+    # stands in for the board, parsing and acknowledging like remote_execute
+    def serve():
+        executed = 0
+        while (frame := device_link.receive(1.0)) is not None:
+            received.append(frame[1])
+            for command in parse(frame[1]):
+                executed += 1
+                if command[0] == FLUSH:
+                    reply = bytes([FLUSH, command[1]]) + executed.to_bytes(4, "little")
+                    device_link.send(link.CHANNEL_DRAW, reply)
+
+    server = threading.Thread(target=serve)
+    server.start()
+
+    commands = random_commands(random.Random(0), count).flush(0)
+    payloads = commands.take()
+
+    # every flush is answered, the last one carries the total
+    total = None
+    begin = time.monotonic()
+    for payload in payloads:
+        host_link.send(link.CHANNEL_DRAW, payload)
+
+    while total != commands.count and (frame := host_link.receive(2.0)):
+        total = int.from_bytes(frame[1][2:6], "little")
+    elapsed = time.monotonic() - begin
+    server.join()
+
+    if total != commands.count or received != payloads:
+        sys.exit(f"loopback: {total} of {commands.count} commands came through")
+
+    print(f"loopback: {commands.count} commands in {len(payloads)} frames intact")
+    print(f"loopback: {commands.count / elapsed:.0f} commands/s on the host side")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Drives the display through draw commands over the link"
+    )
+    parser.add_argument("--device", help="serial device")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--enter", action="store_true", help="send the link command")
+    parser.add_argument("--text", help="draw this text and flush")
+    parser.add_argument("--benchmark", type=int, metavar="COUNT")
+    parser.add_argument("--batch", type=int, default=64, help="commands per flush")
+    parser.add_argument("--loopback", type=int, metavar="COUNT")
+    arguments = parser.parse_args()
+
+    if arguments.loopback:
+        loopback(arguments.loopback)
+        return
+
+    if not arguments.device:
+        parser.error("--device is required unless --loopback is given")
+
+    device = link.open_serial(arguments.device, arguments.baud)
+    if arguments.enter:
+        device.write(b"link\n")
+        time.sleep(0.1)
+
+    if arguments.text is not None:
+        send(device, Commands().clear().text(0, 0, arguments.text).flush(0))
+        if wait_flush(device, 0) is None:
+            sys.exit("flush was not answered")
+
+    if arguments.benchmark:
+        benchmark(device, arguments.benchmark, arguments.batch)
+
+
+if __name__ == "__main__":
+    main()
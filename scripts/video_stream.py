@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+
+import argparse
+import math
+import os
+import pathlib
+import socket
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import link
+
+PAGE_HEIGHT = 8
+
+CHUNK_BEGIN = 1 << 0
+CHUNK_END = 1 << 1
+CHUNK_KEY = 1 << 2
+
+SKIP_MAX = 128
+LITERAL_MAX = 64
+REPEAT_MAX = 65
+
+# matches the link RX buffer of main, a token never spans chunks
+MAX_PAYLOAD = 480
+
+
+def read_pbm(path):
+    # returns the image in the frame buffer page layout
+    data = pathlib.Path(path).read_bytes()
+    fields = []
+    index = 0
+    while len(fields) < 3:
+        while data[index : index + 1].isspace():
+            index += 1
+        if data[index : index + 1] == b"#":
+            index = data.index(b"\n", index)
+            continue
+        end = index
+        while not data[end : end + 1].isspace():
+            end += 1
+        fields.append(data[index:end])
+        index = end
+    if fields[0] != b"P4":
+        sys.exit(f"{path}: only binary PBM is supported")
+
+    width, height = int(fields[1]), int(fields[2])
+    bits = data[index + 1 :]
+    stride = (width + 7) // 8
+    pages = bytearray(width * ((height + PAGE_HEIGHT - 1) // PAGE_HEIGHT))
+    for y in range(height):
+        for x in range(width):
+            if bits[y * stride + x // 8] & (0x80 >> (x % 8)):
+                pages[(y // PAGE_HEIGHT) * width + x] |= 1 << (y % PAGE_HEIGHT)
+
+    return width, height, bytes(pages)
+
+
+def encode_tokens(delta):
+    tokens = []
+    index = 0
+
+    while index < len(delta):
+        if delta[index] == 0:
+            end = index
+            while end < len(delta) and delta[end] == 0:
+                end += 1
+            # a trailing skip would only move the cursor
+            if end < len(delta):
+                for begin in range(index, end, SKIP_MAX):
+                    tokens.append(bytes([min(SKIP_MAX, end - begin) - 1]))
+            index = end
+            continue
+
+        run = 1
+        while (
+            index + run < len(delta)
+            and run < REPEAT_MAX
+            and delta[index + run] == delta[index]
+        ):
+            run += 1
+        if run >= 3:
+            tokens.append(bytes([0xC0 + run - 2, delta[index]]))
+            index += run
+            continue
+
+        # literals end where a zero pair or a repeat could do better
+        begin = index
+        while index < len(delta) and index - begin < LITERAL_MAX:
+            if delta[index] == 0 and delta[index + 1 : index + 2] in (b"", b"\0"):
+                break
+            if delta[index : index + 3] == bytes([delta[index]]) * 3:
+                break
+            index += 1
+        tokens.append(bytes([0x7F + index - begin]) + delta[begin:index])
+
+    return tokens
+
+
+class Encoder:
+    def __init__(self, size, key_interval=50, max_payload=MAX_PAYLOAD):
+        self.previous = bytes(size)
+        self.key_interval = key_interval
+        self.max_payload = max_payload
+        self.frames = 0
+        self.sequence = 0
+
+    def encode(self, frame):
+        key = self.frames % self.key_interval == 0
+        reference = bytes(len(frame)) if key else self.previous
+        delta = bytes(a ^ b for a, b in zip(frame, reference))
+        self.previous = frame
+        self.frames += 1
+
+        flags = CHUNK_BEGIN | (CHUNK_KEY if key else 0)
+        chunks = []
+        chunk = bytearray()
+        for token in encode_tokens(delta):
+            if 2 + len(chunk) + len(token) > self.max_payload:
+                chunks.append([flags, chunk])
+                flags, chunk = 0, bytearray()
+            chunk += token
+        chunks.append([flags | CHUNK_END, chunk])
+
+        payloads = []
+        for flags, tokens in chunks:
+            payloads.append(bytes([flags, self.sequence]) + tokens)
+            self.sequence = (self.sequence + 1) & 0xFF
+        return payloads
+
+
+class Decoder:
+    # reference for video_decode, works on a frame buffer the same way
+    def __init__(self, size):
+        self.frame = bytearray(size)
+        self.cursor = 0
+        self.sequence = 0
+        self.synchronized = False
+        self.frames = []
+
+    def decode(self, chunk):
+        flags, sequence = chunk[0], chunk[1]
+        in_order = sequence == self.sequence
+        self.sequence = (sequence + 1) & 0xFF
+
+        if flags & CHUNK_BEGIN and flags & CHUNK_KEY:
+            self.frame[:] = bytes(len(self.frame))
+            self.synchronized = True
+        elif not self.synchronized or not in_order:
+            self.synchronized = False
+            return
+        if flags & CHUNK_BEGIN:
+            self.cursor = 0
+
+        index = 2
+        while index < len(chunk):
+            token = chunk[index]
+            index += 1
+            if token < 0x80:
+                self.cursor += token + 1
+                continue
+            if token < 0xC0:
+                count = token - 0x7F
+                data = chunk[index : index + count]
+                index += count
+            else:
+                count = token - 0xBE
+                data = bytes([chunk[index]]) * count
+                index += 1
+            for offset in range(count):
+                self.frame[self.cursor + offset] ^= data[offset]
+            self.cursor += count
+
+        if flags & CHUNK_END:
+            self.frames.append(bytes(self.frame))
+
+
+def animation(width, height, count):
+    # a ball bouncing over a scrolling stripe pattern, in page layout
+    pages = (height + PAGE_HEIGHT - 1) // PAGE_HEIGHT
+    for number in range(count):
+        frame = bytearray(width * pages)
+        cx = width / 2 + math.sin(number / 9) * width / 3
+        cy = height / 2 + math.cos(number / 7) * height / 3
+        for x in range(width):
+            for y in range(height):
+                inside = (x - cx) ** 2 + (y - cy) ** 2 < 100
+                stripe = y > height - 12 and (x + number) % 16 < 8
+                if inside or stripe:
+                    frame[(y // PAGE_HEIGHT) * width + x] |= 1 << (y % PAGE_HEIGHT)
+        yield bytes(frame)
+
+
+def loopback(count, width, height):
+    host, device = socket.socketpair()
+    host_link = link.Link(host.fileno(), is_tty=False)
+    device_link = link.Link(device.fileno(), is_tty=False)
+    size = width * ((height + PAGE_HEIGHT - 1) // PAGE_HEIGHT)
+    decoder = Decoder(size)
+    decoded = [0]
+
+    def serve():
+        while (frame := device_link.receive(1.0)) is not None:
+            begin = time.monotonic()
+            decoder.decode(frame[1])
+            decoded[0] += time.monotonic() - begin
+
+    frames = list(animation(width, height, count))
+    encoder = Encoder(size)
+    payloads = [payload for frame in frames for payload in encoder.encode(frame)]
+    wire = sum(len(link.encode_frame(link.CHANNEL_VIDEO, p)) for p in payloads)
+
+    server = threading.Thread(target=serve)
+    server.start()
+    for payload in payloads:
+        host_link.send(link.CHANNEL_VIDEO, payload)
+    server.join()
+
+    if decoder.frames != frames:
+        sys.exit(f"loopback: {len(decoder.frames)} of {count} frames intact")
+
+    print(f"loopback: {count} frames round-tripped in {len(payloads)} chunks")
+    print(f"loopback: {wire / count:.0f} bytes per frame on the wire, raw is {size}")
+    print(f"loopback: reference decoder at {wire / decoded[0] / 1e3:.0f} kB/s")
+    for baud in (115200, 921600, 2000000):
+        print(f"loopback: {baud / 10 / (wire / count):.1f} frames/s at {baud} baud")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Streams PBM frames as XOR deltas over the link"
+    )
+    parser.add_argument("frames", nargs="*", help="PBM files, in order")
+    parser.add_argument("--device", help="serial device")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--enter", action="store_true", help="send the link command")
+    parser.add_argument("--fps", type=float, default=10.0)
+    parser.add_argument("--repeat", action="store_true", help="loop forever")
+    parser.add_argument("--key-interval", type=int, default=50)
+    parser.add_argument("--loopback", type=int, metavar="COUNT")
+    parser.add_argument("--width", type=int, default=128)
+    parser.add_argument("--height", type=int, default=128)
+    arguments = parser.parse_args()
+
+    if arguments.loopback:
+        loopback(arguments.loopback, arguments.width, arguments.height)
+        return
+
+    if not arguments.device or not arguments.frames:
+        parser.error("--device and frames are required unless --loopback is given")
+
+    frames = [read_pbm(path) for path in arguments.frames]
+    width, height, _ = frames[0]
+    if any(frame[:2] != (width, height) for frame in frames):
+        sys.exit("all frames must have the same size")
+
+    device = link.open_serial(arguments.device, arguments.baud)
+    if arguments.enter:
+        device.write(b"link\n")
+        time.sleep(0.1)
+
+    encoder = Encoder(len(frames[0][2]), arguments.key_interval)
+    period = 1.0 / arguments.fps
+    deadline = time.monotonic()
+
+    while True:
+        for _, _, frame in frames:
+            for payload in encoder.encode(frame):
+                device.send(link.CHANNEL_VIDEO, payload)
+            deadline += period
+            time.sleep(max(0.0, deadline - time.monotonic()))
+        if not arguments.repeat:
+            break
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,9 @@
+#ifndef TESTS_COMMON_SH1107_H
+#define TESTS_COMMON_SH1107_H
+
+// The screen size of the sh1107 submodule, for main sources built on the
+// host without the driver
+#define SH1107_SCREEN_WIDTH (128U)
+#define SH1107_SCREEN_HEIGHT (128U)
+
+#endif // TESTS_COMMON_SH1107_H
@@ -0,0 +1,67 @@
+#include "test.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static size_t test_failures = 0U;
+static uint32_t test_random_state = 0x12345678U;
+
+bool test_check(bool condition,
+                char const* expression,
+                char const* file,
+                int line)
+{
+    if (!condition) {
+        ++test_failures;
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    }
+
+    return condition;
+}
+
+int test_finish(void)
+{
+    if (test_failures > 0U) {
+        fprintf(stderr, "%zu checks failed\n", test_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+size_t test_get_iterations(int argc, char** argv, size_t iterations)
+{
+    for (int index = 1; index < argc; ++index) {
+        if (strcmp(argv[index], "--quick") == 0) {
+            return iterations / 1000U > 0U ? iterations / 1000U : 1U;
+        }
+    }
+
+    return iterations;
+}
+
+uint64_t test_get_time(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+void test_report(char const* name, size_t iterations, uint64_t nanoseconds)
+{
+    printf("%-40s %10.1f ns\n",
+           name,
+           (double)nanoseconds / (double)(iterations > 0U ? iterations : 1U));
+}
+
+uint32_t test_random(void)
+{
+    // xorshift32
+    test_random_state ^= test_random_state << 13U;
+    test_random_state ^= test_random_state >> 17U;
+    test_random_state ^= test_random_state << 5U;
+
+    return test_random_state;
+}
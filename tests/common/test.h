@@ -0,0 +1,32 @@
+#ifndef TESTS_COMMON_TEST_H
+#define TESTS_COMMON_TEST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Reports a failed check and carries on, main returns test_finish()
+#define TEST_CHECK(condition) \
+    test_check((condition), #condition, __FILE__, __LINE__)
+
+bool test_check(bool condition,
+                char const* expression,
+                char const* file,
+                int line);
+
+// EXIT_FAILURE once any check failed
+int test_finish(void);
+
+// Benchmarks run briefly as a smoke test when given --quick, which ctest
+// does for every build type but Release
+size_t test_get_iterations(int argc, char** argv, size_t iterations);
+
+// Monotonic time in nanoseconds
+uint64_t test_get_time(void);
+
+void test_report(char const* name, size_t iterations, uint64_t nanoseconds);
+
+// Deterministic pseudo random numbers, the same on every run
+uint32_t test_random(void);
+
+#endif // TESTS_COMMON_TEST_H
@@ -0,0 +1,84 @@
+#include "test_gfx.h"
+#include "font5x7.h"
+#include <string.h>
+
+gfx_font_t test_gfx_get_font(void)
+{
+    return (gfx_font_t){
+        .glyphs = (uint8_t const*)font5x7,
+        .glyph_count = FONT5X7_CHARS,
+        .code_offset = FONT5X7_CHAR_CODE_OFFSET,
+        .width = FONT5X7_WIDTH,
+        .height = FONT5X7_HEIGHT,
+        .extended_code_points = font5x7_ext_code_points,
+        .extended_glyphs = (uint8_t const*)font5x7_ext,
+        .extended_glyph_count = FONT5X7_EXT_CHARS,
+    };
+}
+
+void test_gfx_initialize(gfx_t* gfx,
+                         uint8_t* frame_buffer,
+                         size_t frame_width,
+                         size_t frame_height,
+                         gfx_interface_t const* interface)
+{
+    memset(frame_buffer,
+           0,
+           frame_width * ((frame_height + GFX_PAGE_HEIGHT - 1U) /
+                          GFX_PAGE_HEIGHT));
+    gfx_initialize(gfx,
+                   &(gfx_config_t){.frame_buffer = frame_buffer,
+                                   .frame_width = frame_width,
+                                   .frame_height = frame_height,
+                                   .font = test_gfx_get_font()},
+                   interface ? interface : &(gfx_interface_t){0});
+}
+
+void test_gfx_plot(gfx_t* gfx, int32_t x, int32_t y, gfx_rop_t rop)
+{
+    if (x < 0 || y < 0 || x >= (int32_t)gfx->config.frame_width ||
+        y >= (int32_t)gfx->config.frame_height) {
+        return;
+    }
+
+    bool state = gfx_get_pixel(gfx, (int16_t)x, (int16_t)y);
+
+    switch (rop) {
+        case GFX_ROP_CLEAR: {
+            state = false;
+            break;
+        }
+        case GFX_ROP_XOR:
+        case GFX_ROP_INVERT: {
+            state = !state;
+            break;
+        }
+        case GFX_ROP_AND: {
+            break;
+        }
+        default: {
+            state = true;
+            break;
+        }
+    }
+
+    gfx_set_pixel(gfx, (int16_t)x, (int16_t)y, state);
+}
+
+bool test_gfx_is_dirty(gfx_t const* gfx, uint8_t const* before)
+{
+    size_t width = gfx->config.frame_width;
+
+    for (size_t page = 0U; page < gfx_get_pages(gfx); ++page) {
+        gfx_span_t span = gfx_get_dirty(gfx, page);
+        for (size_t column = 0U; column < width; ++column) {
+            size_t offset = page * width + column;
+            if (gfx->config.frame_buffer[offset] != before[offset] &&
+                (column < span.begin || column >= span.end)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
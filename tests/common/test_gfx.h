@@ -0,0 +1,32 @@
+#ifndef TESTS_COMMON_TEST_GFX_H
+#define TESTS_COMMON_TEST_GFX_H
+
+#include "gfx.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TEST_GFX_WIDTH (128U)
+#define TEST_GFX_HEIGHT (128U)
+#define TEST_GFX_FRAME_SIZE (TEST_GFX_WIDTH * TEST_GFX_HEIGHT / 8U)
+
+// The 5x7 font of main, as main.c configures it
+gfx_font_t test_gfx_get_font(void);
+
+// Clears frame_buffer and initializes gfx over it with the 5x7 font,
+// interface may be NULL for a gfx that is never flushed
+void test_gfx_initialize(gfx_t* gfx,
+                         uint8_t* frame_buffer,
+                         size_t frame_width,
+                         size_t frame_height,
+                         gfx_interface_t const* interface);
+
+// Applies the raster operation of a shape to one pixel with gfx_set_pixel,
+// the reference the primitives of gfx_draw.h are compared with
+void test_gfx_plot(gfx_t* gfx, int32_t x, int32_t y, gfx_rop_t rop);
+
+// Whether every byte that differs from before lies in the dirty span of its
+// page, so that a flush sends it
+bool test_gfx_is_dirty(gfx_t const* gfx, uint8_t const* before);
+
+#endif // TESTS_COMMON_TEST_GFX_H
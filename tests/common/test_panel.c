@@ -0,0 +1,65 @@
+#include "test_panel.h"
+#include <string.h>
+
+static gfx_err_t test_panel_flush_span(void* user,
+                                       size_t page,
+                                       size_t column,
+                                       uint8_t const* data,
+                                       size_t size)
+{
+    test_panel_t* panel = (test_panel_t*)user;
+
+    // the column address does not wrap into the next page
+    if (page >= TEST_PANEL_HEIGHT / 8U || column + size > TEST_PANEL_WIDTH) {
+        return GFX_ERR_FAIL;
+    }
+
+    memcpy(&panel->ram[page * TEST_PANEL_WIDTH + column], data, size);
+    panel->spans += 1U;
+    panel->bytes += 3U + size;
+
+    return GFX_ERR_OK;
+}
+
+static gfx_err_t test_panel_set_start_line(void* user, size_t line)
+{
+    test_panel_t* panel = (test_panel_t*)user;
+
+    if (line >= TEST_PANEL_HEIGHT) {
+        return GFX_ERR_FAIL;
+    }
+
+    panel->start_line = line;
+    panel->bytes += 2U;
+
+    return GFX_ERR_OK;
+}
+
+void test_panel_initialize(test_panel_t* panel)
+{
+    memset(panel, 0, sizeof(*panel));
+}
+
+gfx_interface_t test_panel_get_interface(test_panel_t* panel)
+{
+    return (gfx_interface_t){
+        .panel_user = panel,
+        .flush_span = test_panel_flush_span,
+        .set_start_line = test_panel_set_start_line,
+    };
+}
+
+bool test_panel_get_pixel(test_panel_t const* panel, size_t x, size_t y)
+{
+    size_t row = (y + panel->start_line) % TEST_PANEL_HEIGHT;
+
+    return ((uint32_t)panel->ram[(row / 8U) * TEST_PANEL_WIDTH + x] >>
+            (row % 8U)) &
+           1U;
+}
+
+void test_panel_reset_counters(test_panel_t* panel)
+{
+    panel->spans = 0U;
+    panel->bytes = 0U;
+}
@@ -0,0 +1,33 @@
+#ifndef TESTS_COMMON_TEST_PANEL_H
+#define TESTS_COMMON_TEST_PANEL_H
+
+#include "gfx.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TEST_PANEL_WIDTH (128U)
+#define TEST_PANEL_HEIGHT (128U)
+
+// SH1107 display RAM as the controller holds it, written through the gfx
+// interface the way main.c drives the chip
+typedef struct {
+    uint8_t ram[TEST_PANEL_WIDTH * TEST_PANEL_HEIGHT / 8U];
+    // RAM row shown on the top row of the screen
+    size_t start_line;
+    size_t spans;
+    // bus bytes, the address and start line commands included
+    size_t bytes;
+} test_panel_t;
+
+void test_panel_initialize(test_panel_t* panel);
+
+gfx_interface_t test_panel_get_interface(test_panel_t* panel);
+
+// Pixel on row y of the screen, the RAM row the start line maps there
+bool test_panel_get_pixel(test_panel_t const* panel, size_t x, size_t y);
+
+// Zeroes the bus counters
+void test_panel_reset_counters(test_panel_t* panel);
+
+#endif // TESTS_COMMON_TEST_PANEL_H
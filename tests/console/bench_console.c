@@ -0,0 +1,151 @@
+#include "console.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+
+typedef struct {
+    test_panel_t panel;
+    gfx_interface_t interface;
+    gfx_t gfx;
+    console_t console;
+} bench_t;
+
+static void bench_initialize(bench_t* bench, bool hardware_scroll)
+{
+    test_panel_initialize(&bench->panel);
+    bench->interface = test_panel_get_interface(&bench->panel);
+    test_gfx_initialize(&bench->gfx,
+                        frame,
+                        TEST_GFX_WIDTH,
+                        TEST_GFX_HEIGHT,
+                        &bench->interface);
+    console_initialize(&bench->console,
+                       &(console_config_t){.gfx = &bench->gfx,
+                                           .hardware_scroll = hardware_scroll});
+
+    // the first flush sends every cell, which is not what is measured
+    console_flush(&bench->console);
+    test_panel_reset_counters(&bench->panel);
+}
+
+// Time and bus bytes per console_flush of one update
+static void report(bench_t const* bench,
+                   char const* name,
+                   size_t iterations,
+                   uint64_t nanoseconds)
+{
+    test_report(name, iterations, nanoseconds);
+    printf("%-40s %10.1f bytes\n",
+           "",
+           (double)bench->panel.bytes / (double)iterations);
+}
+
+// A status screen of labels, one value changes a digit per tick
+static void run_status(size_t iterations)
+{
+    static bench_t bench;
+    char text[16];
+
+    bench_initialize(&bench, false);
+    for (size_t row = 0U; row < 16U; ++row) {
+        console_set_cursor(&bench.console, row, 0U);
+        snprintf(text, sizeof(text), "value %zu:", row);
+        console_write(&bench.console, text, strlen(text));
+    }
+    console_flush(&bench.console);
+    test_panel_reset_counters(&bench.panel);
+
+    uint64_t begin = test_get_time();
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        console_set_cursor(&bench.console, iteration % 16U, 10U);
+        int length =
+            snprintf(text, sizeof(text), "%zu.5", 100U + iteration % 900U);
+        console_write(&bench.console, text, (size_t)length);
+        console_flush(&bench.console);
+    }
+    report(&bench, "status value", iterations, test_get_time() - begin);
+
+    // a field cleared to the end of the line first, as a shorter value
+    // would need, sends its cells twice
+    begin = test_get_time();
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        console_set_cursor(&bench.console, iteration % 16U, 10U);
+        console_clear_to_end_of_line(&bench.console);
+        console_flush(&bench.console);
+        int length =
+            snprintf(text, sizeof(text), "%zu.5", 100U + iteration % 900U);
+        console_write(&bench.console, text, (size_t)length);
+        console_flush(&bench.console);
+    }
+    report(&bench,
+           "status value, cleared and rewritten",
+           iterations,
+           test_get_time() - begin);
+}
+
+// A log line per update, scrolling once the screen is full
+static void run_log(char const* name, bool hardware_scroll, size_t iterations)
+{
+    static bench_t bench;
+    char line[32];
+
+    bench_initialize(&bench, hardware_scroll);
+    for (size_t row = 0U; row < 16U; ++row) {
+        console_write(&bench.console, "boot\n", 5U);
+    }
+    console_flush(&bench.console);
+    test_panel_reset_counters(&bench.panel);
+
+    uint64_t begin = test_get_time();
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        int length = snprintf(
+            line, sizeof(line), "%zu: sensor ok\n", iteration % 10000U);
+        console_write(&bench.console, line, (size_t)length);
+        console_flush(&bench.console);
+    }
+    report(&bench, name, iterations, test_get_time() - begin);
+}
+
+// Parser cost per byte of a status screen redrawn by escape sequences, with
+// no cell changing and nothing rendered
+static void run_parse(size_t iterations)
+{
+    static char const screen[] = "\x1b[H\x1b[7m Sensors \x1b[m\x1b[K\r\n"
+                                 "Temp:   23.5°C\x1b[K\r\n"
+                                 "Humid:  41%\x1b[K\r\n"
+                                 "Press:  1013 hPa\x1b[K\r\n"
+                                 "\x1b[6;1H\x1b[7mOK\x1b[m\x1b[J";
+    static bench_t bench;
+
+    bench_initialize(&bench, false);
+    console_write(&bench.console, screen, sizeof(screen) - 1U);
+    console_flush(&bench.console);
+    test_panel_reset_counters(&bench.panel);
+
+    uint64_t begin = test_get_time();
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        console_write(&bench.console, screen, sizeof(screen) - 1U);
+    }
+    test_report("escape stream, per byte",
+                iterations * (sizeof(screen) - 1U),
+                test_get_time() - begin);
+
+    console_flush(&bench.console);
+    TEST_CHECK(bench.panel.bytes == 0U);
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations = test_get_iterations(argc, argv, 100000U);
+
+    run_status(iterations);
+    run_log("log line, redrawn rows", false, iterations);
+    run_log("log line, hardware scroll", true, iterations);
+    run_parse(iterations);
+
+    return test_finish();
+}
@@ -0,0 +1,62 @@
+#include "console.h"
+#include "console_sink.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LINES_PER_PROCESS (8U)
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t buffer[512];
+
+// Writer cost per log line, against the rendering and flushing it defers to
+// console_sink_process
+int main(int argc, char** argv)
+{
+    size_t iterations = test_get_iterations(argc, argv, 100000U);
+    static test_panel_t panel;
+    static console_t console;
+    console_sink_t sink;
+    gfx_t gfx;
+    char line[32];
+
+    test_panel_initialize(&panel);
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    test_gfx_initialize(
+        &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    console_initialize(
+        &console, &(console_config_t){.gfx = &gfx, .hardware_scroll = true});
+    console_sink_initialize(
+        &sink,
+        &(console_sink_config_t){
+            .console = &console, .buffer = buffer, .buffer_size = 512U});
+
+    uint64_t writing = 0U;
+    uint64_t processing = 0U;
+    size_t bytes = 0U;
+
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        int length = snprintf(
+            line, sizeof(line), "%zu: sensor ok\n", iteration % 10000U);
+        bytes += (size_t)length;
+
+        uint64_t begin = test_get_time();
+        console_sink_write(&sink, line, (size_t)length);
+        writing += test_get_time() - begin;
+
+        if (iteration % LINES_PER_PROCESS == LINES_PER_PROCESS - 1U) {
+            begin = test_get_time();
+            console_sink_process(&sink);
+            processing += test_get_time() - begin;
+        }
+    }
+
+    test_report("sink write, per line", iterations, writing);
+    test_report("sink process, per line", iterations, processing);
+    test_report("sink write, per byte", bytes, writing);
+    TEST_CHECK(console_sink_get_dropped(&sink) == 0U);
+
+    return test_finish();
+}
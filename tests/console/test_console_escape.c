@@ -0,0 +1,194 @@
+#include "console.h"
+#include "gfx_utf8.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ROWS (16U)
+#define COLUMNS (21U)
+
+// Rows of the screen a stream leaves behind, missing rows are blank. Cells
+// marked with # in inverse are shown inverted.
+typedef struct {
+    char const* name;
+    char const* stream;
+    char const* rows[ROWS];
+    char const* inverse[ROWS];
+} recording_t;
+
+// Streams as full screen programs and tput write them
+static recording_t const recordings[] = {
+    {
+        .name = "status screen",
+        .stream = "\x1b[2J\x1b[HTemp: 23.5\r\n"
+                  "\x1b[3;5H\x1b[7mALARM\x1b[0m"
+                  "\x1b[1;7H\x1b[K24",
+        .rows = {"Temp: 24", "", "    ALARM"},
+        .inverse = {"", "", "    #####"},
+    },
+    {
+        .name = "erase in display",
+        .stream = "aaaa\r\nbbbb\r\ncccc\r\ndddd"
+                  "\x1b[2;3H\x1b[1J"
+                  "\x1b[3;2H\x1b[J",
+        .rows = {"", "   b", "c"},
+    },
+    {
+        .name = "erase in line",
+        .stream = "abcdefgh\x1b[1;4H\x1b[1K"
+                  "\r\n12345678\x1b[2;4H\x1b[2K"
+                  "\r\nxyz\x1b[3;2H\x1b[0K",
+        .rows = {"    efgh", "", "x"},
+    },
+    {
+        .name = "unsupported sequences",
+        .stream = "\x1b[?25lA\x1b[31mB\x1b[1;2;3;4;5mC"
+                  "\x1b(BD\x1b(0E\x1b" "7F\x1b[12\nG",
+        .rows = {"ABCDEF", "G"},
+    },
+    {
+        .name = "cursor position",
+        .stream = "\x1b[99;99HZ\x1b[HY\x1b[0;0fX\x1b[5HW\x1b[;3HV",
+        .rows = {"X V", [4] = "W", [15] = "                    Z"},
+    },
+    {
+        .name = "utf-8 and wrapping",
+        .stream = "Zażółć gęślą jaźń 123456\xff\xc4x",
+        .rows = {"Zażółć gęślą jaźń 123",
+                 "456\xef\xbf\xbd\xef\xbf\xbdx"},
+    },
+    {
+        .name = "inverse",
+        .stream = "\x1b[7mab\x1b[27mcd\x1b[7;0mef\x1b[0;7mgh\x1b[m\x1b[7m",
+        .rows = {"abcdefgh"},
+        .inverse = {"##    ##"},
+    },
+    {
+        .name = "tput sgr0",
+        .stream = "\x1b[7mon\x1b(B\x1b[moff",
+        .rows = {"onoff"},
+        .inverse = {"##"},
+    },
+};
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+
+static bool is_screen_expected(console_t const* console,
+                               recording_t const* recording)
+{
+    for (size_t row = 0U; row < ROWS; ++row) {
+        char const* text = recording->rows[row] ? recording->rows[row] : "";
+        char const* inverse =
+            recording->inverse[row] ? recording->inverse[row] : "";
+        size_t size = strlen(text);
+        size_t marks = strlen(inverse);
+
+        for (size_t column = 0U; column < COLUMNS; ++column) {
+            uint32_t code_point = ' ';
+            if (size > 0U) {
+                size_t used = gfx_utf8_decode(text, size, &code_point);
+                text += used;
+                size -= used;
+            }
+
+            bool inverted = column < marks && inverse[column] == '#';
+            console_cell_t const* cell = &console->cells[row][column];
+            if (cell->code_point != code_point ||
+                ((cell->attributes & CONSOLE_ATTRIBUTE_INVERSE) != 0U) !=
+                    inverted) {
+                fprintf(stderr,
+                        "  %s: cell %zu, %zu is U+%04X\n",
+                        recording->name,
+                        row,
+                        column,
+                        (unsigned)cell->code_point);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// The same screen whether a stream comes in whole, byte by byte or in chunks
+// split anywhere
+static void test_recordings(void)
+{
+    gfx_t gfx;
+    console_t console;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    for (size_t index = 0U; index < sizeof(recordings) / sizeof(*recordings);
+         ++index) {
+        recording_t const* recording = &recordings[index];
+        size_t size = strlen(recording->stream);
+
+        for (size_t split = 0U; split < 10U; ++split) {
+            console_initialize(&console, &(console_config_t){.gfx = &gfx});
+            TEST_CHECK(console.columns == COLUMNS && console.rows == ROWS);
+
+            size_t offset = 0U;
+            while (offset < size) {
+                size_t chunk = split == 0U   ? size
+                               : split == 1U ? 1U
+                                             : 1U + test_random() % 8U;
+                if (chunk > size - offset) {
+                    chunk = size - offset;
+                }
+                console_write(&console, &recording->stream[offset], chunk);
+                offset += chunk;
+            }
+
+            if (!TEST_CHECK(is_screen_expected(&console, recording))) {
+                break;
+            }
+        }
+    }
+}
+
+// Rewriting a status screen only sends the cells that changed
+static void test_status_deltas(void)
+{
+    // drawn over the old screen, as a clear would damage every cell
+    static char const screen[] = "\x1b[HTemp: 23.5\x1b[K\r\n"
+                                 "\x1b[3;5H\x1b[7mALARM\x1b[0m\x1b[J";
+    test_panel_t panel;
+    console_t console;
+    gfx_t gfx;
+
+    test_panel_initialize(&panel);
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    test_gfx_initialize(
+        &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    console_initialize(&console, &(console_config_t){.gfx = &gfx});
+    console_write(&console, screen, sizeof(screen) - 1U);
+    TEST_CHECK(console_flush(&console) == GFX_ERR_OK);
+
+    test_panel_reset_counters(&panel);
+    console_write(&console, screen, sizeof(screen) - 1U);
+    TEST_CHECK(console_flush(&console) == GFX_ERR_OK);
+    TEST_CHECK(panel.bytes == 0U);
+
+    test_panel_reset_counters(&panel);
+    console_write(&console, "\x1b[1;7H23.6", 10U);
+    TEST_CHECK(console_flush(&console) == GFX_ERR_OK);
+    TEST_CHECK(panel.spans == 1U && panel.bytes == 3U + 6U);
+
+    test_panel_reset_counters(&panel);
+    console_write(&console, "\x1b[3;1H\x1b[K", 9U);
+    TEST_CHECK(console_flush(&console) == GFX_ERR_OK);
+    TEST_CHECK(panel.spans == 1U && panel.bytes == 3U + 5U * 6U);
+
+    TEST_CHECK(memcmp(panel.ram, frame, sizeof(frame)) == 0);
+}
+
+int main(void)
+{
+    test_recordings();
+    test_status_deltas();
+
+    return test_finish();
+}
@@ -0,0 +1,192 @@
+#include "console.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LINES (300U)
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+
+// The screen as the panel shows it, against the same text drawn by a console
+// that redraws its rows in place
+static bool is_screen_expected(test_panel_t const* panel, console_t* expected)
+{
+    console_render(expected);
+
+    for (size_t y = 0U; y < TEST_GFX_HEIGHT; ++y) {
+        for (size_t x = 0U; x < TEST_GFX_WIDTH; ++x) {
+            uint32_t byte = expected_frame[(y / 8U) * TEST_GFX_WIDTH + x];
+            bool pixel = (byte >> (y % 8U)) & 1U;
+            if (test_panel_get_pixel(panel, x, y) != pixel) {
+                fprintf(stderr, "  pixel (%zu, %zu) differs\n", x, y);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void test_wraparound(void)
+{
+    test_panel_t panel;
+    gfx_t gfx;
+    gfx_t expected_gfx;
+    console_t console;
+    console_t expected;
+
+    // left on a start line by whatever ran before
+    test_panel_initialize(&panel);
+    panel.start_line = 40U;
+    memset(panel.ram, 0x5A, sizeof(panel.ram));
+
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    test_gfx_initialize(
+        &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    test_gfx_initialize(&expected_gfx,
+                        expected_frame,
+                        TEST_GFX_WIDTH,
+                        TEST_GFX_HEIGHT,
+                        NULL);
+    console_initialize(
+        &console, &(console_config_t){.gfx = &gfx, .hardware_scroll = true});
+    console_initialize(&expected,
+                       &(console_config_t){.gfx = &expected_gfx});
+    TEST_CHECK(console.config.hardware_scroll);
+
+    TEST_CHECK(console_flush(&console) == GFX_ERR_OK);
+    TEST_CHECK(panel.start_line == 0U);
+    TEST_CHECK(is_screen_expected(&panel, &expected));
+
+    // lines of every length, some wrapping, flushed after random counts so
+    // that the start line passes the end of the RAM many times
+    char line[64];
+    for (size_t index = 0U; index < LINES; ++index) {
+        int length = snprintf(line,
+                              sizeof(line),
+                              "%zu %.*s\n",
+                              index,
+                              (int)(test_random() % 40U),
+                              "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMN");
+        console_write(&console, line, (size_t)length);
+        console_write(&expected, line, (size_t)length);
+
+        if (test_random() % 3U == 0U) {
+            TEST_CHECK(console_flush(&console) == GFX_ERR_OK);
+            TEST_CHECK(panel.start_line == console.scroll_row * 8U);
+            TEST_CHECK(is_screen_expected(&panel, &expected));
+        }
+    }
+
+    TEST_CHECK(console_flush(&console) == GFX_ERR_OK);
+    TEST_CHECK(is_screen_expected(&panel, &expected));
+}
+
+static void test_line_traffic(void)
+{
+    test_panel_t panel;
+    gfx_t gfx;
+    console_t console;
+
+    test_panel_initialize(&panel);
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    test_gfx_initialize(
+        &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    console_initialize(
+        &console, &(console_config_t){.gfx = &gfx, .hardware_scroll = true});
+
+    // fills the screen, the cursor ends up on the bottom row
+    char line[32];
+    for (size_t index = 0U; index < 15U; ++index) {
+        console_write(&console, "-\n", 2U);
+    }
+    TEST_CHECK(console_flush(&console) == GFX_ERR_OK);
+
+    // a full new line is one page of cells and the start line command, 131
+    // bytes instead of the 2 KB frame
+    for (size_t index = 0U; index < 40U; ++index) {
+        snprintf(line, sizeof(line), "%021zu", index);
+        test_panel_reset_counters(&panel);
+        console_write(&console, "\n", 1U);
+        console_write(&console, line, 21U);
+        TEST_CHECK(console_flush(&console) == GFX_ERR_OK);
+        TEST_CHECK(panel.spans == 1U);
+        TEST_CHECK(panel.bytes == 3U + 21U * 6U + 2U);
+    }
+}
+
+// A console on the bottom pages scrolls in software and leaves the pages
+// above it alone, its rows show what a console of as many rows at the top of
+// a frame shows
+static void test_window(void)
+{
+    static uint8_t background[TEST_GFX_FRAME_SIZE];
+    size_t window = 11U * TEST_GFX_WIDTH;
+    test_panel_t panel;
+    gfx_t gfx;
+    gfx_t expected_gfx;
+    console_t console;
+    console_t expected;
+
+    test_panel_initialize(&panel);
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    test_gfx_initialize(
+        &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    test_gfx_initialize(&expected_gfx,
+                        expected_frame,
+                        TEST_GFX_WIDTH,
+                        TEST_GFX_HEIGHT,
+                        NULL);
+    for (size_t offset = 0U; offset < sizeof(background); ++offset) {
+        background[offset] = (uint8_t)test_random();
+    }
+    memcpy(frame, background, sizeof(frame));
+    // the columns right of the last cell keep the background
+    memcpy(expected_frame, &background[window], 5U * TEST_GFX_WIDTH);
+    gfx_mark_dirty(&gfx, 0, 0, TEST_GFX_WIDTH, TEST_GFX_HEIGHT);
+    TEST_CHECK(gfx_flush(&gfx) == GFX_ERR_OK);
+
+    console_initialize(&console,
+                       &(console_config_t){.gfx = &gfx,
+                                           .first_row = 11U,
+                                           .hardware_scroll = true});
+    console_initialize(
+        &expected, &(console_config_t){.gfx = &expected_gfx, .rows = 5U});
+    TEST_CHECK(!console.config.hardware_scroll && console.rows == 5U);
+
+    char line[64];
+    for (size_t index = 0U; index < LINES; ++index) {
+        int length = snprintf(line,
+                              sizeof(line),
+                              "%zu %.*s\n",
+                              index,
+                              (int)(test_random() % 40U),
+                              "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMN");
+        console_write(&console, line, (size_t)length);
+        console_write(&expected, line, (size_t)length);
+
+        if (test_random() % 3U == 0U) {
+            TEST_CHECK(console_flush(&console) == GFX_ERR_OK);
+            console_render(&expected);
+            if (!TEST_CHECK(panel.start_line == 0U) ||
+                !TEST_CHECK(memcmp(panel.ram, background, window) == 0) ||
+                !TEST_CHECK(memcmp(&panel.ram[window],
+                                   expected_frame,
+                                   5U * TEST_GFX_WIDTH) == 0)) {
+                break;
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    test_wraparound();
+    test_line_traffic();
+    test_window();
+
+    return test_finish();
+}
@@ -0,0 +1,204 @@
+#include "console.h"
+#include "console_sink.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+
+// Everything the UART sink was handed, in order, the size counts past the
+// end of the data
+typedef struct {
+    char data[8192];
+    size_t size;
+} uart_mock_t;
+
+typedef struct {
+    test_panel_t panel;
+    gfx_interface_t interface;
+    gfx_t gfx;
+    console_t console;
+    uint8_t buffer[64];
+    console_sink_t sink;
+    uart_mock_t uart;
+
+    // fed what the sink accepted, straight and in order
+    gfx_t expected_gfx;
+    console_t expected;
+    size_t written;
+    size_t accepted;
+} fixture_t;
+
+static void fixture_initialize(fixture_t* fixture)
+{
+    memset(fixture, 0, sizeof(*fixture));
+
+    test_panel_initialize(&fixture->panel);
+    fixture->interface = test_panel_get_interface(&fixture->panel);
+    test_gfx_initialize(&fixture->gfx,
+                        frame,
+                        TEST_GFX_WIDTH,
+                        TEST_GFX_HEIGHT,
+                        &fixture->interface);
+    console_initialize(&fixture->console,
+                       &(console_config_t){.gfx = &fixture->gfx});
+    console_sink_initialize(
+        &fixture->sink,
+        &(console_sink_config_t){.console = &fixture->console,
+                                 .buffer = fixture->buffer,
+                                 .buffer_size = sizeof(fixture->buffer)});
+
+    test_gfx_initialize(&fixture->expected_gfx,
+                        expected_frame,
+                        TEST_GFX_WIDTH,
+                        TEST_GFX_HEIGHT,
+                        NULL);
+    console_initialize(&fixture->expected,
+                       &(console_config_t){.gfx = &fixture->expected_gfx});
+}
+
+// What _write does with both sinks added, as main.c adds them
+static void fixture_write(fixture_t* fixture, char const* data, size_t size)
+{
+    uart_mock_t* uart = &fixture->uart;
+    if (uart->size + size <= sizeof(uart->data)) {
+        memcpy(&uart->data[uart->size], data, size);
+    }
+    uart->size += size;
+
+    // writes are taken or dropped whole, never cut inside a sequence
+    size_t accepted = console_sink_write(&fixture->sink, data, size);
+    TEST_CHECK(accepted == 0U || accepted == size);
+
+    console_write(&fixture->expected, data, accepted);
+    fixture->written += size;
+    fixture->accepted += accepted;
+}
+
+static void fixture_write_string(fixture_t* fixture, char const* string)
+{
+    fixture_write(fixture, string, strlen(string));
+}
+
+// The display shows exactly the accepted text, the UART got every byte
+static bool fixture_is_consistent(fixture_t* fixture)
+{
+    console_render(&fixture->expected);
+
+    return memcmp(fixture->console.cells,
+                  fixture->expected.cells,
+                  sizeof(fixture->console.cells)) == 0 &&
+           fixture->console.cursor_row == fixture->expected.cursor_row &&
+           fixture->console.cursor_column ==
+               fixture->expected.cursor_column &&
+           memcmp(fixture->panel.ram, expected_frame, sizeof(frame)) == 0 &&
+           fixture->uart.size == fixture->written &&
+           console_sink_get_dropped(&fixture->sink) ==
+               fixture->written - fixture->accepted;
+}
+
+static void test_writes_only_queue(void)
+{
+    static fixture_t fixture;
+    fixture_initialize(&fixture);
+    TEST_CHECK(console_sink_process(&fixture.sink) == GFX_ERR_OK);
+    test_panel_reset_counters(&fixture.panel);
+
+    fixture_write_string(&fixture, "boot\n");
+    fixture_write_string(&fixture, "Zażółć\n");
+
+    // nothing reaches the panel from the writer's context
+    TEST_CHECK(fixture.panel.bytes == 0U);
+    TEST_CHECK(fixture.console.cells[0][0].code_point == ' ');
+    TEST_CHECK(fixture.uart.size == 5U + 11U);
+    TEST_CHECK(memcmp(fixture.uart.data, "boot\nZażółć\n", 16U) == 0);
+
+    TEST_CHECK(console_sink_process(&fixture.sink) == GFX_ERR_OK);
+    TEST_CHECK(fixture.panel.bytes > 0U);
+    TEST_CHECK(fixture_is_consistent(&fixture));
+    TEST_CHECK(console_sink_get_dropped(&fixture.sink) == 0U);
+}
+
+static void test_overflow(void)
+{
+    static fixture_t fixture;
+    char line[32];
+
+    fixture_initialize(&fixture);
+
+    // a burst larger than the ring between two process calls
+    for (size_t index = 0U; index < 10U; ++index) {
+        snprintf(line, sizeof(line), "line %02zu of the burst\n", index);
+        fixture_write_string(&fixture, line);
+    }
+    TEST_CHECK(fixture.accepted <= sizeof(fixture.buffer));
+    TEST_CHECK(fixture.accepted < fixture.written);
+    TEST_CHECK(console_sink_process(&fixture.sink) == GFX_ERR_OK);
+    TEST_CHECK(fixture_is_consistent(&fixture));
+
+    // drained, so the next line is taken whole
+    size_t dropped = console_sink_get_dropped(&fixture.sink);
+    fixture_write_string(&fixture, "after\n");
+    TEST_CHECK(console_sink_get_dropped(&fixture.sink) == dropped);
+    TEST_CHECK(console_sink_process(&fixture.sink) == GFX_ERR_OK);
+    TEST_CHECK(fixture_is_consistent(&fixture));
+}
+
+static void test_random_bursts(void)
+{
+    static char const* const texts[] = {
+        "x",
+        "tick 1234\n",
+        "Zażółć gęślą jaźń\n",
+        "\x1b[7minverse\x1b[m\n",
+        "\x1b[2J\x1b[H",
+        "a long line that wraps past the right edge of the panel\n",
+    };
+    static fixture_t fixture;
+
+    fixture_initialize(&fixture);
+
+    for (size_t round = 0U; round < 2000U; ++round) {
+        size_t writes = test_random() % 6U;
+        for (size_t index = 0U; index < writes; ++index) {
+            fixture_write_string(&fixture, texts[test_random() % 6U]);
+        }
+
+        TEST_CHECK(console_sink_process(&fixture.sink) == GFX_ERR_OK);
+        if (!TEST_CHECK(fixture_is_consistent(&fixture))) {
+            fprintf(stderr, "  round %zu\n", round);
+            break;
+        }
+    }
+}
+
+static void test_detach(void)
+{
+    static fixture_t fixture;
+    fixture_initialize(&fixture);
+    TEST_CHECK(console_sink_process(&fixture.sink) == GFX_ERR_OK);
+
+    // queued text is discarded and later writes are not taken, the panel
+    // never hears of either
+    console_sink_write(&fixture.sink, "queued\n", 7U);
+    console_sink_detach(&fixture.sink);
+    TEST_CHECK(console_sink_write(&fixture.sink, "later\n", 6U) == 0U);
+    test_panel_reset_counters(&fixture.panel);
+    TEST_CHECK(console_sink_process(&fixture.sink) == GFX_ERR_OK);
+    TEST_CHECK(fixture.panel.bytes == 0U);
+    TEST_CHECK(fixture.console.cells[0][0].code_point == ' ');
+    TEST_CHECK(console_sink_get_dropped(&fixture.sink) == 0U);
+}
+
+int main(void)
+{
+    test_writes_only_queue();
+    test_overflow();
+    test_random_bursts();
+    test_detach();
+
+    return test_finish();
+}
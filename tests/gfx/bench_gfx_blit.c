@@ -0,0 +1,97 @@
+#include "gfx_blit.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <stdio.h>
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+
+// A 32x32 image, four pages of 32 columns
+static uint8_t image[32U * 4U];
+
+typedef enum {
+    WORKLOAD_SCROLL_PAGE,
+    WORKLOAD_SCROLL_ROW,
+    WORKLOAD_IMAGE_ALIGNED,
+    WORKLOAD_IMAGE_SHIFTED,
+    WORKLOAD_IMAGE_PIXELS,
+} workload_t;
+
+static void draw(gfx_t* gfx, workload_t workload, size_t iteration)
+{
+    static gfx_bitmap_t const bitmap = {
+        .data = image, .width = 32U, .height = 32U};
+    gfx_bitmap_t screen = gfx_get_frame(gfx);
+    int16_t x = (int16_t)(iteration % 96U);
+
+    switch (workload) {
+        case WORKLOAD_SCROLL_PAGE: {
+            gfx_blit(gfx, 0, 0, &screen, 0, 8, 128, 120, GFX_ROP_COPY);
+            break;
+        }
+        case WORKLOAD_SCROLL_ROW: {
+            gfx_blit(gfx, 0, 0, &screen, 0, 1, 128, 127, GFX_ROP_COPY);
+            break;
+        }
+        case WORKLOAD_IMAGE_ALIGNED: {
+            gfx_blit(gfx, x, 64, &bitmap, 0, 0, 32, 32, GFX_ROP_XOR);
+            break;
+        }
+        case WORKLOAD_IMAGE_SHIFTED: {
+            gfx_blit(gfx, x, 61, &bitmap, 0, 0, 32, 32, GFX_ROP_XOR);
+            break;
+        }
+        default: {
+            for (uint32_t row = 0U; row < 32U; ++row) {
+                for (uint32_t column = 0U; column < 32U; ++column) {
+                    uint32_t byte = image[row / 8U * 32U + column];
+                    if ((byte >> (row % 8U)) & 1U) {
+                        int16_t at_x = (int16_t)(x + (int16_t)column);
+                        int16_t at_y = (int16_t)(61 + (int16_t)row);
+                        gfx_set_pixel(
+                            gfx, at_x, at_y, !gfx_get_pixel(gfx, at_x, at_y));
+                    }
+                }
+            }
+            break;
+        }
+    }
+}
+
+static void run(gfx_t* gfx,
+                char const* name,
+                workload_t workload,
+                size_t iterations)
+{
+    uint64_t begin = test_get_time();
+
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        draw(gfx, workload, iteration);
+    }
+
+    test_report(name, iterations, test_get_time() - begin);
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations = test_get_iterations(argc, argv, 100000U);
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    for (size_t offset = 0U; offset < sizeof(frame); ++offset) {
+        frame[offset] = (uint8_t)test_random();
+    }
+    for (size_t offset = 0U; offset < sizeof(image); ++offset) {
+        image[offset] = (uint8_t)test_random();
+    }
+
+    run(&gfx, "scroll one page", WORKLOAD_SCROLL_PAGE, iterations);
+    run(&gfx, "scroll one row", WORKLOAD_SCROLL_ROW, iterations);
+    run(&gfx, "32x32 XOR page aligned", WORKLOAD_IMAGE_ALIGNED, iterations);
+    run(&gfx, "32x32 XOR 3 rows off", WORKLOAD_IMAGE_SHIFTED, iterations);
+    run(&gfx,
+        "32x32 XOR pixel by pixel",
+        WORKLOAD_IMAGE_PIXELS,
+        iterations / 10U);
+
+    return test_finish();
+}
@@ -0,0 +1,99 @@
+#include "gfx_draw.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <stdio.h>
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+
+typedef enum {
+    SHAPE_CIRCLE,
+    SHAPE_FILL_CIRCLE,
+    SHAPE_FILL_ELLIPSE,
+    SHAPE_FILL_ARC,
+    // gfx_set_pixel over the bounding box, what the fills replace
+    SHAPE_PIXELS,
+} shape_t;
+
+static void draw(gfx_t* gfx, shape_t shape, int16_t radius, gfx_rop_t rop)
+{
+    switch (shape) {
+        case SHAPE_CIRCLE: {
+            gfx_draw_circle(gfx, 64, 64, radius, rop);
+            break;
+        }
+        case SHAPE_FILL_CIRCLE: {
+            gfx_fill_circle(gfx, 64, 64, radius, rop);
+            break;
+        }
+        case SHAPE_FILL_ELLIPSE: {
+            gfx_fill_ellipse(gfx, 64, 64, radius, radius / 2, rop);
+            break;
+        }
+        case SHAPE_FILL_ARC: {
+            gfx_fill_arc(gfx, 64, 64, radius, 30, 300, rop);
+            break;
+        }
+        default: {
+            int32_t limit = (int32_t)radius * radius + radius;
+            for (int32_t y = -radius; y <= radius; ++y) {
+                for (int32_t x = -radius; x <= radius; ++x) {
+                    if (x * x + y * y <= limit) {
+                        gfx_set_pixel(gfx,
+                                      (int16_t)(64 + x),
+                                      (int16_t)(64 + y),
+                                      rop == GFX_ROP_SET);
+                    }
+                }
+            }
+            break;
+        }
+    }
+}
+
+static void run(gfx_t* gfx,
+                char const* name,
+                shape_t shape,
+                int16_t radius,
+                size_t iterations)
+{
+    char label[64];
+    uint64_t begin = test_get_time();
+
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        draw(gfx,
+             shape,
+             radius,
+             iteration % 2U == 0U ? GFX_ROP_SET : GFX_ROP_CLEAR);
+    }
+
+    snprintf(label, sizeof(label), "%s radius %d", name, radius);
+    test_report(label, iterations, test_get_time() - begin);
+}
+
+int main(int argc, char** argv)
+{
+    static int16_t const radii[] = {4, 16, 63};
+    size_t iterations = test_get_iterations(argc, argv, 100000U);
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    for (size_t index = 0U; index < sizeof(radii) / sizeof(*radii); ++index) {
+        int16_t radius = radii[index];
+        run(&gfx, "circle", SHAPE_CIRCLE, radius, iterations);
+        run(&gfx, "fill_circle", SHAPE_FILL_CIRCLE, radius, iterations);
+        run(&gfx,
+            "fill_ellipse half height",
+            SHAPE_FILL_ELLIPSE,
+            radius,
+            iterations);
+        run(&gfx, "fill_arc 270 degrees", SHAPE_FILL_ARC, radius, iterations);
+        run(&gfx,
+            "disc pixel by pixel",
+            SHAPE_PIXELS,
+            radius,
+            iterations / 10U);
+    }
+
+    return test_finish();
+}
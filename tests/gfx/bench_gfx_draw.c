@@ -0,0 +1,127 @@
+#include "gfx_draw.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <stdio.h>
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+
+typedef enum {
+    SHAPE_FILL,
+    SHAPE_HLINE,
+    SHAPE_VLINE,
+    SHAPE_LINE,
+} shape_t;
+
+static void draw(gfx_t* gfx, shape_t shape, size_t iteration)
+{
+    gfx_rop_t rop = iteration % 2U == 0U ? GFX_ROP_SET : GFX_ROP_CLEAR;
+    int16_t offset = (int16_t)(iteration % TEST_GFX_HEIGHT);
+
+    switch (shape) {
+        case SHAPE_FILL: {
+            gfx_fill_rect(gfx, 3, 5, 120, 110, rop);
+            break;
+        }
+        case SHAPE_HLINE: {
+            gfx_draw_hline(gfx, 0, offset, TEST_GFX_WIDTH, rop);
+            break;
+        }
+        case SHAPE_VLINE: {
+            gfx_draw_vline(gfx, offset, 0, TEST_GFX_HEIGHT, rop);
+            break;
+        }
+        default: {
+            gfx_draw_line(gfx, 0, offset, 127, (int16_t)(127 - offset), rop);
+            break;
+        }
+    }
+}
+
+// The same pixels one gfx_set_pixel at a time
+static void draw_pixels(gfx_t* gfx, shape_t shape, size_t iteration)
+{
+    bool state = iteration % 2U == 0U;
+    int32_t offset = (int32_t)(iteration % TEST_GFX_HEIGHT);
+
+    switch (shape) {
+        case SHAPE_FILL: {
+            for (int32_t y = 5; y < 115; ++y) {
+                for (int32_t x = 3; x < 123; ++x) {
+                    gfx_set_pixel(gfx, (int16_t)x, (int16_t)y, state);
+                }
+            }
+            break;
+        }
+        case SHAPE_HLINE: {
+            for (int32_t x = 0; x < (int32_t)TEST_GFX_WIDTH; ++x) {
+                gfx_set_pixel(gfx, (int16_t)x, (int16_t)offset, state);
+            }
+            break;
+        }
+        case SHAPE_VLINE: {
+            for (int32_t y = 0; y < (int32_t)TEST_GFX_HEIGHT; ++y) {
+                gfx_set_pixel(gfx, (int16_t)offset, (int16_t)y, state);
+            }
+            break;
+        }
+        default: {
+            int32_t x = 0;
+            int32_t y = offset;
+            int32_t y1 = 127 - offset;
+            int32_t dy = y1 > y ? y - y1 : y1 - y;
+            int32_t error = 127 + dy;
+            while (true) {
+                gfx_set_pixel(gfx, (int16_t)x, (int16_t)y, state);
+                if (x == 127 && y == y1) {
+                    break;
+                }
+                int32_t doubled = 2 * error;
+                if (doubled >= dy) {
+                    error += dy;
+                    ++x;
+                }
+                if (doubled <= 127) {
+                    error += 127;
+                    y += y < y1 ? 1 : -1;
+                }
+            }
+            break;
+        }
+    }
+}
+
+// Cost per primitive against setting its pixels one by one
+static void run(gfx_t* gfx, char const* name, shape_t shape, size_t count)
+{
+    uint64_t begin = test_get_time();
+    for (size_t iteration = 0U; iteration < count; ++iteration) {
+        draw(gfx, shape, iteration);
+    }
+    uint64_t drawing = test_get_time() - begin;
+
+    begin = test_get_time();
+    for (size_t iteration = 0U; iteration < count; ++iteration) {
+        draw_pixels(gfx, shape, iteration);
+    }
+    uint64_t plotting = test_get_time() - begin;
+
+    test_report(name, count, drawing);
+    printf("%-40s %10.1f x faster than gfx_set_pixel\n",
+           "",
+           (double)plotting / (double)drawing);
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations = test_get_iterations(argc, argv, 100000U);
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    run(&gfx, "fill_rect 120x110", SHAPE_FILL, iterations / 10U);
+    run(&gfx, "hline 128", SHAPE_HLINE, iterations);
+    run(&gfx, "vline 128", SHAPE_VLINE, iterations);
+    run(&gfx, "line 128 columns", SHAPE_LINE, iterations);
+
+    return test_finish();
+}
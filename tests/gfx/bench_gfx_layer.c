@@ -0,0 +1,177 @@
+#include "gfx_draw.h"
+#include "gfx_layer.h"
+#include "gfx_printf.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdio.h>
+
+static uint8_t background[TEST_GFX_FRAME_SIZE];
+static uint8_t content_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t overlay_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t staging[TEST_GFX_WIDTH];
+
+// Three 30x16 number fields over the flash background
+#define WINDOWS (3U)
+static uint8_t window_frames[WINDOWS][30U * 2U];
+
+typedef enum {
+    WORKLOAD_BLINK,
+    WORKLOAD_RECOMPOSE,
+    WORKLOAD_FLUSH,
+} workload_t;
+
+static void run(gfx_compositor_t* compositor,
+                gfx_t* gfx,
+                char const* name,
+                workload_t workload,
+                size_t iterations)
+{
+    uint64_t begin = test_get_time();
+
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        switch (workload) {
+            case WORKLOAD_BLINK: {
+                gfx_fill_rect(gfx, 60, 60, 2, 10, GFX_ROP_XOR);
+                gfx_compositor_flush(compositor);
+                break;
+            }
+            case WORKLOAD_RECOMPOSE: {
+                gfx_compositor_set_visible(
+                    compositor, 2U, (iteration & 1U) != 0U);
+                gfx_compositor_flush(compositor);
+                break;
+            }
+            default: {
+                gfx_mark_dirty(gfx, 0, 0, 128, 128);
+                gfx_flush(gfx);
+                break;
+            }
+        }
+    }
+
+    test_report(name, iterations, test_get_time() - begin);
+}
+
+// The fields printed again every frame, with no frame sized buffer in RAM
+static void run_dashboard(test_panel_t* panel, size_t iterations)
+{
+    gfx_interface_t interface = test_panel_get_interface(panel);
+    gfx_t windows[WINDOWS];
+    gfx_layer_t layers[WINDOWS + 1U] = {
+        {.data = background, .rop = GFX_ROP_SET, .visible = true},
+    };
+
+    for (size_t index = 0U; index < WINDOWS; ++index) {
+        test_gfx_initialize(
+            &windows[index], window_frames[index], 30U, 16U, NULL);
+        layers[index + 1U] = (gfx_layer_t){
+            .gfx = &windows[index],
+            .x = 10U + index * 38U,
+            .page = 2U + index * 4U,
+            .rop = GFX_ROP_COPY,
+            .visible = true,
+        };
+    }
+
+    gfx_compositor_t compositor;
+    gfx_compositor_initialize(
+        &compositor,
+        &(gfx_compositor_config_t){.layers = layers,
+                                   .layer_count = WINDOWS + 1U,
+                                   .frame_width = TEST_GFX_WIDTH,
+                                   .frame_height = TEST_GFX_HEIGHT,
+                                   .staging = staging},
+        &interface);
+    gfx_compositor_flush(&compositor);
+    test_panel_reset_counters(panel);
+
+    uint64_t begin = test_get_time();
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        for (size_t index = 0U; index < WINDOWS; ++index) {
+            gfx_fill_rect(&windows[index], 0, 0, 30, 16, GFX_ROP_CLEAR);
+            gfx_draw_printf(&windows[index],
+                            0,
+                            4,
+                            GFX_ROP_SET,
+                            "%u",
+                            (uint32_t)((iteration * 7U + index) % 10000U));
+        }
+        gfx_compositor_flush(&compositor);
+    }
+    test_report("three printed windows", iterations, test_get_time() - begin);
+    printf("%-40s %10.1f bytes\n",
+           "",
+           (double)panel->bytes / (double)iterations);
+
+    gfx_compositor_deinitialize(&compositor);
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations = test_get_iterations(argc, argv, 100000U);
+    test_panel_t panel;
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    gfx_t content;
+    gfx_t overlay;
+    gfx_t plain;
+
+    test_panel_initialize(&panel);
+    test_gfx_initialize(
+        &content, content_frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    test_gfx_initialize(
+        &overlay, overlay_frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    for (size_t offset = 0U; offset < sizeof(background); ++offset) {
+        background[offset] = (uint8_t)test_random();
+        content_frame[offset] = (uint8_t)test_random();
+    }
+
+    gfx_layer_t layers[] = {
+        {.data = background, .rop = GFX_ROP_SET, .visible = true},
+        {.gfx = &content, .rop = GFX_ROP_XOR, .visible = true},
+        {.gfx = &overlay, .rop = GFX_ROP_XOR, .visible = true},
+    };
+    gfx_compositor_t compositor;
+    gfx_compositor_initialize(
+        &compositor,
+        &(gfx_compositor_config_t){.layers = layers,
+                                   .layer_count = 3U,
+                                   .frame_width = TEST_GFX_WIDTH,
+                                   .frame_height = TEST_GFX_HEIGHT,
+                                   .staging = staging},
+        &interface);
+    gfx_compositor_flush(&compositor);
+
+    test_panel_reset_counters(&panel);
+    run(&compositor, &overlay, "2x10 cursor blink", WORKLOAD_BLINK, iterations);
+    printf("%-40s %10.1f bytes\n",
+           "",
+           (double)panel.bytes / (double)iterations);
+
+    run(&compositor,
+        &overlay,
+        "three layer recompose",
+        WORKLOAD_RECOMPOSE,
+        iterations / 10U);
+    gfx_compositor_set_rop(&compositor, 1U, GFX_ROP_CLEAR);
+    run(&compositor,
+        &overlay,
+        "three layer recompose with a mask",
+        WORKLOAD_RECOMPOSE,
+        iterations / 10U);
+
+    // the same frame flushed from one buffer, without composing
+    test_gfx_initialize(
+        &plain, content_frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    run(&compositor,
+        &plain,
+        "plain full flush",
+        WORKLOAD_FLUSH,
+        iterations / 10U);
+
+    gfx_compositor_deinitialize(&compositor);
+
+    run_dashboard(&panel, iterations / 10U);
+
+    return test_finish();
+}
@@ -0,0 +1,98 @@
+#include "gfx_polygon.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <math.h>
+#include <stdio.h>
+
+#define PI (3.14159265358979323846)
+#define POINTS_MAX (64U)
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+
+// A regular polygon, or a star when every other point is pulled inwards
+static size_t make_polygon(gfx_point_t* points,
+                           size_t count,
+                           double radius,
+                           double inner_radius)
+{
+    for (size_t index = 0U; index < count; ++index) {
+        double angle = 2.0 * PI * (double)index / (double)count;
+        double distance = index % 2U == 0U ? radius : inner_radius;
+        points[index] = (gfx_point_t){
+            .x = (int16_t)lround(64.0 + distance * cos(angle)),
+            .y = (int16_t)lround(64.0 + distance * sin(angle)),
+        };
+    }
+
+    return count;
+}
+
+static void run(gfx_t* gfx,
+                char const* name,
+                gfx_point_t const* points,
+                size_t count,
+                gfx_fill_rule_t rule,
+                size_t iterations)
+{
+    gfx_edge_t edges[POINTS_MAX];
+    uint64_t begin = test_get_time();
+
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        gfx_fill_polygon(gfx,
+                         points,
+                         count,
+                         rule,
+                         edges,
+                         POINTS_MAX,
+                         iteration % 2U == 0U ? GFX_ROP_SET : GFX_ROP_CLEAR);
+    }
+
+    test_report(name, iterations, test_get_time() - begin);
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations = test_get_iterations(argc, argv, 100000U);
+    gfx_point_t points[POINTS_MAX];
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    static gfx_point_t const triangle[] = {{10, 120}, {64, 8}, {118, 100}};
+    run(&gfx, "triangle", triangle, 3U, GFX_FILL_RULE_EVEN_ODD, iterations);
+
+    static gfx_point_t const pentagram[] = {
+        {64, 4}, {100, 120}, {8, 46}, {120, 46}, {28, 120}};
+    run(&gfx,
+        "pentagram nonzero",
+        pentagram,
+        5U,
+        GFX_FILL_RULE_NONZERO,
+        iterations);
+
+    size_t count = make_polygon(points, 16U, 60.0, 25.0);
+    run(&gfx,
+        "8 pointed star",
+        points,
+        count,
+        GFX_FILL_RULE_EVEN_ODD,
+        iterations);
+
+    count = make_polygon(points, POINTS_MAX, 60.0, 60.0);
+    run(&gfx,
+        "64-gon radius 60",
+        points,
+        count,
+        GFX_FILL_RULE_EVEN_ODD,
+        iterations);
+
+    count = make_polygon(points, 8U, 6.0, 6.0);
+    run(&gfx,
+        "octagon radius 6",
+        points,
+        count,
+        GFX_FILL_RULE_EVEN_ODD,
+        iterations);
+
+    return test_finish();
+}
@@ -0,0 +1,49 @@
+#include "gfx_printf.h"
+#include "gfx_text.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <stdio.h>
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+
+int main(int argc, char** argv)
+{
+    size_t iterations = test_get_iterations(argc, argv, 1000000U);
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    // the values of a sensor readout line, "T -12.35 C  H 0x1F3A"
+    uint64_t begin = test_get_time();
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        int32_t value = (int32_t)(iteration % 5000U) - 2500;
+        gfx_draw_printf(&gfx,
+                        0,
+                        8,
+                        GFX_ROP_COPY,
+                        "T %6.2k C  H 0x%04X",
+                        value,
+                        (unsigned)iteration & 0xFFFFU);
+    }
+    test_report("gfx_draw_printf", iterations, test_get_time() - begin);
+
+    // the path it replaces, a buffer formatted by the C library
+    begin = test_get_time();
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        int32_t value = (int32_t)(iteration % 5000U) - 2500;
+        char buffer[32];
+        snprintf(buffer,
+                 sizeof(buffer),
+                 "T %s%3ld.%02ld C  H 0x%04X",
+                 value < 0 ? "-" : " ",
+                 (long)((value < 0 ? -value : value) / 100),
+                 (long)((value < 0 ? -value : value) % 100),
+                 (unsigned)iteration & 0xFFFFU);
+        gfx_draw_string(&gfx, 0, 8, buffer, GFX_ROP_COPY);
+    }
+    test_report("snprintf and gfx_draw_string",
+                iterations,
+                test_get_time() - begin);
+
+    return test_finish();
+}
@@ -0,0 +1,83 @@
+#include "gfx_draw.h"
+#include "gfx_text.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <stdio.h>
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+
+typedef enum {
+    WORKLOAD_FILL,
+    WORKLOAD_LINE,
+    WORKLOAD_FILL_CIRCLE,
+    WORKLOAD_STRING,
+} workload_t;
+
+static void draw(gfx_t* gfx, workload_t workload, gfx_rop_t rop)
+{
+    switch (workload) {
+        case WORKLOAD_FILL: {
+            gfx_fill_rect(gfx, 3, 5, 120, 110, rop);
+            break;
+        }
+        case WORKLOAD_LINE: {
+            gfx_draw_line(gfx, 0, 10, 127, 117, rop);
+            break;
+        }
+        case WORKLOAD_FILL_CIRCLE: {
+            gfx_fill_circle(gfx, 64, 64, 40, rop);
+            break;
+        }
+        default: {
+            gfx_draw_string(gfx, 3, 61, "Temperature 23.5 C", rop);
+            break;
+        }
+    }
+}
+
+// Every operation has to cost what SET costs, apart from text where AND,
+// INVERT and COPY also write the spacer columns
+static void run(gfx_t* gfx,
+                char const* name,
+                workload_t workload,
+                size_t iterations)
+{
+    static struct {
+        gfx_rop_t rop;
+        char const* name;
+    } const rops[] = {
+        {GFX_ROP_SET, "SET"},
+        {GFX_ROP_CLEAR, "CLEAR"},
+        {GFX_ROP_XOR, "XOR"},
+        {GFX_ROP_AND, "AND"},
+        {GFX_ROP_INVERT, "INVERT"},
+        {GFX_ROP_COPY, "COPY"},
+    };
+
+    for (size_t index = 0U; index < sizeof(rops) / sizeof(*rops); ++index) {
+        char label[64];
+        uint64_t begin = test_get_time();
+
+        for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+            draw(gfx, workload, rops[index].rop);
+        }
+
+        snprintf(label, sizeof(label), "%s %s", name, rops[index].name);
+        test_report(label, iterations, test_get_time() - begin);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations = test_get_iterations(argc, argv, 100000U);
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    run(&gfx, "fill_rect 120x110", WORKLOAD_FILL, iterations);
+    run(&gfx, "line 128x108", WORKLOAD_LINE, iterations);
+    run(&gfx, "fill_circle radius 40", WORKLOAD_FILL_CIRCLE, iterations);
+    run(&gfx, "string 18 glyphs", WORKLOAD_STRING, iterations);
+
+    return test_finish();
+}
@@ -0,0 +1,89 @@
+#include "font5x7.h"
+#include "gfx_text.h"
+#include "test.h"
+#include "test_gfx.h"
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+
+// Cost per glyph of a string, drawn on every line of the frame
+static void run(gfx_t* gfx,
+                char const* name,
+                char const* string,
+                size_t glyphs,
+                size_t iterations)
+{
+    uint64_t begin = test_get_time();
+
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        int16_t y = (int16_t)((iteration % 16U) * 8U);
+        gfx_draw_string(
+            gfx, (int16_t)(iteration % 3U), y, string, GFX_ROP_SET);
+    }
+
+    test_report(name, iterations * glyphs, test_get_time() - begin);
+}
+
+// The loop gfx_draw_string replaced, as sh1107_draw_string drew ASCII: the
+// glyph indexed by the byte, then pixel by pixel
+static void draw_naive_string(gfx_t* gfx,
+                              int16_t x,
+                              int16_t y,
+                              char const* string)
+{
+    for (; *string != '\0'; ++string) {
+        uint8_t const* glyph =
+            font5x7[(unsigned char)*string - FONT5X7_CHAR_CODE_OFFSET];
+
+        for (size_t column = 0U; column < FONT5X7_WIDTH; ++column) {
+            for (size_t row = 0U; row < FONT5X7_HEIGHT; ++row) {
+                if ((glyph[column] & (1U << row)) != 0U) {
+                    gfx_set_pixel(gfx,
+                                  (int16_t)(x + (int16_t)column),
+                                  (int16_t)(y + (int16_t)row),
+                                  true);
+                }
+            }
+        }
+        x = (int16_t)(x + (int16_t)FONT5X7_CHAR_WIDTH);
+    }
+}
+
+static void run_naive(gfx_t* gfx,
+                      char const* name,
+                      char const* string,
+                      size_t glyphs,
+                      size_t iterations)
+{
+    uint64_t begin = test_get_time();
+
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        int16_t y = (int16_t)((iteration % 16U) * 8U);
+        draw_naive_string(gfx, (int16_t)(iteration % 3U), y, string);
+    }
+
+    test_report(name, iterations * glyphs, test_get_time() - begin);
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations = test_get_iterations(argc, argv, 1000000U);
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    // 20 glyphs each, all ASCII, Polish text and nothing but extended glyphs
+    run_naive(&gfx,
+              "ascii glyph, pixel by pixel",
+              "Temperature: 23.5 C ",
+              20U,
+              iterations);
+    run(&gfx, "ascii glyph", "Temperature: 23.5 C ", 20U, iterations);
+    run(&gfx, "polish text glyph", "Zażółć gęślą jaźń 1 ", 20U, iterations);
+    run(&gfx,
+        "extended glyph",
+        "ĄĆĘŁŃÓŚŹŻąćęłńóśźż€",
+        20U,
+        iterations);
+
+    return test_finish();
+}
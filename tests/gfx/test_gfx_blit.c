@@ -0,0 +1,285 @@
+#include "gfx_blit.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TRIALS (4000U)
+#define SOURCE_SIZE_MAX (150U)
+
+static gfx_rop_t const rops[] = {
+    GFX_ROP_SET,
+    GFX_ROP_CLEAR,
+    GFX_ROP_XOR,
+    GFX_ROP_AND,
+    GFX_ROP_INVERT,
+    GFX_ROP_COPY,
+};
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t before[TEST_GFX_FRAME_SIZE];
+
+static size_t get_size(size_t width, size_t height)
+{
+    return width * ((height + GFX_PAGE_HEIGHT - 1U) / GFX_PAGE_HEIGHT);
+}
+
+static bool get_bit(uint8_t const* data, size_t width, int32_t x, int32_t y)
+{
+    uint8_t byte = data[(size_t)y / GFX_PAGE_HEIGHT * width + (size_t)x];
+
+    return ((uint32_t)byte >> ((uint32_t)y % GFX_PAGE_HEIGHT)) & 1U;
+}
+
+static void put_bit(uint8_t* data, size_t width, int32_t x, int32_t y, bool bit)
+{
+    uint8_t* byte = &data[(size_t)y / GFX_PAGE_HEIGHT * width + (size_t)x];
+    uint8_t mask = (uint8_t)(1U << ((uint32_t)y % GFX_PAGE_HEIGHT));
+
+    *byte = bit ? (uint8_t)(*byte | mask) : (uint8_t)(*byte & ~mask);
+}
+
+static bool apply(bool pixel, bool source, gfx_rop_t rop)
+{
+    switch (rop) {
+        case GFX_ROP_SET: {
+            return pixel || source;
+        }
+        case GFX_ROP_CLEAR: {
+            return pixel && !source;
+        }
+        case GFX_ROP_XOR: {
+            return pixel != source;
+        }
+        case GFX_ROP_AND: {
+            return pixel && source;
+        }
+        case GFX_ROP_INVERT: {
+            return !pixel;
+        }
+        default: {
+            return source;
+        }
+    }
+}
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t source_x;
+    int16_t source_y;
+    int16_t width;
+    int16_t height;
+    gfx_rop_t rop;
+} blit_t;
+
+// Pixel by pixel from a copy of the source, so that it also holds for a
+// buffer blitted onto itself. Only pixels inside both buffers take part.
+static void blit_reference(uint8_t* buffer,
+                           size_t buffer_width,
+                           size_t buffer_height,
+                           gfx_bitmap_t const* source,
+                           blit_t const* blit)
+{
+    static uint8_t copy[SOURCE_SIZE_MAX * SOURCE_SIZE_MAX];
+    memcpy(copy, source->data, get_size(source->width, source->height));
+
+    for (int32_t row = 0; row < blit->height; ++row) {
+        for (int32_t column = 0; column < blit->width; ++column) {
+            int32_t x = blit->x + column;
+            int32_t y = blit->y + row;
+            int32_t source_x = blit->source_x + column;
+            int32_t source_y = blit->source_y + row;
+            if (x < 0 || y < 0 || x >= (int32_t)buffer_width ||
+                y >= (int32_t)buffer_height || source_x < 0 ||
+                source_y < 0 || source_x >= (int32_t)source->width ||
+                source_y >= (int32_t)source->height) {
+                continue;
+            }
+
+            bool pixel = get_bit(buffer, buffer_width, x, y);
+            bool bit = get_bit(copy, source->width, source_x, source_y);
+            put_bit(buffer, buffer_width, x, y, apply(pixel, bit, blit->rop));
+        }
+    }
+}
+
+static int16_t get_random(int32_t low, int32_t high)
+{
+    return (int16_t)(low + (int32_t)(test_random() % (uint32_t)(high - low)));
+}
+
+static blit_t get_random_blit(void)
+{
+    return (blit_t){
+        .x = get_random(-40, 170),
+        .y = get_random(-40, 170),
+        .source_x = get_random(-40, 170),
+        .source_y = get_random(-40, 170),
+        .width = get_random(-5, 170),
+        .height = get_random(-5, 170),
+        .rop = rops[test_random() % 6U],
+    };
+}
+
+// Each bitmap on the heap at its exact size, so that ASan sees reads past it
+static uint8_t* make_random_bitmap(size_t width, size_t height)
+{
+    size_t size = get_size(width, height);
+    uint8_t* data = malloc(size);
+
+    for (size_t offset = 0U; offset < size; ++offset) {
+        data[offset] = (uint8_t)test_random();
+    }
+
+    return data;
+}
+
+static void fill_random(uint8_t* data, size_t size)
+{
+    for (size_t offset = 0U; offset < size; ++offset) {
+        data[offset] = (uint8_t)test_random();
+    }
+}
+
+static void test_bitmap(gfx_t* gfx)
+{
+    for (size_t trial = 0U; trial < TRIALS; ++trial) {
+        size_t width = test_random() % SOURCE_SIZE_MAX + 1U;
+        size_t height = test_random() % SOURCE_SIZE_MAX + 1U;
+        uint8_t* data = make_random_bitmap(width, height);
+        gfx_bitmap_t source = {.data = data, .width = width, .height = height};
+        blit_t blit = get_random_blit();
+
+        fill_random(frame, sizeof(frame));
+        memcpy(expected_frame, frame, sizeof(frame));
+        memcpy(before, frame, sizeof(frame));
+        gfx_clear_dirty(gfx);
+
+        gfx_blit(gfx,
+                 blit.x,
+                 blit.y,
+                 &source,
+                 blit.source_x,
+                 blit.source_y,
+                 blit.width,
+                 blit.height,
+                 blit.rop);
+        blit_reference(expected_frame,
+                       TEST_GFX_WIDTH,
+                       TEST_GFX_HEIGHT,
+                       &source,
+                       &blit);
+        free(data);
+
+        if (!TEST_CHECK(memcmp(frame, expected_frame, sizeof(frame)) == 0) ||
+            !TEST_CHECK(test_gfx_is_dirty(gfx, before))) {
+            break;
+        }
+    }
+}
+
+// Scrolling and moving within the frame, in every direction
+static void test_overlapping(gfx_t* gfx)
+{
+    gfx_bitmap_t source = gfx_get_frame(gfx);
+    gfx_bitmap_t expected_source = {.data = expected_frame,
+                                    .width = TEST_GFX_WIDTH,
+                                    .height = TEST_GFX_HEIGHT};
+
+    for (size_t trial = 0U; trial < TRIALS; ++trial) {
+        blit_t blit = get_random_blit();
+        // mostly short moves, which overlap
+        if (test_random() % 2U == 0U) {
+            blit.source_x = (int16_t)(blit.x + get_random(-9, 10));
+            blit.source_y = (int16_t)(blit.y + get_random(-17, 18));
+        }
+
+        fill_random(frame, sizeof(frame));
+        memcpy(expected_frame, frame, sizeof(frame));
+        memcpy(before, frame, sizeof(frame));
+        gfx_clear_dirty(gfx);
+
+        gfx_blit(gfx,
+                 blit.x,
+                 blit.y,
+                 &source,
+                 blit.source_x,
+                 blit.source_y,
+                 blit.width,
+                 blit.height,
+                 blit.rop);
+        blit_reference(expected_frame,
+                       TEST_GFX_WIDTH,
+                       TEST_GFX_HEIGHT,
+                       &expected_source,
+                       &blit);
+
+        if (!TEST_CHECK(memcmp(frame, expected_frame, sizeof(frame)) == 0) ||
+            !TEST_CHECK(test_gfx_is_dirty(gfx, before))) {
+            break;
+        }
+    }
+}
+
+// Buffers of any size, on the heap so that ASan sees writes past them
+static void test_buffer(void)
+{
+    for (size_t trial = 0U; trial < TRIALS; ++trial) {
+        size_t width = test_random() % 60U + 1U;
+        size_t height = test_random() % 60U + 1U;
+        size_t source_width = test_random() % 60U + 1U;
+        size_t source_height = test_random() % 60U + 1U;
+        size_t size = get_size(width, height);
+        uint8_t* buffer = make_random_bitmap(width, height);
+        uint8_t* expected = malloc(size);
+        uint8_t* data = make_random_bitmap(source_width, source_height);
+        gfx_bitmap_t source = {
+            .data = data, .width = source_width, .height = source_height};
+        blit_t blit = {
+            .x = get_random(-20, 70),
+            .y = get_random(-20, 70),
+            .source_x = get_random(-20, 70),
+            .source_y = get_random(-20, 70),
+            .width = get_random(-2, 70),
+            .height = get_random(-2, 70),
+            .rop = rops[test_random() % 6U],
+        };
+
+        memcpy(expected, buffer, size);
+        gfx_blit_buffer(buffer,
+                        width,
+                        height,
+                        blit.x,
+                        blit.y,
+                        &source,
+                        blit.source_x,
+                        blit.source_y,
+                        blit.width,
+                        blit.height,
+                        blit.rop);
+        blit_reference(expected, width, height, &source, &blit);
+
+        bool matches = memcmp(buffer, expected, size) == 0;
+        free(data);
+        free(expected);
+        free(buffer);
+        if (!TEST_CHECK(matches)) {
+            break;
+        }
+    }
+}
+
+int main(void)
+{
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    test_bitmap(&gfx);
+    test_overlapping(&gfx);
+    test_buffer();
+
+    return test_finish();
+}
@@ -0,0 +1,459 @@
+#include "gfx_draw.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <math.h>
+#include <string.h>
+
+#define TRIALS (6000U)
+#define PI (3.14159265358979323846)
+
+typedef enum {
+    SHAPE_CIRCLE,
+    SHAPE_FILL_CIRCLE,
+    SHAPE_ELLIPSE,
+    SHAPE_FILL_ELLIPSE,
+    SHAPE_ARC,
+    SHAPE_FILL_ARC,
+} shape_t;
+
+// Circles and arcs use radius_x only
+typedef struct {
+    shape_t shape;
+    int16_t x;
+    int16_t y;
+    int16_t radius_x;
+    int16_t radius_y;
+    int16_t start;
+    int16_t end;
+    gfx_rop_t rop;
+} primitive_t;
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t shape_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t before[TEST_GFX_FRAME_SIZE];
+
+// The shape in frame coordinates, and the tallest row offset of each column
+// offset from the center for the fills, -1 for none
+typedef struct {
+    gfx_t gfx;
+    primitive_t const* primitive;
+    int32_t heights[INT16_MAX + 1];
+} reference_t;
+
+static bool is_arc(primitive_t const* primitive)
+{
+    return primitive->shape == SHAPE_ARC || primitive->shape == SHAPE_FILL_ARC;
+}
+
+static int32_t get_sweep(primitive_t const* primitive)
+{
+    int32_t sweep = ((int32_t)primitive->end - primitive->start) % 360;
+
+    return sweep <= 0 ? sweep + 360 : sweep;
+}
+
+// Angle of an offset in degrees, counterclockwise from three o'clock
+static bool is_in_sector(primitive_t const* primitive, int32_t x, int32_t y)
+{
+    int32_t sweep = get_sweep(primitive);
+
+    if (!is_arc(primitive) || sweep == 360 || (x == 0 && y == 0)) {
+        return true;
+    }
+
+    double angle = atan2(-(double)y, (double)x) * 180.0 / PI;
+    double relative = fmod(angle - primitive->start, 360.0);
+    if (relative < 0.0) {
+        relative += 360.0;
+    }
+
+    return relative <= sweep;
+}
+
+// Whether an offset lies so close to a boundary ray that the sine table of
+// gfx_draw.c may put it on either side
+static bool is_on_boundary(primitive_t const* primitive, int32_t x, int32_t y)
+{
+    int16_t const angles[2] = {primitive->start, primitive->end};
+
+    if (!is_arc(primitive) || get_sweep(primitive) == 360) {
+        return false;
+    }
+
+    double tolerance = 0.01 + hypot(x, y) / 8192.0;
+
+    for (size_t index = 0U; index < 2U; ++index) {
+        double radians = angles[index] * PI / 180.0;
+        double distance = fabs(x * sin(radians) + y * cos(radians));
+        if (distance < tolerance) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void mark(reference_t* reference, int32_t x, int32_t y)
+{
+    primitive_t const* primitive = reference->primitive;
+    int32_t const signs[2] = {1, -1};
+
+    for (size_t sign_x = 0U; sign_x < 2U; ++sign_x) {
+        for (size_t sign_y = 0U; sign_y < 2U; ++sign_y) {
+            int32_t offset_x = x * signs[sign_x];
+            int32_t offset_y = y * signs[sign_y];
+            if (is_in_sector(primitive, offset_x, offset_y)) {
+                test_gfx_plot(&reference->gfx,
+                              primitive->x + offset_x,
+                              primitive->y + offset_y,
+                              GFX_ROP_SET);
+            }
+        }
+    }
+
+    if (reference->heights[x] < y) {
+        reference->heights[x] = y;
+    }
+}
+
+// Plain eight way midpoint circle
+static void walk_circle(reference_t* reference, int32_t radius)
+{
+    int32_t x = radius;
+    int32_t y = 0;
+    int32_t error = 1 - radius;
+
+    while (x >= y) {
+        mark(reference, x, y);
+        mark(reference, y, x);
+        ++y;
+        if (error < 0) {
+            error += 2 * y + 1;
+        } else {
+            --x;
+            error += 2 * (y - x) + 1;
+        }
+    }
+}
+
+// Textbook two region midpoint ellipse in floating point
+static void walk_ellipse(reference_t* reference,
+                         int32_t radius_x,
+                         int32_t radius_y)
+{
+    double radius_x2 = (double)radius_x * radius_x;
+    double radius_y2 = (double)radius_y * radius_y;
+    int32_t x = 0;
+    int32_t y = radius_y;
+    double step_x = 0.0;
+    double step_y = 2.0 * radius_x2 * y;
+    double error = radius_y2 - radius_x2 * radius_y + 0.25 * radius_x2;
+
+    while (step_x < step_y) {
+        mark(reference, x, y);
+        ++x;
+        step_x += 2.0 * radius_y2;
+        if (error < 0.0) {
+            error += radius_y2 + step_x;
+        } else {
+            --y;
+            step_y -= 2.0 * radius_x2;
+            error += radius_y2 + step_x - step_y;
+        }
+    }
+
+    error = radius_y2 * (x + 0.5) * (x + 0.5) +
+            radius_x2 * (y - 1.0) * (y - 1.0) - radius_x2 * radius_y2;
+
+    while (y >= 0) {
+        mark(reference, x, y);
+        --y;
+        step_y -= 2.0 * radius_x2;
+        if (error > 0.0) {
+            error += radius_x2 - step_y;
+        } else {
+            ++x;
+            step_x += 2.0 * radius_y2;
+            error += radius_x2 - step_y + step_x;
+        }
+    }
+}
+
+static void draw_reference(reference_t* reference)
+{
+    primitive_t const* primitive = reference->primitive;
+    int32_t radius_x = primitive->radius_x;
+    int32_t radius_y = primitive->radius_y;
+    bool fill = false;
+
+    memset(reference->heights, 0xFF, sizeof(reference->heights));
+
+    switch (primitive->shape) {
+        case SHAPE_FILL_CIRCLE:
+        case SHAPE_FILL_ARC: {
+            fill = true;
+            walk_circle(reference, radius_x);
+            break;
+        }
+        case SHAPE_CIRCLE:
+        case SHAPE_ARC: {
+            walk_circle(reference, radius_x);
+            break;
+        }
+        default: {
+            fill = primitive->shape == SHAPE_FILL_ELLIPSE;
+            if (radius_x == 0 || radius_y == 0) {
+                // a line, filled or not
+                fill = true;
+                for (int32_t x = 0; x <= radius_x; ++x) {
+                    reference->heights[x] = radius_y;
+                }
+            } else {
+                walk_ellipse(reference, radius_x, radius_y);
+            }
+            break;
+        }
+    }
+
+    if (!fill) {
+        return;
+    }
+
+    // only the columns and rows inside the frame
+    int32_t left = -primitive->x > -radius_x ? -primitive->x : -radius_x;
+    int32_t right = (int32_t)TEST_GFX_WIDTH - primitive->x;
+    right = right < radius_x ? right : radius_x;
+
+    memset(shape_frame, 0, sizeof(shape_frame));
+    for (int32_t x = left; x <= right; ++x) {
+        int32_t height = reference->heights[x < 0 ? -x : x];
+        int32_t top = -primitive->y > -height ? -primitive->y : -height;
+        int32_t bottom = (int32_t)TEST_GFX_HEIGHT - primitive->y;
+        bottom = bottom < height ? bottom : height;
+        for (int32_t y = top; y <= bottom; ++y) {
+            if (is_in_sector(primitive, x, y)) {
+                test_gfx_plot(&reference->gfx,
+                              primitive->x + x,
+                              primitive->y + y,
+                              GFX_ROP_SET);
+            }
+        }
+    }
+}
+
+static void draw(gfx_t* gfx, primitive_t const* primitive)
+{
+    switch (primitive->shape) {
+        case SHAPE_CIRCLE: {
+            gfx_draw_circle(gfx,
+                            primitive->x,
+                            primitive->y,
+                            primitive->radius_x,
+                            primitive->rop);
+            break;
+        }
+        case SHAPE_FILL_CIRCLE: {
+            gfx_fill_circle(gfx,
+                            primitive->x,
+                            primitive->y,
+                            primitive->radius_x,
+                            primitive->rop);
+            break;
+        }
+        case SHAPE_ELLIPSE: {
+            gfx_draw_ellipse(gfx,
+                             primitive->x,
+                             primitive->y,
+                             primitive->radius_x,
+                             primitive->radius_y,
+                             primitive->rop);
+            break;
+        }
+        case SHAPE_FILL_ELLIPSE: {
+            gfx_fill_ellipse(gfx,
+                             primitive->x,
+                             primitive->y,
+                             primitive->radius_x,
+                             primitive->radius_y,
+                             primitive->rop);
+            break;
+        }
+        case SHAPE_ARC: {
+            gfx_draw_arc(gfx,
+                         primitive->x,
+                         primitive->y,
+                         primitive->radius_x,
+                         primitive->start,
+                         primitive->end,
+                         primitive->rop);
+            break;
+        }
+        default: {
+            gfx_fill_arc(gfx,
+                         primitive->x,
+                         primitive->y,
+                         primitive->radius_x,
+                         primitive->start,
+                         primitive->end,
+                         primitive->rop);
+            break;
+        }
+    }
+}
+
+// Arcs may differ from the reference right on their boundary rays
+static bool differs_on_boundary(gfx_t const* gfx,
+                                gfx_t const* expected,
+                                primitive_t const* primitive)
+{
+    for (int16_t y = 0; y < (int16_t)TEST_GFX_HEIGHT; ++y) {
+        for (int16_t x = 0; x < (int16_t)TEST_GFX_WIDTH; ++x) {
+            if (gfx_get_pixel(gfx, x, y) != gfx_get_pixel(expected, x, y) &&
+                !is_on_boundary(
+                    primitive, x - primitive->x, y - primitive->y)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Draws the primitive over random content and compares it with the
+// reference shape combined into the same content pixel by pixel. XOR makes
+// a pixel drawn twice show up.
+static bool check(gfx_t* gfx, gfx_t* expected, primitive_t const* primitive)
+{
+    static reference_t reference;
+
+    for (size_t offset = 0U; offset < TEST_GFX_FRAME_SIZE; ++offset) {
+        frame[offset] = (uint8_t)test_random();
+    }
+    memcpy(expected_frame, frame, sizeof(frame));
+    memcpy(before, frame, sizeof(frame));
+
+    gfx_clear_dirty(gfx);
+    draw(gfx, primitive);
+
+    test_gfx_initialize(
+        &reference.gfx, shape_frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    reference.primitive = primitive;
+    // circles and arcs ignore radius_y
+    if (primitive->radius_x >= 0 &&
+        (primitive->radius_y >= 0 || primitive->shape == SHAPE_CIRCLE ||
+         primitive->shape == SHAPE_FILL_CIRCLE || is_arc(primitive))) {
+        draw_reference(&reference);
+    }
+
+    for (int16_t y = 0; y < (int16_t)TEST_GFX_HEIGHT; ++y) {
+        for (int16_t x = 0; x < (int16_t)TEST_GFX_WIDTH; ++x) {
+            if (gfx_get_pixel(&reference.gfx, x, y)) {
+                test_gfx_plot(expected, x, y, primitive->rop);
+            }
+        }
+    }
+
+    bool matches = memcmp(frame, expected_frame, sizeof(frame)) == 0 ||
+                   differs_on_boundary(gfx, expected, primitive);
+
+    return TEST_CHECK(matches) && TEST_CHECK(test_gfx_is_dirty(gfx, before));
+}
+
+static int16_t get_random_radius(void)
+{
+    switch (test_random() % 20U) {
+        case 0U: {
+            return (int16_t)(test_random() % 1000U);
+        }
+        case 1U: {
+            return (int16_t)(-(int32_t)(test_random() % 4U) - 1);
+        }
+        default: {
+            return (int16_t)(test_random() % 90U);
+        }
+    }
+}
+
+static int16_t get_random_angle(void)
+{
+    return (int16_t)((int32_t)(test_random() % 1000U) - 500);
+}
+
+static void test_matches_reference(gfx_t* gfx, gfx_t* expected)
+{
+    static gfx_rop_t const rops[] = {GFX_ROP_SET, GFX_ROP_CLEAR, GFX_ROP_XOR};
+
+    for (size_t trial = 0U; trial < TRIALS; ++trial) {
+        primitive_t primitive = {
+            .shape = (shape_t)(test_random() % 6U),
+            .x = (int16_t)((int32_t)(test_random() % 200U) - 36),
+            .y = (int16_t)((int32_t)(test_random() % 200U) - 36),
+            .radius_x = get_random_radius(),
+            .radius_y = get_random_radius(),
+            .start = get_random_angle(),
+            .end = get_random_angle(),
+            .rop = rops[test_random() % 3U],
+        };
+
+        // whole circles, half circles and right angles
+        switch (test_random() % 8U) {
+            case 0U: {
+                primitive.end = primitive.start;
+                break;
+            }
+            case 1U: {
+                primitive.end = (int16_t)(primitive.start + 180);
+                break;
+            }
+            case 2U: {
+                primitive.start = (int16_t)(test_random() % 4U * 90U);
+                primitive.end = (int16_t)(primitive.start + 90);
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+
+        if (!check(gfx, expected, &primitive)) {
+            break;
+        }
+    }
+}
+
+// The walks stay exact and in range at the largest radii
+static void test_extremes(gfx_t* gfx, gfx_t* expected)
+{
+    static primitive_t const primitives[] = {
+        {SHAPE_CIRCLE, 64, 64, INT16_MAX, 0, 0, 0, GFX_ROP_XOR},
+        {SHAPE_FILL_CIRCLE, 64, INT16_MIN, INT16_MAX, 0, 0, 0, GFX_ROP_XOR},
+        {SHAPE_ELLIPSE, 64, 64, INT16_MAX, INT16_MAX, 0, 0, GFX_ROP_XOR},
+        {SHAPE_ELLIPSE, 64, 64, INT16_MAX, 3, 0, 0, GFX_ROP_XOR},
+        {SHAPE_FILL_ELLIPSE, 64, 64, 3, INT16_MAX, 0, 0, GFX_ROP_XOR},
+        {SHAPE_FILL_ELLIPSE, 64, 64, INT16_MAX, 0, 0, 0, GFX_ROP_XOR},
+        {SHAPE_ARC, 0, 0, INT16_MAX, 0, INT16_MIN, INT16_MAX, GFX_ROP_XOR},
+        {SHAPE_FILL_ARC, 64, 64, 200, 0, 30, 29, GFX_ROP_XOR},
+        {SHAPE_FILL_ARC, 64, 64, 0, 0, 30, 60, GFX_ROP_XOR},
+    };
+
+    for (size_t index = 0U; index < sizeof(primitives) / sizeof(*primitives);
+         ++index) {
+        check(gfx, expected, &primitives[index]);
+    }
+}
+
+int main(void)
+{
+    gfx_t gfx;
+    gfx_t expected;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    test_gfx_initialize(
+        &expected, expected_frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    test_matches_reference(&gfx, &expected);
+    test_extremes(&gfx, &expected);
+
+    return test_finish();
+}
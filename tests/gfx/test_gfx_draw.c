@@ -0,0 +1,286 @@
+#include "gfx_draw.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <string.h>
+
+#define TRIALS (20000U)
+#define GUARD (0xA5U)
+#define GUARD_SIZE (8U)
+
+typedef enum {
+    SHAPE_LINE,
+    SHAPE_HLINE,
+    SHAPE_VLINE,
+    SHAPE_RECT,
+    SHAPE_FILL,
+} shape_t;
+
+// Lines take the second point as width and height
+typedef struct {
+    shape_t shape;
+    int16_t x;
+    int16_t y;
+    int16_t width;
+    int16_t height;
+    gfx_rop_t rop;
+} primitive_t;
+
+static void reference_line(gfx_t* gfx,
+                           int32_t x0,
+                           int32_t y0,
+                           int32_t x1,
+                           int32_t y1,
+                           gfx_rop_t rop)
+{
+    int32_t dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    int32_t dy = y1 > y0 ? y0 - y1 : y1 - y0;
+    int32_t step_x = x0 < x1 ? 1 : -1;
+    int32_t step_y = y0 < y1 ? 1 : -1;
+    int32_t error = dx + dy;
+
+    for (;;) {
+        test_gfx_plot(gfx, x0, y0, rop);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int32_t doubled = 2 * error;
+        if (doubled >= dy) {
+            error += dy;
+            x0 += step_x;
+        }
+        if (doubled <= dx) {
+            error += dx;
+            y0 += step_y;
+        }
+    }
+}
+
+// Every pixel of the area once, outline only or filled
+static void reference_rect(gfx_t* gfx,
+                           int32_t x,
+                           int32_t y,
+                           int32_t width,
+                           int32_t height,
+                           bool fill,
+                           gfx_rop_t rop)
+{
+    int32_t left = x > 0 ? x : 0;
+    int32_t top = y > 0 ? y : 0;
+    int32_t right = x + width;
+    int32_t bottom = y + height;
+
+    if (right > (int32_t)gfx->config.frame_width) {
+        right = (int32_t)gfx->config.frame_width;
+    }
+    if (bottom > (int32_t)gfx->config.frame_height) {
+        bottom = (int32_t)gfx->config.frame_height;
+    }
+
+    for (int32_t row = top; row < bottom; ++row) {
+        for (int32_t column = left; column < right; ++column) {
+            if (fill || row == y || row == y + height - 1 || column == x ||
+                column == x + width - 1) {
+                test_gfx_plot(gfx, column, row, rop);
+            }
+        }
+    }
+}
+
+static void draw(gfx_t* gfx, primitive_t const* primitive)
+{
+    switch (primitive->shape) {
+        case SHAPE_LINE: {
+            gfx_draw_line(gfx,
+                          primitive->x,
+                          primitive->y,
+                          primitive->width,
+                          primitive->height,
+                          primitive->rop);
+            break;
+        }
+        case SHAPE_HLINE: {
+            gfx_draw_hline(gfx,
+                           primitive->x,
+                           primitive->y,
+                           primitive->width,
+                           primitive->rop);
+            break;
+        }
+        case SHAPE_VLINE: {
+            gfx_draw_vline(gfx,
+                           primitive->x,
+                           primitive->y,
+                           primitive->height,
+                           primitive->rop);
+            break;
+        }
+        case SHAPE_RECT: {
+            gfx_draw_rect(gfx,
+                          primitive->x,
+                          primitive->y,
+                          primitive->width,
+                          primitive->height,
+                          primitive->rop);
+            break;
+        }
+        default: {
+            gfx_fill_rect(gfx,
+                          primitive->x,
+                          primitive->y,
+                          primitive->width,
+                          primitive->height,
+                          primitive->rop);
+            break;
+        }
+    }
+}
+
+static void draw_reference(gfx_t* gfx, primitive_t const* primitive)
+{
+    switch (primitive->shape) {
+        case SHAPE_LINE: {
+            reference_line(gfx,
+                           primitive->x,
+                           primitive->y,
+                           primitive->width,
+                           primitive->height,
+                           primitive->rop);
+            break;
+        }
+        case SHAPE_HLINE: {
+            reference_rect(gfx,
+                           primitive->x,
+                           primitive->y,
+                           primitive->width,
+                           1,
+                           true,
+                           primitive->rop);
+            break;
+        }
+        case SHAPE_VLINE: {
+            reference_rect(gfx,
+                           primitive->x,
+                           primitive->y,
+                           1,
+                           primitive->height,
+                           true,
+                           primitive->rop);
+            break;
+        }
+        default: {
+            reference_rect(gfx,
+                           primitive->x,
+                           primitive->y,
+                           primitive->width,
+                           primitive->height,
+                           primitive->shape == SHAPE_FILL,
+                           primitive->rop);
+            break;
+        }
+    }
+}
+
+// Mostly around the frame, now and then at the ends of int16_t
+static int16_t get_random_coordinate(void)
+{
+    switch (test_random() % 40U) {
+        case 0U: {
+            return INT16_MIN;
+        }
+        case 1U: {
+            return INT16_MAX;
+        }
+        default: {
+            return (int16_t)((int32_t)(test_random() % 200U) - 40);
+        }
+    }
+}
+
+// Random primitives on a frame of the given size, starting offset bytes into
+// the storage so that the word stores start unaligned
+static void test_matches_reference(size_t width, size_t height, size_t offset)
+{
+    static uint8_t storage[GUARD_SIZE + TEST_GFX_FRAME_SIZE + GUARD_SIZE];
+    static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+    static uint8_t before[TEST_GFX_FRAME_SIZE];
+    uint8_t* frame = &storage[offset];
+    size_t frame_size =
+        width * ((height + GFX_PAGE_HEIGHT - 1U) / GFX_PAGE_HEIGHT);
+    gfx_t gfx;
+    gfx_t expected;
+
+    memset(storage, GUARD, sizeof(storage));
+    test_gfx_initialize(&gfx, frame, width, height, NULL);
+    test_gfx_initialize(&expected, expected_frame, width, height, NULL);
+
+    for (size_t trial = 0U; trial < TRIALS; ++trial) {
+        primitive_t primitive = {
+            .shape = (shape_t)(test_random() % 5U),
+            .x = get_random_coordinate(),
+            .y = get_random_coordinate(),
+            .width = get_random_coordinate(),
+            .height = get_random_coordinate(),
+            .rop = test_random() % 3U == 0U ? GFX_ROP_CLEAR : GFX_ROP_SET,
+        };
+
+        memcpy(before, frame, frame_size);
+        gfx_clear_dirty(&gfx);
+        draw(&gfx, &primitive);
+        draw_reference(&expected, &primitive);
+
+        if (!TEST_CHECK(memcmp(frame, expected_frame, frame_size) == 0) ||
+            !TEST_CHECK(test_gfx_is_dirty(&gfx, before))) {
+            break;
+        }
+    }
+
+    for (size_t index = 0U; index < offset; ++index) {
+        TEST_CHECK(storage[index] == GUARD);
+    }
+    for (size_t index = offset + frame_size; index < sizeof(storage);
+         ++index) {
+        TEST_CHECK(storage[index] == GUARD);
+    }
+}
+
+// Clipped away or empty shapes change nothing and mark nothing
+static void test_nothing_drawn(void)
+{
+    static uint8_t frame[TEST_GFX_FRAME_SIZE];
+    static primitive_t const primitives[] = {
+        {SHAPE_FILL, 10, 10, 0, 20, GFX_ROP_SET},
+        {SHAPE_FILL, 10, 10, 20, -1, GFX_ROP_SET},
+        {SHAPE_RECT, 10, 10, -5, 5, GFX_ROP_SET},
+        {SHAPE_HLINE, -30, 5, 30, 0, GFX_ROP_SET},
+        {SHAPE_VLINE, 5, 128, 0, 10, GFX_ROP_SET},
+        {SHAPE_LINE, -10, -10, -1, -20, GFX_ROP_SET},
+        {SHAPE_FILL, INT16_MIN, INT16_MIN, INT16_MAX, INT16_MAX, GFX_ROP_SET},
+    };
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    for (size_t index = 0U; index < sizeof(primitives) / sizeof(*primitives);
+         ++index) {
+        gfx_clear_dirty(&gfx);
+        draw(&gfx, &primitives[index]);
+        for (size_t page = 0U; page < gfx_get_pages(&gfx); ++page) {
+            gfx_span_t span = gfx_get_dirty(&gfx, page);
+            TEST_CHECK(span.begin >= span.end);
+        }
+    }
+
+    for (size_t offset = 0U; offset < sizeof(frame); ++offset) {
+        TEST_CHECK(frame[offset] == 0U);
+    }
+}
+
+int main(void)
+{
+    test_matches_reference(TEST_GFX_WIDTH, TEST_GFX_HEIGHT, GUARD_SIZE);
+    test_matches_reference(TEST_GFX_WIDTH, 125U, GUARD_SIZE + 1U);
+    test_matches_reference(127U, 64U, GUARD_SIZE + 3U);
+    test_nothing_drawn();
+
+    return test_finish();
+}
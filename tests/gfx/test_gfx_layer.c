@@ -0,0 +1,514 @@
+#include "gfx_draw.h"
+#include "gfx_layer.h"
+#include "gfx_printf.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ROUNDS (2000U)
+#define STEPS (20U)
+#define LAYERS_MAX (4U)
+#define WINDOWS_MAX (5U)
+
+static gfx_rop_t const rops[] = {
+    GFX_ROP_SET,
+    GFX_ROP_CLEAR,
+    GFX_ROP_XOR,
+    GFX_ROP_AND,
+    GFX_ROP_INVERT,
+    GFX_ROP_COPY,
+};
+
+static uint8_t content_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t overlay_frame[TEST_GFX_FRAME_SIZE];
+
+static void fill_random(uint8_t* data, size_t size)
+{
+    for (size_t offset = 0U; offset < size; ++offset) {
+        data[offset] = (uint8_t)test_random();
+    }
+}
+
+static int16_t get_random(int32_t low, int32_t high)
+{
+    return (int16_t)(low + (int32_t)(test_random() % (uint32_t)(high - low)));
+}
+
+static uint8_t apply(uint8_t byte, uint8_t source, gfx_rop_t rop)
+{
+    switch (rop) {
+        case GFX_ROP_SET: {
+            return (uint8_t)(byte | source);
+        }
+        case GFX_ROP_CLEAR: {
+            return (uint8_t)(byte & ~source);
+        }
+        case GFX_ROP_XOR: {
+            return (uint8_t)(byte ^ source);
+        }
+        case GFX_ROP_AND: {
+            return (uint8_t)(byte & source);
+        }
+        case GFX_ROP_INVERT: {
+            return (uint8_t)~byte;
+        }
+        default: {
+            return source;
+        }
+    }
+}
+
+// A byte of the panel, the visible layers that cover it combined bottom
+// first over a blank one
+static uint8_t compose_reference(gfx_compositor_t const* compositor,
+                                 size_t page,
+                                 size_t column)
+{
+    uint8_t byte = 0U;
+
+    for (size_t index = 0U; index < compositor->config.layer_count; ++index) {
+        gfx_layer_t const* layer = &compositor->config.layers[index];
+        if (!layer->visible) {
+            continue;
+        }
+
+        uint8_t source = 0U;
+        if (layer->gfx) {
+            gfx_t const* gfx = layer->gfx;
+            if (page < layer->page ||
+                page - layer->page >= gfx_get_pages(gfx) ||
+                column < layer->x ||
+                column - layer->x >= gfx->config.frame_width) {
+                continue;
+            }
+            source = gfx->config.frame_buffer[(page - layer->page) *
+                                                  gfx->config.frame_width +
+                                              column - layer->x];
+        } else {
+            source = layer->data[page * compositor->config.frame_width +
+                                 column];
+        }
+
+        byte = apply(byte, source, layer->rop);
+    }
+
+    return byte;
+}
+
+static bool matches_reference(gfx_compositor_t const* compositor,
+                              test_panel_t const* panel)
+{
+    size_t pages = (compositor->config.frame_height + GFX_PAGE_HEIGHT - 1U) /
+                   GFX_PAGE_HEIGHT;
+
+    for (size_t page = 0U; page < pages; ++page) {
+        for (size_t column = 0U; column < compositor->config.frame_width;
+             ++column) {
+            if (panel->ram[page * TEST_PANEL_WIDTH + column] !=
+                compose_reference(compositor, page, column)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Flushes and checks the panel, and that each page sent exactly the span
+// covering the compositor's own changes and those of the visible layers
+static bool flush_and_check(gfx_compositor_t* compositor, test_panel_t* panel)
+{
+    size_t pages = (compositor->config.frame_height + GFX_PAGE_HEIGHT - 1U) /
+                   GFX_PAGE_HEIGHT;
+    size_t bytes = 0U;
+
+    for (size_t page = 0U; page < pages; ++page) {
+        size_t begin = compositor->dirty[page].begin;
+        size_t end = compositor->dirty[page].end;
+
+        for (size_t index = 0U; index < compositor->config.layer_count;
+             ++index) {
+            gfx_layer_t const* layer = &compositor->config.layers[index];
+            if (!layer->visible || !layer->gfx || page < layer->page ||
+                page - layer->page >= gfx_get_pages(layer->gfx)) {
+                continue;
+            }
+
+            gfx_span_t span = gfx_get_dirty(layer->gfx, page - layer->page);
+            if (span.begin >= span.end) {
+                continue;
+            }
+            if (begin >= end) {
+                begin = layer->x + span.begin;
+                end = layer->x + span.end;
+                continue;
+            }
+            begin = begin < layer->x + span.begin ? begin
+                                                  : layer->x + span.begin;
+            end = end > layer->x + span.end ? end : layer->x + span.end;
+        }
+
+        if (begin < end) {
+            bytes += 3U + end - begin;
+        }
+    }
+
+    test_panel_reset_counters(panel);
+
+    return gfx_compositor_flush(compositor) == GFX_ERR_OK &&
+           panel->bytes == bytes && matches_reference(compositor, panel);
+}
+
+// Whether a flush left any drawn layer with something to send
+static bool is_clean(gfx_compositor_t const* compositor)
+{
+    for (size_t index = 0U; index < compositor->config.layer_count; ++index) {
+        gfx_t const* gfx = compositor->config.layers[index].gfx;
+        for (size_t page = 0U; gfx && page < gfx_get_pages(gfx); ++page) {
+            gfx_span_t span = gfx_get_dirty(gfx, page);
+            if (span.begin < span.end) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void draw_random(gfx_t* gfx)
+{
+    if (test_random() % 4U == 0U) {
+        gfx_draw_line(gfx,
+                      get_random(-20, 150),
+                      get_random(-20, 150),
+                      get_random(-20, 150),
+                      get_random(-20, 150),
+                      rops[test_random() % 6U]);
+        return;
+    }
+
+    gfx_fill_rect(gfx,
+                  get_random(-20, 140),
+                  get_random(-20, 140),
+                  get_random(0, 50),
+                  get_random(0, 50),
+                  rops[test_random() % 6U]);
+}
+
+// Stacks of up to four frame sized layers, flash and drawn, under random
+// drawing, visibility and operations. The panel shows the composition after
+// every flush, whatever it held before the first one.
+static void test_matches_reference(size_t frame_height)
+{
+    size_t size = TEST_GFX_WIDTH *
+                  ((frame_height + GFX_PAGE_HEIGHT - 1U) / GFX_PAGE_HEIGHT);
+    test_panel_t panel;
+    gfx_t content;
+    gfx_t overlay;
+
+    test_gfx_initialize(
+        &content, content_frame, TEST_GFX_WIDTH, frame_height, NULL);
+    test_gfx_initialize(
+        &overlay, overlay_frame, TEST_GFX_WIDTH, frame_height, NULL);
+
+    for (size_t round = 0U; round < ROUNDS; ++round) {
+        // static layers and staging on the heap at their exact size, so
+        // that ASan sees reads and writes past them
+        uint8_t* background = malloc(size);
+        uint8_t* pattern = malloc(size);
+        uint8_t* staging = malloc(TEST_GFX_WIDTH);
+        fill_random(background, size);
+        fill_random(pattern, size);
+        fill_random(content_frame, size);
+        fill_random(overlay_frame, size);
+
+        gfx_layer_t layers[LAYERS_MAX] = {
+            {.data = background},
+            {.gfx = &content},
+            {.gfx = &overlay},
+            {.data = pattern},
+        };
+        // in any order, drawn layers at the bottom as well
+        for (size_t index = 0U; index < LAYERS_MAX; ++index) {
+            size_t other = test_random() % LAYERS_MAX;
+            gfx_layer_t swap = layers[index];
+            layers[index] = layers[other];
+            layers[other] = swap;
+        }
+        for (size_t index = 0U; index < LAYERS_MAX; ++index) {
+            layers[index].rop = rops[test_random() % 6U];
+            layers[index].visible = test_random() % 4U != 0U;
+        }
+
+        size_t count = test_random() % (LAYERS_MAX + 1U);
+        gfx_compositor_t compositor;
+        gfx_interface_t interface = test_panel_get_interface(&panel);
+        gfx_compositor_initialize(
+            &compositor,
+            &(gfx_compositor_config_t){.layers = layers,
+                                       .layer_count = count,
+                                       .frame_width = TEST_GFX_WIDTH,
+                                       .frame_height = frame_height,
+                                       .staging = staging},
+            &interface);
+        test_panel_initialize(&panel);
+        memset(panel.ram, 0xA5, sizeof(panel.ram));
+
+        bool matches = true;
+        bool clean = true;
+        for (size_t step = 0U; step < STEPS && matches && clean; ++step) {
+            uint32_t kind = test_random() % 8U;
+            if (kind < 6U) {
+                draw_random(test_random() % 2U == 0U ? &content : &overlay);
+            } else if (count > 0U && kind == 6U) {
+                gfx_compositor_set_visible(&compositor,
+                                           test_random() % count,
+                                           test_random() % 2U == 0U);
+            } else if (count > 0U) {
+                gfx_compositor_set_rop(&compositor,
+                                       test_random() % count,
+                                       rops[test_random() % 6U]);
+            }
+
+            if (test_random() % 3U == 0U || step + 1U == STEPS) {
+                matches = flush_and_check(&compositor, &panel);
+                clean = is_clean(&compositor);
+            }
+        }
+
+        gfx_compositor_deinitialize(&compositor);
+        free(staging);
+        free(pattern);
+        free(background);
+
+        if (!TEST_CHECK(matches) || !TEST_CHECK(clean)) {
+            break;
+        }
+    }
+}
+
+static void draw_random_window(gfx_t* window)
+{
+    switch (test_random() % 4U) {
+        case 0U: {
+            gfx_draw_printf(window,
+                            get_random(-5, 40),
+                            get_random(-5, 40),
+                            GFX_ROP_COPY,
+                            "%u",
+                            test_random() % 100000U);
+            break;
+        }
+        case 1U: {
+            gfx_draw_line(window,
+                          get_random(0, 128),
+                          get_random(0, 64),
+                          get_random(0, 128),
+                          get_random(0, 64),
+                          GFX_ROP_XOR);
+            break;
+        }
+        default: {
+            gfx_fill_rect(window,
+                          get_random(-10, 130),
+                          get_random(-10, 130),
+                          get_random(0, 40),
+                          get_random(0, 40),
+                          rops[test_random() % 6U]);
+            break;
+        }
+    }
+}
+
+// A flash background under up to five RAM windows of any size and place,
+// many with a last page partly outside them. Windows draw in their own
+// coordinates and show composed in place. test_panel refuses any span that
+// leaves the panel.
+static void test_windows(size_t frame_height)
+{
+    size_t pages = (frame_height + GFX_PAGE_HEIGHT - 1U) / GFX_PAGE_HEIGHT;
+    test_panel_t panel;
+    gfx_t windows[WINDOWS_MAX];
+
+    for (size_t round = 0U; round < ROUNDS; ++round) {
+        // every buffer on the heap at its exact size, so that ASan sees
+        // reads and writes past them
+        uint8_t* background = malloc(TEST_GFX_WIDTH * pages);
+        uint8_t* staging = malloc(TEST_GFX_WIDTH);
+        uint8_t* buffers[WINDOWS_MAX] = {0};
+        gfx_layer_t layers[WINDOWS_MAX + 1U] = {
+            {.data = background, .rop = GFX_ROP_SET, .visible = true},
+        };
+        size_t count = test_random() % (WINDOWS_MAX + 1U);
+        fill_random(background, TEST_GFX_WIDTH * pages);
+
+        for (size_t index = 0U; index < count; ++index) {
+            size_t page = test_random() % pages;
+            size_t height =
+                test_random() % (frame_height - page * GFX_PAGE_HEIGHT) + 1U;
+            size_t width = test_random() % TEST_GFX_WIDTH + 1U;
+            size_t size =
+                width * ((height + GFX_PAGE_HEIGHT - 1U) / GFX_PAGE_HEIGHT);
+
+            buffers[index] = malloc(size);
+            test_gfx_initialize(
+                &windows[index], buffers[index], width, height, NULL);
+            fill_random(buffers[index], size);
+            layers[index + 1U] = (gfx_layer_t){
+                .gfx = &windows[index],
+                .x = test_random() % (TEST_GFX_WIDTH - width + 1U),
+                .page = page,
+                .rop = rops[test_random() % 6U],
+                .visible = test_random() % 4U != 0U,
+            };
+        }
+
+        gfx_compositor_t compositor;
+        gfx_interface_t interface = test_panel_get_interface(&panel);
+        gfx_compositor_initialize(
+            &compositor,
+            &(gfx_compositor_config_t){.layers = layers,
+                                       .layer_count = count + 1U,
+                                       .frame_width = TEST_GFX_WIDTH,
+                                       .frame_height = frame_height,
+                                       .staging = staging},
+            &interface);
+        test_panel_initialize(&panel);
+        memset(panel.ram, 0xA5, sizeof(panel.ram));
+
+        bool matches = true;
+        bool clean = true;
+        for (size_t step = 0U; step < STEPS && matches && clean; ++step) {
+            size_t index = count > 0U ? test_random() % count : 0U;
+            uint32_t kind = test_random() % 6U;
+            if (count > 0U && kind < 4U) {
+                draw_random_window(&windows[index]);
+            } else if (count > 0U && kind == 4U) {
+                gfx_compositor_set_visible(
+                    &compositor, index + 1U, test_random() % 2U == 0U);
+            } else if (count > 0U) {
+                gfx_compositor_set_rop(
+                    &compositor, index + 1U, rops[test_random() % 6U]);
+            }
+
+            if (test_random() % 2U == 0U || step + 1U == STEPS) {
+                matches = flush_and_check(&compositor, &panel);
+                clean = is_clean(&compositor);
+            }
+        }
+
+        // showing or hiding a window sends its pages and nothing else
+        bool sent = true;
+        if (count > 0U && matches) {
+            gfx_t const* window = &windows[0];
+            test_panel_reset_counters(&panel);
+            gfx_compositor_set_visible(
+                &compositor, 1U, !layers[1].visible);
+            matches = gfx_compositor_flush(&compositor) == GFX_ERR_OK &&
+                      matches_reference(&compositor, &panel);
+            sent = panel.spans == gfx_get_pages(window) &&
+                   panel.bytes == panel.spans *
+                                      (3U + window->config.frame_width);
+        }
+
+        gfx_compositor_deinitialize(&compositor);
+        for (size_t index = 0U; index < count; ++index) {
+            free(buffers[index]);
+        }
+        free(staging);
+        free(background);
+
+        if (!TEST_CHECK(matches) || !TEST_CHECK(clean) ||
+            !TEST_CHECK(sent)) {
+            break;
+        }
+    }
+}
+
+// Once the panel is up to date only what changed is composed and sent
+static void test_partial(void)
+{
+    static uint8_t background[TEST_GFX_FRAME_SIZE];
+    static uint8_t staging[TEST_GFX_WIDTH];
+    test_panel_t panel;
+    gfx_t content;
+    gfx_t overlay;
+
+    fill_random(background, sizeof(background));
+    test_gfx_initialize(
+        &content, content_frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    test_gfx_initialize(
+        &overlay, overlay_frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    fill_random(content_frame, sizeof(content_frame));
+
+    gfx_layer_t layers[] = {
+        {.data = background, .rop = GFX_ROP_SET, .visible = true},
+        {.gfx = &content, .rop = GFX_ROP_XOR, .visible = true},
+        {.gfx = &overlay, .rop = GFX_ROP_XOR, .visible = true},
+    };
+    gfx_compositor_t compositor;
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    gfx_compositor_initialize(
+        &compositor,
+        &(gfx_compositor_config_t){.layers = layers,
+                                   .layer_count = 3U,
+                                   .frame_width = TEST_GFX_WIDTH,
+                                   .frame_height = TEST_GFX_HEIGHT,
+                                   .staging = staging},
+        &interface);
+    test_panel_initialize(&panel);
+
+    TEST_CHECK(gfx_compositor_flush(&compositor) == GFX_ERR_OK);
+    TEST_CHECK(panel.spans == TEST_GFX_HEIGHT / GFX_PAGE_HEIGHT);
+    TEST_CHECK(matches_reference(&compositor, &panel));
+
+    test_panel_reset_counters(&panel);
+    TEST_CHECK(gfx_compositor_flush(&compositor) == GFX_ERR_OK);
+    TEST_CHECK(panel.spans == 0U);
+
+    // a 2x10 cursor over rows 60 to 69 is two bytes in each of two pages,
+    // with three bytes of addressing per span
+    gfx_fill_rect(&overlay, 60, 60, 2, 10, GFX_ROP_XOR);
+    TEST_CHECK(gfx_compositor_flush(&compositor) == GFX_ERR_OK);
+    TEST_CHECK(panel.spans == 2U && panel.bytes == 2U * (3U + 2U));
+    TEST_CHECK(matches_reference(&compositor, &panel));
+
+    // drawing on a hidden layer sends nothing until it shows
+    gfx_compositor_set_visible(&compositor, 2U, false);
+    TEST_CHECK(gfx_compositor_flush(&compositor) == GFX_ERR_OK);
+    test_panel_reset_counters(&panel);
+    gfx_fill_rect(&overlay, 10, 10, 30, 30, GFX_ROP_XOR);
+    TEST_CHECK(gfx_compositor_flush(&compositor) == GFX_ERR_OK);
+    TEST_CHECK(panel.spans == 0U);
+    gfx_compositor_set_visible(&compositor, 2U, true);
+    TEST_CHECK(gfx_compositor_flush(&compositor) == GFX_ERR_OK);
+    TEST_CHECK(matches_reference(&compositor, &panel));
+
+    gfx_compositor_deinitialize(&compositor);
+
+    // without a panel there is nothing to flush to
+    gfx_compositor_initialize(
+        &compositor,
+        &(gfx_compositor_config_t){.layers = layers,
+                                   .layer_count = 3U,
+                                   .frame_width = TEST_GFX_WIDTH,
+                                   .frame_height = TEST_GFX_HEIGHT,
+                                   .staging = staging},
+        &(gfx_interface_t){0});
+    TEST_CHECK(gfx_compositor_flush(&compositor) == GFX_ERR_NULL);
+    gfx_compositor_deinitialize(&compositor);
+}
+
+int main(void)
+{
+    // a full frame and one whose last page is partly outside it
+    test_matches_reference(TEST_GFX_HEIGHT);
+    test_matches_reference(122U);
+    test_windows(TEST_GFX_HEIGHT);
+    test_windows(122U);
+    test_partial();
+
+    return test_finish();
+}
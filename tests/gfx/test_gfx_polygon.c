@@ -0,0 +1,213 @@
+#include "gfx_draw.h"
+#include "gfx_polygon.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TRIALS (2000U)
+#define POINTS_MAX (12U)
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t before[TEST_GFX_FRAME_SIZE];
+
+// Whether the centre of the pixel is inside, counting the edges that cross
+// its row left of it. Rows include the top end of an edge and exclude the
+// bottom one, so shared vertices count once.
+static bool is_inside(gfx_point_t const* points,
+                      size_t count,
+                      gfx_fill_rule_t rule,
+                      int32_t x,
+                      int32_t y)
+{
+    int32_t winding = 0;
+
+    for (size_t index = 0U; index < count; ++index) {
+        gfx_point_t from = points[index];
+        gfx_point_t to = points[(index + 1U) % count];
+        int32_t direction = 1;
+
+        if (from.y == to.y) {
+            continue;
+        }
+        if (from.y > to.y) {
+            gfx_point_t swap = from;
+            from = to;
+            to = swap;
+            direction = -1;
+        }
+        if (y < from.y || y >= to.y) {
+            continue;
+        }
+
+        // from.x + (2 * (y - from.y) + 1) * dx / (2 * dy) <= x + 0.5
+        int64_t dx = (int64_t)to.x - from.x;
+        int64_t dy = (int64_t)to.y - from.y;
+        if (2 * dy * from.x + (2 * ((int64_t)y - from.y) + 1) * dx <=
+            (2 * (int64_t)x + 1) * dy) {
+            winding += rule == GFX_FILL_RULE_NONZERO ? direction : 1;
+        }
+    }
+
+    return rule == GFX_FILL_RULE_NONZERO ? winding != 0 : (winding & 1) != 0;
+}
+
+static void draw_reference(gfx_t* gfx,
+                           gfx_point_t const* points,
+                           size_t count,
+                           gfx_fill_rule_t rule,
+                           gfx_rop_t rop)
+{
+    for (int32_t y = 0; y < (int32_t)TEST_GFX_HEIGHT; ++y) {
+        for (int32_t x = 0; x < (int32_t)TEST_GFX_WIDTH; ++x) {
+            if (is_inside(points, count, rule, x, y)) {
+                test_gfx_plot(gfx, x, y, rop);
+            }
+        }
+    }
+}
+
+// Around the frame, far outside or repeating a coordinate of the previous
+// point for horizontal and vertical edges
+static void make_random_polygon(gfx_point_t* points, size_t count)
+{
+    static int32_t const spreads[] = {60, 180, 30000};
+    int32_t spread = spreads[test_random() % 10U == 0U ? 2U
+                                                       : test_random() % 2U];
+
+    for (size_t index = 0U; index < count; ++index) {
+        uint32_t range = (uint32_t)(2 * spread + 1);
+        points[index] = (gfx_point_t){
+            .x = (int16_t)((int32_t)(test_random() % range) - spread + 64),
+            .y = (int16_t)((int32_t)(test_random() % range) - spread + 64),
+        };
+        if (index > 0U && test_random() % 4U == 0U) {
+            points[index].y = points[index - 1U].y;
+        }
+        if (index > 0U && test_random() % 4U == 0U) {
+            points[index].x = points[index - 1U].x;
+        }
+    }
+}
+
+static void test_matches_reference(gfx_t* gfx, gfx_t* expected)
+{
+    static gfx_rop_t const rops[] = {GFX_ROP_SET, GFX_ROP_CLEAR, GFX_ROP_XOR};
+    gfx_point_t points[POINTS_MAX];
+
+    for (size_t trial = 0U; trial < TRIALS; ++trial) {
+        size_t count = test_random() % POINTS_MAX + 1U;
+        gfx_fill_rule_t rule = (gfx_fill_rule_t)(test_random() % 2U);
+        gfx_rop_t rop = rops[test_random() % 3U];
+        // now and then too few edges for the polygon, on the heap so that
+        // ASan sees writes past them
+        size_t capacity =
+            test_random() % 5U == 0U ? test_random() % count : count;
+        gfx_edge_t* edges =
+            malloc(capacity > 0U ? capacity * sizeof(gfx_edge_t) : 1U);
+
+        make_random_polygon(points, count);
+        for (size_t offset = 0U; offset < sizeof(frame); ++offset) {
+            frame[offset] = (uint8_t)test_random();
+        }
+        memcpy(expected_frame, frame, sizeof(frame));
+        memcpy(before, frame, sizeof(frame));
+        gfx_clear_dirty(gfx);
+
+        gfx_err_t err =
+            gfx_fill_polygon(gfx, points, count, rule, edges, capacity, rop);
+        free(edges);
+        if (err == GFX_ERR_OK) {
+            draw_reference(expected, points, count, rule, rop);
+        }
+
+        if (!TEST_CHECK(err == GFX_ERR_OK || capacity < count) ||
+            !TEST_CHECK(memcmp(frame, expected_frame, sizeof(frame)) == 0) ||
+            !TEST_CHECK(test_gfx_is_dirty(gfx, before))) {
+            break;
+        }
+    }
+}
+
+static void test_shapes(gfx_t* gfx, gfx_t* expected)
+{
+    gfx_edge_t edges[5];
+
+    // corners on pixel edges, the same pixels as gfx_fill_rect
+    static gfx_point_t const square[] = {{3, 5}, {90, 5}, {90, 77}, {3, 77}};
+    memset(frame, 0, sizeof(frame));
+    memset(expected_frame, 0, sizeof(expected_frame));
+    TEST_CHECK(gfx_fill_polygon(gfx,
+                                square,
+                                4U,
+                                GFX_FILL_RULE_EVEN_ODD,
+                                edges,
+                                4U,
+                                GFX_ROP_SET) == GFX_ERR_OK);
+    gfx_fill_rect(expected, 3, 5, 87, 72, GFX_ROP_SET);
+    TEST_CHECK(memcmp(frame, expected_frame, sizeof(frame)) == 0);
+
+    // the pentagram centre is open under even-odd and filled under nonzero
+    static gfx_point_t const star[] = {
+        {64, 4}, {100, 120}, {8, 46}, {120, 46}, {28, 120}};
+    memset(frame, 0, sizeof(frame));
+    gfx_fill_polygon(
+        gfx, star, 5U, GFX_FILL_RULE_EVEN_ODD, edges, 5U, GFX_ROP_SET);
+    TEST_CHECK(!gfx_get_pixel(gfx, 64, 70) && gfx_get_pixel(gfx, 64, 20));
+    memset(frame, 0, sizeof(frame));
+    gfx_fill_polygon(
+        gfx, star, 5U, GFX_FILL_RULE_NONZERO, edges, 5U, GFX_ROP_SET);
+    TEST_CHECK(gfx_get_pixel(gfx, 64, 70) && gfx_get_pixel(gfx, 64, 20));
+
+    // XOR twice leaves nothing behind
+    gfx_fill_polygon(
+        gfx, star, 5U, GFX_FILL_RULE_NONZERO, edges, 5U, GFX_ROP_XOR);
+    for (size_t offset = 0U; offset < sizeof(frame); ++offset) {
+        TEST_CHECK(frame[offset] == 0U);
+    }
+
+    // fewer than three points, or only horizontal edges, cover no centre
+    gfx_clear_dirty(gfx);
+    TEST_CHECK(gfx_fill_polygon(gfx,
+                                NULL,
+                                0U,
+                                GFX_FILL_RULE_NONZERO,
+                                NULL,
+                                0U,
+                                GFX_ROP_SET) == GFX_ERR_OK);
+    TEST_CHECK(gfx_fill_polygon(gfx,
+                                square,
+                                2U,
+                                GFX_FILL_RULE_NONZERO,
+                                edges,
+                                2U,
+                                GFX_ROP_SET) == GFX_ERR_OK);
+    static gfx_point_t const flat[] = {{0, 9}, {127, 9}, {50, 9}};
+    TEST_CHECK(gfx_fill_polygon(gfx,
+                                flat,
+                                3U,
+                                GFX_FILL_RULE_NONZERO,
+                                NULL,
+                                0U,
+                                GFX_ROP_SET) == GFX_ERR_OK);
+    for (size_t page = 0U; page < gfx_get_pages(gfx); ++page) {
+        gfx_span_t span = gfx_get_dirty(gfx, page);
+        TEST_CHECK(span.begin >= span.end);
+    }
+}
+
+int main(void)
+{
+    gfx_t gfx;
+    gfx_t expected;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    test_gfx_initialize(
+        &expected, expected_frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    test_matches_reference(&gfx, &expected);
+    test_shapes(&gfx, &expected);
+
+    return test_finish();
+}
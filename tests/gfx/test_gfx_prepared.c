@@ -0,0 +1,101 @@
+#include "gfx_text.h"
+#include "labels.h"
+#include "prepared.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <string.h>
+
+typedef struct {
+    gfx_prepared_string_t const* prepared;
+    char const* text;
+} entry_t;
+
+static entry_t const entries[] = {
+    {&labels_title, LABELS_TITLE_TEXT},
+    {&labels_temperature, LABELS_TEMPERATURE_TEXT},
+    {&labels_humidity, LABELS_HUMIDITY_TEXT},
+    {&labels_pressure, LABELS_PRESSURE_TEXT},
+    {&prepared_plain, PREPARED_PLAIN_TEXT},
+    {&prepared_polish, PREPARED_POLISH_TEXT},
+    {&prepared_extended, PREPARED_EXTENDED_TEXT},
+    {&prepared_escapes, PREPARED_ESCAPES_TEXT},
+    {&prepared_malformed, PREPARED_MALFORMED_TEXT},
+    {&prepared_unknown, PREPARED_UNKNOWN_TEXT},
+    {&prepared_terminated, PREPARED_TERMINATED_TEXT},
+    {&prepared_empty, PREPARED_EMPTY_TEXT},
+};
+
+static gfx_rop_t const rops[] = {
+    GFX_ROP_SET,
+    GFX_ROP_CLEAR,
+    GFX_ROP_XOR,
+    GFX_ROP_AND,
+    GFX_ROP_INVERT,
+    GFX_ROP_COPY,
+};
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+
+static void fill_pattern(uint8_t* buffer)
+{
+    for (size_t index = 0U; index < TEST_GFX_FRAME_SIZE; ++index) {
+        buffer[index] = (uint8_t)(index * 29U + 5U);
+    }
+}
+
+int main(void)
+{
+    static int16_t const positions[][2] = {{0, 0}, {5, 13}, {-4, 60}};
+
+    gfx_t gfx;
+    gfx_t expected;
+
+    TEST_CHECK(prepared_empty.width == 0U);
+    TEST_CHECK(prepared_terminated.width == 6U * 6U);
+    TEST_CHECK(strcmp(PREPARED_ESCAPES_TEXT,
+                      "tab\there \"quoted\" back\\slash ABą\U0001F600") ==
+               0);
+
+    for (size_t index = 0U; index < sizeof(entries) / sizeof(*entries);
+         ++index) {
+        for (size_t rop = 0U; rop < sizeof(rops) / sizeof(*rops); ++rop) {
+            for (size_t position = 0U;
+                 position < sizeof(positions) / sizeof(*positions);
+                 ++position) {
+                int16_t x = positions[position][0];
+                int16_t y = positions[position][1];
+
+                test_gfx_initialize(
+                    &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+                test_gfx_initialize(&expected,
+                                    expected_frame,
+                                    TEST_GFX_WIDTH,
+                                    TEST_GFX_HEIGHT,
+                                    NULL);
+                fill_pattern(frame);
+                fill_pattern(expected_frame);
+                gfx_clear_dirty(&gfx);
+                gfx_clear_dirty(&expected);
+
+                gfx_draw_prepared_string(
+                    &gfx, x, y, entries[index].prepared, rops[rop]);
+                gfx_draw_string(
+                    &expected, x, y, entries[index].text, rops[rop]);
+
+                TEST_CHECK(memcmp(frame, expected_frame, sizeof(frame)) ==
+                           0);
+                for (size_t page = 0U; page < gfx_get_pages(&gfx); ++page) {
+                    gfx_span_t span = gfx_get_dirty(&gfx, page);
+                    gfx_span_t expected_span = gfx_get_dirty(&expected, page);
+                    TEST_CHECK((span.begin >= span.end &&
+                                expected_span.begin >= expected_span.end) ||
+                               (span.begin == expected_span.begin &&
+                                span.end == expected_span.end));
+                }
+            }
+        }
+    }
+
+    return test_finish();
+}
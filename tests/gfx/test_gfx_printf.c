@@ -0,0 +1,160 @@
+#include "gfx_printf.h"
+#include "gfx_text.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// wide enough for every expected text, so none is cut at the right edge
+#define FRAME_WIDTH (512U)
+#define FRAME_HEIGHT (16U)
+
+static uint8_t frame[FRAME_WIDTH * FRAME_HEIGHT / 8U];
+static uint8_t expected_frame[FRAME_WIDTH * FRAME_HEIGHT / 8U];
+
+static int32_t count_glyphs(char const* string)
+{
+    int32_t count = 0;
+
+    for (; *string != '\0'; ++string) {
+        count += ((uint8_t)*string & 0xC0U) != 0x80U ? 1 : 0;
+    }
+
+    return count;
+}
+
+// Draws format and the expected text at the same spot, the frames, dirty
+// spans and returned cursors have to match
+static void check_drawn(char const* expected,
+                        char const* format,
+                        va_list arguments)
+{
+    gfx_t gfx;
+    gfx_t reference;
+
+    test_gfx_initialize(&gfx, frame, FRAME_WIDTH, FRAME_HEIGHT, NULL);
+    test_gfx_initialize(
+        &reference, expected_frame, FRAME_WIDTH, FRAME_HEIGHT, NULL);
+    memset(frame, 0xA5, sizeof(frame));
+    memset(expected_frame, 0xA5, sizeof(expected_frame));
+    gfx_clear_dirty(&gfx);
+    gfx_clear_dirty(&reference);
+
+    int32_t cursor =
+        gfx_draw_vprintf(&gfx, -3, 5, GFX_ROP_COPY, format, arguments);
+    gfx_draw_string(&reference, -3, 5, expected, GFX_ROP_COPY);
+
+    bool same = memcmp(frame, expected_frame, sizeof(frame)) == 0 &&
+                cursor == -3 + 6 * count_glyphs(expected);
+    for (size_t page = 0U; page < gfx_get_pages(&gfx); ++page) {
+        gfx_span_t span = gfx_get_dirty(&gfx, page);
+        gfx_span_t expected_span = gfx_get_dirty(&reference, page);
+        same = same && span.begin == expected_span.begin &&
+               span.end == expected_span.end;
+    }
+
+    if (!TEST_CHECK(same)) {
+        fprintf(
+            stderr, "  format \"%s\", expected \"%s\"\n", format, expected);
+    }
+}
+
+// Standard conversions, the host printf gives the expected text
+__attribute__((format(printf, 1, 2))) static void
+check(char const* format, ...)
+{
+    char expected[128];
+    va_list arguments;
+
+    va_start(arguments, format);
+    vsnprintf(expected, sizeof(expected), format, arguments);
+    va_end(arguments);
+
+    va_start(arguments, format);
+    check_drawn(expected, format, arguments);
+    va_end(arguments);
+}
+
+// Conversions of gfx_draw_printf alone
+static void check_text(char const* expected, char const* format, ...)
+{
+    va_list arguments;
+
+    va_start(arguments, format);
+    check_drawn(expected, format, arguments);
+    va_end(arguments);
+}
+
+static void test_integers(void)
+{
+    static int const values[] = {
+        0, 1, -1, 7, -42, 255, 1000, -99999, INT_MAX, INT_MIN};
+
+    for (size_t index = 0U; index < sizeof(values) / sizeof(*values);
+         ++index) {
+        int value = values[index];
+        unsigned magnitude = (unsigned)value;
+
+        check("%d|%i|%u", value, value, magnitude);
+        check("%5d|%-5d|%05d", value, value, value);
+        check("%.3d|%.0d|%8.4d", value, value, value);
+        check("%-8.4d|%8.0d", value, value);
+        check("%x|%X|%.6x", magnitude, magnitude, magnitude);
+        check("%.0X|%010x|%-9.7X", magnitude, magnitude, magnitude);
+        check("%.3u|%.0u|%6.2u", magnitude, magnitude, magnitude);
+        check("%ld|%lu|%lx",
+              (long)value,
+              (unsigned long)magnitude,
+              (unsigned long)magnitude);
+    }
+
+    // precision turns the 0 flag off, the compiler warns about it in printf
+    check_text("    0042|  -042", "%08.4d|%06.3d", 42, -42);
+    check_text("     00ff", "%09.4x", 0xFFU);
+
+    // precision past the digit buffer is clamped to it
+    check_text("000000000000000000000042", "%.30d", 42);
+}
+
+static void test_fixed_point(void)
+{
+    check_text("23.5", "%.1k", 235);
+    check_text("-0.05", "%k", -5);
+    check_text("12", "%.0k", 12);
+    check_text("  1.000", "%7.3k", 1000);
+    check_text("-002.50", "%07k", -250);
+    check_text("21474836.47", "%k", INT_MAX);
+    check_text("-2.147483648", "%.12k", INT_MIN);
+}
+
+static void test_strings(void)
+{
+    check("[%s] [%.3s] [%6s] [%-6s] [%c]", "ab", "abcdef", "ab", "ab", 'z');
+    check("%s°C %.2s", "Zażółć", "ąę");
+    check("100%% done");
+
+    check_text("(null)", "%s", (char const*)NULL);
+    check_text("(nu", "%.3s", (char const*)NULL);
+    check_text("  (null)", "%8s", (char const*)NULL);
+}
+
+static void test_unknown_conversions(void)
+{
+    check_text("a%qb", "a%qb", 1);
+    check_text("%-5q|7", "%-5q|%d", 7);
+    check_text("%08.3y", "%08.3y");
+    check_text("end%", "end%");
+    check_text("end%-4", "end%-4");
+}
+
+int main(void)
+{
+    test_integers();
+    test_fixed_point();
+    test_strings();
+    test_unknown_conversions();
+
+    return test_finish();
+}
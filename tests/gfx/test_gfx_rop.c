@@ -0,0 +1,309 @@
+#include "gfx_draw.h"
+#include "gfx_polygon.h"
+#include "gfx_text.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <string.h>
+
+#define TRIALS (4000U)
+#define COLUMNS_MAX (24U)
+
+typedef enum {
+    PRIMITIVE_PIXEL,
+    PRIMITIVE_LINE,
+    PRIMITIVE_HLINE,
+    PRIMITIVE_VLINE,
+    PRIMITIVE_RECT,
+    PRIMITIVE_FILL_RECT,
+    PRIMITIVE_CIRCLE,
+    PRIMITIVE_FILL_CIRCLE,
+    PRIMITIVE_ELLIPSE,
+    PRIMITIVE_FILL_ELLIPSE,
+    PRIMITIVE_ARC,
+    PRIMITIVE_FILL_ARC,
+    PRIMITIVE_POLYGON,
+    PRIMITIVE_COLUMNS,
+    PRIMITIVE_STRING,
+    PRIMITIVE_COUNT,
+} primitive_t;
+
+static gfx_rop_t const rops[] = {
+    GFX_ROP_SET,
+    GFX_ROP_CLEAR,
+    GFX_ROP_XOR,
+    GFX_ROP_AND,
+    GFX_ROP_INVERT,
+    GFX_ROP_COPY,
+};
+
+static char const* const strings[] = {
+    "Temp 23.5C",
+    "Zażółć",
+    "€µ°",
+    "|",
+};
+
+// Random arguments, each primitive takes what it needs
+typedef struct {
+    primitive_t primitive;
+    int16_t values[6];
+    gfx_point_t points[6];
+    uint8_t columns[COLUMNS_MAX];
+    size_t count;
+    char const* string;
+} shape_t;
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t source_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t footprint_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t content_frame[TEST_GFX_FRAME_SIZE];
+
+static void draw(gfx_t* gfx, shape_t const* shape, gfx_rop_t rop)
+{
+    int16_t const* values = shape->values;
+    gfx_edge_t edges[6];
+
+    switch (shape->primitive) {
+        case PRIMITIVE_PIXEL: {
+            gfx_draw_pixel(gfx, values[0], values[1], rop);
+            break;
+        }
+        case PRIMITIVE_LINE: {
+            gfx_draw_line(gfx, values[0], values[1], values[2], values[3], rop);
+            break;
+        }
+        case PRIMITIVE_HLINE: {
+            gfx_draw_hline(gfx, values[0], values[1], values[2], rop);
+            break;
+        }
+        case PRIMITIVE_VLINE: {
+            gfx_draw_vline(gfx, values[0], values[1], values[3], rop);
+            break;
+        }
+        case PRIMITIVE_RECT: {
+            gfx_draw_rect(gfx, values[0], values[1], values[2], values[3], rop);
+            break;
+        }
+        case PRIMITIVE_FILL_RECT: {
+            gfx_fill_rect(gfx, values[0], values[1], values[2], values[3], rop);
+            break;
+        }
+        case PRIMITIVE_CIRCLE: {
+            gfx_draw_circle(gfx, values[0], values[1], values[4], rop);
+            break;
+        }
+        case PRIMITIVE_FILL_CIRCLE: {
+            gfx_fill_circle(gfx, values[0], values[1], values[4], rop);
+            break;
+        }
+        case PRIMITIVE_ELLIPSE: {
+            gfx_draw_ellipse(
+                gfx, values[0], values[1], values[4], values[5], rop);
+            break;
+        }
+        case PRIMITIVE_FILL_ELLIPSE: {
+            gfx_fill_ellipse(
+                gfx, values[0], values[1], values[4], values[5], rop);
+            break;
+        }
+        case PRIMITIVE_ARC: {
+            gfx_draw_arc(gfx,
+                         values[0],
+                         values[1],
+                         values[4],
+                         values[2],
+                         values[3],
+                         rop);
+            break;
+        }
+        case PRIMITIVE_FILL_ARC: {
+            gfx_fill_arc(gfx,
+                         values[0],
+                         values[1],
+                         values[4],
+                         values[2],
+                         values[3],
+                         rop);
+            break;
+        }
+        case PRIMITIVE_POLYGON: {
+            gfx_fill_polygon(gfx,
+                             shape->points,
+                             shape->count,
+                             (gfx_fill_rule_t)(values[5] % 2),
+                             edges,
+                             shape->count,
+                             rop);
+            break;
+        }
+        case PRIMITIVE_COLUMNS: {
+            gfx_draw_columns(
+                gfx, values[0], values[1], shape->columns, shape->count, rop);
+            break;
+        }
+        default: {
+            gfx_draw_string(gfx, values[0], values[1], shape->string, rop);
+            break;
+        }
+    }
+}
+
+static shape_t get_random_shape(void)
+{
+    shape_t shape = {
+        .primitive = (primitive_t)(test_random() % PRIMITIVE_COUNT),
+        .count = test_random() % 6U + 1U,
+        .string = strings[test_random() % 4U],
+    };
+
+    for (size_t index = 0U; index < 4U; ++index) {
+        shape.values[index] =
+            (int16_t)((int32_t)(test_random() % 180U) - 26);
+    }
+    shape.values[4] = (int16_t)(test_random() % 70U);
+    shape.values[5] = (int16_t)(test_random() % 70U);
+    for (size_t index = 0U; index < 6U; ++index) {
+        shape.points[index] = (gfx_point_t){
+            .x = (int16_t)((int32_t)(test_random() % 180U) - 26),
+            .y = (int16_t)((int32_t)(test_random() % 180U) - 26),
+        };
+    }
+    if (shape.primitive == PRIMITIVE_COLUMNS) {
+        shape.count = test_random() % COLUMNS_MAX + 1U;
+    }
+    for (size_t index = 0U; index < COLUMNS_MAX; ++index) {
+        shape.columns[index] = (uint8_t)test_random();
+    }
+
+    return shape;
+}
+
+// A byte of the frame after rop, where footprint is the area the operation
+// covers and source the pixels drawn in it
+static uint8_t apply(uint8_t byte,
+                     uint8_t source,
+                     uint8_t footprint,
+                     gfx_rop_t rop)
+{
+    uint8_t result = byte;
+
+    switch (rop) {
+        case GFX_ROP_SET: {
+            result = (uint8_t)(byte | source);
+            break;
+        }
+        case GFX_ROP_CLEAR: {
+            result = (uint8_t)(byte & ~source);
+            break;
+        }
+        case GFX_ROP_XOR: {
+            result = (uint8_t)(byte ^ source);
+            break;
+        }
+        case GFX_ROP_AND: {
+            result = (uint8_t)(byte & source);
+            break;
+        }
+        case GFX_ROP_INVERT: {
+            result = (uint8_t)~byte;
+            break;
+        }
+        default: {
+            result = source;
+            break;
+        }
+    }
+
+    return (uint8_t)((result & footprint) | (byte & ~footprint));
+}
+
+// The pixels a primitive sets with SET on a blank frame are its source, the
+// ones INVERT flips are its footprint. Every operation has to combine the
+// two with any content byte by byte.
+static void test_matches_reference(gfx_t* gfx)
+{
+    for (size_t trial = 0U; trial < TRIALS; ++trial) {
+        shape_t shape = get_random_shape();
+
+        memset(frame, 0, sizeof(frame));
+        draw(gfx, &shape, GFX_ROP_SET);
+        memcpy(source_frame, frame, sizeof(frame));
+
+        memset(frame, 0, sizeof(frame));
+        draw(gfx, &shape, GFX_ROP_INVERT);
+        memcpy(footprint_frame, frame, sizeof(frame));
+
+        // XOR on a blank frame only equals SET if no pixel is drawn twice
+        memset(frame, 0, sizeof(frame));
+        draw(gfx, &shape, GFX_ROP_XOR);
+        bool once = memcmp(frame, source_frame, sizeof(frame)) == 0;
+
+        for (size_t offset = 0U; offset < sizeof(content_frame); ++offset) {
+            content_frame[offset] = (uint8_t)test_random();
+        }
+
+        bool matches = true;
+        bool dirty = true;
+        for (size_t index = 0U; index < sizeof(rops) / sizeof(*rops);
+             ++index) {
+            memcpy(frame, content_frame, sizeof(frame));
+            gfx_clear_dirty(gfx);
+            draw(gfx, &shape, rops[index]);
+            dirty = dirty && test_gfx_is_dirty(gfx, content_frame);
+
+            for (size_t offset = 0U; offset < sizeof(frame); ++offset) {
+                if (frame[offset] != apply(content_frame[offset],
+                                           source_frame[offset],
+                                           footprint_frame[offset],
+                                           rops[index])) {
+                    matches = false;
+                }
+            }
+
+            // XOR and INVERT undo themselves
+            if (rops[index] == GFX_ROP_XOR || rops[index] == GFX_ROP_INVERT) {
+                draw(gfx, &shape, rops[index]);
+                matches = matches &&
+                          memcmp(frame, content_frame, sizeof(frame)) == 0;
+            }
+        }
+
+        if (!TEST_CHECK(once) || !TEST_CHECK(matches) ||
+            !TEST_CHECK(dirty)) {
+            break;
+        }
+    }
+}
+
+// Shapes have every source pixel set, AND leaves them as they are and
+// COPY sets them
+static void test_shapes(gfx_t* gfx)
+{
+    for (size_t offset = 0U; offset < sizeof(content_frame); ++offset) {
+        content_frame[offset] = (uint8_t)test_random();
+    }
+
+    memcpy(frame, content_frame, sizeof(frame));
+    gfx_fill_circle(gfx, 64, 64, 40, GFX_ROP_AND);
+    gfx_fill_rect(gfx, 3, 5, 120, 110, GFX_ROP_AND);
+    TEST_CHECK(memcmp(frame, content_frame, sizeof(frame)) == 0);
+
+    memcpy(frame, content_frame, sizeof(frame));
+    gfx_fill_rect(gfx, 3, 5, 120, 110, GFX_ROP_COPY);
+    memcpy(source_frame, frame, sizeof(frame));
+    memcpy(frame, content_frame, sizeof(frame));
+    gfx_fill_rect(gfx, 3, 5, 120, 110, GFX_ROP_SET);
+    TEST_CHECK(memcmp(frame, source_frame, sizeof(frame)) == 0);
+}
+
+int main(void)
+{
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+
+    test_matches_reference(&gfx);
+    test_shapes(&gfx);
+
+    return test_finish();
+}
@@ -0,0 +1,222 @@
+extern "C" {
+#include "gfx_blit.h"
+#include "gfx_draw.h"
+#include "gfx_text.h"
+#include "screens.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+}
+
+#include "font5x7_static.hpp"
+#include "gfx_static.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+    constexpr std::size_t trials = 20000U;
+    constexpr std::size_t steps = 6U;
+
+    constexpr std::array<gfx_rop_t, 6> rops = {
+        GFX_ROP_SET,
+        GFX_ROP_CLEAR,
+        GFX_ROP_XOR,
+        GFX_ROP_AND,
+        GFX_ROP_INVERT,
+        GFX_ROP_COPY,
+    };
+
+    // malformed and truncated sequences and code points without a glyph
+    constexpr std::array<char const*, 5> strings = {
+        "Hello",
+        "Zażółć gęślą jaźń",
+        "\x80\xC3(ok)\xE2\x82",
+        "Ciśnienie: 1013 hPa",
+        "\xF0\x9F\x98\x80!",
+    };
+
+    std::array<std::uint8_t, TEST_GFX_FRAME_SIZE> frame;
+
+    int get_random(int low, int high)
+    {
+        return low + static_cast<int>(test_random() %
+                                      static_cast<std::uint32_t>(high - low));
+    }
+
+    // The splash of main/screens.cpp, drawn at run time
+    void draw_splash(gfx_t* gfx)
+    {
+        static std::uint8_t const thermometer[] = {
+            0x00, 0x60, 0x9E, 0x81, 0x9E, 0x60, 0x00, 0x00};
+
+        gfx_draw_rect(gfx, 0, 0, 128, 128, GFX_ROP_SET);
+        gfx_fill_rect(gfx, 2, 2, 124, 12, GFX_ROP_SET);
+        gfx_draw_string(gfx, 4, 4, "SH1107", GFX_ROP_CLEAR);
+        gfx_draw_hline(gfx, 2, 16, 124, GFX_ROP_SET);
+
+        gfx_draw_string(gfx, 4, 24, "Zażółć gęślą jaźń", GFX_ROP_SET);
+        gfx_draw_columns(gfx, 4, 40, thermometer, 8U, GFX_ROP_SET);
+        gfx_draw_string(gfx, 16, 40, "Temperatura:", GFX_ROP_SET);
+        gfx_draw_string(gfx, 16, 52, "Wilgotność:", GFX_ROP_SET);
+        gfx_draw_string(gfx, 16, 64, "Ciśnienie:", GFX_ROP_SET);
+
+        gfx_draw_line(gfx, 4, 120, 60, 84, GFX_ROP_SET);
+        gfx_draw_line(gfx, 60, 84, 123, 120, GFX_ROP_SET);
+    }
+
+    // The image the compiler rendered is the one gfx draws, and
+    // gfx_flush_image sends it as whole pages without touching the frame
+    void test_splash()
+    {
+        test_panel_t panel;
+        gfx_interface_t interface = test_panel_get_interface(&panel);
+        gfx_t gfx;
+
+        test_panel_initialize(&panel);
+        test_gfx_initialize(
+            &gfx, frame.data(), TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+        draw_splash(&gfx);
+        TEST_CHECK(std::memcmp(frame.data(), screens_splash, frame.size()) ==
+                   0);
+
+        gfx_fill_rect(&gfx, 10, 10, 30, 30, GFX_ROP_XOR);
+        auto before = frame;
+        gfx_clear_dirty(&gfx);
+        TEST_CHECK(gfx_flush_image(&gfx, screens_splash) == GFX_ERR_OK);
+        TEST_CHECK(panel.spans == TEST_GFX_HEIGHT / GFX_PAGE_HEIGHT);
+        TEST_CHECK(std::memcmp(panel.ram, screens_splash, frame.size()) == 0);
+        TEST_CHECK(frame == before);
+
+        // the next flush puts the frame buffer back on the panel
+        TEST_CHECK(gfx_flush(&gfx) == GFX_ERR_OK);
+        TEST_CHECK(std::memcmp(panel.ram, frame.data(), frame.size()) == 0);
+    }
+
+    // Random sequences of every primitive and operation through both
+    // renderers, also on a screen whose last page is partly outside it
+    template <std::size_t Width, std::size_t Height>
+    void test_matches_runtime()
+    {
+        constexpr std::size_t size =
+            Width * ((Height + GFX_PAGE_HEIGHT - 1U) / GFX_PAGE_HEIGHT);
+        gfx_t gfx;
+
+        test_gfx_initialize(&gfx, frame.data(), Width, Height, nullptr);
+
+        for (std::size_t trial = 0U; trial < trials; ++trial) {
+            gfx_static_screen<Width, Height> screen(font5x7_static);
+            std::memset(frame.data(), 0, size);
+
+            bool matches = true;
+            for (std::size_t step = 0U; step < steps && matches; ++step) {
+                int x = get_random(-30, 140);
+                int y = get_random(-30, 140);
+                int width = get_random(-10, 80);
+                int height = get_random(-10, 80);
+                auto at_x = static_cast<std::int16_t>(x);
+                auto at_y = static_cast<std::int16_t>(y);
+                auto span_x = static_cast<std::int16_t>(width);
+                auto span_y = static_cast<std::int16_t>(height);
+                gfx_rop_t rop = rops[test_random() % rops.size()];
+
+                switch (test_random() % 9U) {
+                    case 0U: {
+                        gfx_fill_rect(&gfx, at_x, at_y, span_x, span_y, rop);
+                        screen.fill_rect(x, y, width, height, rop);
+                        break;
+                    }
+                    case 1U: {
+                        gfx_draw_rect(&gfx, at_x, at_y, span_x, span_y, rop);
+                        screen.draw_rect(x, y, width, height, rop);
+                        break;
+                    }
+                    case 2U: {
+                        auto end_x = static_cast<std::int16_t>(x + width);
+                        auto end_y = static_cast<std::int16_t>(y + height);
+                        gfx_draw_line(&gfx, at_x, at_y, end_x, end_y, rop);
+                        screen.draw_line(x, y, x + width, y + height, rop);
+                        break;
+                    }
+                    case 3U: {
+                        gfx_draw_hline(&gfx, at_x, at_y, span_x, rop);
+                        screen.draw_hline(x, y, width, rop);
+                        break;
+                    }
+                    case 4U: {
+                        gfx_draw_vline(&gfx, at_x, at_y, span_y, rop);
+                        screen.draw_vline(x, y, height, rop);
+                        break;
+                    }
+                    case 5U: {
+                        char const* string =
+                            strings[test_random() % strings.size()];
+                        gfx_draw_string(&gfx, at_x, at_y, string, rop);
+                        screen.draw_string(x, y, string, rop);
+                        break;
+                    }
+                    case 6U: {
+                        std::array<std::uint8_t, 9> columns;
+                        for (auto& column : columns) {
+                            column = static_cast<std::uint8_t>(test_random());
+                        }
+                        gfx_draw_columns(&gfx,
+                                         at_x,
+                                         at_y,
+                                         columns.data(),
+                                         columns.size(),
+                                         rop);
+                        screen.draw_columns(x, y, columns, rop);
+                        break;
+                    }
+                    case 7U: {
+                        std::array<std::uint8_t, 20U * 3U> data;
+                        for (auto& byte : data) {
+                            byte = static_cast<std::uint8_t>(test_random());
+                        }
+                        std::size_t image_width = test_random() % 20U + 1U;
+                        std::size_t image_height = test_random() % 24U + 1U;
+                        gfx_bitmap_t bitmap = {.data = data.data(),
+                                               .width = image_width,
+                                               .height = image_height};
+                        gfx_blit(&gfx,
+                                 at_x,
+                                 at_y,
+                                 &bitmap,
+                                 0,
+                                 0,
+                                 static_cast<std::int16_t>(image_width),
+                                 static_cast<std::int16_t>(image_height),
+                                 rop);
+                        screen.blit(x, y, data, image_width, image_height, rop);
+                        break;
+                    }
+                    default: {
+                        gfx_draw_pixel(&gfx, at_x, at_y, rop);
+                        screen.draw_pixel(x, y, rop);
+                        break;
+                    }
+                }
+
+                matches = std::memcmp(frame.data(),
+                                      screen.get_image().data(),
+                                      size) == 0;
+            }
+
+            if (!TEST_CHECK(matches)) {
+                break;
+            }
+        }
+    }
+
+} // namespace
+
+int main()
+{
+    test_splash();
+    test_matches_runtime<TEST_GFX_WIDTH, TEST_GFX_HEIGHT>();
+    test_matches_runtime<100U, 61U>();
+
+    return test_finish();
+}
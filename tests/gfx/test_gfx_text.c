@@ -0,0 +1,303 @@
+#include "font5x7.h"
+#include "gfx_text.h"
+#include "gfx_utf8.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <string.h>
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+
+static gfx_rop_t const rops[] = {
+    GFX_ROP_SET,
+    GFX_ROP_CLEAR,
+    GFX_ROP_XOR,
+    GFX_ROP_AND,
+    GFX_ROP_INVERT,
+    GFX_ROP_COPY,
+};
+
+// Glyph by glyph through gfx_draw_columns, the way the text path has to
+// come out
+static void draw_expected(gfx_t* gfx,
+                          int16_t x,
+                          int16_t y,
+                          char const* string,
+                          gfx_rop_t rop)
+{
+    static uint8_t const spacer = 0x00U;
+
+    size_t length = strlen(string);
+    int16_t advance = (int16_t)(FONT5X7_WIDTH + 1U);
+
+    while (length > 0U) {
+        uint32_t code_point;
+        size_t consumed = gfx_utf8_decode(string, length, &code_point);
+        string += consumed;
+        length -= consumed;
+
+        gfx_draw_columns(gfx,
+                         x,
+                         y,
+                         gfx_font_get_glyph(&gfx->config.font, code_point),
+                         FONT5X7_WIDTH,
+                         rop);
+        if (rop == GFX_ROP_INVERT || rop == GFX_ROP_AND ||
+            rop == GFX_ROP_COPY) {
+            gfx_draw_columns(
+                gfx, (int16_t)(x + advance - 1), y, &spacer, 1U, rop);
+        }
+        x = (int16_t)(x + advance);
+    }
+}
+
+static void fill_pattern(uint8_t* buffer)
+{
+    for (size_t index = 0U; index < TEST_GFX_FRAME_SIZE; ++index) {
+        buffer[index] = (uint8_t)(index * 37U + 11U);
+    }
+}
+
+static void test_glyphs_leave_spacing_row(void)
+{
+    for (size_t glyph = 0U; glyph < FONT5X7_CHARS; ++glyph) {
+        for (size_t column = 0U; column < FONT5X7_WIDTH; ++column) {
+            TEST_CHECK((font5x7[glyph][column] & 0x80U) == 0U);
+        }
+    }
+    for (size_t glyph = 0U; glyph < FONT5X7_EXT_CHARS; ++glyph) {
+        for (size_t column = 0U; column < FONT5X7_WIDTH; ++column) {
+            TEST_CHECK((font5x7_ext[glyph][column] & 0x80U) == 0U);
+        }
+    }
+}
+
+static void test_extended_lookup(void)
+{
+    gfx_font_t font = test_gfx_get_font();
+
+    for (size_t index = 0U; index < FONT5X7_EXT_CHARS; ++index) {
+        TEST_CHECK(gfx_font_find_extended(
+                       &font, font5x7_ext_code_points[index]) == index);
+        if (index > 0U) {
+            TEST_CHECK(font5x7_ext_code_points[index - 1U] <
+                       font5x7_ext_code_points[index]);
+        }
+    }
+
+    uint32_t const misses[] = {0x0000U, 0x007FU, 0x00AFU, 0x0100U, 0xFFFDU};
+    for (size_t index = 0U; index < sizeof(misses) / sizeof(*misses);
+         ++index) {
+        TEST_CHECK(gfx_font_find_extended(&font, misses[index]) ==
+                   GFX_GLYPH_NOT_FOUND);
+    }
+
+    uint8_t const* question = gfx_font_get_glyph(&font, '?');
+    TEST_CHECK(gfx_font_get_glyph(&font, 0x0100U) == question);
+    TEST_CHECK(gfx_font_get_glyph(&font, 0x1FU) == question);
+    TEST_CHECK(gfx_font_get_glyph(&font, 0x00F3U) == font5x7_ext[4]);
+}
+
+static void test_strings_match_glyphs(void)
+{
+    static char const* const strings[] = {
+        "Hello, world!",
+        "Zażółć gęślą jaźń",
+        "ĄĘŁŃÓŚŹŻ µ±° €←↑→↓",
+        // malformed, truncated and overlong sequences show as '?'
+        "A\xff" "B\xc4",
+        "\xe2\x82" "C\xc0\xaf",
+    };
+    static int16_t const positions[][2] = {
+        {0, 0}, {3, 5}, {-7, 13}, {100, 60}, {2, -3}, {-2, 124}};
+
+    gfx_t gfx;
+    gfx_t expected;
+
+    for (size_t string = 0U; string < sizeof(strings) / sizeof(*strings);
+         ++string) {
+        for (size_t rop = 0U; rop < sizeof(rops) / sizeof(*rops); ++rop) {
+            for (size_t position = 0U;
+                 position < sizeof(positions) / sizeof(*positions);
+                 ++position) {
+                int16_t x = positions[position][0];
+                int16_t y = positions[position][1];
+
+                test_gfx_initialize(
+                    &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+                test_gfx_initialize(&expected,
+                                    expected_frame,
+                                    TEST_GFX_WIDTH,
+                                    TEST_GFX_HEIGHT,
+                                    NULL);
+                fill_pattern(frame);
+                fill_pattern(expected_frame);
+
+                gfx_draw_string(&gfx, x, y, strings[string], rops[rop]);
+                draw_expected(&expected, x, y, strings[string], rops[rop]);
+
+                TEST_CHECK(memcmp(frame, expected_frame, sizeof(frame)) ==
+                           0);
+            }
+        }
+    }
+}
+
+static void test_lines_keep_spacing(void)
+{
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    gfx_draw_string(&gfx, 0, 0, "ĄĘ ąę µ gjpqy", GFX_ROP_SET);
+    gfx_draw_string(&gfx, 0, 8, "ŚŹŻ śźż ÓŁŃ", GFX_ROP_SET);
+
+    for (int16_t x = 0; x < (int16_t)TEST_GFX_WIDTH; ++x) {
+        TEST_CHECK(!gfx_get_pixel(&gfx, x, 7));
+        TEST_CHECK(!gfx_get_pixel(&gfx, x, 15));
+    }
+}
+
+static void test_dirty_span(void)
+{
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    gfx_clear_dirty(&gfx);
+
+    // four glyphs from column 10, across pages 1 and 2
+    gfx_draw_string(&gfx, 10, 12, "Łódź", GFX_ROP_SET);
+
+    for (size_t page = 0U; page < TEST_GFX_HEIGHT / GFX_PAGE_HEIGHT; ++page) {
+        gfx_span_t span = gfx_get_dirty(&gfx, page);
+        if (page == 1U || page == 2U) {
+            TEST_CHECK(span.begin == 10U && span.end == 10U + 4U * 6U);
+        } else {
+            TEST_CHECK(span.begin >= span.end);
+        }
+    }
+}
+
+// Column counts past int16_t and int32_t, only the visible ones are read
+static void test_wide_columns(void)
+{
+    static uint8_t columns[2U * TEST_GFX_WIDTH];
+    size_t const counts[] = {
+        (size_t)UINT16_MAX + 10U,
+        SIZE_MAX > UINT32_MAX ? (size_t)UINT32_MAX + 11U : SIZE_MAX,
+    };
+    gfx_t gfx;
+
+    for (size_t index = 0U; index < sizeof(columns); ++index) {
+        columns[index] = (uint8_t)test_random();
+    }
+
+    for (size_t index = 0U; index < sizeof(counts) / sizeof(*counts);
+         ++index) {
+        test_gfx_initialize(
+            &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+        gfx_clear_dirty(&gfx);
+
+        gfx_draw_columns(&gfx, -5, 8, columns, counts[index], GFX_ROP_COPY);
+
+        TEST_CHECK(memcmp(&frame[TEST_GFX_WIDTH],
+                          &columns[5],
+                          TEST_GFX_WIDTH) == 0);
+        for (size_t page = 0U; page < gfx_get_pages(&gfx); ++page) {
+            gfx_span_t span = gfx_get_dirty(&gfx, page);
+            if (page == 1U) {
+                TEST_CHECK(span.begin == 0U && span.end == TEST_GFX_WIDTH);
+            } else {
+                TEST_CHECK(span.begin >= span.end);
+            }
+        }
+    }
+}
+
+// A length cuts the string like a shorter string would, through a UTF-8
+// sequence or past a NUL alike
+static void test_text_length(void)
+{
+    static char const* const strings[] = {
+        "Zażółć gęślą jaźń",
+        "€ ±°µ",
+        "a\xff\xc4",
+        "NUL\0hidden",
+    };
+    char prefix[32];
+    gfx_t gfx;
+    gfx_t expected;
+
+    for (size_t index = 0U; index < sizeof(strings) / sizeof(*strings);
+         ++index) {
+        size_t size = strlen(strings[index]);
+        for (size_t length = 0U; length <= size + 1U; ++length) {
+            size_t cut = length < size ? length : size;
+            memcpy(prefix, strings[index], cut);
+            prefix[cut] = '\0';
+
+            test_gfx_initialize(
+                &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+            test_gfx_initialize(&expected,
+                                expected_frame,
+                                TEST_GFX_WIDTH,
+                                TEST_GFX_HEIGHT,
+                                NULL);
+            gfx_clear_dirty(&gfx);
+            gfx_clear_dirty(&expected);
+
+            gfx_draw_text(&gfx, -3, 13, strings[index], length, GFX_ROP_SET);
+            gfx_draw_string(&expected, -3, 13, prefix, GFX_ROP_SET);
+
+            TEST_CHECK(memcmp(frame, expected_frame, sizeof(frame)) == 0);
+            for (size_t page = 0U; page < gfx_get_pages(&gfx); ++page) {
+                gfx_span_t span = gfx_get_dirty(&gfx, page);
+                gfx_span_t expected_span = gfx_get_dirty(&expected, page);
+                TEST_CHECK(span.begin == expected_span.begin &&
+                           span.end == expected_span.end);
+            }
+        }
+    }
+}
+
+static void test_flush_sends_dirty_spans(void)
+{
+    test_panel_t panel;
+    gfx_t gfx;
+
+    test_panel_initialize(&panel);
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    test_gfx_initialize(
+        &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+
+    // the first flush sends the whole frame
+    TEST_CHECK(gfx_flush(&gfx) == GFX_ERR_OK);
+    TEST_CHECK(panel.spans == TEST_GFX_HEIGHT / 8U);
+    TEST_CHECK(gfx_flush(&gfx) == GFX_ERR_OK);
+    TEST_CHECK(panel.spans == TEST_GFX_HEIGHT / 8U);
+
+    test_panel_reset_counters(&panel);
+    gfx_draw_text(&gfx, 10, 20, "12:34", 5U, GFX_ROP_SET);
+    gfx_draw_text(&gfx, 70, 20, "5%", 2U, GFX_ROP_SET);
+    gfx_draw_text(&gfx, 0, 96, "ok", 2U, GFX_ROP_SET);
+    TEST_CHECK(gfx_flush(&gfx) == GFX_ERR_OK);
+
+    // rows 20-27 span pages 2 and 3, the labels on them merge into one span
+    TEST_CHECK(panel.spans == 3U);
+    TEST_CHECK(panel.bytes == 2U * (3U + 72U) + (3U + 12U));
+    TEST_CHECK(memcmp(panel.ram, frame, sizeof(frame)) == 0);
+}
+
+int main(void)
+{
+    test_glyphs_leave_spacing_row();
+    test_extended_lookup();
+    test_strings_match_glyphs();
+    test_lines_keep_spacing();
+    test_dirty_span();
+    test_wide_columns();
+    test_text_length();
+    test_flush_sends_dirty_spans();
+
+    return test_finish();
+}
@@ -0,0 +1,164 @@
+#include "gfx_text.h"
+#include "gfx_text_field.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdio.h>
+#include <string.h>
+
+static char const* const texts[] = {
+    "12:34:56",
+    "12:34:57",
+    "12:35:00",
+    "9",
+    "",
+    "Zażółć gęślą",
+    "Zażółć gęśla",
+    "Zazółć",
+    "\xc5\x9b\xff\xc4",
+    "0123456789abcdefghijklmnopqrstuvwxyz",
+    "ąąąąąąąąąąąąąąąąąą",
+    "-12.5°C",
+};
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t background[TEST_GFX_FRAME_SIZE];
+
+static size_t count_cells(char const* string, size_t length)
+{
+    size_t count = 0U;
+
+    for (size_t index = 0U; index < length; ++index) {
+        count += ((uint8_t)string[index] & 0xC0U) != 0x80U ? 1U : 0U;
+    }
+
+    return count;
+}
+
+// What the field holds of string, as the field truncates it
+static size_t get_kept_length(char const* string)
+{
+    size_t length = strlen(string);
+
+    if (length > GFX_TEXT_FIELD_CAPACITY) {
+        length = GFX_TEXT_FIELD_CAPACITY;
+        while (((uint8_t)string[length] & 0xC0U) == 0x80U) {
+            --length;
+        }
+    }
+
+    return length;
+}
+
+// The whole field drawn from scratch: blank cells over everything it ever
+// covered, then the text with its cells overwritten
+static void draw_expected(gfx_t* gfx,
+                          int16_t x,
+                          int16_t y,
+                          char const* string,
+                          size_t cells)
+{
+    memcpy(gfx->config.frame_buffer, background, sizeof(background));
+    for (size_t cell = 0U; cell < cells; ++cell) {
+        gfx_draw_cell(gfx,
+                      (int16_t)(x + (int16_t)(cell * 6U)),
+                      y,
+                      ' ',
+                      GFX_TEXT_ATTRIBUTE_NONE);
+    }
+    gfx_draw_text(gfx, x, y, string, get_kept_length(string), GFX_ROP_COPY);
+}
+
+static void test_matches_full_redraw(void)
+{
+    static int16_t const positions[][2] = {
+        {0, 0}, {7, 21}, {-9, 60}, {90, 123}};
+
+    gfx_t gfx;
+    gfx_t expected;
+
+    for (size_t index = 0U; index < sizeof(background); ++index) {
+        background[index] = (uint8_t)test_random();
+    }
+
+    for (size_t position = 0U;
+         position < sizeof(positions) / sizeof(*positions);
+         ++position) {
+        int16_t x = positions[position][0];
+        int16_t y = positions[position][1];
+        gfx_text_field_t field;
+        size_t cells = 0U;
+
+        test_gfx_initialize(
+            &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+        test_gfx_initialize(&expected,
+                            expected_frame,
+                            TEST_GFX_WIDTH,
+                            TEST_GFX_HEIGHT,
+                            NULL);
+        memcpy(frame, background, sizeof(background));
+        gfx_text_field_initialize(&field, x, y);
+
+        for (size_t update = 0U; update < 200U; ++update) {
+            char const* text = texts[test_random() % 12U];
+            size_t kept = get_kept_length(text);
+            size_t text_cells = count_cells(text, kept);
+            cells = text_cells > cells ? text_cells : cells;
+
+            gfx_text_field_update(&gfx, &field, text, strlen(text));
+            draw_expected(&expected, x, y, text, cells);
+
+            if (!TEST_CHECK(memcmp(frame, expected_frame, sizeof(frame)) ==
+                            0)) {
+                fprintf(stderr, "  at (%d, %d): \"%s\"\n", x, y, text);
+            }
+        }
+
+        gfx_text_field_clear(&gfx, &field);
+        draw_expected(&expected, x, y, "", cells);
+        TEST_CHECK(memcmp(frame, expected_frame, sizeof(frame)) == 0);
+    }
+}
+
+static void test_tick_traffic(void)
+{
+    test_panel_t panel;
+    gfx_text_field_t field;
+    gfx_t gfx;
+
+    test_panel_initialize(&panel);
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    test_gfx_initialize(
+        &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    gfx_text_field_initialize(&field, 16, 40);
+    gfx_text_field_update(&gfx, &field, "12:34:56", 8U);
+    TEST_CHECK(gfx_flush(&gfx) == GFX_ERR_OK);
+
+    // one digit is one cell: the page address and six columns
+    test_panel_reset_counters(&panel);
+    gfx_text_field_update(&gfx, &field, "12:34:57", 8U);
+    TEST_CHECK(gfx_flush(&gfx) == GFX_ERR_OK);
+    TEST_CHECK(panel.spans == 1U && panel.bytes == 3U + 6U);
+
+    // the span covers the first to the last changed cell
+    test_panel_reset_counters(&panel);
+    gfx_text_field_update(&gfx, &field, "12:35:00", 8U);
+    TEST_CHECK(gfx_flush(&gfx) == GFX_ERR_OK);
+    TEST_CHECK(panel.spans == 1U && panel.bytes == 3U + 4U * 6U);
+
+    test_panel_reset_counters(&panel);
+    gfx_text_field_update(&gfx, &field, "12:35:00", 8U);
+    TEST_CHECK(gfx_flush(&gfx) == GFX_ERR_OK);
+    TEST_CHECK(panel.bytes == 0U);
+
+    TEST_CHECK(memcmp(panel.ram, frame, sizeof(frame)) == 0);
+}
+
+int main(void)
+{
+    test_matches_full_redraw();
+    test_tick_traffic();
+
+    return test_finish();
+}
@@ -0,0 +1,131 @@
+#include "link.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BUFFER_SIZE (300U)
+#define FRAMES (1000000U)
+
+// Loops every frame straight back into the receiver, nothing stays on the
+// wire between frames
+typedef struct {
+    link_t link;
+    uint8_t tx_buffer[BUFFER_SIZE];
+    uint8_t rx_buffer[BUFFER_SIZE];
+    uint8_t wire[BUFFER_SIZE];
+    size_t written;
+    size_t read;
+    size_t received;
+} loopback_t;
+
+static size_t loopback_write(void* user, uint8_t const* data, size_t size)
+{
+    loopback_t* loopback = (loopback_t*)user;
+
+    memcpy(loopback->wire, data, size);
+    loopback->written = size;
+    loopback->read = 0U;
+
+    return size;
+}
+
+static size_t loopback_read(void* user, uint8_t* data, size_t size)
+{
+    loopback_t* loopback = (loopback_t*)user;
+    size_t available = loopback->written - loopback->read;
+
+    if (size > available) {
+        size = available;
+    }
+    memcpy(data, &loopback->wire[loopback->read], size);
+    loopback->read += size;
+
+    return size;
+}
+
+static void loopback_receive(void* user,
+                             uint8_t channel,
+                             uint8_t const* payload,
+                             size_t size)
+{
+    loopback_t* loopback = (loopback_t*)user;
+    (void)channel;
+    (void)payload;
+
+    loopback->received += size;
+}
+
+// Encode and decode cost per frame, and what is left of each baud rate for
+// the payload once COBS, the channel and the CRC are paid for
+static void run(char const* name, size_t size, bool zeros, size_t frames)
+{
+    static loopback_t loopback;
+    uint8_t payload[BUFFER_SIZE];
+
+    memset(&loopback, 0, sizeof(loopback));
+    link_initialize(&loopback.link,
+                    &(link_config_t){.tx_buffer = loopback.tx_buffer,
+                                     .tx_buffer_size = BUFFER_SIZE,
+                                     .rx_buffer = loopback.rx_buffer,
+                                     .rx_buffer_size = BUFFER_SIZE,
+                                     .baud = 115200U,
+                                     .max_baud = 4000000U},
+                    &(link_interface_t){.transport_user = &loopback,
+                                        .transport_write = loopback_write,
+                                        .transport_read = loopback_read,
+                                        .receive_user = &loopback,
+                                        .receive = loopback_receive});
+
+    for (size_t index = 0U; index < size; ++index) {
+        payload[index] = zeros && test_random() % 4U == 0U
+                             ? 0U
+                             : (uint8_t)(1U + test_random() % 255U);
+    }
+
+    uint64_t encoding = 0U;
+    uint64_t decoding = 0U;
+    size_t wire = 0U;
+
+    for (size_t frame = 0U; frame < frames; ++frame) {
+        uint64_t begin = test_get_time();
+        link_send(&loopback.link, LINK_CHANNEL_USER, payload, size);
+        uint64_t middle = test_get_time();
+        link_process(&loopback.link, 0U);
+        uint64_t end = test_get_time();
+
+        encoding += middle - begin;
+        decoding += end - middle;
+        wire += loopback.written;
+    }
+    TEST_CHECK(loopback.received == frames * size);
+
+    char label[64];
+    snprintf(label, sizeof(label), "encode %s", name);
+    test_report(label, frames, encoding);
+    snprintf(label, sizeof(label), "decode %s", name);
+    test_report(label, frames, decoding);
+
+    double efficiency = (double)(frames * size) / (double)wire;
+    printf("%-40s %10.1f %% payload\n", "", 100.0 * efficiency);
+    printf("%-40s %10.1f MB/s\n",
+           "",
+           (double)(frames * size) * 1000.0 / (double)(encoding + decoding));
+    for (uint32_t baud = 115200U; baud <= 4000000U; baud *= 4U) {
+        printf("%-40s %10.1f kB/s at %u baud\n",
+               "",
+               (double)baud / 10.0 * efficiency / 1000.0,
+               (unsigned)baud);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t frames = test_get_iterations(argc, argv, FRAMES);
+
+    run("16 bytes", 16U, true, frames);
+    run("64 bytes", 64U, true, frames);
+    run("294 bytes", 294U, true, frames / 4U);
+    run("294 bytes without zeros", 294U, false, frames / 4U);
+
+    return test_finish();
+}
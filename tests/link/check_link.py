@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+
+import argparse
+import pathlib
+import random
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, str(pathlib.Path(__file__).resolve().parents[2] / "scripts"))
+
+import link  # noqa: E402
+
+
+# Frames encoded by scripts/link.py go through test_link, which decodes them
+# with components/link and sends each back, the echo has to decode to the same
+# frames on the host
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("test")
+    arguments = parser.parse_args()
+
+    generator = random.Random(0)
+    frames = [(link.CHANNEL_USER, b""), (link.CHANNEL_TEXT, b"\0" * 251)]
+    frames.append((link.CHANNEL_MIRROR, b"\x01" * 254))
+    for _ in range(500):
+        size = generator.randrange(252)
+        payload = bytes(
+            generator.choice((0, generator.randrange(256))) for _ in range(size)
+        )
+        frames.append((generator.randrange(1, 256), payload))
+
+    with tempfile.TemporaryDirectory() as directory:
+        input_path = pathlib.Path(directory) / "input.bin"
+        output_path = pathlib.Path(directory) / "output.bin"
+        input_path.write_bytes(
+            b"".join(link.encode_frame(channel, payload) for channel, payload in frames)
+        )
+
+        result = subprocess.run([arguments.test, input_path, output_path])
+        if result.returncode != 0:
+            return result.returncode
+
+        decoder = link.FrameDecoder()
+        echoed = decoder.feed(output_path.read_bytes())
+
+    if decoder.dropped > 0 or echoed != frames:
+        print(f"{len(echoed)} of {len(frames)} frames echoed, {decoder.dropped} dropped")
+        return 1
+
+    print(f"{len(echoed)} frames echoed")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,359 @@
+#include "link.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BUFFER_SIZE (300U)
+#define WIRE_SIZE (1U << 16U)
+#define TRIALS (2000U)
+
+// One direction of the serial line, the receiver reads it in short DMA
+// sized bites
+typedef struct {
+    uint8_t data[WIRE_SIZE];
+    size_t written;
+    size_t read;
+    size_t bite;
+} wire_t;
+
+typedef struct {
+    link_t link;
+    uint8_t tx_buffer[BUFFER_SIZE];
+    uint8_t rx_buffer[BUFFER_SIZE];
+    wire_t* tx;
+    wire_t* rx;
+    uint32_t baud;
+    bool refuse_baud;
+    // sends every frame back as it arrives
+    bool echo;
+
+    uint8_t channel;
+    uint8_t payload[BUFFER_SIZE];
+    size_t payload_size;
+    size_t frames;
+} endpoint_t;
+
+static size_t endpoint_write(void* user, uint8_t const* data, size_t size)
+{
+    wire_t* wire = ((endpoint_t*)user)->tx;
+
+    if (size > WIRE_SIZE - wire->written) {
+        return 0U;
+    }
+    memcpy(&wire->data[wire->written], data, size);
+    wire->written += size;
+
+    return size;
+}
+
+static size_t endpoint_read(void* user, uint8_t* data, size_t size)
+{
+    wire_t* wire = ((endpoint_t*)user)->rx;
+    size_t available = wire->written - wire->read;
+
+    if (size > available) {
+        size = available;
+    }
+    if (wire->bite > 0U && size > wire->bite) {
+        size = wire->bite;
+    }
+    memcpy(data, &wire->data[wire->read], size);
+    wire->read += size;
+
+    return size;
+}
+
+static link_err_t endpoint_set_baud(void* user, uint32_t baud)
+{
+    endpoint_t* endpoint = (endpoint_t*)user;
+
+    if (endpoint->refuse_baud) {
+        return LINK_ERR_FAIL;
+    }
+    endpoint->baud = baud;
+
+    return LINK_ERR_OK;
+}
+
+static void endpoint_receive(void* user,
+                             uint8_t channel,
+                             uint8_t const* payload,
+                             size_t size)
+{
+    endpoint_t* endpoint = (endpoint_t*)user;
+
+    endpoint->channel = channel;
+    memcpy(endpoint->payload, payload, size);
+    endpoint->payload_size = size;
+    ++endpoint->frames;
+
+    if (endpoint->echo) {
+        TEST_CHECK(link_send(&endpoint->link, channel, payload, size) ==
+                   LINK_ERR_OK);
+    }
+}
+
+static void endpoint_initialize(endpoint_t* endpoint, wire_t* tx, wire_t* rx)
+{
+    memset(endpoint, 0, sizeof(*endpoint));
+    endpoint->tx = tx;
+    endpoint->rx = rx;
+    endpoint->baud = 115200U;
+
+    link_initialize(&endpoint->link,
+                    &(link_config_t){.tx_buffer = endpoint->tx_buffer,
+                                     .tx_buffer_size = BUFFER_SIZE,
+                                     .rx_buffer = endpoint->rx_buffer,
+                                     .rx_buffer_size = BUFFER_SIZE,
+                                     .baud = 115200U,
+                                     .max_baud = 4000000U},
+                    &(link_interface_t){.transport_user = endpoint,
+                                        .transport_write = endpoint_write,
+                                        .transport_read = endpoint_read,
+                                        .transport_set_baud =
+                                            endpoint_set_baud,
+                                        .receive_user = endpoint,
+                                        .receive = endpoint_receive});
+}
+
+static void wire_reset(wire_t* wire)
+{
+    wire->written = 0U;
+    wire->read = 0U;
+}
+
+// Payloads with runs of zeros, no zeros at all and COBS block boundaries
+static size_t make_payload(uint8_t* payload, size_t trial, size_t max_size)
+{
+    size_t size = test_random() % (max_size + 1U);
+
+    for (size_t index = 0U; index < size; ++index) {
+        switch (trial % 4U) {
+            case 0U: {
+                payload[index] = 0U;
+                break;
+            }
+            case 1U: {
+                payload[index] = (uint8_t)(1U + test_random() % 255U);
+                break;
+            }
+            default: {
+                payload[index] = test_random() % 3U == 0U
+                                     ? 0U
+                                     : (uint8_t)test_random();
+                break;
+            }
+        }
+    }
+
+    return size;
+}
+
+static void test_framing(void)
+{
+    static wire_t wire;
+    static endpoint_t host;
+    static endpoint_t device;
+    uint8_t payload[BUFFER_SIZE];
+
+    endpoint_initialize(&host, &wire, &wire);
+    endpoint_initialize(&device, &wire, &wire);
+    wire.bite = 7U;
+
+    size_t max_payload = link_get_max_payload(&host.link);
+
+    for (size_t trial = 0U; trial < TRIALS; ++trial) {
+        size_t size = make_payload(payload, trial, max_payload);
+        uint8_t channel = (uint8_t)(LINK_CHANNEL_TEXT + trial % 30U);
+
+        // the delimiter only ever ends a frame
+        wire_reset(&wire);
+        TEST_CHECK(link_send(&host.link, channel, payload, size) ==
+                   LINK_ERR_OK);
+        TEST_CHECK(memchr(wire.data, LINK_FRAME_DELIMITER, wire.written) ==
+                   &wire.data[wire.written - 1U]);
+
+        device.frames = 0U;
+        link_process(&device.link, 0U);
+        if (!TEST_CHECK(device.frames == 1U && device.channel == channel &&
+                        device.payload_size == size &&
+                        memcmp(device.payload, payload, size) == 0)) {
+            fprintf(stderr, "  trial %zu, %zu bytes\n", trial, size);
+            return;
+        }
+
+        // any single corrupted byte is caught, by the CRC or by COBS
+        size_t dropped = link_get_rx_dropped(&device.link);
+        size_t offset = test_random() % (wire.written - 1U);
+        uint8_t original = wire.data[offset];
+        wire.data[offset] ^= (uint8_t)(1U + test_random() % 255U);
+        if (wire.data[offset] == LINK_FRAME_DELIMITER) {
+            wire.data[offset] = original == 0x55U ? 0xAAU : 0x55U;
+        }
+        wire.read = 0U;
+        device.frames = 0U;
+        link_process(&device.link, 0U);
+        TEST_CHECK(device.frames == 0U);
+        TEST_CHECK(link_get_rx_dropped(&device.link) == dropped + 1U);
+    }
+
+    // the largest payload without zeros needs every code byte and still fits
+    // the buffers, one more byte is refused
+    wire_reset(&wire);
+    memset(payload, 0x11, sizeof(payload));
+    TEST_CHECK(link_send(&host.link, 1U, payload, max_payload) == LINK_ERR_OK);
+    TEST_CHECK(wire.written <= BUFFER_SIZE);
+    device.frames = 0U;
+    link_process(&device.link, 0U);
+    TEST_CHECK(device.frames == 1U && device.payload_size == max_payload);
+    TEST_CHECK(link_send(&host.link, 1U, payload, max_payload + 1U) ==
+               LINK_ERR_FAIL);
+
+    // a run longer than the receive buffer is dropped, the next frame after
+    // the delimiter arrives
+    wire_reset(&wire);
+    memset(wire.data, 0x05, 2U * BUFFER_SIZE);
+    wire.written = 2U * BUFFER_SIZE;
+    wire.data[wire.written++] = LINK_FRAME_DELIMITER;
+    TEST_CHECK(link_send(&host.link, 3U, (uint8_t const*)"hi", 2U) ==
+               LINK_ERR_OK);
+    size_t dropped = link_get_rx_dropped(&device.link);
+    device.frames = 0U;
+    link_process(&device.link, 0U);
+    TEST_CHECK(device.frames == 1U && device.payload_size == 2U);
+    TEST_CHECK(link_get_rx_dropped(&device.link) == dropped + 1U);
+}
+
+static void send_control(endpoint_t* host, uint8_t control, uint32_t value)
+{
+    uint8_t payload[5] = {control,
+                          (uint8_t)value,
+                          (uint8_t)(value >> 8U),
+                          (uint8_t)(value >> 16U),
+                          (uint8_t)(value >> 24U)};
+
+    TEST_CHECK(link_send(&host->link,
+                         LINK_CHANNEL_CONTROL,
+                         payload,
+                         sizeof(payload)) == LINK_ERR_OK);
+}
+
+// The control frame the device answered with, which the host link keeps to
+// itself, so the reply is read straight off the wire
+static bool is_reply(wire_t* wire, uint8_t control, uint32_t value)
+{
+    uint8_t const expected[] = {LINK_CHANNEL_CONTROL,
+                                control,
+                                (uint8_t)value,
+                                (uint8_t)(value >> 8U),
+                                (uint8_t)(value >> 16U),
+                                (uint8_t)(value >> 24U)};
+    static endpoint_t encoder;
+    static wire_t encoded;
+
+    // encoded the way the device did, the bytes on the wire have to match
+    endpoint_initialize(&encoder, &encoded, &encoded);
+    wire_reset(&encoded);
+    link_send(
+        &encoder.link, expected[0], &expected[1], sizeof(expected) - 1U);
+
+    bool matches =
+        wire->written - wire->read == encoded.written &&
+        memcmp(&wire->data[wire->read], encoded.data, encoded.written) == 0;
+    wire->read = wire->written;
+
+    return matches;
+}
+
+static void test_baud_negotiation(void)
+{
+    static wire_t to_device;
+    static wire_t to_host;
+    static endpoint_t host;
+    static endpoint_t device;
+
+    endpoint_initialize(&host, &to_device, &to_host);
+    endpoint_initialize(&device, &to_host, &to_device);
+
+    // acknowledged at the old rate, then switched, and falls back when no
+    // ping confirms it in time
+    send_control(&host, LINK_CONTROL_SET_BAUD, 921600U);
+    link_process(&device.link, 100U);
+    TEST_CHECK(is_reply(&to_host, LINK_CONTROL_BAUD_ACK, 921600U));
+    TEST_CHECK(device.baud == 921600U);
+    TEST_CHECK(link_get_baud(&device.link) == 921600U);
+    link_process(&device.link, 100U + LINK_BAUD_CONFIRM_TIMEOUT - 1U);
+    TEST_CHECK(link_get_baud(&device.link) == 921600U);
+    link_process(&device.link, 100U + LINK_BAUD_CONFIRM_TIMEOUT);
+    TEST_CHECK(link_get_baud(&device.link) == 115200U);
+    TEST_CHECK(device.baud == 115200U);
+
+    // a ping in time keeps the new rate
+    send_control(&host, LINK_CONTROL_SET_BAUD, 2000000U);
+    link_process(&device.link, 1000U);
+    TEST_CHECK(is_reply(&to_host, LINK_CONTROL_BAUD_ACK, 2000000U));
+    send_control(&host, LINK_CONTROL_PING, 0U);
+    link_process(&device.link, 1001U);
+    TEST_CHECK(is_reply(&to_host, LINK_CONTROL_PONG, 2000000U));
+    link_process(&device.link, 5000U);
+    TEST_CHECK(link_get_baud(&device.link) == 2000000U);
+
+    // rates out of range are refused and change nothing
+    send_control(&host, LINK_CONTROL_SET_BAUD, 8000000U);
+    link_process(&device.link, 6000U);
+    TEST_CHECK(is_reply(&to_host, LINK_CONTROL_BAUD_NAK, 8000000U));
+    send_control(&host, LINK_CONTROL_SET_BAUD, LINK_MIN_BAUD - 1U);
+    link_process(&device.link, 6001U);
+    TEST_CHECK(is_reply(&to_host, LINK_CONTROL_BAUD_NAK, LINK_MIN_BAUD - 1U));
+    TEST_CHECK(link_get_baud(&device.link) == 2000000U);
+
+    // a transport that cannot switch keeps the old rate without a fallback
+    device.refuse_baud = true;
+    send_control(&host, LINK_CONTROL_SET_BAUD, 115200U);
+    link_process(&device.link, 7000U);
+    TEST_CHECK(is_reply(&to_host, LINK_CONTROL_BAUD_ACK, 115200U));
+    link_process(&device.link, 9000U);
+    TEST_CHECK(link_get_baud(&device.link) == 2000000U);
+    TEST_CHECK(device.baud == 2000000U);
+}
+
+// Decodes the frames scripts/link.py encoded and sends each back, for
+// check_link.py to compare both directions against its own framing
+static void echo(char const* input_path, char const* output_path)
+{
+    static wire_t input;
+    static wire_t output;
+    static endpoint_t device;
+
+    FILE* file = fopen(input_path, "rb");
+    if (!TEST_CHECK(file != NULL)) {
+        return;
+    }
+    input.written = fread(input.data, 1U, WIRE_SIZE, file);
+    fclose(file);
+
+    endpoint_initialize(&device, &output, &input);
+    device.echo = true;
+    input.bite = 61U;
+    link_process(&device.link, 0U);
+    TEST_CHECK(link_get_rx_dropped(&device.link) == 0U);
+
+    file = fopen(output_path, "wb");
+    if (!TEST_CHECK(file != NULL)) {
+        return;
+    }
+    fwrite(output.data, 1U, output.written, file);
+    fclose(file);
+}
+
+int main(int argc, char** argv)
+{
+    test_framing();
+    test_baud_negotiation();
+
+    if (argc == 3) {
+        echo(argv[1], argv[2]);
+    }
+
+    return test_finish();
+}
@@ -0,0 +1,128 @@
+#include "gfx_text.h"
+#include "mirror.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FRAMES (100000U)
+#define BUFFER_SIZE (505U)
+
+typedef struct {
+    mirror_t mirror;
+    uint8_t buffer[BUFFER_SIZE];
+    size_t bytes;
+} bench_t;
+
+static gfx_err_t bench_flush_span(void* user,
+                                  size_t page,
+                                  size_t column,
+                                  uint8_t const* data,
+                                  size_t size)
+{
+    mirror_span(&((bench_t*)user)->mirror, page, column, data, size);
+
+    return GFX_ERR_OK;
+}
+
+static void bench_sink_write(void* user, uint8_t const* data, size_t size)
+{
+    (void)data;
+
+    ((bench_t*)user)->bytes += size;
+}
+
+typedef enum {
+    CHANGE_PIXEL,
+    CHANGE_TEXT,
+    CHANGE_QUARTER,
+    CHANGE_SCREEN,
+} change_t;
+
+static void draw(gfx_t* gfx, uint8_t* frame, change_t change, size_t index)
+{
+    switch (change) {
+        case CHANGE_PIXEL: {
+            gfx_set_pixel(gfx, 64, 64, index % 2U == 0U);
+            break;
+        }
+        case CHANGE_TEXT: {
+            char text[32];
+            snprintf(text, sizeof(text), "uptime %8zu s", index);
+            gfx_draw_text(gfx, 0, 0, text, sizeof(text), GFX_ROP_COPY);
+            break;
+        }
+        case CHANGE_QUARTER: {
+            for (size_t page = 0U; page < 8U; ++page) {
+                for (size_t column = 0U; column < 64U; ++column) {
+                    frame[page * TEST_GFX_WIDTH + column] =
+                        (uint8_t)test_random();
+                }
+            }
+            gfx_mark_dirty(gfx, 0, 0, 64, 64);
+            break;
+        }
+        default: {
+            for (size_t offset = 0U; offset < TEST_GFX_FRAME_SIZE; ++offset) {
+                frame[offset] = (uint8_t)test_random();
+            }
+            gfx_mark_dirty(gfx, 0, 0, TEST_GFX_WIDTH, TEST_GFX_HEIGHT);
+            break;
+        }
+    }
+}
+
+// Mirror cost and record bytes per frame for changes of growing size, the
+// bytes have to follow the change and not the frame size
+static void run(char const* name, change_t change, size_t frames)
+{
+    static bench_t bench;
+    static uint8_t frame[TEST_GFX_FRAME_SIZE];
+    gfx_t gfx;
+
+    memset(&bench, 0, sizeof(bench));
+    mirror_initialize(&bench.mirror,
+                      &(mirror_config_t){.buffer = bench.buffer,
+                                         .buffer_size = BUFFER_SIZE,
+                                         .frame_width = TEST_GFX_WIDTH,
+                                         .frame_height = TEST_GFX_HEIGHT},
+                      &(mirror_interface_t){.sink_user = &bench,
+                                            .sink_write = bench_sink_write});
+    test_gfx_initialize(&gfx,
+                        frame,
+                        TEST_GFX_WIDTH,
+                        TEST_GFX_HEIGHT,
+                        &(gfx_interface_t){.panel_user = &bench,
+                                           .flush_span = bench_flush_span});
+    gfx_flush(&gfx);
+    mirror_frame(&bench.mirror);
+    bench.bytes = 0U;
+
+    uint64_t mirroring = 0U;
+
+    for (size_t index = 0U; index < frames; ++index) {
+        draw(&gfx, frame, change, index);
+
+        uint64_t begin = test_get_time();
+        gfx_flush(&gfx);
+        mirror_frame(&bench.mirror);
+        mirroring += test_get_time() - begin;
+    }
+
+    test_report(name, frames, mirroring);
+    printf("%-40s %10.1f bytes\n",
+           "",
+           (double)bench.bytes / (double)frames);
+}
+
+int main(int argc, char** argv)
+{
+    size_t frames = test_get_iterations(argc, argv, FRAMES);
+
+    run("one pixel", CHANGE_PIXEL, frames);
+    run("status line", CHANGE_TEXT, frames);
+    run("quarter screen", CHANGE_QUARTER, frames / 10U);
+    run("whole screen", CHANGE_SCREEN, frames / 10U);
+
+    return test_finish();
+}
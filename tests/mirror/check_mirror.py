@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+
+import argparse
+import pathlib
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, str(pathlib.Path(__file__).resolve().parents[2] / "scripts"))
+
+import link  # noqa: E402
+import mirror_viewer  # noqa: E402
+
+WIDTH = 128
+HEIGHT = 128
+
+
+# Rebuilds every frame test_mirror recorded with scripts/mirror_viewer.py, the
+# PBM it writes has to show what the emulated panel showed
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("test")
+    arguments = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        stream_path = pathlib.Path(directory) / "stream.bin"
+        screens_path = pathlib.Path(directory) / "screens.bin"
+
+        result = subprocess.run([arguments.test, stream_path, screens_path])
+        if result.returncode != 0:
+            return result.returncode
+
+        stream = stream_path.read_bytes()
+        screens = screens_path.read_bytes()
+
+    screen_size = WIDTH * HEIGHT // 8
+    header = f"P4\n{WIDTH} {HEIGHT}\n".encode()
+    decoder = link.FrameDecoder()
+    mirror = mirror_viewer.Mirror(WIDTH, HEIGHT)
+    frames = 0
+
+    # fed in pieces that split link frames anywhere
+    for offset in range(0, len(stream), 37):
+        for channel, payload in decoder.feed(stream[offset : offset + 37]):
+            if channel != link.CHANNEL_MIRROR:
+                continue
+            for _ in mirror.feed(payload):
+                expected = screens[frames * screen_size : (frames + 1) * screen_size]
+                if mirror.pbm() != header + expected:
+                    print(f"frame {frames} differs from the panel")
+                    return 1
+                frames += 1
+
+    if decoder.dropped > 0 or frames * screen_size != len(screens):
+        print(f"{frames} frames rebuilt, {decoder.dropped} link frames dropped")
+        return 1
+
+    print(f"{frames} frames rebuilt from {len(stream)} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,252 @@
+#include "gfx_text.h"
+#include "link.h"
+#include "mirror.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FRAMES (400U)
+// as main.c sizes the link, the recording uses a smaller one that splits
+// spans across link frames
+#define LINK_BUFFER_SIZE (512U)
+#define RECORD_LINK_BUFFER_SIZE (96U)
+
+// The panel as main.c drives it in link mode, every flushed span and start
+// line is also handed to the mirror, which sends over the link
+typedef struct {
+    test_panel_t panel;
+    gfx_interface_t panel_interface;
+    mirror_t mirror;
+    uint8_t mirror_buffer[LINK_BUFFER_SIZE];
+    link_t link;
+    uint8_t tx_buffer[LINK_BUFFER_SIZE];
+    uint8_t rx_buffer[LINK_BUFFER_SIZE];
+    FILE* stream;
+    size_t bytes;
+    size_t frames;
+} fixture_t;
+
+static gfx_err_t fixture_flush_span(void* user,
+                                    size_t page,
+                                    size_t column,
+                                    uint8_t const* data,
+                                    size_t size)
+{
+    fixture_t* fixture = (fixture_t*)user;
+
+    mirror_span(&fixture->mirror, page, column, data, size);
+
+    return fixture->panel_interface.flush_span(
+        &fixture->panel, page, column, data, size);
+}
+
+static gfx_err_t fixture_set_start_line(void* user, size_t line)
+{
+    fixture_t* fixture = (fixture_t*)user;
+
+    mirror_start_line(&fixture->mirror, line);
+
+    return fixture->panel_interface.set_start_line(&fixture->panel, line);
+}
+
+static void fixture_mirror_write(void* user, uint8_t const* data, size_t size)
+{
+    fixture_t* fixture = (fixture_t*)user;
+
+    TEST_CHECK(link_send(&fixture->link, LINK_CHANNEL_MIRROR, data, size) ==
+               LINK_ERR_OK);
+}
+
+static size_t fixture_transport_write(void* user,
+                                      uint8_t const* data,
+                                      size_t size)
+{
+    fixture_t* fixture = (fixture_t*)user;
+
+    if (fixture->stream) {
+        fwrite(data, 1U, size, fixture->stream);
+    }
+    fixture->bytes += size;
+
+    return size;
+}
+
+static void fixture_initialize(fixture_t* fixture,
+                               size_t link_buffer_size,
+                               gfx_t* gfx,
+                               uint8_t* frame)
+{
+    memset(fixture, 0, sizeof(*fixture));
+    test_panel_initialize(&fixture->panel);
+    fixture->panel_interface = test_panel_get_interface(&fixture->panel);
+
+    link_initialize(
+        &fixture->link,
+        &(link_config_t){.tx_buffer = fixture->tx_buffer,
+                         .tx_buffer_size = link_buffer_size,
+                         .rx_buffer = fixture->rx_buffer,
+                         .rx_buffer_size = link_buffer_size,
+                         .baud = 115200U,
+                         .max_baud = 115200U},
+        &(link_interface_t){.transport_user = fixture,
+                            .transport_write = fixture_transport_write});
+    mirror_initialize(
+        &fixture->mirror,
+        &(mirror_config_t){.buffer = fixture->mirror_buffer,
+                           .buffer_size = link_get_max_payload(&fixture->link),
+                           .frame_width = TEST_PANEL_WIDTH,
+                           .frame_height = TEST_PANEL_HEIGHT},
+        &(mirror_interface_t){.sink_user = fixture,
+                              .sink_write = fixture_mirror_write});
+    test_gfx_initialize(gfx,
+                        frame,
+                        TEST_GFX_WIDTH,
+                        TEST_GFX_HEIGHT,
+                        &(gfx_interface_t){
+                            .panel_user = fixture,
+                            .flush_span = fixture_flush_span,
+                            .set_start_line = fixture_set_start_line,
+                        });
+}
+
+// Flushes and ends the frame, returns the link bytes it took
+static size_t end_frame(fixture_t* fixture, gfx_t* gfx)
+{
+    size_t bytes = fixture->bytes;
+
+    TEST_CHECK(gfx_flush(gfx) == GFX_ERR_OK);
+    if (fixture->mirror.changed) {
+        ++fixture->frames;
+    }
+    mirror_frame(&fixture->mirror);
+
+    return fixture->bytes - bytes;
+}
+
+// The screen as PBM rows, the way mirror_viewer.py has to write it
+static void write_screen(test_panel_t const* panel, FILE* file)
+{
+    for (size_t y = 0U; y < TEST_PANEL_HEIGHT; ++y) {
+        for (size_t x = 0U; x < TEST_PANEL_WIDTH; x += 8U) {
+            uint8_t byte = 0U;
+            for (size_t bit = 0U; bit < 8U; ++bit) {
+                byte = (uint8_t)(byte << 1U |
+                                 test_panel_get_pixel(panel, x + bit, y));
+            }
+            fputc(byte, file);
+        }
+    }
+}
+
+// Frames cost what changed in them, and nothing when nothing did
+static void test_bandwidth(void)
+{
+    static fixture_t fixture;
+    static uint8_t frame[TEST_GFX_FRAME_SIZE];
+    gfx_t gfx;
+
+    fixture_initialize(&fixture, LINK_BUFFER_SIZE, &gfx, frame);
+
+    // the cleared frame first, then nothing
+    TEST_CHECK(end_frame(&fixture, &gfx) > 0U);
+    TEST_CHECK(end_frame(&fixture, &gfx) == 0U);
+
+    // one byte span, its record and the frame record in one link frame
+    gfx_set_pixel(&gfx, 10, 20, true);
+    size_t pixel = end_frame(&fixture, &gfx);
+    TEST_CHECK(pixel == 1U + 1U + 6U + 2U + 5U + LINK_CRC_SIZE + 1U);
+
+    gfx_draw_string(&gfx, 0, 40, "Temperature 23.5 C", GFX_ROP_SET);
+    size_t line = end_frame(&fixture, &gfx);
+    TEST_CHECK(line > pixel && line < 2U * 6U * 18U);
+
+    // a uniform screen compresses to runs
+    memset(frame, 0xFF, sizeof(frame));
+    gfx_mark_dirty(&gfx, 0, 0, TEST_GFX_WIDTH, TEST_GFX_HEIGHT);
+    size_t full = end_frame(&fixture, &gfx);
+    TEST_CHECK(full < TEST_GFX_FRAME_SIZE / 8U);
+
+    TEST_CHECK(end_frame(&fixture, &gfx) == 0U);
+    TEST_CHECK(fixture.frames == 4U);
+}
+
+// Random drawing, scrolling and clearing, for check_mirror.py to rebuild
+// with scripts/mirror_viewer.py from the recorded link stream
+static void record(char const* stream_path, char const* screens_path)
+{
+    static fixture_t fixture;
+    static uint8_t frame[TEST_GFX_FRAME_SIZE];
+    gfx_t gfx;
+
+    fixture_initialize(&fixture, RECORD_LINK_BUFFER_SIZE, &gfx, frame);
+    fixture.stream = fopen(stream_path, "wb");
+    FILE* screens = fopen(screens_path, "wb");
+    if (!TEST_CHECK(fixture.stream && screens)) {
+        return;
+    }
+
+    for (size_t index = 0U; index < FRAMES; ++index) {
+        int16_t x = (int16_t)(test_random() % 150U) - 10;
+        int16_t y = (int16_t)(test_random() % 150U) - 10;
+
+        switch (test_random() % 5U) {
+            case 0U: {
+                size_t count = test_random() % 40U;
+                for (size_t pixel = 0U; pixel < count; ++pixel) {
+                    gfx_set_pixel(
+                        &gfx, (int16_t)(x + (int16_t)pixel), y, true);
+                }
+                break;
+            }
+            case 1U: {
+                uint8_t columns[200];
+                size_t count = test_random() % sizeof(columns);
+                for (size_t column = 0U; column < count; ++column) {
+                    columns[column] = test_random() % 4U != 0U
+                                          ? 0xFFU
+                                          : (uint8_t)test_random();
+                }
+                gfx_draw_columns(&gfx, x, y, columns, count, GFX_ROP_XOR);
+                break;
+            }
+            case 2U: {
+                gfx_draw_string(&gfx, x, y, "mirror", GFX_ROP_SET);
+                break;
+            }
+            case 3U: {
+                TEST_CHECK(gfx_set_start_line(
+                               &gfx, test_random() % TEST_GFX_HEIGHT) ==
+                           GFX_ERR_OK);
+                break;
+            }
+            default: {
+                if (index % 50U == 0U) {
+                    gfx_clear(&gfx);
+                }
+                break;
+            }
+        }
+
+        size_t frames = fixture.frames;
+        end_frame(&fixture, &gfx);
+        if (fixture.frames != frames) {
+            write_screen(&fixture.panel, screens);
+        }
+    }
+
+    fclose(fixture.stream);
+    fclose(screens);
+}
+
+int main(int argc, char** argv)
+{
+    test_bandwidth();
+
+    if (TEST_CHECK(argc == 3)) {
+        record(argv[1], argv[2]);
+    }
+
+    return test_finish();
+}
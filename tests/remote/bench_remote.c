@@ -0,0 +1,126 @@
+#include "remote.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BATCHES (20000U)
+#define PAYLOAD_SIZE (480U)
+
+typedef enum {
+    WORKLOAD_PIXELS,
+    WORKLOAD_LABELS,
+    WORKLOAD_FILLS,
+} workload_t;
+
+static size_t put_16(uint8_t* data, int32_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)((uint32_t)value >> 8U);
+
+    return 2U;
+}
+
+// One link frame worth of commands ending in a flush, as
+// scripts/remote_draw.py packs them
+static size_t make_payload(uint8_t* payload, workload_t workload, size_t* count)
+{
+    size_t size = 0U;
+    *count = 0U;
+
+    for (;;) {
+        uint8_t command[32];
+        size_t command_size = 0U;
+        int32_t x = (int32_t)(test_random() % 128U);
+        int32_t y = (int32_t)(test_random() % 128U);
+
+        switch (workload) {
+            case WORKLOAD_PIXELS: {
+                command[command_size++] = REMOTE_COMMAND_PIXEL;
+                command_size += put_16(&command[command_size], x);
+                command_size += put_16(&command[command_size], y);
+                command[command_size++] = 1U;
+                break;
+            }
+            case WORKLOAD_LABELS: {
+                command[command_size++] = REMOTE_COMMAND_TEXT;
+                command_size += put_16(&command[command_size], x);
+                command_size += put_16(&command[command_size], y);
+                command[command_size++] = 10U;
+                memcpy(&command[command_size], "Temp 23.5C", 10U);
+                command_size += 10U;
+                break;
+            }
+            default: {
+                command[command_size++] = REMOTE_COMMAND_FILL;
+                command_size += put_16(&command[command_size], x);
+                command_size += put_16(&command[command_size], y);
+                command_size += put_16(&command[command_size], 24);
+                command_size += put_16(&command[command_size], 12);
+                command[command_size++] = (uint8_t)(test_random() % 2U);
+                break;
+            }
+        }
+
+        if (size + command_size + 2U > PAYLOAD_SIZE) {
+            break;
+        }
+        memcpy(&payload[size], command, command_size);
+        size += command_size;
+        ++*count;
+    }
+
+    payload[size++] = REMOTE_COMMAND_FLUSH;
+    payload[size++] = 0U;
+    ++*count;
+
+    return size;
+}
+
+// Commands per second executed from received frames, the panel transfer of
+// every flush included
+static void run(char const* name, workload_t workload, size_t batches)
+{
+    static uint8_t frame[TEST_GFX_FRAME_SIZE];
+    static uint8_t payload[PAYLOAD_SIZE];
+    test_panel_t panel;
+    remote_t remote;
+    gfx_t gfx;
+    size_t count;
+
+    test_panel_initialize(&panel);
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    test_gfx_initialize(
+        &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    remote_initialize(
+        &remote, &(remote_config_t){.gfx = &gfx}, &(remote_interface_t){0});
+    size_t size = make_payload(payload, workload, &count);
+
+    uint64_t begin = test_get_time();
+    for (size_t batch = 0U; batch < batches; ++batch) {
+        remote_execute(&remote, payload, size);
+    }
+    uint64_t elapsed = test_get_time() - begin;
+
+    TEST_CHECK(remote_get_executed(&remote) == batches * count);
+    TEST_CHECK(remote_get_errors(&remote) == 0U);
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s, %zu per flush", name, count);
+    test_report(label, batches * count, elapsed);
+    printf("%-40s %10.0f commands/s\n",
+           "",
+           (double)(batches * count) * 1e9 / (double)elapsed);
+}
+
+int main(int argc, char** argv)
+{
+    size_t batches = test_get_iterations(argc, argv, BATCHES);
+
+    run("pixels", WORKLOAD_PIXELS, batches);
+    run("labels", WORKLOAD_LABELS, batches);
+    run("fills", WORKLOAD_FILLS, batches);
+
+    return test_finish();
+}
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+
+import argparse
+import pathlib
+import random
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, str(pathlib.Path(__file__).resolve().parents[2] / "scripts"))
+
+import link  # noqa: E402
+import remote_draw  # noqa: E402
+
+
+# Random commands encoded by scripts/remote_draw.py are executed by test_remote
+# as the board would, every flush has to be answered with the count of
+# commands the reference parser sees up to it
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("test")
+    arguments = parser.parse_args()
+
+    commands = remote_draw.random_commands(random.Random(0), 3000).flush(0)
+    payloads = commands.take()
+
+    expected = []
+    executed = 0
+    for payload in payloads:
+        for command in remote_draw.parse(payload):
+            executed += 1
+            if command[0] == remote_draw.FLUSH:
+                expected.append((command[1], executed))
+
+    with tempfile.TemporaryDirectory() as directory:
+        input_path = pathlib.Path(directory) / "input.bin"
+        output_path = pathlib.Path(directory) / "output.bin"
+        input_path.write_bytes(
+            b"".join(link.encode_frame(link.CHANNEL_DRAW, payload) for payload in payloads)
+        )
+
+        result = subprocess.run([arguments.test, input_path, output_path])
+        if result.returncode != 0:
+            return result.returncode
+
+        decoder = link.FrameDecoder()
+        frames = decoder.feed(output_path.read_bytes())
+
+    replies = [
+        (payload[1], int.from_bytes(payload[2:6], "little"))
+        for channel, payload in frames
+        if channel == link.CHANNEL_DRAW and payload[0] == remote_draw.FLUSH
+    ]
+    if replies != expected:
+        print(f"{len(replies)} replies, expected {len(expected)}")
+        for index, (reply, want) in enumerate(zip(replies, expected)):
+            if reply != want:
+                print(f"reply {index} is {reply}, expected {want}")
+                break
+        return 1
+
+    print(f"{commands.count} commands in {len(payloads)} frames, {len(replies)} flushes answered")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,354 @@
+#include "gfx_draw.h"
+#include "gfx_text.h"
+#include "link.h"
+#include "remote.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BATCH_SIZE (512U)
+#define LINK_BUFFER_SIZE (512U)
+#define WIRE_SIZE (1U << 20U)
+
+// Commands as scripts/remote_draw.py encodes them
+typedef struct {
+    uint8_t data[BATCH_SIZE];
+    size_t size;
+    size_t count;
+    // offset of every command, and of the end
+    size_t offsets[BATCH_SIZE + 1U];
+} batch_t;
+
+static void batch_put(batch_t* batch, uint8_t byte)
+{
+    batch->data[batch->size++] = byte;
+}
+
+static void batch_put_16(batch_t* batch, int32_t value)
+{
+    batch_put(batch, (uint8_t)value);
+    batch_put(batch, (uint8_t)((uint32_t)value >> 8U));
+}
+
+static void batch_begin(batch_t* batch, uint8_t opcode, int16_t x, int16_t y)
+{
+    batch->offsets[batch->count++] = batch->size;
+    batch_put(batch, opcode);
+    if (opcode != REMOTE_COMMAND_CLEAR && opcode != REMOTE_COMMAND_FLUSH) {
+        batch_put_16(batch, x);
+        batch_put_16(batch, y);
+    }
+}
+
+static void batch_end(batch_t* batch)
+{
+    batch->offsets[batch->count] = batch->size;
+}
+
+static void batch_fill(batch_t* batch,
+                       int16_t x,
+                       int16_t y,
+                       int16_t width,
+                       int16_t height,
+                       bool state)
+{
+    batch_begin(batch, REMOTE_COMMAND_FILL, x, y);
+    batch_put_16(batch, width);
+    batch_put_16(batch, height);
+    batch_put(batch, state);
+    batch_end(batch);
+}
+
+static void batch_pixel(batch_t* batch, int16_t x, int16_t y, bool state)
+{
+    batch_begin(batch, REMOTE_COMMAND_PIXEL, x, y);
+    batch_put(batch, state);
+    batch_end(batch);
+}
+
+static void batch_text(batch_t* batch, int16_t x, int16_t y, char const* text)
+{
+    size_t length = strlen(text);
+
+    batch_begin(batch, REMOTE_COMMAND_TEXT, x, y);
+    batch_put(batch, (uint8_t)length);
+    memcpy(&batch->data[batch->size], text, length);
+    batch->size += length;
+    batch_end(batch);
+}
+
+static void batch_bitmap(batch_t* batch,
+                         int16_t x,
+                         int16_t y,
+                         uint8_t const* columns,
+                         size_t width,
+                         size_t pages)
+{
+    batch_begin(batch, REMOTE_COMMAND_BITMAP, x, y);
+    batch_put_16(batch, (int32_t)width);
+    batch_put(batch, (uint8_t)pages);
+    memcpy(&batch->data[batch->size], columns, width * pages);
+    batch->size += width * pages;
+    batch_end(batch);
+}
+
+static void batch_flush(batch_t* batch, uint8_t sequence)
+{
+    batch_begin(batch, REMOTE_COMMAND_FLUSH, 0, 0);
+    batch_put(batch, sequence);
+    batch_end(batch);
+}
+
+typedef struct {
+    uint8_t sequence;
+    uint32_t executed;
+    size_t replies;
+} replies_t;
+
+static void record_reply(void* user, uint8_t const* data, size_t size)
+{
+    replies_t* replies = (replies_t*)user;
+
+    TEST_CHECK(size == 6U && data[0] == REMOTE_COMMAND_FLUSH);
+    replies->sequence = data[1];
+    replies->executed = (uint32_t)data[2] | (uint32_t)data[3] << 8U |
+                        (uint32_t)data[4] << 16U | (uint32_t)data[5] << 24U;
+    ++replies->replies;
+}
+
+// Commands draw what the same gfx calls draw, the panel only sees the
+// batch at its flush
+static void test_commands(void)
+{
+    static uint8_t frame[TEST_GFX_FRAME_SIZE];
+    static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+    static batch_t batch;
+    test_panel_t panel;
+    replies_t replies = {0};
+    remote_t remote;
+    gfx_t gfx;
+    gfx_t expected;
+
+    test_panel_initialize(&panel);
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    test_gfx_initialize(
+        &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    test_gfx_initialize(
+        &expected, expected_frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    TEST_CHECK(gfx_flush(&gfx) == GFX_ERR_OK);
+    test_panel_reset_counters(&panel);
+
+    remote_initialize(&remote,
+                      &(remote_config_t){.gfx = &gfx},
+                      &(remote_interface_t){.reply_user = &replies,
+                                            .reply = record_reply});
+
+    static uint8_t const columns[] = {1U, 2U, 3U, 4U, 5U, 6U};
+    batch_fill(&batch, -5, 10, 30, 20, true);
+    batch_fill(&batch, 12, 14, 4, 4, false);
+    batch_text(&batch, 5, 50, "Zażółć 23.5");
+    batch_bitmap(&batch, 100, -4, columns, 3U, 2U);
+    batch_pixel(&batch, 7, 7, true);
+    batch_pixel(&batch, 127, 127, true);
+    batch_pixel(&batch, -1, 200, true);
+
+    gfx_fill_rect(&expected, -5, 10, 30, 20, GFX_ROP_SET);
+    gfx_fill_rect(&expected, 12, 14, 4, 4, GFX_ROP_CLEAR);
+    gfx_draw_string(&expected, 5, 50, "Zażółć 23.5", GFX_ROP_SET);
+    gfx_draw_columns(&expected, 100, -4, &columns[0], 3U, GFX_ROP_SET);
+    gfx_draw_columns(&expected, 100, 4, &columns[3], 3U, GFX_ROP_SET);
+    gfx_set_pixel(&expected, 7, 7, true);
+    gfx_set_pixel(&expected, 127, 127, true);
+
+    TEST_CHECK(remote_execute(&remote, batch.data, batch.size) ==
+               REMOTE_ERR_OK);
+    TEST_CHECK(memcmp(frame, expected_frame, sizeof(frame)) == 0);
+    TEST_CHECK(panel.spans == 0U && replies.replies == 0U);
+
+    // the flush sends the merged dirty spans, one per page touched
+    batch.size = 0U;
+    batch.count = 0U;
+    batch_flush(&batch, 42U);
+    TEST_CHECK(remote_execute(&remote, batch.data, batch.size) ==
+               REMOTE_ERR_OK);
+    TEST_CHECK(replies.replies == 1U && replies.sequence == 42U);
+    TEST_CHECK(replies.executed == 8U);
+    TEST_CHECK(panel.spans > 0U && panel.spans <= 16U);
+    TEST_CHECK(memcmp(panel.ram, expected_frame, sizeof(panel.ram)) == 0);
+
+    // a clear empties the frame
+    batch.size = 0U;
+    batch.count = 0U;
+    batch_begin(&batch, REMOTE_COMMAND_CLEAR, 0, 0);
+    batch_end(&batch);
+    batch_flush(&batch, 43U);
+    TEST_CHECK(remote_execute(&remote, batch.data, batch.size) ==
+               REMOTE_ERR_OK);
+    memset(expected_frame, 0, sizeof(expected_frame));
+    TEST_CHECK(memcmp(panel.ram, expected_frame, sizeof(panel.ram)) == 0);
+    TEST_CHECK(replies.executed == 10U);
+}
+
+// A batch cut anywhere runs the whole commands before the cut and stops
+static void test_truncated(void)
+{
+    static uint8_t frame[TEST_GFX_FRAME_SIZE];
+    static batch_t batch;
+    static uint8_t const columns[64] = {0xFFU};
+    remote_t remote;
+    gfx_t gfx;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    remote_initialize(
+        &remote, &(remote_config_t){.gfx = &gfx}, &(remote_interface_t){0});
+
+    batch_fill(&batch, 0, 0, 10, 10, true);
+    batch_text(&batch, 0, 20, "abc");
+    batch_bitmap(&batch, 0, 40, columns, 32U, 2U);
+    batch_pixel(&batch, 1, 1, true);
+    batch_flush(&batch, 1U);
+
+    for (size_t size = 1U; size < batch.size; ++size) {
+        size_t whole = 0U;
+        while (batch.offsets[whole + 1U] <= size) {
+            ++whole;
+        }
+
+        // copied to the heap so ASan catches a read past the cut
+        uint8_t* data = malloc(size);
+        memcpy(data, batch.data, size);
+        uint32_t executed = remote_get_executed(&remote);
+        size_t errors = remote_get_errors(&remote);
+        remote_err_t err = remote_execute(&remote, data, size);
+        free(data);
+
+        bool cut = batch.offsets[whole] != size;
+        TEST_CHECK(err == (cut ? REMOTE_ERR_FAIL : REMOTE_ERR_OK));
+        TEST_CHECK(remote_get_errors(&remote) == errors + (cut ? 1U : 0U));
+        TEST_CHECK(remote_get_executed(&remote) == executed + whole);
+    }
+
+    // unknown opcodes and coordinates far off the frame
+    static uint8_t const unknown[] = {0U, 1U};
+    TEST_CHECK(remote_execute(&remote, unknown, sizeof(unknown)) ==
+               REMOTE_ERR_FAIL);
+    batch.size = 0U;
+    batch.count = 0U;
+    batch_fill(&batch, INT16_MIN, INT16_MIN, INT16_MAX, INT16_MAX, true);
+    batch_fill(&batch, INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, true);
+    batch_bitmap(&batch, INT16_MAX, INT16_MIN, columns, 64U, 1U);
+    TEST_CHECK(remote_execute(&remote, batch.data, batch.size) ==
+               REMOTE_ERR_OK);
+}
+
+typedef struct {
+    link_t link;
+    uint8_t tx_buffer[LINK_BUFFER_SIZE];
+    uint8_t rx_buffer[LINK_BUFFER_SIZE];
+    remote_t remote;
+    uint8_t const* input;
+    size_t input_size;
+    size_t read;
+    FILE* output;
+} device_t;
+
+static size_t device_write(void* user, uint8_t const* data, size_t size)
+{
+    return fwrite(data, 1U, size, ((device_t*)user)->output);
+}
+
+static size_t device_read(void* user, uint8_t* data, size_t size)
+{
+    device_t* device = (device_t*)user;
+    size_t available = device->input_size - device->read;
+
+    if (size > available) {
+        size = available;
+    }
+    memcpy(data, &device->input[device->read], size);
+    device->read += size;
+
+    return size;
+}
+
+static void device_receive(void* user,
+                           uint8_t channel,
+                           uint8_t const* data,
+                           size_t size)
+{
+    device_t* device = (device_t*)user;
+
+    if (channel == LINK_CHANNEL_DRAW) {
+        TEST_CHECK(remote_execute(&device->remote, data, size) ==
+                   REMOTE_ERR_OK);
+    }
+}
+
+static void device_reply(void* user, uint8_t const* data, size_t size)
+{
+    device_t* device = (device_t*)user;
+
+    link_send(&device->link, LINK_CHANNEL_DRAW, data, size);
+}
+
+// The board end of scripts/remote_draw.py, as main.c wires it, for
+// check_remote.py to compare the replies with its own count
+static void serve(char const* input_path, char const* output_path)
+{
+    static uint8_t input[WIRE_SIZE];
+    static uint8_t frame[TEST_GFX_FRAME_SIZE];
+    static device_t device;
+    test_panel_t panel;
+    gfx_t gfx;
+
+    FILE* file = fopen(input_path, "rb");
+    device.output = fopen(output_path, "wb");
+    if (!TEST_CHECK(file && device.output)) {
+        return;
+    }
+    device.input = input;
+    device.input_size = fread(input, 1U, sizeof(input), file);
+    fclose(file);
+
+    test_panel_initialize(&panel);
+    gfx_interface_t interface = test_panel_get_interface(&panel);
+    test_gfx_initialize(
+        &gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    link_initialize(&device.link,
+                    &(link_config_t){.tx_buffer = device.tx_buffer,
+                                     .tx_buffer_size = LINK_BUFFER_SIZE,
+                                     .rx_buffer = device.rx_buffer,
+                                     .rx_buffer_size = LINK_BUFFER_SIZE,
+                                     .baud = 115200U,
+                                     .max_baud = 115200U},
+                    &(link_interface_t){.transport_user = &device,
+                                        .transport_write = device_write,
+                                        .transport_read = device_read,
+                                        .receive_user = &device,
+                                        .receive = device_receive});
+    remote_initialize(&device.remote,
+                      &(remote_config_t){.gfx = &gfx},
+                      &(remote_interface_t){.reply_user = &device,
+                                            .reply = device_reply});
+
+    link_process(&device.link, 0U);
+    TEST_CHECK(link_get_rx_dropped(&device.link) == 0U);
+    TEST_CHECK(memcmp(panel.ram, frame, sizeof(frame)) == 0);
+
+    fclose(device.output);
+}
+
+int main(int argc, char** argv)
+{
+    test_commands();
+    test_truncated();
+
+    if (TEST_CHECK(argc == 3)) {
+        serve(argv[1], argv[2]);
+    }
+
+    return test_finish();
+}
@@ -0,0 +1,163 @@
+#include "ring.h"
+#include "test.h"
+#include <pthread.h>
+#include <string.h>
+
+#define RING_SIZE (64U)
+#define RECORDS (100000U)
+#define RECORD_MAX_SIZE (24U)
+
+static uint8_t buffer[RING_SIZE];
+
+static void test_wraparound(void)
+{
+    ring_t ring;
+    uint8_t data[RING_SIZE + 8U];
+    uint8_t read[RING_SIZE + 8U];
+
+    for (size_t index = 0U; index < sizeof(data); ++index) {
+        data[index] = (uint8_t)index;
+    }
+
+    ring_initialize(&ring, &(ring_config_t){.buffer = buffer, .size = 64U});
+
+    // every split of a write and a read across the end of the buffer
+    for (size_t round = 0U; round < 3U * RING_SIZE; ++round) {
+        size_t size = 1U + round % 40U;
+        TEST_CHECK(ring_write(&ring, data, size) == size);
+        TEST_CHECK(ring_get_used(&ring) == size);
+        TEST_CHECK(ring_read(&ring, read, sizeof(read)) == size);
+        TEST_CHECK(memcmp(read, data, size) == 0);
+    }
+
+    // a write that does not fit is cut, ring_write_all drops it whole
+    TEST_CHECK(ring_write(&ring, data, RING_SIZE - 8U) == RING_SIZE - 8U);
+    TEST_CHECK(ring_write_all(&ring, data, 9U) == 0U);
+    TEST_CHECK(ring_get_dropped(&ring) == 9U);
+    TEST_CHECK(ring_write_all(&ring, data, 8U) == 8U);
+    TEST_CHECK(ring_write(&ring, data, 5U) == 0U);
+    TEST_CHECK(ring_get_dropped(&ring) == 14U);
+
+    // discarding drops the oldest bytes
+    TEST_CHECK(ring_discard(&ring, 10U) == 10U);
+    TEST_CHECK(ring_get_dropped(&ring) == 24U);
+    TEST_CHECK(ring_read(&ring, read, 4U) == 4U);
+    TEST_CHECK(memcmp(read, &data[10], 4U) == 0);
+
+    // peek exposes the run up to the end of the buffer
+    uint8_t const* run;
+    size_t used = ring_get_used(&ring);
+    size_t size = ring_peek(&ring, &run);
+    TEST_CHECK(size > 0U && size <= used);
+    TEST_CHECK(memcmp(run, &data[14], size < 42U ? size : 42U) == 0);
+    ring_consume(&ring, size);
+    TEST_CHECK(ring_get_used(&ring) == used - size);
+
+    // realigning drops the rest and restarts at the start of the buffer
+    TEST_CHECK(ring_realign(&ring) == used - size);
+    TEST_CHECK(ring_get_used(&ring) == 0U && ring_get_free(&ring) == 64U);
+    TEST_CHECK(ring_write(&ring, data, 3U) == 3U);
+    TEST_CHECK(ring_peek(&ring, &run) == 3U && run == buffer);
+}
+
+typedef struct {
+    ring_t ring;
+    size_t offered;
+    size_t accepted;
+    atomic_bool finished;
+} producer_t;
+
+// A record is its size, its sequence number and bytes derived from both
+static size_t make_record(uint8_t* record, uint32_t sequence)
+{
+    size_t size = 5U + sequence % (RECORD_MAX_SIZE - 4U);
+
+    record[0] = (uint8_t)size;
+    memcpy(&record[1], &sequence, sizeof(sequence));
+    for (size_t offset = 5U; offset < size; ++offset) {
+        record[offset] = (uint8_t)(sequence + offset);
+    }
+
+    return size;
+}
+
+// Writes every record all or nothing, against a consumer in another thread
+static void* produce(void* user)
+{
+    producer_t* producer = (producer_t*)user;
+    uint8_t record[RECORD_MAX_SIZE];
+
+    for (uint32_t sequence = 0U; sequence < RECORDS; ++sequence) {
+        size_t size = make_record(record, sequence);
+        producer->offered += size;
+        producer->accepted += ring_write_all(&producer->ring, record, size);
+    }
+
+    atomic_store(&producer->finished, true);
+
+    return NULL;
+}
+
+static void test_concurrent(void)
+{
+    static producer_t producer;
+    static uint8_t storage[RING_SIZE];
+    pthread_t thread;
+
+    ring_initialize(&producer.ring,
+                    &(ring_config_t){.buffer = storage, .size = RING_SIZE});
+    atomic_init(&producer.finished, false);
+    TEST_CHECK(pthread_create(&thread, NULL, produce, &producer) == 0);
+
+    // records arrive whole and in order, dropped ones leave gaps in the
+    // sequence
+    uint8_t record[RECORD_MAX_SIZE];
+    uint8_t expected[RECORD_MAX_SIZE];
+    size_t record_size = 0U;
+    size_t received = 0U;
+    size_t records = 0U;
+    uint32_t next = 0U;
+    bool whole = true;
+
+    for (;;) {
+        bool finished = atomic_load(&producer.finished);
+
+        uint8_t data[16];
+        size_t size = ring_read(&producer.ring, data, sizeof(data));
+        for (size_t offset = 0U; offset < size && whole; ++offset) {
+            record[record_size++] = data[offset];
+            if (record_size < 5U ||
+                (record_size < record[0] && record_size < RECORD_MAX_SIZE)) {
+                continue;
+            }
+
+            uint32_t sequence;
+            memcpy(&sequence, &record[1], sizeof(sequence));
+            whole = sequence >= next && sequence < RECORDS &&
+                    make_record(expected, sequence) == record_size &&
+                    memcmp(record, expected, record_size) == 0;
+            next = sequence + 1U;
+            record_size = 0U;
+            ++records;
+        }
+        received += size;
+
+        if (size == 0U && finished) {
+            break;
+        }
+    }
+
+    TEST_CHECK(pthread_join(thread, NULL) == 0);
+    TEST_CHECK(whole && record_size == 0U && records > 0U);
+    TEST_CHECK(received == producer.accepted);
+    TEST_CHECK(ring_get_dropped(&producer.ring) ==
+               producer.offered - producer.accepted);
+}
+
+int main(void)
+{
+    test_wraparound();
+    test_concurrent();
+
+    return test_finish();
+}
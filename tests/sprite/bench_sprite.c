@@ -0,0 +1,110 @@
+#include "gfx_draw.h"
+#include "sprite.h"
+#include "test.h"
+#include "test_gfx.h"
+
+#define SPRITES (10U)
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t save_buffer[SPRITES * 16U * 3U];
+static sprite_slot_t slots[SPRITES];
+
+// A 16x16 cursor, opaque over its whole square
+static uint8_t image[16U * 2U];
+static uint8_t mask[16U * 2U];
+
+typedef enum {
+    WORKLOAD_MOVE,
+    WORKLOAD_MOVE_ALIGNED,
+    WORKLOAD_FILL,
+} workload_t;
+
+static void run(gfx_t* gfx,
+                sprite_t* sprite,
+                char const* name,
+                workload_t workload,
+                size_t iterations)
+{
+    uint64_t begin = test_get_time();
+
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        int16_t x = (int16_t)(iteration % 100U);
+        switch (workload) {
+            case WORKLOAD_MOVE: {
+                int16_t y = (int16_t)(iteration * 3U % 100U);
+                sprite_move(sprite, 0U, x, y);
+                sprite_update(sprite);
+                break;
+            }
+            case WORKLOAD_MOVE_ALIGNED: {
+                int16_t y = (int16_t)(iteration % 12U * GFX_PAGE_HEIGHT);
+                sprite_move(sprite, 0U, x, y);
+                sprite_update(sprite);
+                break;
+            }
+            default: {
+                gfx_fill_rect(gfx, 0, 0, 128, 128, GFX_ROP_SET);
+                break;
+            }
+        }
+    }
+
+    test_report(name, iterations, test_get_time() - begin);
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations = test_get_iterations(argc, argv, 200000U);
+    static gfx_bitmap_t const cursor = {
+        .data = image, .width = 16U, .height = 16U};
+    static gfx_bitmap_t const cursor_mask = {
+        .data = mask, .width = 16U, .height = 16U};
+    gfx_t gfx;
+    sprite_t sprite;
+    size_t id = 0U;
+
+    test_gfx_initialize(&gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, NULL);
+    for (size_t offset = 0U; offset < sizeof(frame); ++offset) {
+        frame[offset] = (uint8_t)test_random();
+    }
+    for (size_t offset = 0U; offset < sizeof(image); ++offset) {
+        image[offset] = (uint8_t)test_random();
+        mask[offset] = 0xFFU;
+    }
+
+    sprite_initialize(&sprite,
+                      &(sprite_config_t){
+                          .gfx = &gfx,
+                          .slots = slots,
+                          .capacity = SPRITES,
+                          .save_buffer = save_buffer,
+                          .save_buffer_size = sizeof(save_buffer),
+                      });
+    sprite_add(&sprite, &cursor, &cursor_mask, GFX_ROP_SET, &id);
+    sprite_set_visible(&sprite, id, true);
+
+    run(&gfx, &sprite, "16x16 masked move", WORKLOAD_MOVE, iterations);
+    run(&gfx,
+        &sprite,
+        "16x16 masked move page aligned",
+        WORKLOAD_MOVE_ALIGNED,
+        iterations);
+
+    // the moving one under nine that overlap it and each other
+    for (size_t index = 1U; index < SPRITES; ++index) {
+        sprite_add(&sprite, &cursor, NULL, GFX_ROP_XOR, &id);
+        sprite_move(&sprite,
+                    id,
+                    (int16_t)(index * 12U),
+                    (int16_t)(index * 11U));
+        sprite_set_visible(&sprite, id, true);
+    }
+    sprite_update(&sprite);
+
+    run(&gfx, &sprite, "bottom of ten overlapping", WORKLOAD_MOVE, iterations);
+    run(&gfx, &sprite, "full frame fill", WORKLOAD_FILL, iterations);
+
+    sprite_deinitialize(&sprite);
+
+    return test_finish();
+}
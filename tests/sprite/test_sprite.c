@@ -0,0 +1,398 @@
+#include "gfx_draw.h"
+#include "sprite.h"
+#include "test.h"
+#include "test_gfx.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ROUNDS (300U)
+#define STEPS (60U)
+#define SPRITES (12U)
+#define IMAGE_SIZE_MAX (40U)
+
+static gfx_rop_t const rops[] = {
+    GFX_ROP_SET,
+    GFX_ROP_CLEAR,
+    GFX_ROP_XOR,
+    GFX_ROP_AND,
+    GFX_ROP_INVERT,
+    GFX_ROP_COPY,
+};
+
+// What the test expects of a sprite, drawn in the order of its slot
+typedef struct {
+    gfx_bitmap_t images[2];
+    gfx_bitmap_t masks[2];
+    size_t image;
+    bool masked;
+    gfx_rop_t rop;
+    int16_t x;
+    int16_t y;
+    bool visible;
+    bool added;
+    size_t id;
+} model_t;
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+static uint8_t expected_frame[TEST_GFX_FRAME_SIZE];
+static uint8_t background[TEST_GFX_FRAME_SIZE];
+static uint8_t before[TEST_GFX_FRAME_SIZE];
+static sprite_slot_t slots[SPRITES];
+static model_t models[SPRITES];
+
+static size_t get_size(size_t width, size_t height)
+{
+    return width * ((height + GFX_PAGE_HEIGHT - 1U) / GFX_PAGE_HEIGHT);
+}
+
+// What sprite_config.h asks of the save buffer for an image
+static size_t get_save_size(gfx_bitmap_t const* image)
+{
+    return image->width * ((image->height + 14U) / GFX_PAGE_HEIGHT);
+}
+
+static void fill_random(uint8_t* data, size_t size)
+{
+    for (size_t offset = 0U; offset < size; ++offset) {
+        data[offset] = (uint8_t)test_random();
+    }
+}
+
+static int16_t get_random(int32_t low, int32_t high)
+{
+    return (int16_t)(low + (int32_t)(test_random() % (uint32_t)(high - low)));
+}
+
+// Each bitmap on the heap at its exact size, so that ASan sees reads past it
+static gfx_bitmap_t make_random_bitmap(size_t width, size_t height)
+{
+    size_t size = get_size(width, height);
+    uint8_t* data = malloc(size);
+
+    fill_random(data, size);
+
+    return (gfx_bitmap_t){.data = data, .width = width, .height = height};
+}
+
+static void free_bitmap(gfx_bitmap_t* bitmap)
+{
+    free((void*)bitmap->data);
+    bitmap->data = NULL;
+}
+
+static gfx_bitmap_t const* get_mask(model_t const* model)
+{
+    return model->masked ? &model->masks[model->image] : NULL;
+}
+
+// The background with the visible sprites drawn in slot order
+static void draw_reference(gfx_t* expected, sprite_t const* sprite)
+{
+    memcpy(expected_frame, background, sizeof(expected_frame));
+
+    for (size_t id = 0U; id < sprite->count; ++id) {
+        for (size_t index = 0U; index < SPRITES; ++index) {
+            model_t const* model = &models[index];
+            if (!model->added || model->id != id || !model->visible) {
+                continue;
+            }
+
+            gfx_bitmap_t const* image = &model->images[model->image];
+            int16_t width = (int16_t)image->width;
+            int16_t height = (int16_t)image->height;
+            if (model->masked) {
+                gfx_blit(expected,
+                         model->x,
+                         model->y,
+                         get_mask(model),
+                         0,
+                         0,
+                         width,
+                         height,
+                         GFX_ROP_CLEAR);
+            }
+            gfx_blit(expected,
+                     model->x,
+                     model->y,
+                     image,
+                     0,
+                     0,
+                     width,
+                     height,
+                     model->rop);
+        }
+    }
+}
+
+static bool is_id_taken(size_t id, size_t except)
+{
+    for (size_t index = 0U; index < SPRITES; ++index) {
+        if (index != except && models[index].added &&
+            models[index].id == id) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// One random call on one sprite, false if its result was wrong
+static bool change_random(sprite_t* sprite, gfx_t const* gfx)
+{
+    size_t index = test_random() % SPRITES;
+    model_t* model = &models[index];
+    uint32_t kind = test_random() % 12U;
+
+    if (!model->added) {
+        if (kind < 8U) {
+            // a removed sprite is gone for every call, unless another one
+            // took its slot
+            return is_id_taken(model->id, index) ||
+                   sprite_move(sprite, model->id, 1, 1) == SPRITE_ERR_FAIL;
+        }
+
+        size_t id = 0U;
+        if (sprite_add(sprite,
+                       &model->images[model->image],
+                       get_mask(model),
+                       model->rop,
+                       &id) != SPRITE_ERR_OK) {
+            return true;
+        }
+
+        bool unique = !is_id_taken(id, index);
+        model->id = id;
+        model->added = true;
+        model->visible = false;
+        model->x = 0;
+        model->y = 0;
+        return unique;
+    }
+
+    if (kind < 6U) {
+        model->x = get_random(-40, (int32_t)gfx->config.frame_width + 20);
+        model->y = get_random(-40, (int32_t)gfx->config.frame_height + 20);
+        return sprite_move(sprite, model->id, model->x, model->y) ==
+               SPRITE_ERR_OK;
+    }
+    if (kind < 9U) {
+        model->visible = test_random() % 4U != 0U;
+        return sprite_set_visible(sprite, model->id, model->visible) ==
+               SPRITE_ERR_OK;
+    }
+    if (kind < 11U) {
+        size_t image = 1U - model->image;
+        gfx_bitmap_t const* mask = model->masked ? &model->masks[image] : NULL;
+        bool fits = get_save_size(&model->images[image]) <=
+                    slots[model->id].save_size;
+        sprite_err_t err = sprite_set_image(
+            sprite, model->id, &model->images[image], mask);
+        if (err == SPRITE_ERR_OK) {
+            model->image = image;
+        }
+        return (err == SPRITE_ERR_OK) == fits;
+    }
+
+    model->added = false;
+    return sprite_remove(sprite, model->id) == SPRITE_ERR_OK;
+}
+
+static void make_models(void)
+{
+    for (size_t index = 0U; index < SPRITES; ++index) {
+        model_t* model = &models[index];
+        *model = (model_t){
+            .masked = test_random() % 2U == 0U,
+            .rop = rops[test_random() % 6U],
+        };
+
+        for (size_t image = 0U; image < 2U; ++image) {
+            size_t width = test_random() % IMAGE_SIZE_MAX + 1U;
+            size_t height = test_random() % IMAGE_SIZE_MAX + 1U;
+            model->images[image] = make_random_bitmap(width, height);
+            model->masks[image] = make_random_bitmap(width, height);
+        }
+    }
+}
+
+static void free_models(void)
+{
+    for (size_t index = 0U; index < SPRITES; ++index) {
+        for (size_t image = 0U; image < 2U; ++image) {
+            free_bitmap(&models[index].images[image]);
+            free_bitmap(&models[index].masks[image]);
+        }
+    }
+}
+
+// Random moves, visibility, image changes, removal and adding again of
+// overlapping sprites over random content. After every update the frame is
+// the background with the visible sprites on top, hiding them all brings
+// the background back bit for bit.
+static void test_matches_reference(gfx_t* gfx, gfx_t* expected)
+{
+    size_t size = get_size(gfx->config.frame_width, gfx->config.frame_height);
+
+    for (size_t round = 0U; round < ROUNDS; ++round) {
+        make_models();
+
+        // on the heap at the size the first images need, so that ASan sees
+        // writes past it
+        size_t save_size = 0U;
+        for (size_t index = 0U; index < SPRITES; ++index) {
+            save_size += get_save_size(&models[index].images[0]);
+        }
+        uint8_t* save_buffer = malloc(save_size);
+
+        sprite_t sprite;
+        sprite_initialize(&sprite,
+                          &(sprite_config_t){.gfx = gfx,
+                                             .slots = slots,
+                                             .capacity = SPRITES,
+                                             .save_buffer = save_buffer,
+                                             .save_buffer_size = save_size});
+
+        fill_random(frame, size);
+        memcpy(background, frame, size);
+
+        bool calls = true;
+        for (size_t index = 0U; index < SPRITES; ++index) {
+            model_t* model = &models[index];
+            calls = calls && sprite_add(&sprite,
+                                        &model->images[0],
+                                        get_mask(model),
+                                        model->rop,
+                                        &model->id) == SPRITE_ERR_OK;
+            calls = calls && model->id == index;
+            model->added = true;
+        }
+
+        bool matches = true;
+        bool dirty = true;
+        for (size_t step = 0U; step < STEPS && calls && matches && dirty;
+             ++step) {
+            for (uint32_t count = test_random() % 4U + 1U; count > 0U;
+                 --count) {
+                calls = calls && change_random(&sprite, gfx);
+            }
+
+            memcpy(before, frame, size);
+            gfx_clear_dirty(gfx);
+
+            // the background drawn again between the sprites coming off and
+            // going back on
+            if (test_random() % 10U == 0U) {
+                sprite_restore(&sprite);
+                matches = memcmp(frame, background, size) == 0;
+                for (size_t count = 0U; count < 3U; ++count) {
+                    gfx_fill_rect(gfx,
+                                  get_random(-20, 128),
+                                  get_random(-20, 128),
+                                  get_random(0, 60),
+                                  get_random(0, 60),
+                                  GFX_ROP_XOR);
+                }
+                memcpy(background, frame, size);
+            }
+
+            sprite_update(&sprite);
+            draw_reference(expected, &sprite);
+            matches = matches && memcmp(frame, expected_frame, size) == 0;
+            dirty = test_gfx_is_dirty(gfx, before);
+        }
+
+        for (size_t index = 0U; index < SPRITES; ++index) {
+            if (models[index].added) {
+                sprite_set_visible(&sprite, models[index].id, false);
+            }
+        }
+        sprite_update(&sprite);
+        bool restored = memcmp(frame, background, size) == 0;
+
+        sprite_deinitialize(&sprite);
+        free(save_buffer);
+        free_models();
+
+        if (!TEST_CHECK(calls) || !TEST_CHECK(matches) ||
+            !TEST_CHECK(dirty) || !TEST_CHECK(restored)) {
+            break;
+        }
+    }
+}
+
+// Slots and the save buffer run out, removed slots come back once the
+// update took their sprite off
+static void test_limits(gfx_t* gfx)
+{
+    static uint8_t data[16U * 2U];
+    static gfx_bitmap_t const small = {.data = data, .width = 8U, .height = 8U};
+    static gfx_bitmap_t const large = {
+        .data = data, .width = 16U, .height = 16U};
+    // two pages each for the small image, not enough for the large one
+    uint8_t* save_buffer = malloc(8U * 2U * 2U);
+    sprite_slot_t limited[2];
+    sprite_t sprite;
+    size_t first = 0U;
+    size_t second = 0U;
+    size_t third = 0U;
+
+    sprite_initialize(&sprite,
+                      &(sprite_config_t){.gfx = gfx,
+                                         .slots = limited,
+                                         .capacity = 2U,
+                                         .save_buffer = save_buffer,
+                                         .save_buffer_size = 8U * 2U * 2U});
+    TEST_CHECK(sprite_add(&sprite, &large, NULL, GFX_ROP_SET, &first) ==
+               SPRITE_ERR_FAIL);
+    TEST_CHECK(sprite_add(&sprite, &small, NULL, GFX_ROP_SET, &first) ==
+               SPRITE_ERR_OK);
+    TEST_CHECK(sprite_add(&sprite, &small, NULL, GFX_ROP_SET, &second) ==
+               SPRITE_ERR_OK);
+    TEST_CHECK(first == 0U && second == 1U);
+    TEST_CHECK(sprite_add(&sprite, &small, NULL, GFX_ROP_SET, &third) ==
+               SPRITE_ERR_FAIL);
+    TEST_CHECK(sprite_set_image(&sprite, first, &large, NULL) ==
+               SPRITE_ERR_FAIL);
+    TEST_CHECK(sprite_move(&sprite, 2U, 0, 0) == SPRITE_ERR_FAIL);
+
+    // still in the frame until the update, so the slot is not free yet
+    sprite_set_visible(&sprite, first, true);
+    sprite_update(&sprite);
+    TEST_CHECK(sprite_remove(&sprite, first) == SPRITE_ERR_OK);
+    TEST_CHECK(sprite_remove(&sprite, first) == SPRITE_ERR_FAIL);
+    TEST_CHECK(sprite_set_visible(&sprite, first, true) == SPRITE_ERR_FAIL);
+    TEST_CHECK(sprite_add(&sprite, &small, NULL, GFX_ROP_SET, &third) ==
+               SPRITE_ERR_FAIL);
+    sprite_update(&sprite);
+    TEST_CHECK(sprite_add(&sprite, &large, NULL, GFX_ROP_SET, &third) ==
+               SPRITE_ERR_FAIL);
+    TEST_CHECK(sprite_add(&sprite, &small, NULL, GFX_ROP_SET, &third) ==
+               SPRITE_ERR_OK);
+    TEST_CHECK(third == first);
+
+    sprite_deinitialize(&sprite);
+    free(save_buffer);
+}
+
+int main(void)
+{
+    // a full frame and one whose last page is partly outside it
+    static size_t const heights[] = {TEST_GFX_HEIGHT, 122U};
+    gfx_t gfx;
+    gfx_t expected;
+
+    for (size_t index = 0U; index < 2U; ++index) {
+        test_gfx_initialize(
+            &gfx, frame, TEST_GFX_WIDTH, heights[index], NULL);
+        test_gfx_initialize(&expected,
+                            expected_frame,
+                            TEST_GFX_WIDTH,
+                            heights[index],
+                            NULL);
+        test_matches_reference(&gfx, &expected);
+    }
+
+    test_limits(&gfx);
+
+    return test_finish();
+}
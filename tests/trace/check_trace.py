@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+
+import argparse
+import io
+import pathlib
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, str(pathlib.Path(__file__).resolve().parents[2] / "scripts"))
+
+import decode_trace  # noqa: E402
+
+
+# Runs test_trace and decodes the stream it captured with the format strings
+# of its own binary, the text has to come out as printf formatted it
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("test")
+    arguments = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        stream_path = pathlib.Path(directory) / "stream.bin"
+        expected_path = pathlib.Path(directory) / "expected.txt"
+
+        result = subprocess.run([arguments.test, stream_path, expected_path])
+        if result.returncode != 0:
+            return result.returncode
+
+        address, strings = decode_trace.parse_strings(arguments.test)
+        buffer = io.BytesIO()
+        output = io.TextIOWrapper(buffer, encoding="utf-8", newline="")
+        with open(stream_path, "rb") as stream:
+            decode_trace.decode(stream, output, address, strings)
+        output.flush()
+
+        decoded = buffer.getvalue().splitlines(keepends=True)
+        expected = expected_path.read_bytes().splitlines(keepends=True)
+
+    for number, (line, want) in enumerate(zip(decoded, expected), 1):
+        if line != want:
+            print(f"line {number}: decoded {line!r}, expected {want!r}")
+            return 1
+    if len(decoded) != len(expected):
+        print(f"decoded {len(decoded)} lines, expected {len(expected)}")
+        return 1
+
+    print(f"{len(decoded)} lines decoded")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,205 @@
+#include "ring.h"
+#include "test.h"
+#include "trace.h"
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define RING_SIZE (128U)
+#define ROUNDS (200U)
+#define RECORD_MAX_SIZE (1U + 5U * (1U + TRACE_MAX_ARGUMENTS))
+
+// The uart of the firmware, records and text share a small ring queued all
+// or nothing and drained into the capture file now and then
+typedef struct {
+    ring_t ring;
+    uint8_t buffer[RING_SIZE];
+    FILE* stream;
+    FILE* expected;
+    bool accepted;
+} capture_t;
+
+static void capture_drain(capture_t* capture)
+{
+    uint8_t data[16];
+    size_t size;
+
+    while ((size = ring_read(&capture->ring, data, sizeof(data))) > 0U) {
+        fwrite(data, 1U, size, capture->stream);
+    }
+}
+
+static void capture_sink_write(void* user, uint8_t const* data, size_t size)
+{
+    capture_t* capture = (capture_t*)user;
+
+    capture->accepted = ring_write_all(&capture->ring, data, size) == size;
+}
+
+static void capture_text(capture_t* capture, char const* text)
+{
+    size_t size = strlen(text);
+
+    if (ring_write_all(&capture->ring, text, size) == size) {
+        fputs(text, capture->expected);
+    }
+}
+
+// What the decoder has to print for the last record, if it was queued
+__attribute__((format(printf, 2, 3))) static void expect(
+    capture_t* capture,
+    char const* format,
+    ...)
+{
+    if (!capture->accepted) {
+        return;
+    }
+
+    va_list arguments;
+    va_start(arguments, format);
+    vfprintf(capture->expected, format, arguments);
+    va_end(arguments);
+}
+
+// A record whose argument count does not match its format, as a TRACE call
+// that got past the compiler would write, the decoder has to flag it and
+// still find the records after it
+static void check_mismatch(capture_t* capture,
+                           trace_t* trace,
+                           char const* format,
+                           size_t count)
+{
+    trace_write(trace, format, (uint32_t const[]){1U, 2U, 3U}, count);
+    expect(capture,
+           "<trace record 0x%" PRIX32 " has %zu arguments, "
+           "its format wants 2>\n",
+           (uint32_t)(uintptr_t)format,
+           count);
+}
+
+#define CHECK_TRACE(capture, trace, ...) \
+    do {                                 \
+        TRACE((trace), __VA_ARGS__);     \
+        expect((capture), __VA_ARGS__);  \
+    } while (0)
+
+static uint8_t record[RECORD_MAX_SIZE];
+static size_t record_size;
+
+static void record_sink_write(void* user, uint8_t const* data, size_t size)
+{
+    (void)user;
+
+    memcpy(record, data, size);
+    record_size = size;
+}
+
+// The marker with the argument count, the format address and the arguments
+// as LEB128
+static void test_encoding(void)
+{
+    trace_t trace;
+    uint8_t expected[RECORD_MAX_SIZE];
+
+    trace_initialize(&trace,
+                     &(trace_interface_t){.sink_write = record_sink_write});
+
+    static char const format[] = "%u %u %u %d\n";
+    trace_write(&trace,
+                format,
+                (uint32_t const[]){0U, 127U, 300U, (uint32_t)-1},
+                4U);
+
+    uint32_t address = (uint32_t)(uintptr_t)format;
+    size_t size = 0U;
+    expected[size++] = TRACE_RECORD_MARKER + 4U;
+    while (address >= 0x80U) {
+        expected[size++] = (uint8_t)(address | 0x80U);
+        address >>= 7U;
+    }
+    expected[size++] = (uint8_t)address;
+    memcpy(&expected[size], "\x00\x7f\xac\x02\xff\xff\xff\xff\x0f", 9U);
+    size += 9U;
+
+    TEST_CHECK(record_size == size);
+    TEST_CHECK(memcmp(record, expected, size) == 0);
+
+    // a format in .trace_strings is never a null pointer, even the first
+    TRACE(&trace, "first\n");
+    TEST_CHECK(record_size > 1U && record[1] != 0U);
+}
+
+// Writes the stream and the text the decoder has to turn it into, for
+// check_trace.py to compare
+static void test_stream(char const* stream_path, char const* expected_path)
+{
+    static capture_t capture;
+    static char const mismatched[]
+        __attribute__((section(".trace_strings"), used)) = "%u %u\n";
+    trace_t trace;
+
+    capture.stream = fopen(stream_path, "wb");
+    capture.expected = fopen(expected_path, "wb");
+    if (!TEST_CHECK(capture.stream && capture.expected)) {
+        return;
+    }
+
+    ring_initialize(&capture.ring,
+                    &(ring_config_t){.buffer = capture.buffer,
+                                     .size = sizeof(capture.buffer)});
+    trace_initialize(&trace,
+                     &(trace_interface_t){.sink_user = &capture,
+                                          .sink_write = capture_sink_write});
+
+    for (size_t round = 0U; round < ROUNDS; ++round) {
+        int value = (int)(test_random() % 2000001U) - 1000000;
+        unsigned large = test_random();
+
+        capture_text(&capture, "plain text, zażółć\n");
+        CHECK_TRACE(&capture, &trace, "boot\n");
+        CHECK_TRACE(&capture, &trace, "round %zu\n", round);
+        CHECK_TRACE(&capture, &trace, "%d %i %u\n", value, -value, large);
+        CHECK_TRACE(&capture, &trace, "0x%08X %x '%c'\n", large, large, 'A');
+        CHECK_TRACE(&capture,
+                    &trace,
+                    "[%5d] [%-5u] [%+d] [% d] 100%%\n",
+                    value % 1000,
+                    large % 1000U,
+                    value % 100,
+                    -7);
+        CHECK_TRACE(&capture, &trace, "%.3d %04x\n", value % 10, 0xbeU);
+        CHECK_TRACE(&capture,
+                    &trace,
+                    "%d %d %d %d %d %d\n",
+                    1,
+                    -2,
+                    3,
+                    -4,
+                    5,
+                    value);
+        check_mismatch(&capture, &trace, mismatched, round % 2U * 2U + 1U);
+
+        if (test_random() % 4U != 0U) {
+            capture_drain(&capture);
+        }
+    }
+    capture_drain(&capture);
+
+    // some of both got dropped, whole
+    TEST_CHECK(ring_get_dropped(&capture.ring) > 0U);
+
+    fclose(capture.stream);
+    fclose(capture.expected);
+}
+
+int main(int argc, char** argv)
+{
+    test_encoding();
+
+    if (TEST_CHECK(argc == 3)) {
+        test_stream(argv[1], argv[2]);
+    }
+
+    return test_finish();
+}
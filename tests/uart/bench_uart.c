@@ -0,0 +1,104 @@
+#include "test.h"
+#include "uart.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BAUD (115200U)
+#define FRAME_TIME (16667U)
+#define FRAMES (600U)
+
+// USART2 on a simulated clock, a transfer takes ten bit times per byte
+typedef struct {
+    uart_t* uart;
+    uint64_t now;
+    uint64_t busy_until;
+    size_t running;
+    size_t sent;
+} wire_t;
+
+static uart_err_t wire_transmit(void* user, uint8_t const* data, size_t size)
+{
+    wire_t* wire = (wire_t*)user;
+    (void)data;
+
+    uint64_t start = wire->busy_until > wire->now ? wire->busy_until
+                                                  : wire->now;
+    wire->busy_until = start + size * 10U * 1000000U / BAUD;
+    wire->running = size;
+
+    return UART_ERR_OK;
+}
+
+// Plays the completion interrupts of every transfer that ended by time
+static void wire_run_until(wire_t* wire, uint64_t time)
+{
+    while (wire->running > 0U && wire->busy_until <= time) {
+        wire->now = wire->busy_until;
+        wire->sent += wire->running;
+        wire->running = 0U;
+        uart_transmit_complete(wire->uart);
+    }
+
+    wire->now = time;
+}
+
+// Sixty frames a second, every frame logs a burst of lines at its start
+static void run(uart_overflow_t overflow,
+                char const* name,
+                size_t lines_per_frame,
+                size_t frames)
+{
+    static uint8_t tx_buffer[1024];
+    static uart_t uart;
+    wire_t wire = {.uart = &uart};
+    char line[48];
+    size_t offered = 0U;
+    uint64_t writing = 0U;
+
+    uart_initialize(&uart,
+                    &(uart_config_t){.tx_buffer = tx_buffer,
+                                     .tx_buffer_size = sizeof(tx_buffer),
+                                     .overflow = overflow},
+                    &(uart_interface_t){.bus_user = &wire,
+                                        .bus_transmit = wire_transmit});
+
+    for (size_t frame = 0U; frame < frames; ++frame) {
+        wire_run_until(&wire, frame * FRAME_TIME);
+
+        for (size_t index = 0U; index < lines_per_frame; ++index) {
+            int length = snprintf(
+                line, sizeof(line), "frame %zu: render %zu us\n", frame, index);
+            offered += (size_t)length;
+
+            uint64_t begin = test_get_time();
+            uart_write_all(&uart, line, (size_t)length);
+            writing += test_get_time() - begin;
+        }
+    }
+    wire_run_until(&wire, UINT64_MAX);
+
+    char label[64];
+    snprintf(
+        label, sizeof(label), "%s, %zu lines/frame", name, lines_per_frame);
+    test_report(label, frames * lines_per_frame, writing);
+    printf("%-40s %10.1f %% dropped\n",
+           "",
+           100.0 * (double)uart_get_dropped(&uart) / (double)offered);
+    TEST_CHECK(wire.sent + uart_get_dropped(&uart) == offered);
+}
+
+// Writer cost per line and the share of the log lost once bursts outrun the
+// 1440 bytes the wire moves per frame
+int main(int argc, char** argv)
+{
+    size_t frames = test_get_iterations(argc, argv, FRAMES * 100U);
+    static size_t const bursts[] = {4U, 16U, 64U};
+
+    for (size_t index = 0U; index < sizeof(bursts) / sizeof(*bursts);
+         ++index) {
+        run(UART_OVERFLOW_DROP, "drop", bursts[index], frames);
+        run(UART_OVERFLOW_OVERWRITE, "overwrite", bursts[index], frames);
+    }
+
+    return test_finish();
+}
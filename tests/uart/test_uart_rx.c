@@ -0,0 +1,178 @@
+#include "test.h"
+#include "uart.h"
+#include <stdio.h>
+#include <string.h>
+
+#define RX_BUFFER_SIZE (32U)
+#define LINE_BUFFER_SIZE (16U)
+
+// Circular DMA reception into the buffer the uart armed, with the half,
+// full and idle line events the HAL reports
+typedef struct {
+    uart_t* uart;
+    uint8_t* buffer;
+    size_t size;
+    size_t position;
+    size_t starts;
+} bus_mock_t;
+
+static uart_err_t bus_transmit(void* user, uint8_t const* data, size_t size)
+{
+    (void)user;
+    (void)data;
+    (void)size;
+
+    return UART_ERR_OK;
+}
+
+static uart_err_t bus_receive(void* user, uint8_t* data, size_t size)
+{
+    bus_mock_t* bus = (bus_mock_t*)user;
+
+    bus->buffer = data;
+    bus->size = size;
+    bus->position = 0U;
+    ++bus->starts;
+
+    return UART_ERR_OK;
+}
+
+// Bytes arriving back to back, then the line going idle
+static void bus_feed(bus_mock_t* bus, char const* data, size_t size)
+{
+    for (size_t index = 0U; index < size; ++index) {
+        bus->buffer[bus->position] = (uint8_t)data[index];
+        bus->position = (bus->position + 1U) % bus->size;
+
+        if (bus->position == 0U) {
+            uart_receive_event(bus->uart, bus->size);
+        } else if (bus->position == bus->size / 2U) {
+            uart_receive_event(bus->uart, bus->position);
+        }
+    }
+
+    uart_receive_event(bus->uart, bus->position);
+}
+
+static void bus_feed_string(bus_mock_t* bus, char const* string)
+{
+    bus_feed(bus, string, strlen(string));
+}
+
+static void initialize(uart_t* uart, bus_mock_t* bus)
+{
+    static uint8_t tx_buffer[16];
+    static uint8_t rx_buffer[RX_BUFFER_SIZE];
+    static char line_buffer[LINE_BUFFER_SIZE];
+
+    memset(bus, 0, sizeof(*bus));
+    bus->uart = uart;
+
+    uart_initialize(uart,
+                    &(uart_config_t){.tx_buffer = tx_buffer,
+                                     .tx_buffer_size = sizeof(tx_buffer),
+                                     .rx_buffer = rx_buffer,
+                                     .rx_buffer_size = sizeof(rx_buffer),
+                                     .rx_line_buffer = line_buffer,
+                                     .rx_line_buffer_size =
+                                         sizeof(line_buffer)},
+                    &(uart_interface_t){.bus_user = bus,
+                                        .bus_transmit = bus_transmit,
+                                        .bus_receive = bus_receive});
+    TEST_CHECK(uart_receive_start(uart) == UART_ERR_OK);
+}
+
+// The next assembled line has to be expected
+static bool is_next_line(uart_t* uart, char const* expected)
+{
+    char const* line;
+    size_t length;
+
+    if (!uart_read_line(uart, &line, &length)) {
+        fprintf(stderr, "  no line, expected \"%s\"\n", expected);
+        return false;
+    }
+    if (length != strlen(expected) || strcmp(line, expected) != 0) {
+        fprintf(stderr, "  line \"%s\", expected \"%s\"\n", line, expected);
+        return false;
+    }
+
+    return true;
+}
+
+static bool is_line_pending(uart_t* uart)
+{
+    char const* line;
+    size_t length;
+
+    return uart_read_line(uart, &line, &length);
+}
+
+static void test_lines(void)
+{
+    static uart_t uart;
+    bus_mock_t bus;
+
+    initialize(&uart, &bus);
+
+    // CR, LF and CRLF end lines, even split across idle events
+    bus_feed_string(&bus, "help\r\nstat");
+    TEST_CHECK(is_next_line(&uart, "help"));
+    TEST_CHECK(!is_line_pending(&uart));
+    bus_feed_string(&bus, "us\r");
+    TEST_CHECK(is_next_line(&uart, "status"));
+    bus_feed_string(&bus, "\nlink\n\nx\r");
+    TEST_CHECK(is_next_line(&uart, "link"));
+    TEST_CHECK(is_next_line(&uart, ""));
+    TEST_CHECK(is_next_line(&uart, "x"));
+    TEST_CHECK(!is_line_pending(&uart));
+
+    // a line longer than the line buffer comes out in pieces
+    bus_feed_string(&bus, "abcdefghijklmnopqrstuvwxyz\n");
+    TEST_CHECK(is_next_line(&uart, "abcdefghijklmno"));
+    TEST_CHECK(is_next_line(&uart, "pqrstuvwxyz"));
+    TEST_CHECK(uart_get_receive_dropped(&uart) == 0U);
+
+    // seven byte lines start at every offset of the DMA buffer in turn, so
+    // each split across its end comes up
+    for (size_t index = 0U; index < 2U * RX_BUFFER_SIZE; ++index) {
+        bus_feed_string(&bus, "hello!\n");
+        TEST_CHECK(is_next_line(&uart, "hello!"));
+    }
+    TEST_CHECK(!is_line_pending(&uart));
+}
+
+static void test_overrun_and_restart(void)
+{
+    static uart_t uart;
+    bus_mock_t bus;
+    char data[RX_BUFFER_SIZE];
+
+    initialize(&uart, &bus);
+
+    // more than the buffer holds before anyone reads, the oldest bytes were
+    // overwritten by the DMA and are dropped
+    bus_feed_string(&bus, "0123456789ABCDEFGHIJ");
+    bus_feed_string(&bus, "klmnopqrstuv\n");
+    TEST_CHECK(uart_get_receive_dropped(&uart) == 33U - RX_BUFFER_SIZE);
+    TEST_CHECK(uart_read(&uart, data, sizeof(data)) == RX_BUFFER_SIZE);
+    TEST_CHECK(memcmp(data, "123456789ABCDEFGHIJklmnopqrstuv\n", 32U) == 0);
+    TEST_CHECK(uart_read(&uart, data, sizeof(data)) == 0U);
+
+    // rearming after an error drops what was not read yet
+    bus_feed_string(&bus, "partial");
+    TEST_CHECK(uart_receive_start(&uart) == UART_ERR_OK);
+    TEST_CHECK(bus.starts == 2U);
+    TEST_CHECK(uart_get_receive_dropped(&uart) == 1U + 7U);
+    bus_feed_string(&bus, "after\n");
+    TEST_CHECK(uart_read(&uart, data, sizeof(data)) == 6U);
+    TEST_CHECK(memcmp(data, "after\n", 6U) == 0);
+}
+
+int main(void)
+{
+    test_lines();
+    test_overrun_and_restart();
+
+    return test_finish();
+}
@@ -0,0 +1,260 @@
+#include "test.h"
+#include "uart.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TX_BUFFER_SIZE (256U)
+#define LINES (400U)
+
+// DMA transmitter of USART2, a transfer runs until bus_complete plays its
+// completion interrupt
+typedef struct {
+    uart_t* uart;
+    uint8_t sent[LINES * 32U];
+    size_t sent_size;
+    size_t running;
+    // transfers to refuse before accepting again
+    size_t refuse;
+    // the completion interrupt fires whenever the writer leaves its critical
+    // section or reads the tick
+    bool interrupts;
+    uint32_t tick;
+} bus_mock_t;
+
+// Everything offered, and the part the uart queued
+typedef struct {
+    uint8_t data[LINES * 32U];
+    size_t size;
+    size_t written;
+    size_t line_offsets[LINES + 1U];
+} stream_t;
+
+static uint8_t tx_buffer[TX_BUFFER_SIZE];
+
+static void bus_complete(bus_mock_t* bus)
+{
+    if (bus->running > 0U) {
+        bus->running = 0U;
+        uart_transmit_complete(bus->uart);
+    }
+}
+
+static uart_err_t bus_transmit(void* user, uint8_t const* data, size_t size)
+{
+    bus_mock_t* bus = (bus_mock_t*)user;
+
+    TEST_CHECK(bus->running == 0U && size <= UART_TX_CHUNK_SIZE);
+    if (bus->refuse > 0U) {
+        --bus->refuse;
+        return UART_ERR_FAIL;
+    }
+
+    memcpy(&bus->sent[bus->sent_size], data, size);
+    bus->sent_size += size;
+    bus->running = size;
+
+    return UART_ERR_OK;
+}
+
+static void bus_lock(void* user)
+{
+    (void)user;
+}
+
+static void bus_unlock(void* user)
+{
+    bus_mock_t* bus = (bus_mock_t*)user;
+
+    if (bus->interrupts) {
+        bus_complete(bus);
+    }
+}
+
+static uint32_t bus_get_tick(void* user)
+{
+    bus_mock_t* bus = (bus_mock_t*)user;
+
+    if (bus->interrupts) {
+        bus_complete(bus);
+    }
+
+    return ++bus->tick;
+}
+
+static void initialize(uart_t* uart, bus_mock_t* bus, uart_overflow_t overflow)
+{
+    memset(bus, 0, sizeof(*bus));
+    bus->uart = uart;
+
+    uart_initialize(uart,
+                    &(uart_config_t){.tx_buffer = tx_buffer,
+                                     .tx_buffer_size = TX_BUFFER_SIZE,
+                                     .overflow = overflow,
+                                     .drain_timeout = 100U},
+                    &(uart_interface_t){.bus_user = bus,
+                                        .bus_transmit = bus_transmit,
+                                        .lock = bus_lock,
+                                        .unlock = bus_unlock,
+                                        .get_tick = bus_get_tick});
+}
+
+// Log lines of varying length, written in bursts the bus cannot keep up with
+static void write_bursts(uart_t* uart,
+                         bus_mock_t* bus,
+                         stream_t* stream,
+                         bool whole)
+{
+    char line[32];
+
+    memset(stream, 0, sizeof(*stream));
+
+    for (size_t index = 0U; index < LINES; ++index) {
+        int length = snprintf(line,
+                              sizeof(line),
+                              "[%03zu] %.*s\n",
+                              index,
+                              (int)(test_random() % 20U),
+                              "burst of log lines");
+        size_t size = (size_t)length;
+
+        stream->line_offsets[index] = stream->size;
+        memcpy(&stream->data[stream->size], line, size);
+        stream->size += size;
+        stream->line_offsets[index + 1U] = stream->size;
+
+        size_t queued = whole ? uart_write_all(uart, line, size)
+                              : uart_write(uart, line, size);
+        TEST_CHECK(queued <= size);
+        TEST_CHECK(!whole || queued == 0U || queued == size);
+        stream->written += queued;
+
+        if (test_random() % 8U == 0U) {
+            bus_complete(bus);
+        }
+    }
+
+    bus->interrupts = true;
+    TEST_CHECK(uart_drain(uart) == UART_ERR_OK);
+}
+
+// Every line sent is a whole line of the stream, in order
+static bool are_lines_whole(bus_mock_t const* bus, stream_t const* stream)
+{
+    size_t offset = 0U;
+    size_t line = 0U;
+
+    while (offset < bus->sent_size && line < LINES) {
+        size_t begin = stream->line_offsets[line];
+        size_t size = stream->line_offsets[line + 1U] - begin;
+        if (offset + size <= bus->sent_size &&
+            memcmp(&bus->sent[offset], &stream->data[begin], size) == 0) {
+            offset += size;
+        }
+        ++line;
+    }
+
+    return offset == bus->sent_size;
+}
+
+static void test_drop(void)
+{
+    static uart_t uart;
+    static bus_mock_t bus;
+    static stream_t stream;
+
+    // the bytes that fit are sent in order, the rest is counted
+    initialize(&uart, &bus, UART_OVERFLOW_DROP);
+    write_bursts(&uart, &bus, &stream, false);
+    TEST_CHECK(stream.written < stream.size);
+    TEST_CHECK(bus.sent_size == stream.written);
+    TEST_CHECK(uart_get_dropped(&uart) == stream.size - stream.written);
+
+    // records are never cut
+    initialize(&uart, &bus, UART_OVERFLOW_DROP);
+    write_bursts(&uart, &bus, &stream, true);
+    TEST_CHECK(stream.written < stream.size);
+    TEST_CHECK(bus.sent_size == stream.written);
+    TEST_CHECK(uart_get_dropped(&uart) == stream.size - stream.written);
+    TEST_CHECK(are_lines_whole(&bus, &stream));
+}
+
+static void test_overwrite(void)
+{
+    static uart_t uart;
+    static bus_mock_t bus;
+    static stream_t stream;
+
+    // the newest bytes survive
+    initialize(&uart, &bus, UART_OVERFLOW_OVERWRITE);
+    write_bursts(&uart, &bus, &stream, false);
+    TEST_CHECK(bus.sent_size + uart_get_dropped(&uart) == stream.size);
+    TEST_CHECK(bus.sent_size >= TX_BUFFER_SIZE);
+    TEST_CHECK(memcmp(&bus.sent[bus.sent_size - TX_BUFFER_SIZE],
+                      &stream.data[stream.size - TX_BUFFER_SIZE],
+                      TX_BUFFER_SIZE) == 0);
+
+    // a record larger than the ring is dropped whole instead of its tail
+    // being sent
+    uint8_t record[TX_BUFFER_SIZE + 1U];
+    memset(record, 'r', sizeof(record));
+    size_t dropped = uart_get_dropped(&uart);
+    TEST_CHECK(uart_write_all(&uart, record, sizeof(record)) == 0U);
+    TEST_CHECK(uart_get_dropped(&uart) == dropped + sizeof(record));
+}
+
+static void test_block(void)
+{
+    static uart_t uart;
+    static bus_mock_t bus;
+    static stream_t stream;
+
+    initialize(&uart, &bus, UART_OVERFLOW_BLOCK);
+    bus.interrupts = true;
+    write_bursts(&uart, &bus, &stream, false);
+    TEST_CHECK(stream.written == stream.size);
+    TEST_CHECK(bus.sent_size == stream.size);
+    TEST_CHECK(memcmp(bus.sent, stream.data, stream.size) == 0);
+    TEST_CHECK(uart_get_dropped(&uart) == 0U);
+}
+
+static void test_drain(void)
+{
+    static uart_t uart;
+    static bus_mock_t bus;
+    static uint8_t data[200];
+
+    for (size_t index = 0U; index < sizeof(data); ++index) {
+        data[index] = (uint8_t)index;
+    }
+
+    // a refused transfer loses its chunk and leaves the rest queued with
+    // nothing running, drain restarts it and reports the loss once
+    initialize(&uart, &bus, UART_OVERFLOW_DROP);
+    bus.refuse = 1U;
+    TEST_CHECK(uart_write(&uart, data, sizeof(data)) == sizeof(data));
+    TEST_CHECK(bus.running == 0U && ring_get_used(&uart.tx_ring) > 0U);
+    bus.interrupts = true;
+    TEST_CHECK(uart_drain(&uart) == UART_ERR_FAIL);
+    TEST_CHECK(bus.sent_size == sizeof(data) - UART_TX_CHUNK_SIZE);
+    TEST_CHECK(memcmp(bus.sent,
+                      &data[UART_TX_CHUNK_SIZE],
+                      bus.sent_size) == 0);
+    TEST_CHECK(uart_get_dropped(&uart) == UART_TX_CHUNK_SIZE);
+    TEST_CHECK(uart_drain(&uart) == UART_ERR_OK);
+
+    // a transfer that never completes times out
+    initialize(&uart, &bus, UART_OVERFLOW_DROP);
+    TEST_CHECK(uart_write(&uart, data, sizeof(data)) == sizeof(data));
+    TEST_CHECK(uart_drain(&uart) == UART_ERR_FAIL);
+    TEST_CHECK(bus.tick >= 100U && bus.tick <= 101U);
+}
+
+int main(void)
+{
+    test_drop();
+    test_overwrite();
+    test_block();
+    test_drain();
+
+    return test_finish();
+}
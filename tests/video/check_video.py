@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+
+import argparse
+import pathlib
+import random
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, str(pathlib.Path(__file__).resolve().parents[2] / "scripts"))
+
+import link  # noqa: E402
+import video_stream  # noqa: E402
+
+WIDTH = 128
+HEIGHT = 128
+
+
+# Encodes an animation with scripts/video_stream.py and has test_video decode
+# it behind components/link with text frames in between, every frame has to
+# come out as it went in
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("test")
+    arguments = parser.parse_args()
+
+    size = WIDTH * HEIGHT // video_stream.PAGE_HEIGHT
+    generator = random.Random(0)
+    frames = list(video_stream.animation(WIDTH, HEIGHT, 80))
+    # noise needs literals and splits frames into many chunks, blank frames
+    # are nothing but a skip
+    frames += [bytes(generator.randrange(256) for _ in range(size)) for _ in range(3)]
+    frames += [bytes(size)] * 2
+    frames += list(video_stream.animation(WIDTH, HEIGHT, 20))
+
+    encoder = video_stream.Encoder(size, key_interval=25)
+    payloads = [payload for frame in frames for payload in encoder.encode(frame)]
+    stream = []
+    for index, payload in enumerate(payloads):
+        stream.append(link.encode_frame(link.CHANNEL_VIDEO, payload))
+        # text the host sends in between, main.c prints it
+        if index % 3 == 0:
+            stream.append(link.encode_frame(link.CHANNEL_TEXT, b"text %d" % index))
+
+    with tempfile.TemporaryDirectory() as directory:
+        stream_path = pathlib.Path(directory) / "stream.bin"
+        frames_path = pathlib.Path(directory) / "frames.bin"
+        stream_path.write_bytes(b"".join(stream))
+        frames_path.write_bytes(b"".join(frames))
+
+        return subprocess.run([arguments.test, stream_path, frames_path]).returncode
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,354 @@
+#include "console_sink.h"
+#include "link.h"
+#include "test.h"
+#include "test_gfx.h"
+#include "test_panel.h"
+#include "video.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LINK_BUFFER_SIZE (512U)
+#define STREAM_SIZE (1U << 20U)
+#define FRAMES_MAX (256U)
+#define DROPPED_CHUNK (40U)
+
+static uint8_t frame[TEST_GFX_FRAME_SIZE];
+
+static void initialize(gfx_t* gfx, test_panel_t* panel, video_t* video)
+{
+    test_panel_initialize(panel);
+    gfx_interface_t interface = test_panel_get_interface(panel);
+    test_gfx_initialize(
+        gfx, frame, TEST_GFX_WIDTH, TEST_GFX_HEIGHT, &interface);
+    TEST_CHECK(gfx_flush(gfx) == GFX_ERR_OK);
+    test_panel_reset_counters(panel);
+    video_initialize(video, &(video_config_t){.gfx = gfx});
+}
+
+// Decodes a copy on the heap, so ASan catches reads past the chunk
+static video_err_t decode(video_t* video, uint8_t const* data, size_t size)
+{
+    uint8_t* chunk = malloc(size > 0U ? size : 1U);
+    memcpy(chunk, data, size);
+    video_err_t err = video_decode(video, chunk, size);
+    free(chunk);
+
+    return err;
+}
+
+static void test_tokens(void)
+{
+    test_panel_t panel;
+    video_t video;
+    gfx_t gfx;
+
+    initialize(&gfx, &panel, &video);
+
+    // skip 3, XOR in two literals, skip 128, XOR 0x0F into 5 bytes
+    static uint8_t const key[] = {VIDEO_CHUNK_BEGIN | VIDEO_CHUNK_KEY,
+                                  0U,
+                                  0x02U,
+                                  0x81U,
+                                  0xAAU,
+                                  0x55U,
+                                  0x7FU,
+                                  0xC3U,
+                                  0x0FU};
+    TEST_CHECK(decode(&video, key, sizeof(key)) == VIDEO_ERR_OK);
+    TEST_CHECK(video_get_frames(&video) == 0U && panel.spans == 0U);
+    TEST_CHECK(frame[3] == 0xAAU && frame[4] == 0x55U);
+    TEST_CHECK(frame[133] == 0x0FU && frame[137] == 0x0FU);
+    TEST_CHECK(frame[138] == 0U);
+
+    // the frame ends in the next chunk, a key frame redraws every page
+    static uint8_t const end[] = {VIDEO_CHUNK_END, 1U, 0x80U, 0x01U};
+    TEST_CHECK(decode(&video, end, sizeof(end)) == VIDEO_ERR_OK);
+    TEST_CHECK(frame[138] == 0x01U);
+    TEST_CHECK(video_get_frames(&video) == 1U);
+    TEST_CHECK(panel.spans == TEST_GFX_HEIGHT / GFX_PAGE_HEIGHT);
+    TEST_CHECK(memcmp(panel.ram, frame, sizeof(frame)) == 0);
+
+    // a delta frame XORs against the frame shown, only its page goes out
+    static uint8_t const delta[] = {
+        VIDEO_CHUNK_BEGIN | VIDEO_CHUNK_END, 2U, 0x02U, 0x80U, 0xAAU};
+    test_panel_reset_counters(&panel);
+    TEST_CHECK(decode(&video, delta, sizeof(delta)) == VIDEO_ERR_OK);
+    TEST_CHECK(frame[3] == 0U && panel.spans == 1U);
+    TEST_CHECK(video_get_errors(&video) == 0U);
+}
+
+static void test_sync(void)
+{
+    test_panel_t panel;
+    video_t video;
+    gfx_t gfx;
+
+    initialize(&gfx, &panel, &video);
+
+    // nothing applies before the first key frame
+    static uint8_t const delta[] = {VIDEO_CHUNK_BEGIN | VIDEO_CHUNK_END,
+                                    0U,
+                                    0x80U,
+                                    0xFFU};
+    TEST_CHECK(decode(&video, delta, sizeof(delta)) == VIDEO_ERR_FAIL);
+    TEST_CHECK(frame[0] == 0U && video_get_frames(&video) == 0U);
+
+    static uint8_t const key[] = {
+        VIDEO_CHUNK_BEGIN | VIDEO_CHUNK_KEY, 1U, 0x80U, 0x01U};
+    TEST_CHECK(decode(&video, key, sizeof(key)) == VIDEO_ERR_OK);
+
+    // a missing chunk drops everything up to the next key frame
+    static uint8_t const skipped[] = {VIDEO_CHUNK_END, 3U, 0x80U, 0x02U};
+    TEST_CHECK(decode(&video, skipped, sizeof(skipped)) == VIDEO_ERR_FAIL);
+    TEST_CHECK(video_get_errors(&video) == 1U);
+    static uint8_t const after[] = {VIDEO_CHUNK_BEGIN | VIDEO_CHUNK_END,
+                                    4U,
+                                    0x80U,
+                                    0x04U};
+    TEST_CHECK(decode(&video, after, sizeof(after)) == VIDEO_ERR_FAIL);
+    TEST_CHECK(frame[0] == 0x01U && video_get_frames(&video) == 0U);
+
+    static uint8_t const resync[] = {
+        VIDEO_CHUNK_BEGIN | VIDEO_CHUNK_KEY | VIDEO_CHUNK_END,
+        9U,
+        0x80U,
+        0x08U};
+    TEST_CHECK(decode(&video, resync, sizeof(resync)) == VIDEO_ERR_OK);
+    TEST_CHECK(frame[0] == 0x08U && video_get_frames(&video) == 1U);
+    TEST_CHECK(memcmp(panel.ram, frame, sizeof(frame)) == 0);
+}
+
+static void test_malformed(void)
+{
+    static uint8_t const chunks[][6] = {
+        // literal past the end of the chunk
+        {VIDEO_CHUNK_BEGIN | VIDEO_CHUNK_KEY, 0U, 0x83U, 1U, 2U, 3U},
+        // repeat without its value
+        {VIDEO_CHUNK_BEGIN | VIDEO_CHUNK_KEY, 0U, 0x7FU, 0x7FU, 0xC0U},
+    };
+    test_panel_t panel;
+    video_t video;
+    gfx_t gfx;
+
+    initialize(&gfx, &panel, &video);
+
+    TEST_CHECK(decode(&video, chunks[0], 6U) == VIDEO_ERR_FAIL);
+    TEST_CHECK(decode(&video, chunks[1], 5U) == VIDEO_ERR_FAIL);
+    TEST_CHECK(decode(&video, chunks[1], 1U) == VIDEO_ERR_FAIL);
+    TEST_CHECK(video_get_errors(&video) == 3U);
+
+    // skips past the end of the frame buffer
+    uint8_t skips[2U + TEST_GFX_FRAME_SIZE / VIDEO_SKIP_MAX + 1U];
+    skips[0] = VIDEO_CHUNK_BEGIN | VIDEO_CHUNK_KEY;
+    skips[1] = 0U;
+    memset(&skips[2], VIDEO_SKIP_MAX - 1U, sizeof(skips) - 2U);
+    TEST_CHECK(decode(&video, skips, sizeof(skips) - 1U) == VIDEO_ERR_OK);
+    TEST_CHECK(decode(&video, skips, sizeof(skips)) == VIDEO_ERR_FAIL);
+
+    // random chunks never write outside the frame buffer
+    for (size_t trial = 0U; trial < 20000U; ++trial) {
+        uint8_t chunk[64];
+        size_t size = test_random() % sizeof(chunk);
+        for (size_t index = 0U; index < size; ++index) {
+            chunk[index] = (uint8_t)test_random();
+        }
+        if (size > 0U && trial % 4U == 0U) {
+            chunk[0] |= VIDEO_CHUNK_BEGIN | VIDEO_CHUNK_KEY;
+        }
+        decode(&video, chunk, size);
+    }
+}
+
+// The board end of scripts/video_stream.py, as main.c wires it
+typedef struct {
+    link_t link;
+    uint8_t tx_buffer[LINK_BUFFER_SIZE];
+    uint8_t rx_buffer[LINK_BUFFER_SIZE];
+    uint8_t const* stream;
+    size_t stream_size;
+    size_t read;
+
+    test_panel_t panel;
+    gfx_t gfx;
+    video_t video;
+    console_t console;
+    uint8_t console_buffer[256];
+    console_sink_t console_sink;
+    uint8_t const* frames;
+    size_t frame_count;
+
+    size_t chunks;
+    size_t dropped_chunk;
+    // index of the frame the next chunk belongs to
+    size_t frame_index;
+    size_t mismatches;
+    size_t texts;
+    uint64_t decoding;
+} device_t;
+
+static size_t device_read(void* user, uint8_t* data, size_t size)
+{
+    device_t* device = (device_t*)user;
+    size_t available = device->stream_size - device->read;
+
+    if (size > available) {
+        size = available;
+    }
+    memcpy(data, &device->stream[device->read], size);
+    device->read += size;
+
+    return size;
+}
+
+static void device_receive(void* user,
+                           uint8_t channel,
+                           uint8_t const* data,
+                           size_t size)
+{
+    device_t* device = (device_t*)user;
+
+    // the main loop runs between frames
+    console_sink_process(&device->console_sink);
+
+    if (channel == LINK_CHANNEL_TEXT) {
+        char line[LINK_BUFFER_SIZE + 4U];
+        int length = snprintf(
+            line, sizeof(line), "> %.*s\n", (int)size, (char const*)data);
+        console_sink_write(&device->console_sink, line, (size_t)length);
+        ++device->texts;
+        return;
+    }
+    if (channel != LINK_CHANNEL_VIDEO || size == 0U) {
+        return;
+    }
+
+    size_t index = device->frame_index;
+    if (data[0] & VIDEO_CHUNK_END) {
+        ++device->frame_index;
+    }
+    if (device->chunks++ == device->dropped_chunk) {
+        return;
+    }
+
+    size_t frames = video_get_frames(&device->video);
+    uint64_t begin = test_get_time();
+    video_decode(&device->video, data, size);
+    device->decoding += test_get_time() - begin;
+
+    // every frame that comes out is shown whole and as encoded
+    if (video_get_frames(&device->video) != frames &&
+        (index >= device->frame_count ||
+         memcmp(device->panel.ram,
+                &device->frames[index * TEST_GFX_FRAME_SIZE],
+                TEST_GFX_FRAME_SIZE) != 0)) {
+        ++device->mismatches;
+    }
+}
+
+// Text frames are printed into the console sink the way main.c prints them,
+// on the console rows below the demo text
+static void play(device_t* device, size_t dropped_chunk, bool detached)
+{
+    device->read = 0U;
+    device->chunks = 0U;
+    device->dropped_chunk = dropped_chunk;
+    device->frame_index = 0U;
+    device->mismatches = 0U;
+    device->texts = 0U;
+    device->decoding = 0U;
+
+    initialize(&device->gfx, &device->panel, &device->video);
+    console_initialize(
+        &device->console,
+        &(console_config_t){.gfx = &device->gfx, .first_row = 11U});
+    console_sink_initialize(
+        &device->console_sink,
+        &(console_sink_config_t){
+            .console = &device->console,
+            .buffer = device->console_buffer,
+            .buffer_size = sizeof(device->console_buffer)});
+    if (detached) {
+        console_sink_detach(&device->console_sink);
+    }
+
+    link_initialize(&device->link,
+                    &(link_config_t){.tx_buffer = device->tx_buffer,
+                                     .tx_buffer_size = LINK_BUFFER_SIZE,
+                                     .rx_buffer = device->rx_buffer,
+                                     .rx_buffer_size = LINK_BUFFER_SIZE,
+                                     .baud = 115200U,
+                                     .max_baud = 115200U},
+                    &(link_interface_t){.transport_user = device,
+                                        .transport_read = device_read,
+                                        .receive_user = device,
+                                        .receive = device_receive});
+    link_process(&device->link, 0U);
+    TEST_CHECK(link_get_rx_dropped(&device->link) == 0U);
+}
+
+static size_t read_file(char const* path, uint8_t* data, size_t size)
+{
+    FILE* file = fopen(path, "rb");
+    if (!TEST_CHECK(file != NULL)) {
+        return 0U;
+    }
+    size = fread(data, 1U, size, file);
+    fclose(file);
+
+    return size;
+}
+
+// Round trip of what check_video.py encoded, text frames between the chunks
+// included, then the same with one chunk lost on the way
+static void test_stream(char const* stream_path, char const* frames_path)
+{
+    static uint8_t stream[STREAM_SIZE];
+    static uint8_t frames[FRAMES_MAX * TEST_GFX_FRAME_SIZE];
+    static device_t device;
+
+    device.stream = stream;
+    device.stream_size = read_file(stream_path, stream, sizeof(stream));
+    device.frames = frames;
+    device.frame_count =
+        read_file(frames_path, frames, sizeof(frames)) / TEST_GFX_FRAME_SIZE;
+    TEST_CHECK(device.stream_size > 0U && device.frame_count > 0U);
+
+    // main.c detaches the console sink when it enters link mode
+    play(&device, SIZE_MAX, true);
+    TEST_CHECK(device.mismatches == 0U && device.texts > 0U);
+    TEST_CHECK(video_get_frames(&device.video) == device.frame_count);
+    TEST_CHECK(video_get_errors(&device.video) == 0U);
+
+    test_report("decode per frame", device.frame_count, device.decoding);
+    printf("%-40s %10.1f MB/s\n",
+           "",
+           (double)device.stream_size * 1000.0 / (double)device.decoding);
+    printf("%-40s %10.1f bytes per frame\n",
+           "",
+           (double)device.stream_size / (double)device.frame_count);
+
+    // frames up to the next key frame are lost, the rest is intact
+    play(&device, DROPPED_CHUNK, true);
+    TEST_CHECK(device.mismatches == 0U);
+    TEST_CHECK(video_get_errors(&device.video) == 1U);
+    TEST_CHECK(video_get_frames(&device.video) < device.frame_count);
+    TEST_CHECK(video_get_frames(&device.video) > device.frame_count / 2U);
+
+    // an attached console draws its rows into the frames the deltas apply to
+    play(&device, SIZE_MAX, false);
+    TEST_CHECK(device.mismatches > 0U);
+}
+
+int main(int argc, char** argv)
+{
+    test_tokens();
+    test_sync();
+    test_malformed();
+
+    if (TEST_CHECK(argc == 3)) {
+        test_stream(argv[1], argv[2]);
+    }
+
+    return test_finish();
+}